@@ -32,10 +32,21 @@
 
 #define as_arch_pause() asm volatile("pause" : : : "memory")
 
+// Invariant TSC - not ordered against neighbouring instructions, so only fit
+// for timing spans well above a few cycles.
+#define as_arch_ticks() __builtin_ia32_rdtsc()
+
 #elif defined __aarch64__
 
 #define as_arch_pause() asm volatile("isb" : : : "memory")
 
+// Generic timer virtual count - see cntfrq_el0 for its frequency.
+#define as_arch_ticks() ({ \
+	uint64_t _ticks; \
+	asm volatile("mrs %0, cntvct_el0" : "=r" (_ticks)); \
+	_ticks; \
+})
+
 #endif
 
 #endif // gcc & clang
@@ -108,7 +108,8 @@ typedef struct as_arraylist_s {
 	uint32_t block_size;
 
 	/**
-	 * The total number elements allocated.
+	 * The total number elements allocated, including the unused ones before
+	 * as_arraylist.elements.
 	 */
 	uint32_t capacity;
 
@@ -119,15 +120,26 @@ typedef struct as_arraylist_s {
 
 	/**
 	 * The elements of the list.
+	 *
+	 * Once as_arraylist.front is nonzero, this no longer points to the start
+	 * of its allocation - the allocation starts at elements - front. Code
+	 * that frees or reallocates elements itself must use that address, and
+	 * code that swaps in its own buffer must set front to 0.
 	 */
 	as_val** elements;
 
 	/**
-	 * If true, then as_arraylist.elements will be freed when
-	 * as_arraylist_destroy() is called.
+	 * If true, then the allocation holding as_arraylist.elements will be freed
+	 * when as_arraylist_destroy() is called.
 	 */
 	bool free;
 
+	/**
+	 * The number of unused elements allocated before as_arraylist.elements,
+	 * left by removals from the front or reserved for insertions there.
+	 */
+	uint32_t front;
+
 } as_arraylist;
 
 /**
@@ -157,6 +169,32 @@ typedef enum as_arraylist_status_e {
 
 } as_arraylist_status;
 
+/**
+ * Options for as_arraylist_sort(), combined with bitwise or. The default is
+ * an unstable sort in ascending as_val_cmp() order.
+ */
+typedef enum as_arraylist_sort_flags_e {
+
+	/**
+	 * Sort in descending order.
+	 */
+	AS_ARRAYLIST_SORT_DESCENDING	= 0x1,
+
+	/**
+	 * Keep elements that compare equal in their original order.
+	 */
+	AS_ARRAYLIST_SORT_STABLE		= 0x2,
+
+	/**
+	 * Keep only the first of each run of elements that compare equal. The
+	 * others are destroyed.
+	 */
+	AS_ARRAYLIST_SORT_UNIQUE		= 0x4
+
+} as_arraylist_sort_flags;
+
+struct as_thread_pool_s;
+
 /******************************************************************************
  * MACROS
  ******************************************************************************/
@@ -281,6 +319,19 @@ as_arraylist_concat(as_arraylist* list, const as_arraylist* list2);
 AS_EXTERN int
 as_arraylist_trim(as_arraylist* list, uint32_t index);
 
+/**
+ * Delete (and destroy) the first n elements. Following elements are not
+ * moved, so this is O(n).
+ *
+ * @param list 	The list to trim.
+ * @param n		The number of elements to remove.
+ *
+ * @return AS_ARRAYLIST_OK on success. Otherwise an error occurred.
+ * @relatesalso as_arraylist
+ */
+AS_EXTERN int
+as_arraylist_trim_front(as_arraylist* list, uint32_t n);
+
 /**
  * Get the first element of the list.
  *
@@ -637,6 +688,10 @@ as_arraylist_set_map(as_arraylist* list, uint32_t index, as_map* value)
  * Any elements at and beyond specified index will be shifted so their indexes
  * increase by 1. It's ok to insert beyond the current end of the list.
  *
+ * When there is room before the first element, the shorter side of the list
+ * is moved. A growable list that is full when prepended to grows at the
+ * front, so repeated prepends are amortized O(1).
+ *
  * @param list 	The list.
  * @param index	Position in the list.
  * @param value	The value to insert at the given index.
@@ -1072,6 +1127,9 @@ static inline int as_arraylist_prepend_map(as_arraylist* list, as_map* value)
  * Any elements beyond specified index will be shifted so their indexes
  * decrease by 1. The element at specified index will be destroyed.
  *
+ * The shorter side of the list is moved, so removing the first element is
+ * O(1).
+ *
  * @param list 	The list.
  * @param index 	The index of the element to remove.
  *
@@ -1081,6 +1139,45 @@ static inline int as_arraylist_prepend_map(as_arraylist* list, as_map* value)
 AS_EXTERN int
 as_arraylist_remove(as_arraylist* list, uint32_t index);
 
+/******************************************************************************
+ * SORT FUNCTIONS
+ ******************************************************************************/
+
+/**
+ * Sort the list in as_val_cmp() order.
+ *
+ * Lists of only integers, only doubles or only strings are sorted on keys
+ * extracted up front - the values, or the first 8 bytes of each string -
+ * so most comparisons don't touch the elements.
+ *
+ * @param list 	The list to sort.
+ * @param flags	as_arraylist_sort_flags, or 0.
+ *
+ * @return AS_ARRAYLIST_OK on success. Otherwise an error occurred and the
+ * list is unchanged.
+ * @relatesalso as_arraylist
+ */
+AS_EXTERN int
+as_arraylist_sort(as_arraylist* list, uint32_t flags);
+
+/**
+ * Sort the list like as_arraylist_sort(), splitting large lists into runs
+ * sorted and merged on the pool's threads. The calling thread takes part,
+ * running queued tasks of the pool until the sort is done, so it may itself
+ * be one of the pool's threads.
+ *
+ * @param list 	The list to sort.
+ * @param flags	as_arraylist_sort_flags, or 0.
+ * @param pool		The thread pool. If NULL, the list is sorted on the
+ * 					calling thread.
+ *
+ * @return AS_ARRAYLIST_OK on success. Otherwise an error occurred and the
+ * list is unchanged.
+ * @relatesalso as_arraylist
+ */
+AS_EXTERN int
+as_arraylist_sort_parallel(as_arraylist* list, uint32_t flags, struct as_thread_pool_s* pool);
+
 /******************************************************************************
  * ITERATION FUNCTIONS
  ******************************************************************************/
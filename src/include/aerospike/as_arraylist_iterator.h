@@ -168,6 +168,19 @@ AS_EXTERN bool as_arraylist_iterator_has_next(const as_arraylist_iterator * iter
  */
 AS_EXTERN const as_val * as_arraylist_iterator_next(as_arraylist_iterator * iterator);
 
+/**
+ *	Get up to n values from the iterator, and iterate past them.
+ *
+ *	@param iterator 	The iterator to get the values from.
+ *	@param values		Receives the values, owned by the list.
+ *	@param n			The maximum number of values to get.
+ *
+ *	@return The number of values read. 0 when the iterator is exhausted.
+ *
+ *	@relatesalso as_arraylist_iterator
+ */
+AS_EXTERN uint32_t as_arraylist_iterator_next_n(as_arraylist_iterator * iterator, const as_val ** values, uint32_t n);
+
 #ifdef __cplusplus
 } // end extern "C"
 #endif
@@ -639,6 +639,12 @@ as_decr_int16_rls(int16_t* target)
 
 // "Relaxed" wrappers.
 
+static inline void*
+as_fas_ptr(void** target, void* value)
+{
+	return as_fas_rlx(target, value);
+}
+
 static inline uint64_t
 as_fas_uint64(uint64_t* target, uint64_t value)
 {
@@ -697,6 +703,12 @@ as_fas_int16(int16_t* target, int16_t value)
 
 // "Relaxed" wrappers.
 
+static inline bool
+as_cas_ptr(void** target, void* old_value, void* new_value)
+{
+	return as_cas_rlx(target, &old_value, new_value);
+}
+
 static inline bool
 as_cas_uint64(uint64_t* target, uint64_t old_value, uint64_t new_value)
 {
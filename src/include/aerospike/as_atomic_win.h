@@ -323,6 +323,9 @@ extern "C" {
  * FETCH AND SWAP
  *****************************************************************************/
 
+// void* as_fas_ptr(void** target, void* value)
+#define as_fas_ptr(_target, _value) InterlockedExchangePointer((PVOID volatile*)(_target), (PVOID)(_value))
+
 // uint64_t as_fas_uint64(uint64_t* target, uint64_t value)
 #define as_fas_uint64(_target, _value) (uint64_t)InterlockedExchange64((LONGLONG volatile*)(_target), (LONGLONG)(_value))
 
@@ -345,6 +348,9 @@ extern "C" {
  * COMPARE AND SWAP
  *****************************************************************************/
 
+// bool as_cas_ptr(void** target, void* old_value, void* new_value)
+#define as_cas_ptr(_target, _old_value, _new_value) (InterlockedCompareExchangePointer((PVOID volatile*)(_target), (PVOID)(_new_value), (PVOID)(_old_value)) == (PVOID)(_old_value))
+
 // bool as_cas_uint64(uint64_t* target, uint64_t old_value, uint64_t new_value)
 #define as_cas_uint64(_target, _old_value, _new_value) (InterlockedCompareExchange64((LONGLONG volatile*)(_target), (LONGLONG)(_new_value), (LONGLONG)(_old_value)) == (LONGLONG)(_old_value))
 
@@ -355,6 +355,8 @@ AS_EXTERN as_bytes * as_bytes_init_wrap(as_bytes * bytes, uint8_t * value, uint3
 /**
  *	Create and initialize a new heap allocated `as_bytes`. Allocates an 
  *	internal buffer on the heap of specified capacity using `cf_malloc()`.
+ *	The `as_bytes` itself is slab allocated - release it with
+ *	as_bytes_destroy(), not cf_free(). The same goes for as_bytes_new_wrap().
  *	
  *	~~~~~~~~~~{.c}
  *	as_bytes * bytes = as_bytes_new(10);
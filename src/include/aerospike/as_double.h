@@ -149,6 +149,9 @@ as_double_init(as_double* value_ptr, double value);
  *	as_double_destroy(&v);
  *	~~~~~~~~~~
  *
+ *	The `as_double` comes from as_slab_alloc(), so it must never be passed
+ *	to cf_free().
+ *
  *	@param value		The double value.
  *
  *	@return On success, the initialized value. Otherwise NULL.
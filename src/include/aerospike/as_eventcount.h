@@ -0,0 +1,206 @@
+/*
+ * Copyright 2026 Aerospike, Inc.
+ *
+ * Portions may be licensed to Aerospike, Inc. under one or more contributor
+ * license agreements.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+#pragma once
+
+#include <aerospike/as_atomic.h>
+#include <aerospike/as_std.h>
+#include <citrusleaf/cf_clock.h>
+#include <pthread.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/******************************************************************************
+ * TYPES
+ *****************************************************************************/
+
+/**
+ * Default spin budget - the most iterations a waiter spins before parking.
+ */
+#define AS_EVENTCOUNT_SPIN 128
+
+/**
+ * An eventcount, for waiting on a condition that is checked without a lock.
+ *
+ * A waiter first spins, checking the condition, then registers, checks again
+ * and parks until the epoch moves. A notifier makes the condition true, then
+ * bumps the epoch and wakes parked waiters - but only if there are any, so
+ * an uncontended notify costs a fence and a load.
+ *
+ * The spin adapts between a floor and the budget: it doubles each time a
+ * spin sees the condition come true, and halves each time the waiter has to
+ * park anyway.
+ *
+ * Timed waits take a deadline on the monotonic cf_getns() clock, so they are
+ * not stretched or cut short by wall clock adjustments, and wakeups that find
+ * the condition still false wait only for the time that remains.
+ *
+ * On Linux, waiters park on a futex. Elsewhere they park on a condvar.
+ */
+typedef struct as_eventcount_s {
+	/**
+	 * Bumped by each notify that finds waiters.
+	 */
+	uint32_t epoch;
+
+	/**
+	 * Number of registered waiters.
+	 */
+	uint32_t waiters;
+
+	/**
+	 * The spin budget.
+	 */
+	uint32_t spin;
+
+	/**
+	 * The current adaptive spin limit.
+	 */
+	uint32_t spin_limit;
+
+	/**
+	 * Number of notifies that found waiters, and had to wake them.
+	 */
+	uint64_t wakes;
+
+	/**
+	 * Number of times a waiter parked.
+	 */
+	uint64_t parks;
+
+#if !defined(__linux__)
+	pthread_mutex_t lock;
+	pthread_cond_t cond;
+#endif
+} as_eventcount;
+
+/**
+ * Deadline value for waiting forever.
+ */
+#define AS_EVENTCOUNT_FOREVER 0
+
+/**
+ * Checks the condition being waited for. Called without any lock held.
+ */
+typedef bool (*as_eventcount_ready_fn)(void* udata);
+
+/******************************************************************************
+ * FUNCTIONS
+ *****************************************************************************/
+
+/**
+ * Initialize an eventcount, with the given spin budget. A budget of 0 parks
+ * without spinning.
+ */
+AS_EXTERN void
+as_eventcount_init(as_eventcount* ec, uint32_t spin);
+
+/**
+ * Release eventcount resources.
+ */
+AS_EXTERN void
+as_eventcount_destroy(as_eventcount* ec);
+
+/**
+ * Get the deadline for a wait of ms milliseconds from now. A negative ms
+ * gives AS_EVENTCOUNT_FOREVER.
+ */
+static inline uint64_t
+as_eventcount_deadline(int ms)
+{
+	return ms < 0 ? AS_EVENTCOUNT_FOREVER : cf_getns() + (uint64_t)ms * 1000 * 1000;
+}
+
+/**
+ * Change the spin budget.
+ */
+static inline void
+as_eventcount_set_spin(as_eventcount* ec, uint32_t spin)
+{
+	as_store_uint32(&ec->spin, spin);
+	as_store_uint32(&ec->spin_limit, spin);
+}
+
+/**
+ * Register as a waiter. The caller must check its condition again after this,
+ * then either park with the returned key or cancel.
+ */
+static inline uint32_t
+as_eventcount_prepare(as_eventcount* ec)
+{
+	as_incr_uint32(&ec->waiters);
+
+	// Pairs with the fence in as_eventcount_notify() - either the notifier
+	// sees us registered, or we see its condition on the re-check.
+	as_fence_seq();
+
+	return as_load_uint32(&ec->epoch);
+}
+
+/**
+ * Unregister a waiter that found its condition on the re-check.
+ */
+static inline void
+as_eventcount_cancel(as_eventcount* ec)
+{
+	as_decr_uint32(&ec->waiters);
+}
+
+/**
+ * Park until the epoch moves past key, or until the deadline passes.
+ * Unregisters the waiter.
+ *
+ * Returns false if timed out. Like a condvar, may return spuriously.
+ */
+AS_EXTERN bool
+as_eventcount_park(as_eventcount* ec, uint32_t key, uint64_t deadline);
+
+/**
+ * @private
+ * Bump the epoch and wake up to n parked waiters.
+ */
+AS_EXTERN void
+as_eventcount_wake(as_eventcount* ec, uint32_t n);
+
+/**
+ * Wake up to n waiters, after making their condition true. Costs no system
+ * call when nothing is parked.
+ */
+static inline void
+as_eventcount_notify(as_eventcount* ec, uint32_t n)
+{
+	as_fence_seq();
+
+	if (as_load_uint32(&ec->waiters) != 0) {
+		as_eventcount_wake(ec, n);
+	}
+}
+
+/**
+ * Wait until ready() returns true, or until the deadline passes. Spins within
+ * the adaptive limit, then parks.
+ *
+ * Returns the last result of ready().
+ */
+AS_EXTERN bool
+as_eventcount_await(as_eventcount* ec, as_eventcount_ready_fn ready, void* udata,
+	uint64_t deadline);
+
+#ifdef __cplusplus
+} // end extern "C"
+#endif
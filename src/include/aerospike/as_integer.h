@@ -113,6 +113,25 @@ typedef struct as_integer_s {
 
 } as_integer;
 
+/**
+ *	Range of values held in the preallocated integer cache.
+ */
+#define AS_INTEGER_CACHE_MIN (-128)
+#define AS_INTEGER_CACHE_MAX 1023
+
+/******************************************************************************
+ *	CONSTANTS
+ ******************************************************************************/
+
+/**
+ *	Preallocated, never freed integers for values AS_INTEGER_CACHE_MIN through
+ *	AS_INTEGER_CACHE_MAX. Like `as_true` and `as_false`, these have a zero
+ *	reference count, so as_val_reserve() and as_val_destroy() do nothing.
+ *
+ *	@private Use as_integer_new_cached().
+ */
+AS_EXTERN extern const as_integer as_integer_cache[];
+
 /******************************************************************************
  *	FUNCTIONS
  ******************************************************************************/
@@ -150,6 +169,9 @@ AS_EXTERN as_integer * as_integer_init(as_integer * integer, int64_t value);
  *	as_integer_destroy(&i);
  *	~~~~~~~~~~
  *
+ *	The `as_integer` comes from as_slab_alloc(), so it must never be passed
+ *	to cf_free().
+ *
  *	@param value		The integer value.
  *
  *	@return On success, the initialized value. Otherwise NULL.
@@ -158,6 +180,36 @@ AS_EXTERN as_integer * as_integer_init(as_integer * integer, int64_t value);
  */
 AS_EXTERN as_integer * as_integer_new(int64_t value);
 
+/**
+ *	Get an `as_integer` for the given value, using a shared preallocated
+ *	instance when the value is within the integer cache range, and a new heap
+ *	allocated instance otherwise.
+ *
+ *	Cached instances live in read-only memory, so the result is const and must
+ *	never be written - not even by as_integer_init(). Release it with
+ *	as_val_destroy() as usual.
+ *
+ *	Only callers that ask for it get cached instances - as_unpack_val_cached()
+ *	unpacks with it. as_integer_new(), and helpers such as
+ *	as_arraylist_append_int64(), always allocate.
+ *
+ *	~~~~~~~~~~{.c}
+ *	as_arraylist_append(list, (as_val*)as_integer_new_cached(7));
+ *	~~~~~~~~~~
+ *
+ *	@param value		The integer value.
+ *
+ *	@return On success, the value. Otherwise NULL.
+ *
+ *	@relatesalso as_integer
+ */
+static inline const as_integer * as_integer_new_cached(int64_t value) {
+	if (value >= AS_INTEGER_CACHE_MIN && value <= AS_INTEGER_CACHE_MAX) {
+		return &as_integer_cache[value - AS_INTEGER_CACHE_MIN];
+	}
+	return as_integer_new(value);
+}
+
 /**
  *	Destroy the `as_integer` and release resources.
  *
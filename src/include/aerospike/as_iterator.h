@@ -74,6 +74,17 @@ typedef struct as_iterator_hooks_s {
 	 */
 	const as_val * (* next)(as_iterator *);
 
+	/**
+	 *	Optional. Read up to n values, returning the number read.
+	 */
+	uint32_t (* next_n)(as_iterator *, const as_val ** values, uint32_t n);
+
+	/**
+	 *	Optional, for map iterators. Read up to n keys and values, returning the
+	 *	number read.
+	 */
+	uint32_t (* next_entries)(as_iterator *, const as_val ** keys, const as_val ** values, uint32_t n);
+
 } as_iterator_hooks;
 
 /******************************************************************************
@@ -119,6 +130,30 @@ static inline const as_val * as_iterator_next(as_iterator * iterator)
 	return as_util_hook(next, NULL, iterator);
 }
 
+/**
+ *	Get up to n values from the iterator, advancing past them. Costs one
+ *	indirect call per batch for iterators implementing it, instead of two per
+ *	value.
+ *
+ *	~~~~~~~~~~{.c}
+ *	const as_val * batch[32];
+ *	uint32_t n;
+ *
+ *	while ((n = as_iterator_next_n(it, batch, 32)) != 0) {
+ *		for (uint32_t i = 0; i < n; i++) {
+ *			...
+ *		}
+ *	}
+ *	~~~~~~~~~~
+ *
+ *	@param iterator		The iterator to get the values from.
+ *	@param values		Receives the values, with the same lifetime as those
+ *						returned by as_iterator_next().
+ *	@param n			The maximum number of values to get.
+ *	@return the number of values read. 0 when the iterator is exhausted.
+ */
+AS_EXTERN uint32_t as_iterator_next_n(as_iterator * iterator, const as_val ** values, uint32_t n);
+
 #ifdef __cplusplus
 } // end extern "C"
 #endif
@@ -461,6 +461,37 @@ typedef struct as_list_hooks_s {
 	 */
 	union as_list_iterator_u * (* iterator_init)(const as_list * list, union as_list_iterator_u * it);
 
+	/***************************************************************************
+	 *	memory hooks
+	 **************************************************************************/
+
+	/**
+	 *	Add the heap memory of the list - the header if heap allocated, its
+	 *	storage, and its elements via as_val_memory_add(). Optional - if NULL,
+	 *	as_val_memory_usage() estimates from the elements.
+	 *
+	 *	@param list	The list.
+	 *	@param mem	Accumulates the totals.
+	 *	@param shared	true if the list is referenced from elsewhere.
+	 */
+	void (* memory)(const as_list * list, as_val_memory * mem, bool shared);
+
+	/***************************************************************************
+	 *	copy hooks
+	 **************************************************************************/
+
+	/**
+	 *	Create a heap allocated copy of the list, of the same type. Optional -
+	 *	if NULL, as_val_clone() copies into an as_arraylist.
+	 *
+	 *	@param list	The list to copy.
+	 *	@param deep	true to copy the elements with as_val_clone(), false to
+	 *				share them.
+	 *
+	 *	@return On success, the copy. Otherwise NULL.
+	 */
+	as_list * (* clone)(const as_list * list, bool deep);
+
 } as_list_hooks;
 
 /*******************************************************************************
@@ -1444,6 +1475,25 @@ static inline union as_list_iterator_u * as_list_iterator_init(union as_list_ite
 	return as_util_hook(iterator_init, NULL, list, it);
 }
 
+/******************************************************************************
+ *	COPY FUNCTIONS
+ *****************************************************************************/
+
+/**
+ *	Prepare the element at index for modification. If the element is
+ *	referenced from elsewhere (count > 1), for example after
+ *	as_val_clone_cow(), it is replaced in the list by a copy-on-write copy of
+ *	itself. Otherwise it is left in place.
+ *
+ *	@param list 	The list.
+ *	@param index	The index of the element.
+ *
+ *	@return The element, now owned by this list only. NULL if index is out of
+ *	range or the copy could not be made.
+ *	@relatesalso as_list
+ */
+AS_EXTERN as_val * as_list_unshare(as_list * list, uint32_t index);
+
 /******************************************************************************
  *	CONVERSION FUNCTIONS
  *****************************************************************************/
@@ -18,6 +18,9 @@
 #pragma once
 
 #include <aerospike/as_arraylist_iterator.h>
+#include <aerospike/as_list_slice.h>
+#include <aerospike/as_persistent_list.h>
+#include <aerospike/as_typedlist.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -33,6 +36,9 @@ extern "C" {
 typedef union as_list_iterator_u {
 	
 	as_arraylist_iterator 	arraylist;
+	as_persistent_list_iterator	persistent_list;
+	as_typedlist_iterator	typedlist;
+	as_list_slice_iterator	slice;
 
 } as_list_iterator;
 
@@ -0,0 +1,241 @@
+/*
+ * Copyright 2026 Aerospike, Inc.
+ *
+ * Portions may be licensed to Aerospike, Inc. under one or more contributor
+ * license agreements.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#pragma once
+
+#include <aerospike/as_arraylist.h>
+#include <aerospike/as_iterator.h>
+#include <aerospike/as_list.h>
+#include <aerospike/as_std.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+/******************************************************************************
+ *	TYPES
+ ******************************************************************************/
+
+/**
+ *	An implementation of `as_list` viewing a range of another list, without
+ *	copying or reserving its elements.
+ *
+ *	~~~~~~~~~~{.c}
+ *	// Page through a large list, 100 elements at a time.
+ *	for (uint32_t i = 0; i < as_list_size(list); i += 100) {
+ *		as_list_slice* page = as_list_slice_new(list, i, 100);
+ *		...
+ *		as_list_slice_destroy(page);
+ *	}
+ *	~~~~~~~~~~
+ *
+ *	The slice holds a reference to the parent list, so the parent stays alive
+ *	until the slice is destroyed. A stack allocated parent must outlive the
+ *	slice. Slicing a slice references the original parent.
+ *
+ *	The parent must not be modified while the slice exists. Modifying the
+ *	slice copies the range into an `as_arraylist` first (reserving each
+ *	element) and drops the reference to the parent - except trimming and
+ *	removing the first or last element, which just narrow the range.
+ *
+ *	@extends as_list
+ *	@ingroup aerospike_t
+ */
+typedef struct as_list_slice_s {
+	as_list _;
+
+	/**
+	 *	The list viewed. NULL once the slice has been copied.
+	 */
+	const as_list* parent;
+
+	/**
+	 *	Index in the parent of the first element of the slice.
+	 */
+	uint32_t offset;
+
+	/**
+	 *	Number of elements in the slice.
+	 */
+	uint32_t size;
+
+	/**
+	 *	@private
+	 *	Holds all elements once the slice has been modified. Otherwise NULL.
+	 */
+	as_arraylist* copy;
+} as_list_slice;
+
+/**
+ *	Iterator for as_list_slice.
+ *
+ *	@extends as_iterator
+ */
+typedef struct as_list_slice_iterator_s {
+	as_iterator _;
+
+	const as_list_slice* slice;
+	uint32_t pos;
+} as_list_slice_iterator;
+
+
+/*******************************************************************************
+ *	INSTANCE FUNCTIONS
+ ******************************************************************************/
+
+/**
+ *	Initialize a stack allocated slice of a list. The range is clipped to the
+ *	end of the list.
+ *
+ *	@param slice 	The slice to initialize.
+ *	@param list		The list to view.
+ *	@param offset	The index of the first element of the slice.
+ *	@param count	The maximum number of elements in the slice.
+ *
+ *	@return On success, the initialized slice. Otherwise NULL.
+ *
+ *	@relatesalso as_list_slice
+ */
+AS_EXTERN as_list_slice* as_list_slice_init(as_list_slice* slice, const as_list* list, uint32_t offset, uint32_t count);
+
+/**
+ *	Create a new heap allocated slice of a list. The range is clipped to the
+ *	end of the list.
+ *
+ *	@param list		The list to view.
+ *	@param offset	The index of the first element of the slice.
+ *	@param count	The maximum number of elements in the slice.
+ *
+ *	@return On success, the new slice. Otherwise NULL.
+ *
+ *	@relatesalso as_list_slice
+ */
+AS_EXTERN as_list_slice* as_list_slice_new(const as_list* list, uint32_t offset, uint32_t count);
+
+/**
+ *	Destroy the slice and release its reference to the parent.
+ *
+ *	@relatesalso as_list_slice
+ */
+AS_EXTERN void as_list_slice_destroy(as_list_slice* slice);
+
+/**
+ *	Create a slice of the first n elements of a list - the view counterpart
+ *	of `as_list_take()`.
+ *
+ *	@relatesalso as_list_slice
+ */
+static inline as_list_slice*
+as_list_slice_take(const as_list* list, uint32_t n)
+{
+	return as_list_slice_new(list, 0, n);
+}
+
+/**
+ *	Create a slice of all but the first n elements of a list - the view
+ *	counterpart of `as_list_drop()`.
+ *
+ *	@relatesalso as_list_slice
+ */
+static inline as_list_slice*
+as_list_slice_drop(const as_list* list, uint32_t n)
+{
+	return as_list_slice_new(list, n, UINT32_MAX);
+}
+
+/**
+ *	Create a slice of all but the first element of a list - the view
+ *	counterpart of `as_list_tail()`.
+ *
+ *	@return The slice. NULL if the list is empty.
+ *
+ *	@relatesalso as_list_slice
+ */
+static inline as_list_slice*
+as_list_slice_tail(const as_list* list)
+{
+	return as_list_size(list) == 0 ? NULL : as_list_slice_drop(list, 1);
+}
+
+/**
+ *	Get the number of elements in the slice.
+ *
+ *	@relatesalso as_list_slice
+ */
+static inline uint32_t
+as_list_slice_size(const as_list_slice* slice)
+{
+	return slice->copy ? slice->copy->size : slice->size;
+}
+
+/**
+ *	Get the value at the specified index of the slice.
+ *
+ *	@return The value, owned by the list. NULL if index is out of range.
+ *
+ *	@relatesalso as_list_slice
+ */
+AS_EXTERN as_val* as_list_slice_get(const as_list_slice* slice, uint32_t index);
+
+
+/******************************************************************************
+ *	ITERATION FUNCTIONS
+ *****************************************************************************/
+
+/**
+ *	Call the callback function for each element in the slice.
+ *
+ *	@return true if iteration completes fully. false if iteration was aborted.
+ *
+ *	@relatesalso as_list_slice
+ */
+AS_EXTERN bool as_list_slice_foreach(const as_list_slice* slice, as_list_foreach_callback callback, void* udata);
+
+/**
+ *	Initializes a stack allocated iterator for the given slice.
+ *
+ *	@relatesalso as_list_slice_iterator
+ */
+AS_EXTERN as_list_slice_iterator* as_list_slice_iterator_init(as_list_slice_iterator* it, const as_list_slice* slice);
+
+/**
+ *	Creates a heap allocated iterator for the given slice.
+ *
+ *	@relatesalso as_list_slice_iterator
+ */
+AS_EXTERN as_list_slice_iterator* as_list_slice_iterator_new(const as_list_slice* slice);
+
+/**
+ *	Tests if there are more values available in the iterator.
+ *
+ *	@relatesalso as_list_slice_iterator
+ */
+AS_EXTERN bool as_list_slice_iterator_has_next(const as_list_slice_iterator* it);
+
+/**
+ *	Get the next value from the iterator.
+ *
+ *	@return The next value in the slice if available. Otherwise NULL.
+ *
+ *	@relatesalso as_list_slice_iterator
+ */
+AS_EXTERN const as_val* as_list_slice_iterator_next(as_list_slice_iterator* it);
+
+#ifdef __cplusplus
+} // end extern "C"
+#endif
@@ -206,6 +206,37 @@ typedef struct as_map_hooks_s {
 	 */
 	union as_map_iterator_u* (*iterator_init)(const as_map* map, union as_map_iterator_u* it);
 
+	/***************************************************************************
+	 * memory hooks
+	 **************************************************************************/
+
+	/**
+	 * Add the heap memory of the map - the header if heap allocated, its
+	 * storage, and its keys and values via as_val_memory_add(). Optional - if
+	 * NULL, as_val_memory_usage() estimates from the entries.
+	 *
+	 * @param map 		The map.
+	 * @param mem 		Accumulates the totals.
+	 * @param shared	true if the map is referenced from elsewhere.
+	 */
+	void (*memory)(const as_map* map, as_val_memory* mem, bool shared);
+
+	/***************************************************************************
+	 * copy hooks
+	 **************************************************************************/
+
+	/**
+	 * Create a heap allocated copy of the map, of the same type. Optional - if
+	 * NULL, as_val_clone() copies into an as_orderedmap with the same flags.
+	 *
+	 * @param map 	The map to copy.
+	 * @param deep	true to copy the keys and values with as_val_clone(), false
+	 *				to share them.
+	 *
+	 * @return On success, the copy. Otherwise NULL.
+	 */
+	as_map* (*clone)(const as_map* map, bool deep);
+
 } as_map_hooks;
 
 /******************************************************************************
@@ -404,6 +435,25 @@ static inline union as_map_iterator_u* as_map_iterator_init(union as_map_iterato
 	return as_util_hook(iterator_init, NULL, map, it);
 }
 
+/******************************************************************************
+ * COPY FUNCTIONS
+ *****************************************************************************/
+
+/**
+ * Prepare the value stored under key for modification. If the value is
+ * referenced from elsewhere (count > 1), for example after
+ * as_val_clone_cow(), it is replaced in the map by a copy-on-write copy of
+ * itself. Otherwise it is left in place.
+ *
+ * @param map 	The map.
+ * @param key 	The key of the value. Not consumed.
+ *
+ * @return The value, now owned by this map only. NULL if the key is not found
+ * or the copy could not be made.
+ * @relatesalso as_map
+ */
+AS_EXTERN as_val* as_map_unshare(as_map* map, const as_val* key);
+
 /******************************************************************************
  * CONVERSION FUNCTIONS
  *****************************************************************************/
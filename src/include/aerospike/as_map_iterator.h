@@ -17,7 +17,9 @@
 
 #pragma once
 
+#include <aerospike/as_iterator.h>
 #include <aerospike/as_orderedmap.h>
+#include <aerospike/as_persistent_map.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -32,8 +34,25 @@ extern "C" {
  */
 typedef union as_map_iterator_u {
 	as_orderedmap_iterator orderedmap;
+	as_persistent_map_iterator persistent_map;
 } as_map_iterator;
 
+/******************************************************************************
+ *	FUNCTIONS
+ *****************************************************************************/
+
+/**
+ *	Get up to n entries from a map iterator, advancing past them, without
+ *	building an as_pair per entry where the iterator supports it.
+ *
+ *	@param iterator		The map iterator.
+ *	@param keys			Receives the keys, owned by the map.
+ *	@param values		Receives the values, owned by the map.
+ *	@param n			The maximum number of entries to get.
+ *	@return the number of entries read. 0 when the iterator is exhausted.
+ */
+AS_EXTERN uint32_t as_map_iterator_next_n(as_iterator* iterator, const as_val** keys, const as_val** values, uint32_t n);
+
 #ifdef __cplusplus
 } // end extern "C"
 #endif
@@ -16,57 +16,90 @@
  */
 #pragma once
 
+#include <aerospike/as_eventcount.h>
 #include <aerospike/as_std.h>
 #include <pthread.h>
+#include <sched.h>
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+/**
+ * A one-shot completion signal. The waiter spins briefly, then parks on an
+ * eventcount, so a notify that comes soon after the wait is cheap.
+ */
 typedef struct {
-	pthread_mutex_t lock;
-	pthread_cond_t cond;
-	bool complete;
+	as_eventcount ec;
+	uint32_t complete;
 } as_monitor;
 
 static inline void
 as_monitor_init(as_monitor* monitor)
 {
-	pthread_mutex_init(&monitor->lock, NULL);
-	pthread_cond_init(&monitor->cond, NULL);
-	monitor->complete = false;
+	as_eventcount_init(&monitor->ec, AS_EVENTCOUNT_SPIN);
+	monitor->complete = 0;
 }
 
 static inline void
 as_monitor_destroy(as_monitor* monitor)
 {
-	pthread_mutex_destroy(&monitor->lock);
-	pthread_cond_destroy(&monitor->cond);
+	as_eventcount_destroy(&monitor->ec);
 }
 
 static inline void
 as_monitor_begin(as_monitor* monitor)
 {
-	monitor->complete = false;
+	as_store_uint32(&monitor->complete, 0);
 }
 
 static inline void
 as_monitor_notify(as_monitor* monitor)
 {
-	pthread_mutex_lock(&monitor->lock);
-	monitor->complete = true;
-	pthread_cond_signal(&monitor->cond);
-	pthread_mutex_unlock(&monitor->lock);
+	as_store_uint32_rls(&monitor->complete, 1);
+	as_eventcount_notify(&monitor->ec, UINT32_MAX);
+
+	// Done with the monitor - the waiter may now destroy it.
+	as_store_uint32_rls(&monitor->complete, 2);
+}
+
+static inline bool
+as_monitor_ready(void* udata)
+{
+	return as_load_uint32_acq(&((as_monitor*)udata)->complete) != 0;
 }
 
 static inline void
 as_monitor_wait(as_monitor* monitor)
 {
-	pthread_mutex_lock(&monitor->lock);
-	while (! monitor->complete) {
-		pthread_cond_wait(&monitor->cond, &monitor->lock);
+	as_eventcount_await(&monitor->ec, as_monitor_ready, monitor,
+		AS_EVENTCOUNT_FOREVER);
+
+	// Wait out the end of as_monitor_notify(), which is only a few
+	// instructions away.
+	while (as_load_uint32_acq(&monitor->complete) != 2) {
+		sched_yield();
+	}
+}
+
+/**
+ * Wait for the notify, for at most wait_ms milliseconds. The wait runs to a
+ * monotonic deadline, so wall clock adjustments neither stretch nor shorten
+ * it. Returns false on timeout - the monitor must then not be destroyed while
+ * a notify may still come.
+ */
+static inline bool
+as_monitor_wait_ms(as_monitor* monitor, int wait_ms)
+{
+	if (! as_eventcount_await(&monitor->ec, as_monitor_ready, monitor,
+			as_eventcount_deadline(wait_ms))) {
+		return false;
+	}
+
+	while (as_load_uint32_acq(&monitor->complete) != 2) {
+		sched_yield();
 	}
-	pthread_mutex_unlock(&monitor->lock);
+	return true;
 }
 
 #ifdef __cplusplus
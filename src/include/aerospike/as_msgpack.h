@@ -94,6 +94,30 @@ int as_pack_val(as_packer *pk, const as_val *val);
  * @return 0 on success
  */
 int as_unpack_val(as_unpacker *pk, as_val **val);
+/**
+ * Unpack a value tree confined to the calling thread - reference counts in the
+ * tree are updated without atomic instructions. Call as_val_share() on the
+ * result before passing it to another thread.
+ *
+ * @return 0 on success
+ */
+AS_EXTERN int as_unpack_val_local(as_unpacker *pk, as_val **val);
+/**
+ * Unpack a value, storing lists whose elements are all integers or all doubles
+ * as as_typedlist instead of as_arraylist.
+ *
+ * @return 0 on success
+ */
+AS_EXTERN int as_unpack_val_typed(as_unpacker *pk, as_val **val);
+/**
+ * Unpack a value, taking integers from AS_INTEGER_CACHE_MIN to
+ * AS_INTEGER_CACHE_MAX from the integer cache rather than allocating each. The
+ * cached integers are shared and read-only - see as_integer_new_cached() - so
+ * use this only where the tree's integers are never written.
+ *
+ * @return 0 on success
+ */
+AS_EXTERN int as_unpack_val_cached(as_unpacker *pk, as_val **val);
 
 AS_EXTERN msgpack_compare_t as_val_cmp(const as_val* v1, const as_val* v2);
 
@@ -113,6 +113,12 @@ typedef struct as_orderedmap_s {
 	uint32_t hold_count;
 	map_entry* hold_table;
 	uint32_t* hold_locations;
+
+	// Value-ordered index into table, kept between rank queries only when the
+	// map is flagged AS_PACKED_MAP_FLAG_KV_ORDERED. NULL if not built. Rank
+	// queries install it with a CAS, so they may run concurrently on a map
+	// with nothing left to merge, like other reads.
+	uint32_t* value_order;
 } as_orderedmap;
 
 /**
@@ -223,6 +229,15 @@ AS_EXTERN as_orderedmap* as_orderedmap_new(uint32_t capacity);
  */
 AS_EXTERN void as_orderedmap_destroy(as_orderedmap* map);
 
+/**
+ *	Get the orderedmap behind an `as_map`.
+ *
+ *	@return The orderedmap if `map` is an as_orderedmap. Otherwise NULL.
+ *
+ *	@relatesalso as_orderedmap
+ */
+AS_EXTERN const as_orderedmap* as_orderedmap_frommap(const as_map* map);
+
 /**
  *	Get the number of entries in the map.
  *
@@ -282,6 +297,73 @@ AS_EXTERN int as_orderedmap_clear(as_orderedmap* map);
  */
 AS_EXTERN int as_orderedmap_remove(as_orderedmap* map, const as_val* key);
 
+/**
+ *	Get the entry at the specified index, in key order.
+ *
+ *	@param map 		The map.
+ *	@param index	The index of the entry, 0 being the smallest key.
+ *	@param key_r	If not NULL, set to the key of the entry.
+ *
+ *	@return The value of the entry. Otherwise NULL if index is out of range.
+ *
+ *	@relatesalso as_orderedmap
+ */
+AS_EXTERN as_val* as_orderedmap_get_by_index(const as_orderedmap* map, uint32_t index, as_val** key_r);
+
+/**
+ *	Find the index range of entries whose keys are in [lo, hi).
+ *
+ *	The entries can then be read with `as_orderedmap_get_by_index()` or
+ *	`as_orderedmap_iterator_init_from()`.
+ *
+ *	@param map 		The map.
+ *	@param lo		Smallest key of the range (inclusive), or NULL for the start
+ *					of the map.
+ *	@param hi		Largest key of the range (exclusive), or NULL for the end of
+ *					the map.
+ *	@param index_r	Set to the index of the first entry in range.
+ *	@param count_r	Set to the number of entries in range.
+ *
+ *	@return 0 on success. Otherwise an error occurred.
+ *
+ *	@relatesalso as_orderedmap
+ */
+AS_EXTERN int as_orderedmap_range_by_key(const as_orderedmap* map, const as_val* lo, const as_val* hi, uint32_t* index_r, uint32_t* count_r);
+
+/**
+ *	Get the entry at the specified rank, in value order. Entries with equal
+ *	values are ranked in key order.
+ *
+ *	If the map is flagged `AS_PACKED_MAP_FLAG_KV_ORDERED`, the value order is
+ *	kept until the map is next modified. Otherwise it is rebuilt per call.
+ *
+ *	@param map 		The map.
+ *	@param rank		The rank of the entry, 0 being the smallest value.
+ *	@param key_r	If not NULL, set to the key of the entry.
+ *
+ *	@return The value of the entry. Otherwise NULL if rank is out of range.
+ *
+ *	@relatesalso as_orderedmap
+ */
+AS_EXTERN as_val* as_orderedmap_get_by_rank(const as_orderedmap* map, uint32_t rank, as_val** key_r);
+
+/**
+ *	Find the rank range of entries whose values are in [lo, hi).
+ *
+ *	@param map 		The map.
+ *	@param lo		Smallest value of the range (inclusive), or NULL for the
+ *					smallest value in the map.
+ *	@param hi		Largest value of the range (exclusive), or NULL for the
+ *					largest value in the map.
+ *	@param rank_r	Set to the rank of the first entry in range.
+ *	@param count_r	Set to the number of entries in range.
+ *
+ *	@return 0 on success. Otherwise an error occurred.
+ *
+ *	@relatesalso as_orderedmap
+ */
+AS_EXTERN int as_orderedmap_range_by_value(const as_orderedmap* map, const as_val* lo, const as_val* hi, uint32_t* rank_r, uint32_t* count_r);
+
 /**
  *	Set map attributes.
  *
@@ -328,6 +410,20 @@ AS_EXTERN bool as_orderedmap_foreach(const as_orderedmap* map, as_map_foreach_ca
  */
 AS_EXTERN as_orderedmap_iterator* as_orderedmap_iterator_init(as_orderedmap_iterator* it, const as_orderedmap* map);
 
+/**
+ *	Initializes a stack allocated as_iterator for the given as_orderedmap,
+ *	positioned at the first entry whose key is greater than or equal to key.
+ *
+ *	@param it		The iterator to initialize.
+ *	@param map		The map to iterate.
+ *	@param key		The key to start from.
+ *
+ *	@return On success, the initialized iterator. Otherwise NULL.
+ *
+ *	@relatesalso as_orderedmap_iterator
+ */
+AS_EXTERN as_orderedmap_iterator* as_orderedmap_iterator_init_from(as_orderedmap_iterator* it, const as_orderedmap* map, const as_val* key);
+
 /**
  *	Creates a heap allocated as_iterator for the given as_orderedmap.
  *
@@ -371,6 +467,21 @@ AS_EXTERN bool as_orderedmap_iterator_has_next(const as_orderedmap_iterator* it)
  */
 AS_EXTERN const as_val* as_orderedmap_iterator_next(as_orderedmap_iterator* it);
 
+/**
+ *	Get up to n keys and values from the iterator, and iterate past them.
+ *	Unlike as_orderedmap_iterator_next(), no as_pair is built.
+ *
+ *	@param it		The iterator to get the entries from.
+ *	@param keys		Receives the keys, owned by the map.
+ *	@param values	Receives the values, owned by the map.
+ *	@param n		The maximum number of entries to get.
+ *
+ *	@return The number of entries read. 0 when the iterator is exhausted.
+ *
+ *	@relatesalso as_orderedmap_iterator
+ */
+AS_EXTERN uint32_t as_orderedmap_iterator_next_n(as_orderedmap_iterator* it, const as_val** keys, const as_val** values, uint32_t n);
+
 #ifdef __cplusplus
 } // end extern "C"
 #endif
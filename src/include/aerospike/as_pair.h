@@ -65,7 +65,8 @@ typedef struct as_pair_s {
  ******************************************************************************/
 
 /**
- *	Create and initializes a new heap allocated `as_pair`.
+ *	Create and initializes a new heap allocated `as_pair`. It is slab
+ *	allocated - release it with as_pair_destroy(), not cf_free().
  *
  *	@param _1	The first value.
  *	@param _2	The second value.
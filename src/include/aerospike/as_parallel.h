@@ -0,0 +1,160 @@
+/*
+ * Copyright 2026 Aerospike, Inc.
+ *
+ * Portions may be licensed to Aerospike, Inc. under one or more contributor
+ * license agreements.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#pragma once
+
+#include <aerospike/as_arraylist.h>
+#include <aerospike/as_list.h>
+#include <aerospike/as_map.h>
+#include <aerospike/as_std.h>
+#include <aerospike/as_thread_pool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/******************************************************************************
+ * TYPES
+ *****************************************************************************/
+
+/**
+ * Callback for as_list_parallel_map(). Transforms one element.
+ *
+ * @return The new value, owned by the result list. NULL to stop the whole map.
+ */
+typedef as_val* (*as_list_map_callback)(as_val* value, void* udata);
+
+/**
+ * Callback for as_list_parallel_reduce(). Folds one element into the
+ * accumulator of the calling thread's chunk.
+ *
+ * @return true to continue. false to stop the whole reduction.
+ */
+typedef bool (*as_list_reduce_callback)(as_val* value, void* acc, void* udata);
+
+/**
+ * Callback for as_map_parallel_reduce(). Folds one entry into the
+ * accumulator of the calling thread's chunk.
+ *
+ * @return true to continue. false to stop the whole reduction.
+ */
+typedef bool (*as_map_reduce_callback)(const as_val* key, const as_val* value, void* acc, void* udata);
+
+/**
+ * Merges the accumulator of a later chunk into that of an earlier one. Called
+ * on the calling thread, in chunk order, after all chunks are done.
+ */
+typedef void (*as_reduce_merge_callback)(void* acc, const void* other, void* udata);
+
+/******************************************************************************
+ * FUNCTIONS
+ *****************************************************************************/
+
+/**
+ * Call the callback for each element of the list, from several threads.
+ *
+ * An as_arraylist is split into contiguous chunks - one per pool thread plus
+ * the calling thread, which takes part and then runs queued tasks of the pool
+ * until all chunks are done. So the caller may itself be one of the pool's
+ * threads.
+ * Small lists, other list types, and a NULL pool are iterated on the calling
+ * thread only.
+ *
+ * The callback must be safe to call concurrently, and the list must not be
+ * modified meanwhile. Returning false stops all chunks soon, but elements
+ * already being visited by other threads are not interrupted.
+ *
+ * @param list		The list.
+ * @param pool		The thread pool.
+ * @param callback	Called for each element.
+ * @param udata		Passed to the callback.
+ *
+ * @return true if iteration completed fully. false if it was stopped.
+ */
+AS_EXTERN bool as_list_parallel_foreach(const as_list* list, as_thread_pool* pool, as_list_foreach_callback callback, void* udata);
+
+/**
+ * Call the callback for each entry of the map, from several threads. Splits
+ * an as_orderedmap into chunks of entries, like as_list_parallel_foreach().
+ *
+ * @return true if iteration completed fully. false if it was stopped.
+ */
+AS_EXTERN bool as_map_parallel_foreach(const as_map* map, as_thread_pool* pool, as_map_foreach_callback callback, void* udata);
+
+/**
+ * Create a new list holding the callback's result for each element of the
+ * list, in order, from several threads. Chunks are split as by
+ * as_list_parallel_foreach(), and each thread stores its results in place.
+ *
+ * @param list		The list.
+ * @param pool		The thread pool.
+ * @param callback	Transforms an element.
+ * @param udata		Passed to the callback.
+ *
+ * @return The new list, to be destroyed by the caller. NULL if the callback
+ * returned NULL or the list couldn't be allocated.
+ */
+AS_EXTERN as_arraylist* as_list_parallel_map(const as_list* list, as_thread_pool* pool, as_list_map_callback callback, void* udata);
+
+/**
+ * Reduce the list to a value, from several threads.
+ *
+ * Chunks are split as by as_list_parallel_foreach(). Each chunk folds its
+ * elements into its own accumulator - acc_size bytes, starting as a copy of
+ * acc, which must hold the identity value (e.g. 0 for a sum). The first chunk
+ * uses acc itself. The other accumulators are then merged into acc, in chunk
+ * order, so the merge need only be associative.
+ *
+ * ~~~~~~~~~~{.c}
+ * static bool add(as_val* v, void* acc, void* udata) {
+ *     *(int64_t*)acc += as_integer_get((as_integer*)v);
+ *     return true;
+ * }
+ *
+ * static void merge(void* acc, const void* other, void* udata) {
+ *     *(int64_t*)acc += *(const int64_t*)other;
+ * }
+ *
+ * int64_t sum = 0;
+ * as_list_parallel_reduce(list, pool, add, merge, &sum, sizeof(sum), NULL);
+ * ~~~~~~~~~~
+ *
+ * @param list		The list.
+ * @param pool		The thread pool.
+ * @param callback	Folds an element into an accumulator.
+ * @param merge		Merges two accumulators.
+ * @param acc		The accumulator - initially the identity, finally the result.
+ * @param acc_size	The size of the accumulator.
+ * @param udata		Passed to the callbacks.
+ *
+ * @return true if the reduction completed fully. false if it was stopped or
+ * an accumulator couldn't be allocated.
+ */
+AS_EXTERN bool as_list_parallel_reduce(const as_list* list, as_thread_pool* pool, as_list_reduce_callback callback, as_reduce_merge_callback merge, void* acc, size_t acc_size, void* udata);
+
+/**
+ * Reduce the map to a value, from several threads. See
+ * as_list_parallel_reduce().
+ *
+ * @return true if the reduction completed fully. false if it was stopped or
+ * an accumulator couldn't be allocated.
+ */
+AS_EXTERN bool as_map_parallel_reduce(const as_map* map, as_thread_pool* pool, as_map_reduce_callback callback, as_reduce_merge_callback merge, void* acc, size_t acc_size, void* udata);
+
+#ifdef __cplusplus
+} // end extern "C"
+#endif
@@ -0,0 +1,298 @@
+/*
+ * Copyright 2026 Aerospike, Inc.
+ *
+ * Portions may be licensed to Aerospike, Inc. under one or more contributor
+ * license agreements.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#pragma once
+
+#include <aerospike/as_iterator.h>
+#include <aerospike/as_list.h>
+#include <aerospike/as_std.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+/******************************************************************************
+ *	TYPES
+ ******************************************************************************/
+
+#define AS_PERSISTENT_LIST_BITS 5
+#define AS_PERSISTENT_LIST_WIDTH (1 << AS_PERSISTENT_LIST_BITS)
+
+/**
+ *	@private
+ *	Trie node, shared between list versions. Leaf nodes hold as_val pointers,
+ *	inner nodes hold child nodes.
+ */
+typedef struct as_persistent_list_node_s {
+	uint32_t count;
+	void* slots[AS_PERSISTENT_LIST_WIDTH];
+} as_persistent_list_node;
+
+/**
+ *	A persistent (structurally shared) implementation of `as_list`.
+ *
+ *	Elements are stored in a 32-way trie. `as_persistent_list_copy()` returns
+ *	a new list in O(1) that shares the whole trie with the original. Modifying
+ *	either list afterwards copies only the trie nodes on the path to the
+ *	modified element - all other nodes remain shared.
+ *
+ *	~~~~~~~~~~{.c}
+ *	as_persistent_list* l1 = as_persistent_list_new();
+ *	as_persistent_list_append_int64(l1, 1);
+ *	as_persistent_list_append_int64(l1, 2);
+ *
+ *	as_persistent_list* l2 = as_persistent_list_copy(l1);
+ *	as_persistent_list_set_int64(l2, 0, 100); // l1 is unchanged
+ *
+ *	as_persistent_list_destroy(l1);
+ *	as_persistent_list_destroy(l2);
+ *	~~~~~~~~~~
+ *
+ *	The `as_persistent_list` is a subtype of `as_list`, so it can be used
+ *	with `as_list` functions, `as_pack_val()` and `as_val_cmp()`.
+ *
+ *	Notes:
+ *
+ *	get, set, append and removal of the last element are O(log32 n). insert,
+ *	prepend and other removals rebuild the trie and are O(n).
+ *
+ *	Trie nodes are reference counted atomically, so copies may be handed to
+ *	other threads. A single list instance is NOT threadsafe.
+ *
+ *	The elements themselves are shared between copies with `as_val_reserve()`,
+ *	so mutable elements (e.g. nested lists) are visible through all copies.
+ *
+ *	As with `as_arraylist`, the list takes ownership of values it is given.
+ *
+ *	@extends as_list
+ *	@ingroup aerospike_t
+ */
+typedef struct as_persistent_list_s {
+	as_list _;
+
+	uint32_t size;
+	uint32_t shift;
+	as_persistent_list_node* root;
+} as_persistent_list;
+
+/**
+ *	Iterator for as_persistent_list.
+ *
+ *	@extends as_iterator
+ */
+typedef struct as_persistent_list_iterator_s {
+	as_iterator _;
+
+	const as_persistent_list* list;
+	uint32_t pos;
+	as_val* const* leaf;
+} as_persistent_list_iterator;
+
+
+/*******************************************************************************
+ *	INSTANCE FUNCTIONS
+ ******************************************************************************/
+
+/**
+ *	Initialize a stack allocated persistent list.
+ *
+ *	@param list 	The list to initialize.
+ *
+ *	@return On success, the initialized list. Otherwise NULL.
+ *
+ *	@relatesalso as_persistent_list
+ */
+AS_EXTERN as_persistent_list* as_persistent_list_init(as_persistent_list* list);
+
+/**
+ *	Create a new heap allocated persistent list.
+ *
+ *	@return On success, the new list. Otherwise NULL.
+ *
+ *	@relatesalso as_persistent_list
+ */
+AS_EXTERN as_persistent_list* as_persistent_list_new(void);
+
+/**
+ *	Create a new heap allocated list sharing all storage with the given list.
+ *	This is O(1).
+ *
+ *	@param list 	The list to copy.
+ *
+ *	@return On success, the new list. Otherwise NULL.
+ *
+ *	@relatesalso as_persistent_list
+ */
+AS_EXTERN as_persistent_list* as_persistent_list_copy(const as_persistent_list* list);
+
+/**
+ *	Destroy the list and release resources.
+ *
+ *	@param list 	The list to destroy.
+ *
+ *	@relatesalso as_persistent_list
+ */
+AS_EXTERN void as_persistent_list_destroy(as_persistent_list* list);
+
+/**
+ *	Get the number of elements in the list.
+ *
+ *	@relatesalso as_persistent_list
+ */
+static inline uint32_t
+as_persistent_list_size(const as_persistent_list* list)
+{
+	return list->size;
+}
+
+/**
+ *	Get the value at the specified index.
+ *
+ *	@param list 	The list.
+ *	@param index	The index of the element.
+ *
+ *	@return The value at the index. Otherwise NULL.
+ *
+ *	@relatesalso as_persistent_list
+ */
+AS_EXTERN as_val* as_persistent_list_get(const as_persistent_list* list, uint32_t index);
+
+/**
+ *	Set the value at the specified index. Setting past the end of the list
+ *	pads the list with as_nil.
+ *
+ *	@param list 	The list.
+ *	@param index	The index of the element.
+ *	@param value	The value, ownership is transferred to the list.
+ *
+ *	@return 0 on success. Otherwise an error occurred.
+ *
+ *	@relatesalso as_persistent_list
+ */
+AS_EXTERN int as_persistent_list_set(as_persistent_list* list, uint32_t index, as_val* value);
+
+/**
+ *	Insert the value at the specified index, shifting following elements.
+ *
+ *	@param list 	The list.
+ *	@param index	The index of the element.
+ *	@param value	The value, ownership is transferred to the list.
+ *
+ *	@return 0 on success. Otherwise an error occurred.
+ *
+ *	@relatesalso as_persistent_list
+ */
+AS_EXTERN int as_persistent_list_insert(as_persistent_list* list, uint32_t index, as_val* value);
+
+/**
+ *	Append the value to the end of the list.
+ *
+ *	@param list 	The list.
+ *	@param value	The value, ownership is transferred to the list.
+ *
+ *	@return 0 on success. Otherwise an error occurred.
+ *
+ *	@relatesalso as_persistent_list
+ */
+AS_EXTERN int as_persistent_list_append(as_persistent_list* list, as_val* value);
+
+/**
+ *	Append an int64_t value to the end of the list.
+ *
+ *	@relatesalso as_persistent_list
+ */
+AS_EXTERN int as_persistent_list_append_int64(as_persistent_list* list, int64_t value);
+
+/**
+ *	Set an int64_t value at the specified index.
+ *
+ *	@relatesalso as_persistent_list
+ */
+AS_EXTERN int as_persistent_list_set_int64(as_persistent_list* list, uint32_t index, int64_t value);
+
+/**
+ *	Remove the element at the specified index, shifting following elements.
+ *
+ *	@param list 	The list.
+ *	@param index	The index of the element.
+ *
+ *	@return 0 on success. Otherwise an error occurred.
+ *
+ *	@relatesalso as_persistent_list
+ */
+AS_EXTERN int as_persistent_list_remove(as_persistent_list* list, uint32_t index);
+
+/**
+ *	Remove all elements at and beyond the specified index.
+ *
+ *	@param list 	The list.
+ *	@param index	The index to trim from.
+ *
+ *	@return 0 on success. Otherwise an error occurred.
+ *
+ *	@relatesalso as_persistent_list
+ */
+AS_EXTERN int as_persistent_list_trim(as_persistent_list* list, uint32_t index);
+
+
+/******************************************************************************
+ *	ITERATION FUNCTIONS
+ *****************************************************************************/
+
+/**
+ *	Call the callback function for each element in the list.
+ *
+ *	@return true if iteration completes fully. false if iteration was aborted.
+ *
+ *	@relatesalso as_persistent_list
+ */
+AS_EXTERN bool as_persistent_list_foreach(const as_persistent_list* list, as_list_foreach_callback callback, void* udata);
+
+/**
+ *	Initializes a stack allocated iterator for the given list.
+ *
+ *	@relatesalso as_persistent_list_iterator
+ */
+AS_EXTERN as_persistent_list_iterator* as_persistent_list_iterator_init(as_persistent_list_iterator* it, const as_persistent_list* list);
+
+/**
+ *	Creates a heap allocated iterator for the given list.
+ *
+ *	@relatesalso as_persistent_list_iterator
+ */
+AS_EXTERN as_persistent_list_iterator* as_persistent_list_iterator_new(const as_persistent_list* list);
+
+/**
+ *	Tests if there are more values available in the iterator.
+ *
+ *	@relatesalso as_persistent_list_iterator
+ */
+AS_EXTERN bool as_persistent_list_iterator_has_next(const as_persistent_list_iterator* it);
+
+/**
+ *	Get the next value from the iterator.
+ *
+ *	@return The next value in the list if available. Otherwise NULL.
+ *
+ *	@relatesalso as_persistent_list_iterator
+ */
+AS_EXTERN const as_val* as_persistent_list_iterator_next(as_persistent_list_iterator* it);
+
+#ifdef __cplusplus
+} // end extern "C"
+#endif
@@ -0,0 +1,281 @@
+/*
+ * Copyright 2026 Aerospike, Inc.
+ *
+ * Portions may be licensed to Aerospike, Inc. under one or more contributor
+ * license agreements.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#pragma once
+
+#include <aerospike/as_iterator.h>
+#include <aerospike/as_map.h>
+#include <aerospike/as_pair.h>
+#include <aerospike/as_std.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+/******************************************************************************
+ *	TYPES
+ ******************************************************************************/
+
+/**
+ *	@private
+ *	Treap node, shared between map versions.
+ */
+typedef struct as_persistent_map_node_s {
+	uint32_t count;
+	uint32_t priority;
+	uint32_t size; // number of nodes in this subtree
+	as_val* key;
+	as_val* value;
+	struct as_persistent_map_node_s* left;
+	struct as_persistent_map_node_s* right;
+} as_persistent_map_node;
+
+/**
+ *	A persistent (structurally shared) implementation of `as_map`.
+ *
+ *	Entries are kept in a treap ordered by `as_val_cmp()` on the keys, so
+ *	iteration is in key order like `as_orderedmap`.
+ *	`as_persistent_map_copy()` returns a new map in O(1) that shares the whole
+ *	tree with the original. Modifying either map afterwards copies only the
+ *	nodes on the path to the modified entry.
+ *
+ *	~~~~~~~~~~{.c}
+ *	as_persistent_map* m1 = as_persistent_map_new();
+ *	as_stringmap_set_int64((as_map*)m1, "a", 1);
+ *
+ *	as_persistent_map* m2 = as_persistent_map_copy(m1);
+ *	as_stringmap_set_int64((as_map*)m2, "b", 2); // m1 is unchanged
+ *
+ *	as_persistent_map_destroy(m1);
+ *	as_persistent_map_destroy(m2);
+ *	~~~~~~~~~~
+ *
+ *	The `as_persistent_map` is a subtype of `as_map`, so it can be used with
+ *	`as_map` functions, `as_pack_val()` and `as_val_cmp()`.
+ *
+ *	Notes:
+ *
+ *	get, set and remove are O(log n) expected.
+ *
+ *	Tree nodes are reference counted atomically, so copies may be handed to
+ *	other threads. A single map instance is NOT threadsafe.
+ *
+ *	As with `as_orderedmap`, the map takes ownership of keys and values it is
+ *	given, and keys and values are shared between copies with
+ *	`as_val_reserve()`.
+ *
+ *	@extends as_map
+ *	@ingroup aerospike_t
+ */
+typedef struct as_persistent_map_s {
+	as_map _;
+
+	as_persistent_map_node* root;
+} as_persistent_map;
+
+/**
+ *	Iterator for as_persistent_map. Entries are returned in key order as
+ *	`as_pair` values, valid until the next call.
+ *
+ *	@extends as_iterator
+ */
+typedef struct as_persistent_map_iterator_s {
+	as_iterator _;
+
+	const as_persistent_map* map;
+	uint32_t ix;
+	as_pair pair;
+} as_persistent_map_iterator;
+
+
+/*******************************************************************************
+ *	INSTANCE FUNCTIONS
+ ******************************************************************************/
+
+/**
+ *	Initialize a stack allocated persistent map.
+ *
+ *	@param map 	The map to initialize.
+ *
+ *	@return On success, the initialized map. Otherwise NULL.
+ *
+ *	@relatesalso as_persistent_map
+ */
+AS_EXTERN as_persistent_map* as_persistent_map_init(as_persistent_map* map);
+
+/**
+ *	Create a new heap allocated persistent map.
+ *
+ *	@return On success, the new map. Otherwise NULL.
+ *
+ *	@relatesalso as_persistent_map
+ */
+AS_EXTERN as_persistent_map* as_persistent_map_new(void);
+
+/**
+ *	Create a new heap allocated map sharing all storage with the given map.
+ *	This is O(1).
+ *
+ *	@param map 	The map to copy.
+ *
+ *	@return On success, the new map. Otherwise NULL.
+ *
+ *	@relatesalso as_persistent_map
+ */
+AS_EXTERN as_persistent_map* as_persistent_map_copy(const as_persistent_map* map);
+
+/**
+ *	Destroy the map and release resources.
+ *
+ *	@param map 	The map to destroy.
+ *
+ *	@relatesalso as_persistent_map
+ */
+AS_EXTERN void as_persistent_map_destroy(as_persistent_map* map);
+
+/**
+ *	Get the number of entries in the map.
+ *
+ *	@relatesalso as_persistent_map
+ */
+static inline uint32_t
+as_persistent_map_size(const as_persistent_map* map)
+{
+	return map->root == NULL ? 0 : map->root->size;
+}
+
+/**
+ *	Get the value for the specified key.
+ *
+ *	@param map 	The map.
+ *	@param key	The key.
+ *
+ *	@return The value for the specified key. Otherwise NULL.
+ *
+ *	@relatesalso as_persistent_map
+ */
+AS_EXTERN as_val* as_persistent_map_get(const as_persistent_map* map, const as_val* key);
+
+/**
+ *	Set the value for the specified key, replacing any existing entry.
+ *
+ *	@param map 	The map.
+ *	@param key	The key, ownership is transferred to the map.
+ *	@param val	The value, ownership is transferred to the map.
+ *
+ *	@return 0 on success. Otherwise an error occurred.
+ *
+ *	@relatesalso as_persistent_map
+ */
+AS_EXTERN int as_persistent_map_set(as_persistent_map* map, const as_val* key, const as_val* val);
+
+/**
+ *	Remove the entry for the specified key.
+ *
+ *	@param map 	The map.
+ *	@param key	The key.
+ *
+ *	@return 0 on success. Otherwise an error occurred.
+ *
+ *	@relatesalso as_persistent_map
+ */
+AS_EXTERN int as_persistent_map_remove(as_persistent_map* map, const as_val* key);
+
+/**
+ *	Remove all entries from the map.
+ *
+ *	@relatesalso as_persistent_map
+ */
+AS_EXTERN int as_persistent_map_clear(as_persistent_map* map);
+
+/**
+ *	Get the entry at the specified position in key order. O(log n).
+ *
+ *	@param map 		The map.
+ *	@param index	The position of the entry.
+ *	@param key_r	Set to the entry's key if not NULL.
+ *
+ *	@return The entry's value. NULL if index is out of range.
+ *
+ *	@relatesalso as_persistent_map
+ */
+AS_EXTERN as_val* as_persistent_map_get_by_index(const as_persistent_map* map, uint32_t index, as_val** key_r);
+
+/**
+ *	Set map attributes.
+ *
+ *	@relatesalso as_persistent_map
+ */
+static inline void
+as_persistent_map_set_flags(as_persistent_map* map, uint32_t flags)
+{
+	map->_.flags = flags & AS_MAP_FLAGS_MASK;
+
+	// Ensure k-ordered is set when other bits require k-ordered to be set.
+	if (map->_.flags != 0) {
+		map->_.flags |= 1;
+	}
+}
+
+
+/******************************************************************************
+ *	ITERATION FUNCTIONS
+ *****************************************************************************/
+
+/**
+ *	Call the callback function for each entry in the map, in key order.
+ *
+ *	@return true if iteration completes fully. false if iteration was aborted.
+ *
+ *	@relatesalso as_persistent_map
+ */
+AS_EXTERN bool as_persistent_map_foreach(const as_persistent_map* map, as_map_foreach_callback callback, void* udata);
+
+/**
+ *	Initializes a stack allocated iterator for the given map.
+ *
+ *	@relatesalso as_persistent_map_iterator
+ */
+AS_EXTERN as_persistent_map_iterator* as_persistent_map_iterator_init(as_persistent_map_iterator* it, const as_persistent_map* map);
+
+/**
+ *	Creates a heap allocated iterator for the given map.
+ *
+ *	@relatesalso as_persistent_map_iterator
+ */
+AS_EXTERN as_persistent_map_iterator* as_persistent_map_iterator_new(const as_persistent_map* map);
+
+/**
+ *	Tests if there are more entries available in the iterator.
+ *
+ *	@relatesalso as_persistent_map_iterator
+ */
+AS_EXTERN bool as_persistent_map_iterator_has_next(const as_persistent_map_iterator* it);
+
+/**
+ *	Get the next entry from the iterator.
+ *
+ *	@return The next entry as an `as_pair` if available. Otherwise NULL.
+ *
+ *	@relatesalso as_persistent_map_iterator
+ */
+AS_EXTERN const as_val* as_persistent_map_iterator_next(as_persistent_map_iterator* it);
+
+#ifdef __cplusplus
+} // end extern "C"
+#endif
@@ -149,6 +149,25 @@ as_queue_push_head(as_queue* queue, const void* ptr);
 AS_EXTERN bool
 as_queue_push_head_limit(as_queue* queue, const void* ptr);
 
+/**
+ * Push n items, laid out contiguously at ptr, to the tail of the queue. Items
+ * are copied with at most two memcpy() calls per capacity increase.
+ *
+ * Returns the number of items pushed, which is less than n only if the queue
+ * couldn't grow.
+ */
+AS_EXTERN uint32_t
+as_queue_push_n(as_queue* queue, const void* ptr, uint32_t n);
+
+/**
+ * Pop up to n items from the head of the queue into ptr, which must have room
+ * for n items.
+ *
+ * Returns the number of items popped.
+ */
+AS_EXTERN uint32_t
+as_queue_pop_n(as_queue* queue, void* ptr, uint32_t n);
+
 /**
  * Get item at virtual index.  For internal use only.
  */
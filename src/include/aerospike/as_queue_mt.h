@@ -16,7 +16,9 @@
  */
 #pragma once
 
+#include <aerospike/as_eventcount.h>
 #include <aerospike/as_queue.h>
+#include <aerospike/as_stats.h>
 #include <aerospike/as_std.h>
 #include <pthread.h>
 
@@ -44,9 +46,14 @@ typedef struct as_queue_mt_s {
 	pthread_mutex_t lock;
 
 	/**
-	 * The notify/wait condition variable.
+	 * Blocked pops spin, then park on this.
 	 */
-	pthread_cond_t cond;
+	as_eventcount ec;
+
+	/**
+	 * If not NULL, counters are kept.
+	 */
+	as_queue_stats* stats;
 } as_queue_mt;
 
 /******************************************************************************
@@ -64,7 +71,8 @@ typedef struct as_queue_mt_s {
 #define as_queue_mt_inita(__q, __item_size, __capacity)\
 as_queue_inita(&(__q)->queue, __item_size, __capacity);\
 pthread_mutex_init(&(__q)->lock, NULL);\
-pthread_cond_init(&(__q)->cond, NULL);
+as_eventcount_init(&(__q)->ec, AS_EVENTCOUNT_SPIN);\
+(__q)->stats = NULL;
 
 /******************************************************************************
  * FUNCTIONS
@@ -85,12 +93,65 @@ as_queue_mt_create(uint32_t item_size, uint32_t capacity);
 /**
  * Release queue memory.
  */
+AS_EXTERN void
+as_queue_mt_destroy(as_queue_mt* queue);
+
+/**
+ * Start keeping counters - lock acquisitions and contended lock wait times,
+ * the depth high-water mark, and pop wakeups and parks. Call before the queue
+ * is shared with other threads.
+ *
+ * Returns false if out of memory.
+ */
+AS_EXTERN bool
+as_queue_mt_enable_stats(as_queue_mt* queue);
+
+/**
+ * Get a snapshot of the queue's counters.
+ *
+ * Returns false if counters aren't being kept.
+ */
+AS_EXTERN bool
+as_queue_mt_get_stats(as_queue_mt* queue, as_queue_stats* stats);
+
+/**
+ * @private
+ * Take the queue's lock.
+ */
+static inline void
+as_queue_mt_lock(as_queue_mt* queue)
+{
+	if (queue->stats) {
+		as_queue_stats_lock(queue->stats, &queue->lock);
+	}
+	else {
+		pthread_mutex_lock(&queue->lock);
+	}
+}
+
+/**
+ * @private
+ * Release the queue's lock.
+ */
+static inline void
+as_queue_mt_unlock(as_queue_mt* queue)
+{
+	if (queue->stats) {
+		as_queue_stats_depth(queue->stats, as_queue_size(&queue->queue));
+	}
+
+	pthread_mutex_unlock(&queue->lock);
+}
+
+/**
+ * Set how long a pop on an empty queue spins, checking for an element, before
+ * it parks - see as_eventcount. The default is AS_EVENTCOUNT_SPIN iterations,
+ * and 0 parks at once.
+ */
 static inline void
-as_queue_mt_destroy(as_queue_mt* queue)
+as_queue_mt_set_spin(as_queue_mt* queue, uint32_t spin)
 {
-	pthread_cond_destroy(&queue->cond);
-	pthread_mutex_destroy(&queue->lock);
-	as_queue_destroy(&queue->queue);
+	as_eventcount_set_spin(&queue->ec, spin);
 }
 
 /**
@@ -99,9 +160,9 @@ as_queue_mt_destroy(as_queue_mt* queue)
 static inline uint32_t
 as_queue_mt_size(as_queue_mt* queue)
 {
-	pthread_mutex_lock(&queue->lock);
+	as_queue_mt_lock(queue);
 	uint32_t size = as_queue_size(&queue->queue);
-	pthread_mutex_unlock(&queue->lock);
+	as_queue_mt_unlock(queue);
 	return size;
 }
 	
@@ -111,9 +172,9 @@ as_queue_mt_size(as_queue_mt* queue)
 static inline bool
 as_queue_mt_empty(as_queue_mt* queue)
 {
-	pthread_mutex_lock(&queue->lock);
+	as_queue_mt_lock(queue);
 	bool empty = as_queue_empty(&queue->queue);
-	pthread_mutex_unlock(&queue->lock);
+	as_queue_mt_unlock(queue);
 	return empty;
 }
 
@@ -123,13 +184,13 @@ as_queue_mt_empty(as_queue_mt* queue)
 static inline bool
 as_queue_mt_push(as_queue_mt* queue, const void* ptr)
 {
-	pthread_mutex_lock(&queue->lock);
+	as_queue_mt_lock(queue);
 	bool status = as_queue_push(&queue->queue, ptr);
+	as_queue_mt_unlock(queue);
 
 	if (status) {
-		pthread_cond_signal(&queue->cond);
+		as_eventcount_notify(&queue->ec, 1);
 	}
-	pthread_mutex_unlock(&queue->lock);
 	return status;
 }
 
@@ -139,13 +200,13 @@ as_queue_mt_push(as_queue_mt* queue, const void* ptr)
 static inline bool
 as_queue_mt_push_limit(as_queue_mt* queue, const void* ptr)
 {
-	pthread_mutex_lock(&queue->lock);
+	as_queue_mt_lock(queue);
 	bool status = as_queue_push_limit(&queue->queue, ptr);
+	as_queue_mt_unlock(queue);
 
 	if (status) {
-		pthread_cond_signal(&queue->cond);
+		as_eventcount_notify(&queue->ec, 1);
 	}
-	pthread_mutex_unlock(&queue->lock);
 	return status;
 }
 
@@ -155,13 +216,13 @@ as_queue_mt_push_limit(as_queue_mt* queue, const void* ptr)
 static inline bool
 as_queue_mt_push_head(as_queue_mt* queue, const void* ptr)
 {
-	pthread_mutex_lock(&queue->lock);
+	as_queue_mt_lock(queue);
 	bool status = as_queue_push_head(&queue->queue, ptr);
+	as_queue_mt_unlock(queue);
 
 	if (status) {
-		pthread_cond_signal(&queue->cond);
+		as_eventcount_notify(&queue->ec, 1);
 	}
-	pthread_mutex_unlock(&queue->lock);
 	return status;
 }
 
@@ -171,16 +232,36 @@ as_queue_mt_push_head(as_queue_mt* queue, const void* ptr)
 static inline bool
 as_queue_mt_push_head_limit(as_queue_mt* queue, const void* ptr)
 {
-	pthread_mutex_lock(&queue->lock);
+	as_queue_mt_lock(queue);
 	bool status = as_queue_push_head_limit(&queue->queue, ptr);
+	as_queue_mt_unlock(queue);
 
 	if (status) {
-		pthread_cond_signal(&queue->cond);
+		as_eventcount_notify(&queue->ec, 1);
 	}
-	pthread_mutex_unlock(&queue->lock);
 	return status;
 }
 
+/**
+ * Push n elements, laid out contiguously at ptr, to the tail of the queue,
+ * under one hold of the lock. Wakes up to one waiting pop per element pushed.
+ *
+ * Returns the number of elements pushed, which is less than n only if the
+ * queue couldn't grow.
+ */
+static inline uint32_t
+as_queue_mt_push_n(as_queue_mt* queue, const void* ptr, uint32_t n)
+{
+	as_queue_mt_lock(queue);
+	uint32_t pushed = as_queue_push_n(&queue->queue, ptr, n);
+	as_queue_mt_unlock(queue);
+
+	if (pushed != 0) {
+		as_eventcount_notify(&queue->ec, pushed);
+	}
+	return pushed;
+}
+
 /**
  * Pop from the head of the queue.
  *
@@ -205,6 +286,19 @@ as_queue_mt_pop(as_queue_mt* queue, void* ptr, int wait_ms);
 AS_EXTERN bool
 as_queue_mt_pop_tail(as_queue_mt* queue, void* ptr, int wait_ms);
 
+/**
+ * Pop up to n elements from the head of the queue into ptr, which must have
+ * room for n elements, under one hold of the lock.
+ *
+ * If the queue is empty, wait_ms is the maximum time in milliseconds to wait
+ * for the first element, as for as_queue_mt_pop(). The pop doesn't wait for
+ * more than one.
+ *
+ * The return value is the number of elements retrieved, 0 if none.
+ */
+AS_EXTERN uint32_t
+as_queue_mt_pop_n(as_queue_mt* queue, void* ptr, uint32_t n, int wait_ms);
+
 #ifdef __cplusplus
 } // end extern "C"
 #endif
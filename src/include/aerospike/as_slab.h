@@ -0,0 +1,134 @@
+/*
+ * Copyright 2026 Aerospike, Inc.
+ *
+ * Portions may be licensed to Aerospike, Inc. under one or more contributor
+ * license agreements.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#pragma once
+
+#include <aerospike/as_std.h>
+#include <aerospike/as_val.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/******************************************************************************
+ * TYPES
+ *****************************************************************************/
+
+/**
+ * Largest size served from the per-thread size classes. Larger requests fall
+ * back to cf_malloc().
+ */
+#define AS_SLAB_MAX_SIZE 64
+
+/**
+ * Slab allocator statistics, summed over all thread caches.
+ */
+typedef struct as_slab_stats_s {
+	/**
+	 * Blocks handed out by as_slab_alloc().
+	 */
+	uint64_t allocs;
+
+	/**
+	 * Blocks returned by the thread that owns them.
+	 */
+	uint64_t frees;
+
+	/**
+	 * Blocks returned by a thread other than the owner.
+	 */
+	uint64_t remote_frees;
+
+	/**
+	 * Bytes obtained from cf_malloc() for slabs, less those returned by
+	 * as_slab_trim().
+	 */
+	uint64_t slab_bytes;
+
+	/**
+	 * Thread caches created. Caches of exited threads are reused.
+	 */
+	uint32_t caches;
+
+	/**
+	 * Thread caches left by exited threads, not yet reused.
+	 */
+	uint32_t orphans;
+} as_slab_stats;
+
+/******************************************************************************
+ * FUNCTIONS
+ *****************************************************************************/
+
+/**
+ * Allocate a small fixed-size block from the calling thread's slab cache.
+ *
+ * Used for the headers of as_integer, as_double, as_pair, as_string and
+ * as_bytes. Blocks are carved from larger slabs, so there is no per-block
+ * allocator lock. A block may be freed by any thread - blocks freed by
+ * another thread are queued back to the owning cache without locking.
+ *
+ * Every block, including one too large for the slabs, is preceded by a
+ * pointer to its owner, so the address returned is not the start of a
+ * cf_malloc() block. Release it with as_slab_free() - values built on it,
+ * with as_val_destroy() - and never with cf_free(). Code that used to
+ * cf_free() the result of as_integer_new() and the like must change.
+ *
+ * Slab memory stays with the caches until as_slab_trim() - the cache of an
+ * exited thread is reused by the next new thread.
+ *
+ * In ENHANCED_ALLOC builds this is cf_malloc().
+ */
+AS_EXTERN void* as_slab_alloc(size_t size);
+
+/**
+ * Free a block allocated by as_slab_alloc().
+ */
+AS_EXTERN void as_slab_free(void* p);
+
+/**
+ * Return to the system every slab of the calling thread's cache, and of the
+ * caches left by exited threads, whose blocks are all free. Worth calling
+ * after a thread releases a large number of values, or periodically from a
+ * housekeeping thread - which frees the orphaned caches' slabs.
+ *
+ * Returns the number of bytes released.
+ */
+AS_EXTERN uint64_t as_slab_trim(void);
+
+/**
+ * Get allocator statistics.
+ */
+AS_EXTERN void as_slab_get_stats(as_slab_stats* stats);
+
+/**
+ * @private
+ * Mark a value constructed in as_slab_alloc() memory, so as_val_destroy()
+ * releases it with as_slab_free().
+ */
+static inline as_val*
+as_slab_val(as_val* v)
+{
+	if (v) {
+		v->slab = true;
+	}
+	return v;
+}
+
+#ifdef __cplusplus
+} // end extern "C"
+#endif
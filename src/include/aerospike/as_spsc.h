@@ -0,0 +1,200 @@
+/*
+ * Copyright 2026 Aerospike, Inc.
+ *
+ * Portions may be licensed to Aerospike, Inc. under one or more contributor
+ * license agreements.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+#pragma once
+
+#include <aerospike/as_atomic.h>
+#include <aerospike/as_eventcount.h>
+#include <aerospike/as_std.h>
+#include <string.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/******************************************************************************
+ * TYPES
+ *****************************************************************************/
+
+/**
+ * A bounded ring for exactly one producer thread and one consumer thread.
+ *
+ * There is no lock and no read-modify-write - the producer publishes items
+ * with a release store of its tail, and the consumer frees slots with a
+ * release store of its head. Each side keeps its own index, and a cached copy
+ * of the other's, on its own cache line, so it only reads the other side's
+ * line when the ring looks full or empty.
+ *
+ * The capacity is rounded up to a power of 2 and never grows.
+ *
+ * Waits are optional. A blocking ring parks waiters on eventcounts, at the
+ * cost of a full fence per push or pop (or batch) to check for them. A
+ * non-blocking ring has no such cost, and its waits spin and yield instead.
+ */
+typedef struct as_spsc_s {
+	/**
+	 * Producer's line - the next slot to push, and the last head it read.
+	 */
+	uint32_t tail;
+	uint32_t head_cache;
+	uint8_t pad0[56];
+
+	/**
+	 * Consumer's line - the next slot to pop, and the last tail it read.
+	 */
+	uint32_t head;
+	uint32_t tail_cache;
+	uint8_t pad1[56];
+
+	/**
+	 * Capacity - 1.
+	 */
+	uint32_t mask;
+
+	uint32_t item_size;
+	uint8_t* items;
+
+	/**
+	 * Whether waiters park, and so must be notified.
+	 */
+	bool blocking;
+
+	/**
+	 * Blocked pops park on this.
+	 */
+	as_eventcount not_empty;
+
+	/**
+	 * Blocked pushes park on this.
+	 */
+	as_eventcount not_full;
+} as_spsc;
+
+/******************************************************************************
+ * FUNCTIONS
+ *****************************************************************************/
+
+/**
+ * Initialize a ring of at least capacity items of item_size bytes, up to
+ * 2^31. If blocking, waiting pushes and pops park rather than spin.
+ *
+ * Returns false if out of memory.
+ */
+AS_EXTERN bool
+as_spsc_init(as_spsc* q, uint32_t item_size, uint32_t capacity, bool blocking);
+
+/**
+ * Release ring memory.
+ */
+AS_EXTERN void
+as_spsc_destroy(as_spsc* q);
+
+/**
+ * Get the number of items in the ring. Exact only when called by the
+ * producer or consumer while the other is idle.
+ */
+static inline uint32_t
+as_spsc_size(as_spsc* q)
+{
+	return as_load_uint32(&q->tail) - as_load_uint32(&q->head);
+}
+
+/**
+ * Push up to n items, laid out contiguously at ptr, to the ring. Producer
+ * only.
+ *
+ * If the ring fills, wait_ms is the most milliseconds to wait for room for
+ * the rest - negative waits forever, and 0 not at all.
+ *
+ * Returns the number of items pushed.
+ */
+AS_EXTERN uint32_t
+as_spsc_push_n(as_spsc* q, const void* ptr, uint32_t n, int wait_ms);
+
+/**
+ * Pop up to n items into ptr, which must have room for n items. Consumer
+ * only.
+ *
+ * If the ring is empty, wait_ms is the most milliseconds to wait for the
+ * first item - negative waits forever, and 0 not at all. The pop doesn't wait
+ * for more than one.
+ *
+ * Returns the number of items popped, 0 if none.
+ */
+AS_EXTERN uint32_t
+as_spsc_pop_n(as_spsc* q, void* ptr, uint32_t n, int wait_ms);
+
+/**
+ * Push one item, waiting as as_spsc_push_n() does if the ring is full.
+ * Producer only.
+ *
+ * Returns false if the ring stayed full.
+ */
+static inline bool
+as_spsc_push(as_spsc* q, const void* ptr, int wait_ms)
+{
+	uint32_t tail = q->tail;
+
+	if (tail - q->head_cache > q->mask) {
+		// Looks full - see how far the consumer got.
+		q->head_cache = as_load_uint32_acq(&q->head);
+
+		if (tail - q->head_cache > q->mask) {
+			return wait_ms != 0 && as_spsc_push_n(q, ptr, 1, wait_ms) == 1;
+		}
+	}
+
+	memcpy(&q->items[(tail & q->mask) * q->item_size], ptr, q->item_size);
+	as_store_uint32_rls(&q->tail, tail + 1);
+
+	if (q->blocking) {
+		as_eventcount_notify(&q->not_empty, 1);
+	}
+	return true;
+}
+
+/**
+ * Pop one item, waiting as as_spsc_pop_n() does if the ring is empty.
+ * Consumer only.
+ *
+ * Returns false if the ring stayed empty.
+ */
+static inline bool
+as_spsc_pop(as_spsc* q, void* ptr, int wait_ms)
+{
+	uint32_t head = q->head;
+
+	if (head == q->tail_cache) {
+		// Looks empty - see how far the producer got.
+		q->tail_cache = as_load_uint32_acq(&q->tail);
+
+		if (head == q->tail_cache) {
+			return wait_ms != 0 && as_spsc_pop_n(q, ptr, 1, wait_ms) == 1;
+		}
+	}
+
+	memcpy(ptr, &q->items[(head & q->mask) * q->item_size], q->item_size);
+	as_store_uint32_rls(&q->head, head + 1);
+
+	if (q->blocking) {
+		as_eventcount_notify(&q->not_full, 1);
+	}
+	return true;
+}
+
+#ifdef __cplusplus
+} // end extern "C"
+#endif
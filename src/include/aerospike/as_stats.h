@@ -0,0 +1,234 @@
+/*
+ * Copyright 2026 Aerospike, Inc.
+ *
+ * Portions may be licensed to Aerospike, Inc. under one or more contributor
+ * license agreements.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+#pragma once
+
+#include <aerospike/as_arch.h>
+#include <aerospike/as_std.h>
+#include <citrusleaf/cf_clock.h>
+#include <pthread.h>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/******************************************************************************
+ * TYPES
+ *****************************************************************************/
+
+/**
+ * Number of histogram buckets. The last bucket also holds everything longer.
+ */
+#define AS_HISTOGRAM_BUCKETS 48
+
+/**
+ * A histogram of durations in nanoseconds, in power of 2 buckets. Bucket 0
+ * counts zero durations, and bucket i counts durations from 2^(i-1) up to
+ * 2^i - 1.
+ *
+ * Adding is not atomic - each histogram has one writer at a time. Readers
+ * may see a snapshot that is a few samples behind.
+ */
+typedef struct as_histogram_s {
+	/**
+	 * Number of samples.
+	 */
+	uint64_t count;
+
+	/**
+	 * Sum of all samples.
+	 */
+	uint64_t sum;
+
+	/**
+	 * Longest sample.
+	 */
+	uint64_t max;
+
+	uint64_t buckets[AS_HISTOGRAM_BUCKETS];
+} as_histogram;
+
+/**
+ * Counters for a queue. Counters only grow - diff two snapshots to get rates.
+ */
+typedef struct as_queue_stats_s {
+	/**
+	 * Number of times the queue's lock was taken.
+	 */
+	uint64_t lock_count;
+
+	/**
+	 * Number of times the lock was already held, so the caller waited.
+	 */
+	uint64_t lock_contended;
+
+	/**
+	 * Number of times a notify woke parked pops.
+	 */
+	uint64_t wakeups;
+
+	/**
+	 * Number of times a pop parked.
+	 */
+	uint64_t parks;
+
+	/**
+	 * Most elements the queue has held.
+	 */
+	uint32_t depth_max;
+
+	/**
+	 * How long contended lock acquisitions waited.
+	 */
+	as_histogram lock_wait;
+} as_queue_stats;
+
+/**
+ * @private
+ * Tick to nanosecond multiplier, in 32.32 fixed point.
+ */
+AS_EXTERN extern uint64_t g_as_stats_tick_mult;
+
+/******************************************************************************
+ * FUNCTIONS
+ *****************************************************************************/
+
+/**
+ * Calibrate the tick clock. Done once per process - the functions that enable
+ * stats call this, and so must anyone else using as_stats_ns().
+ */
+AS_EXTERN void
+as_stats_clock_init(void);
+
+/**
+ * A cheap timestamp for measuring durations - the CPU's cycle or timer
+ * counter where there is one, otherwise cf_getns(). Convert differences with
+ * as_stats_ns().
+ */
+static inline uint64_t
+as_stats_ticks(void)
+{
+#if defined(as_arch_ticks)
+	return as_arch_ticks();
+#else
+	return cf_getns();
+#endif
+}
+
+/**
+ * Convert a difference of as_stats_ticks() values to nanoseconds.
+ */
+static inline uint64_t
+as_stats_ns(uint64_t ticks)
+{
+#if defined(as_arch_ticks)
+	return (uint64_t)(((unsigned __int128)ticks * g_as_stats_tick_mult) >> 32);
+#else
+	return ticks;
+#endif
+}
+
+/**
+ * Add a duration in nanoseconds.
+ */
+static inline void
+as_histogram_add(as_histogram* h, uint64_t ns)
+{
+	uint32_t i = 0;
+
+	if (ns != 0) {
+#if defined(_MSC_VER)
+		unsigned long bit;
+
+		_BitScanReverse64(&bit, ns);
+		i = (uint32_t)bit + 1;
+#else
+		i = 64 - (uint32_t)__builtin_clzll(ns);
+#endif
+
+		if (i >= AS_HISTOGRAM_BUCKETS) {
+			i = AS_HISTOGRAM_BUCKETS - 1;
+		}
+	}
+
+	h->count++;
+	h->sum += ns;
+	h->buckets[i]++;
+
+	if (ns > h->max) {
+		h->max = ns;
+	}
+}
+
+/**
+ * Add the samples of src to dst. Src may be in use by its writer.
+ */
+AS_EXTERN void
+as_histogram_merge(as_histogram* dst, const as_histogram* src);
+
+/**
+ * Estimate a percentile (0 to 100), in nanoseconds. Returns the top of the
+ * bucket the percentile falls in, but never more than the longest sample.
+ */
+AS_EXTERN uint64_t
+as_histogram_percentile(const as_histogram* h, double pct);
+
+/**
+ * Add the counters of src to dst, keeping the larger depth_max.
+ */
+AS_EXTERN void
+as_queue_stats_merge(as_queue_stats* dst, const as_queue_stats* src);
+
+/**
+ * @private
+ * Take a queue's lock, counting it. Only acquisitions that find the lock held
+ * are timed, so an uncontended lock costs no clock reads.
+ */
+static inline void
+as_queue_stats_lock(as_queue_stats* stats, pthread_mutex_t* lock)
+{
+	if (pthread_mutex_trylock(lock) == 0) {
+		stats->lock_count++;
+		return;
+	}
+
+	uint64_t start = as_stats_ticks();
+
+	pthread_mutex_lock(lock);
+	stats->lock_count++;
+	stats->lock_contended++;
+	as_histogram_add(&stats->lock_wait, as_stats_ns(as_stats_ticks() - start));
+}
+
+/**
+ * @private
+ * Record the queue's depth. Call with the queue's lock held.
+ */
+static inline void
+as_queue_stats_depth(as_queue_stats* stats, uint32_t depth)
+{
+	if (depth > stats->depth_max) {
+		stats->depth_max = depth;
+	}
+}
+
+#ifdef __cplusplus
+} // end extern "C"
+#endif
@@ -114,13 +114,21 @@ typedef struct as_string_s {
 	 */
 	bool free;
 
+	/**
+	 *	@private
+	 *	Cached hash of the value, 0 if not yet computed. Fits in what was
+	 *	padding, so the `as_string` is no bigger.
+	 */
+	uint32_t hash;
+
 	/**
 	 *	The string value.
 	 */
 	char * value;
 
 	/**
-	 *	The length of the string.
+	 *	The length of the string, or SIZE_MAX until as_string_len() is first
+	 *	called on a string initialized without a length.
 	 */
 	size_t len;
 
@@ -166,6 +174,9 @@ AS_EXTERN as_string * as_string_init_wlen(as_string * string, char * value, size
  *
  *	If free is true, then the string value will be freed when the as_string is destroyed.
  *
+ *	Like all the as_string_new functions, the `as_string` is slab allocated -
+ *	release it with as_string_destroy(), never cf_free().
+ *
  *	@param value 	The NULL terminated string of character.
  *	@param free		If true, then the value will be freed when as_string is destroyed.
  *
@@ -201,6 +212,25 @@ AS_EXTERN as_string * as_string_new_wlen(char * value, size_t len, bool free);
  */
 AS_EXTERN as_string * as_string_new_strdup(const char * value);
 
+/**
+ *	Create and initialize a new heap allocated `as_string` from the first len
+ *	bytes of value, which need not be NULL terminated.
+ *
+ *	The bytes are copied and NULL terminated, right after the `as_string` in
+ *	the same allocation - so `as_string.value` is not separately allocated,
+ *	and `as_string.free` is false. Don't free or keep `as_string.value` past
+ *	the string's destruction, and don't struct-copy such a string - the copy
+ *	would point into the original's block.
+ *
+ *	@param value 	The characters.
+ *	@param len		The number of characters.
+ *
+ *	@return On success, the new string. Otherwise NULL.
+ *
+ *	@relatesalso as_string
+ */
+AS_EXTERN as_string * as_string_new_strndup(const char * value, size_t len);
+
 /**
  *	Destroy the as_string and associated resources.
  *
@@ -16,6 +16,8 @@
  */
 #pragma once
 
+#include <aerospike/as_eventcount.h>
+#include <aerospike/as_stats.h>
 #include <aerospike/as_std.h>
 #include <citrusleaf/cf_queue.h>
 #include <pthread.h>
@@ -34,30 +36,314 @@ extern "C" {
  */
 typedef void (*as_task_fn)(void* user_data);
 	
+/**
+ *	@private
+ *	Thread initialization function callback, called on each worker thread
+ *	before it runs any task. Index is the worker's slot, below thread_max.
+ */
+typedef void (*as_init_fn)(uint32_t index);
+
 /**
  *	@private
  *	Thread finalization function callback.
  */
 typedef void (*as_fini_fn)(void);
+
+/**
+ *	@private
+ *	Most priority lanes a pool can have.
+ */
+#define AS_THREAD_POOL_MAX_LANES 8
+
+/**
+ *	@private
+ *	Options for a queued task.
+ */
+typedef struct as_task_opts_s {
+	/**
+	 *	Priority lane - 0 is the highest, and where as_thread_pool_queue_task()
+	 *	puts tasks. Lanes beyond the pool's are taken as its lowest.
+	 */
+	uint32_t lane;
+
+	/**
+	 *	Put the task at the front of its lane, rather than the back.
+	 */
+	bool front;
+
+	/**
+	 *	Time by which the task must start, on the cf_getns() clock - e.g.
+	 *	as_eventcount_deadline(ms). 0 for none.
+	 */
+	uint64_t deadline;
+
+	/**
+	 *	Called with the task data instead of the task function, if the
+	 *	deadline passes before the task starts. If NULL, the task is dropped.
+	 */
+	as_task_fn cancel_fn;
+} as_task_opts;
+
+/**
+ *	@private
+ *	Thread pool configuration, for as_thread_pool_init_config().
+ */
+typedef struct as_thread_pool_config_s {
+	/**
+	 *	Number of threads to start.
+	 */
+	uint32_t thread_size;
+
+	/**
+	 *	Most threads the pool can grow to with as_thread_pool_resize(). If
+	 *	less than thread_size, thread_size is used.
+	 */
+	uint32_t thread_max;
+
+	/**
+	 *	Fewest threads idle reaping leaves running. At least 1.
+	 */
+	uint32_t thread_min;
+
+	/**
+	 *	Stop a worker that has found no task for this many milliseconds, while
+	 *	more than thread_min run. The pool starts workers again, up to its
+	 *	size, as tasks are queued with no idle worker to take them. 0 keeps
+	 *	workers forever.
+	 */
+	uint32_t idle_ms;
+
+	/**
+	 *	Called on each worker thread as it starts. May be NULL.
+	 */
+	as_init_fn init_fn;
+
+	/**
+	 *	Called on each worker thread as it exits. May be NULL.
+	 */
+	as_fini_fn fini_fn;
+
+	/**
+	 *	CPUs to run the workers on, copied by the pool. NULL for no affinity.
+	 *	Only applied on Linux.
+	 */
+	const uint32_t* cpus;
+
+	/**
+	 *	Number of cpus.
+	 */
+	uint32_t n_cpus;
+
+	/**
+	 *	If true, pin each worker to one of cpus, round-robin by worker slot.
+	 *	Otherwise, let every worker run on any of cpus.
+	 */
+	bool cpu_per_worker;
+
+	/**
+	 *	Number of priority lanes, up to AS_THREAD_POOL_MAX_LANES. 0 means 1.
+	 */
+	uint32_t n_lanes;
+
+	/**
+	 *	Share of tasks each lane gets while several have tasks waiting - only
+	 *	the ratios matter. A lane of weight 0 runs only when the others are
+	 *	empty. NULL for strict priority, where a lane runs only when the
+	 *	higher ones are empty.
+	 */
+	const uint32_t* lane_weights;
+
+	/**
+	 *	Keep counters and timings - see as_thread_pool_get_stats(). Costs two
+	 *	reads of the CPU's tick counter per task.
+	 */
+	bool stats;
+} as_thread_pool_config;
+
+/**
+ *	@private
+ *	Snapshot of a pool's counters. Counters only grow - diff two snapshots
+ *	to get rates.
+ *
+ *	Only tasks run by workers are counted - not those run by other threads
+ *	helping in as_task_group_wait(), or run by the caller because they
+ *	couldn't be queued.
+ */
+typedef struct as_thread_pool_stats_s {
+	/**
+	 *	Number of tasks taken, including expired ones.
+	 */
+	uint64_t tasks;
+
+	/**
+	 *	Number of tasks cancelled or dropped at their deadline.
+	 */
+	uint64_t expired;
+
+	/**
+	 *	Number of tasks taken from another worker's deque.
+	 */
+	uint64_t steals;
+
+	/**
+	 *	Number of times a notify woke parked workers.
+	 */
+	uint64_t wakeups;
+
+	/**
+	 *	Number of times a worker parked.
+	 */
+	uint64_t parks;
+
+	/**
+	 *	Running workers.
+	 */
+	uint32_t threads;
+
+	/**
+	 *	Time from queueing a task to a worker starting it.
+	 */
+	as_histogram wait;
+
+	/**
+	 *	Time tasks took to run.
+	 */
+	as_histogram run;
+
+	/**
+	 *	Lock and depth counters of the lane queues, summed - depth_max is
+	 *	the deepest any lane has been.
+	 */
+	as_queue_stats lanes;
+} as_thread_pool_stats;
 	
+/**
+ *	@private
+ *	Per-worker state - see as_thread_pool.c.
+ */
+struct as_thread_pool_worker_s;
+
+/**
+ *	@private
+ *	Per-worker counters - see as_thread_pool.c.
+ */
+struct as_thread_pool_worker_stats_s;
+
 /**
  *	@private
  *	Thread pool.
+ *
+ *	Each worker has its own work-stealing deque. Tasks queued by a worker go to
+ *	the back of its deque, where the worker takes them again, newest first.
+ *	Tasks queued by other threads go to dispatch_queue, a shared injection
+ *	queue. An idle worker looks in its own deque, then the injection queue,
+ *	then steals the oldest task from another worker's deque, starting from a
+ *	random victim. Workers with nothing to do park on an eventcount.
+ *
+ *	The injection queue is the highest of the priority lanes. Lower lanes
+ *	are queues a worker looks in after stealing - or, with lane weights, a
+ *	worker looks in a lane first on its share of turns.
  */
 typedef struct as_thread_pool_s {
 	pthread_t* threads;
 	cf_queue* dispatch_queue;
+	as_init_fn init_fn;
 	as_fini_fn fini_fn;
+
+	// Running workers, not counting those told to stop.
 	uint32_t thread_size;
+
+	// Worker slots - thread_max.
+	uint32_t worker_size;
+
+	struct as_thread_pool_worker_s* workers;
+	as_eventcount ec;
+	uint8_t shutdown;
+
+	// Guards starting and stopping workers.
+	pthread_mutex_t lock;
+
+	// The size set by init or resize, which thread_size returns to after
+	// idle reaping.
+	uint32_t target_size;
+
+	uint32_t thread_min;
+	uint32_t idle_ms;
+	uint32_t* cpus;
+	uint32_t n_cpus;
+	bool cpu_per_worker;
+
+	// Queues of the priority lanes, highest first - lanes[0] is dispatch_queue.
+	cf_queue* lanes[AS_THREAD_POOL_MAX_LANES];
+	uint32_t n_lanes;
+
+	// The weighted order workers take lanes in, or NULL for strict priority.
+	uint8_t* lane_schedule;
+	uint32_t lane_schedule_size;
+
+	// Lanes of weight 0, as bits. With a schedule, they are searched only
+	// after the weighted lanes.
+	uint32_t lanes_unweighted;
+
+	// Counters of each worker slot, or NULL if not kept.
+	struct as_thread_pool_worker_stats_s* stats;
 } as_thread_pool;
 
+/**
+ *	A set of tasks queued on a pool, to be waited for together.
+ *
+ *	Tasks are added by the thread that waits, or by tasks of the group
+ *	themselves - so a fan-out can keep adding to its own group. Once the wait
+ *	returns true the group is empty, and may be reused or destroyed.
+ *
+ *	~~~~~~~~~~{.c}
+ *	as_task_group group;
+ *	as_task_group_init(&group, pool);
+ *
+ *	for (uint32_t i = 0; i < n; i++) {
+ *		as_task_group_add(&group, do_part, &parts[i]);
+ *	}
+ *
+ *	as_task_group_wait(&group, -1);
+ *	as_task_group_destroy(&group);
+ *	~~~~~~~~~~
+ */
+typedef struct as_task_group_s {
+	as_thread_pool* pool;
+
+	// Twice the number of unfinished tasks - odd while the last one is
+	// waking the waiter.
+	uint32_t pending;
+
+	// Waiters parked on the pool's eventcount - see as_task_group_wait().
+	uint32_t pool_waiters;
+
+	as_eventcount ec;
+} as_task_group;
+
+/**
+ *	Future function callback. Returns the future's result.
+ */
+typedef void* (*as_future_fn)(void* user_data);
+
+/**
+ *	The result of one task, to be waited for.
+ */
+typedef struct as_future_s {
+	as_task_group group;
+	as_future_fn fn;
+	void* user_data;
+	void* result;
+} as_future;
+
 //---------------------------------
 // Functions
 //---------------------------------
 
 /**
  *	@private
- *	Initialize variable task thread pool and start thread_size threads.
+ *	Initialize variable task thread pool and start thread_size threads, with
+ *	no room to grow and no idle reaping.
  *	Multiple task types can be handled in variable task thread pools.
  *
  *	Returns:
@@ -71,7 +357,32 @@ as_thread_pool_init(as_thread_pool* pool, uint32_t thread_size);
 
 /**
  *	@private
- *	Queue a variable task onto thread pool.
+ *	Initialize thread pool with a configuration, and start its threads.
+ *
+ *	Returns:
+ *	0  : Success
+ *	-3 : Some threads failed to start
+ */
+int
+as_thread_pool_init_config(as_thread_pool* pool, const as_thread_pool_config* config);
+
+/**
+ *	@private
+ *	Grow or shrink the pool to thread_size threads, up to its thread_max.
+ *	Workers told to stop first run the tasks on their own deques.
+ *
+ *	Returns:
+ *	0  : Success
+ *	-1 : Size is 0 or above thread_max, or the pool is destroyed
+ *	-3 : Some threads failed to start
+ */
+int
+as_thread_pool_resize(as_thread_pool* pool, uint32_t thread_size);
+
+/**
+ *	@private
+ *	Queue a variable task onto thread pool. Called from a worker of the pool,
+ *	the task goes on that worker's deque, otherwise on the injection queue.
  *
  *	Returns:
  *	0  : Success
@@ -83,7 +394,44 @@ as_thread_pool_queue_task(as_thread_pool* pool, as_task_fn task_fn, void* task);
 
 /**
  *	@private
- *	Destroy thread pool.
+ *	Queue a variable task onto thread pool with options - a priority lane and
+ *	deadline. Tasks on lane 0 without front set go, like
+ *	as_thread_pool_queue_task(), on the worker's deque if called from a
+ *	worker of the pool.
+ *
+ *	Returns:
+ *	0  : Success
+ *	-1 : No threads are running to process task.
+ *	-2 : Failed to push task onto lane queue
+ */
+int
+as_thread_pool_queue_task_opts(as_thread_pool* pool, as_task_fn task_fn, void* task, const as_task_opts* opts);
+
+/**
+ *	@private
+ *	Queue n tasks onto thread pool, each calling task_fn with one of tasks.
+ *	From outside the pool, each run of up to 64 tasks takes one lock of the
+ *	injection queue.
+ *
+ *	Returns the number of tasks queued - the first ones of tasks. 0 if no
+ *	threads are running.
+ */
+uint32_t
+as_thread_pool_queue_tasks(as_thread_pool* pool, as_task_fn task_fn, void* const* tasks, uint32_t n);
+
+/**
+ *	@private
+ *	Get a snapshot of the pool's counters. May be called while tasks run.
+ *
+ *	Returns false if the pool wasn't configured to keep them.
+ */
+bool
+as_thread_pool_get_stats(as_thread_pool* pool, as_thread_pool_stats* stats);
+
+/**
+ *	@private
+ *	Destroy thread pool. All queued tasks, including those they queue in turn,
+ *	run before the threads exit.
  *
  *	Returns:
  *	0  : Success
@@ -93,6 +441,96 @@ as_thread_pool_queue_task(as_thread_pool* pool, as_task_fn task_fn, void* task);
 int
 as_thread_pool_destroy(as_thread_pool* pool);
 
+/**
+ *	Initialize a task group for the pool. A NULL pool, or one without
+ *	threads, runs added tasks on the calling thread.
+ */
+void
+as_task_group_init(as_task_group* group, as_thread_pool* pool);
+
+/**
+ *	Release task group resources. The group must be empty.
+ */
+void
+as_task_group_destroy(as_task_group* group);
+
+/**
+ *	Queue a task in the group. If it can't be queued, the task runs on the
+ *	calling thread before this returns.
+ */
+void
+as_task_group_add(as_task_group* group, as_task_fn task_fn, void* task);
+
+/**
+ *	Queue n tasks in the group, each calling task_fn with one of tasks, like
+ *	as_thread_pool_queue_tasks(). Tasks that can't be queued run on the
+ *	calling thread before this returns.
+ */
+void
+as_task_group_add_n(as_task_group* group, as_task_fn task_fn, void* const* tasks, uint32_t n);
+
+/**
+ *	Queue a task in the group with options, like
+ *	as_thread_pool_queue_task_opts(). A task dropped or cancelled at its
+ *	deadline counts as done.
+ */
+void
+as_task_group_add_opts(as_task_group* group, as_task_fn task_fn, void* task, const as_task_opts* opts);
+
+/**
+ *	Wait until all tasks of the group are done, for at most wait_ms
+ *	milliseconds, or forever if wait_ms is negative.
+ *
+ *	Meanwhile, the calling thread runs queued tasks of the pool - the group's
+ *	or any other. So a task may wait for a group on its own pool without
+ *	tying up the worker, but a long task run this way can take the wait past
+ *	its deadline.
+ *
+ *	Returns false on timeout - the group must then not be destroyed while its
+ *	tasks may still run.
+ */
+bool
+as_task_group_wait(as_task_group* group, int wait_ms);
+
+/**
+ *	Queue fn on the pool, its result to be collected from the future. If it
+ *	can't be queued, fn runs on the calling thread before this returns.
+ */
+void
+as_future_submit(as_future* future, as_thread_pool* pool, as_future_fn fn, void* user_data);
+
+/**
+ *	Wait for the future's result, for at most wait_ms milliseconds, or
+ *	forever if wait_ms is negative. Runs queued tasks of the pool meanwhile,
+ *	like as_task_group_wait().
+ *
+ *	Returns false on timeout.
+ */
+static inline bool
+as_future_wait(as_future* future, int wait_ms)
+{
+	return as_task_group_wait(&future->group, wait_ms);
+}
+
+/**
+ *	Wait for the future's result and return it.
+ */
+static inline void*
+as_future_get(as_future* future)
+{
+	as_task_group_wait(&future->group, -1);
+	return future->result;
+}
+
+/**
+ *	Release future resources. The future must have completed.
+ */
+static inline void
+as_future_destroy(as_future* future)
+{
+	as_task_group_destroy(&future->group);
+}
+
 #ifdef __cplusplus
 } // end extern "C"
 #endif
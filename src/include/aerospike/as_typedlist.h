@@ -0,0 +1,375 @@
+/*
+ * Copyright 2026 Aerospike, Inc.
+ *
+ * Portions may be licensed to Aerospike, Inc. under one or more contributor
+ * license agreements.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#pragma once
+
+#include <aerospike/as_arraylist.h>
+#include <aerospike/as_iterator.h>
+#include <aerospike/as_list.h>
+#include <aerospike/as_std.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+/******************************************************************************
+ *	TYPES
+ ******************************************************************************/
+
+/**
+ *	Element type of an as_typedlist.
+ */
+typedef enum as_typedlist_type_e {
+	AS_TYPEDLIST_INT64,
+	AS_TYPEDLIST_DOUBLE
+} as_typedlist_type;
+
+/**
+ *	An implementation of `as_list` storing integers or doubles in a contiguous
+ *	`int64_t[]` or `double[]` array, instead of one `as_integer` or `as_double`
+ *	per element.
+ *
+ *	~~~~~~~~~~{.c}
+ *	as_typedlist* list = as_typedlist_new(AS_TYPEDLIST_INT64, 1000);
+ *
+ *	for (int64_t i = 0; i < 1000; i++) {
+ *		as_typedlist_append_int64(list, i);
+ *	}
+ *
+ *	const int64_t* values = as_typedlist_int64_values(list);
+ *	~~~~~~~~~~
+ *
+ *	`as_list_get()` and iterators return boxed values, created on first access
+ *	and owned by the list, like the elements of an `as_arraylist`. A value of
+ *	the list's type passed to set, insert or append is copied into the array
+ *	and released - use the value returned by get afterwards. Boxed int64
+ *	values within the integer cache range are shared, read-only instances -
+ *	see as_integer_new_cached().
+ *
+ *	Adding an element of any other type (including `as_nil` padding) promotes
+ *	the list: all elements move to an `as_arraylist` and all further operations
+ *	are forwarded to it. `as_typedlist_int64_values()` and
+ *	`as_typedlist_double_values()` return NULL from then on.
+ *
+ *	Reads may be concurrent. Modifications must not be concurrent with any
+ *	other access.
+ *
+ *	@extends as_list
+ *	@ingroup aerospike_t
+ */
+typedef struct as_typedlist_s {
+	as_list _;
+
+	as_typedlist_type type;
+	uint32_t size;
+	uint32_t capacity;
+
+	union {
+		int64_t* int64s;
+		double* doubles;
+	} values;
+
+	/**
+	 *	@private
+	 *	Boxed elements handed out by get, in parallel with values. NULL until
+	 *	the first one is needed.
+	 */
+	as_val** boxed;
+
+	/**
+	 *	@private
+	 *	Holds all elements once the list has been promoted. Otherwise NULL.
+	 */
+	as_arraylist* promoted;
+} as_typedlist;
+
+/**
+ *	Iterator for as_typedlist.
+ *
+ *	@extends as_iterator
+ */
+typedef struct as_typedlist_iterator_s {
+	as_iterator _;
+
+	const as_typedlist* list;
+	uint32_t pos;
+} as_typedlist_iterator;
+
+
+/*******************************************************************************
+ *	INSTANCE FUNCTIONS
+ ******************************************************************************/
+
+/**
+ *	Initialize a stack allocated typed list.
+ *
+ *	@param list 	The list to initialize.
+ *	@param type		The element type.
+ *	@param capacity	The number of elements to allocate space for.
+ *
+ *	@return On success, the initialized list. Otherwise NULL.
+ *
+ *	@relatesalso as_typedlist
+ */
+AS_EXTERN as_typedlist* as_typedlist_init(as_typedlist* list, as_typedlist_type type, uint32_t capacity);
+
+/**
+ *	Create a new heap allocated typed list.
+ *
+ *	@param type		The element type.
+ *	@param capacity	The number of elements to allocate space for.
+ *
+ *	@return On success, the new list. Otherwise NULL.
+ *
+ *	@relatesalso as_typedlist
+ */
+AS_EXTERN as_typedlist* as_typedlist_new(as_typedlist_type type, uint32_t capacity);
+
+/**
+ *	Destroy the list and release resources.
+ *
+ *	@relatesalso as_typedlist
+ */
+AS_EXTERN void as_typedlist_destroy(as_typedlist* list);
+
+/**
+ *	Get the typed list behind an `as_list`.
+ *
+ *	@return The typed list if `list` is an as_typedlist that has not been
+ *	promoted. Otherwise NULL.
+ *
+ *	@relatesalso as_typedlist
+ */
+AS_EXTERN const as_typedlist* as_typedlist_fromlist(const as_list* list);
+
+/**
+ *	Get the number of elements in the list.
+ *
+ *	@relatesalso as_typedlist
+ */
+static inline uint32_t
+as_typedlist_size(const as_typedlist* list)
+{
+	return list->promoted ? list->promoted->size : list->size;
+}
+
+/**
+ *	Get the contiguous integer storage of the list.
+ *
+ *	@return The integers, valid until the list is modified. NULL if the list
+ *	does not hold integers or has been promoted.
+ *
+ *	@relatesalso as_typedlist
+ */
+static inline const int64_t*
+as_typedlist_int64_values(const as_typedlist* list)
+{
+	return list->type == AS_TYPEDLIST_INT64 && ! list->promoted ?
+			list->values.int64s : NULL;
+}
+
+/**
+ *	Get the contiguous double storage of the list.
+ *
+ *	@return The doubles, valid until the list is modified. NULL if the list
+ *	does not hold doubles or has been promoted.
+ *
+ *	@relatesalso as_typedlist
+ */
+static inline const double*
+as_typedlist_double_values(const as_typedlist* list)
+{
+	return list->type == AS_TYPEDLIST_DOUBLE && ! list->promoted ?
+			list->values.doubles : NULL;
+}
+
+/**
+ *	Get the value at the specified index, boxed.
+ *
+ *	@return The value, owned by the list. NULL if index is out of range.
+ *
+ *	@relatesalso as_typedlist
+ */
+AS_EXTERN as_val* as_typedlist_get(const as_typedlist* list, uint32_t index);
+
+/**
+ *	Get the int64_t value at the specified index.
+ *
+ *	@return The value. 0 if index is out of range or the element is not an
+ *	integer.
+ *
+ *	@relatesalso as_typedlist
+ */
+AS_EXTERN int64_t as_typedlist_get_int64(const as_typedlist* list, uint32_t index);
+
+/**
+ *	Get the double value at the specified index.
+ *
+ *	@return The value. 0.0 if index is out of range or the element is not a
+ *	double.
+ *
+ *	@relatesalso as_typedlist
+ */
+AS_EXTERN double as_typedlist_get_double(const as_typedlist* list, uint32_t index);
+
+/**
+ *	Set the value at the specified index. Setting past the end of the list
+ *	pads the list with as_nil, which promotes it.
+ *
+ *	@param list 	The list.
+ *	@param index	The index of the element.
+ *	@param value	The value, ownership is transferred to the list.
+ *
+ *	@return 0 on success. Otherwise an error occurred.
+ *
+ *	@relatesalso as_typedlist
+ */
+AS_EXTERN int as_typedlist_set(as_typedlist* list, uint32_t index, as_val* value);
+
+/**
+ *	Set an int64_t value at the specified index.
+ *
+ *	@relatesalso as_typedlist
+ */
+AS_EXTERN int as_typedlist_set_int64(as_typedlist* list, uint32_t index, int64_t value);
+
+/**
+ *	Set a double value at the specified index.
+ *
+ *	@relatesalso as_typedlist
+ */
+AS_EXTERN int as_typedlist_set_double(as_typedlist* list, uint32_t index, double value);
+
+/**
+ *	Insert the value at the specified index, shifting following elements.
+ *
+ *	@param list 	The list.
+ *	@param index	The index of the element.
+ *	@param value	The value, ownership is transferred to the list.
+ *
+ *	@return 0 on success. Otherwise an error occurred.
+ *
+ *	@relatesalso as_typedlist
+ */
+AS_EXTERN int as_typedlist_insert(as_typedlist* list, uint32_t index, as_val* value);
+
+/**
+ *	Insert an int64_t value at the specified index.
+ *
+ *	@relatesalso as_typedlist
+ */
+AS_EXTERN int as_typedlist_insert_int64(as_typedlist* list, uint32_t index, int64_t value);
+
+/**
+ *	Insert a double value at the specified index.
+ *
+ *	@relatesalso as_typedlist
+ */
+AS_EXTERN int as_typedlist_insert_double(as_typedlist* list, uint32_t index, double value);
+
+/**
+ *	Append the value to the end of the list.
+ *
+ *	@param list 	The list.
+ *	@param value	The value, ownership is transferred to the list.
+ *
+ *	@return 0 on success. Otherwise an error occurred.
+ *
+ *	@relatesalso as_typedlist
+ */
+AS_EXTERN int as_typedlist_append(as_typedlist* list, as_val* value);
+
+/**
+ *	Append an int64_t value to the end of the list.
+ *
+ *	@relatesalso as_typedlist
+ */
+AS_EXTERN int as_typedlist_append_int64(as_typedlist* list, int64_t value);
+
+/**
+ *	Append a double value to the end of the list.
+ *
+ *	@relatesalso as_typedlist
+ */
+AS_EXTERN int as_typedlist_append_double(as_typedlist* list, double value);
+
+/**
+ *	Remove the element at the specified index, shifting following elements.
+ *
+ *	@return 0 on success. Otherwise an error occurred.
+ *
+ *	@relatesalso as_typedlist
+ */
+AS_EXTERN int as_typedlist_remove(as_typedlist* list, uint32_t index);
+
+/**
+ *	Remove all elements at and beyond the specified index.
+ *
+ *	@return 0 on success. Otherwise an error occurred.
+ *
+ *	@relatesalso as_typedlist
+ */
+AS_EXTERN int as_typedlist_trim(as_typedlist* list, uint32_t index);
+
+
+/******************************************************************************
+ *	ITERATION FUNCTIONS
+ *****************************************************************************/
+
+/**
+ *	Call the callback function for each element in the list.
+ *
+ *	@return true if iteration completes fully. false if iteration was aborted.
+ *
+ *	@relatesalso as_typedlist
+ */
+AS_EXTERN bool as_typedlist_foreach(const as_typedlist* list, as_list_foreach_callback callback, void* udata);
+
+/**
+ *	Initializes a stack allocated iterator for the given list.
+ *
+ *	@relatesalso as_typedlist_iterator
+ */
+AS_EXTERN as_typedlist_iterator* as_typedlist_iterator_init(as_typedlist_iterator* it, const as_typedlist* list);
+
+/**
+ *	Creates a heap allocated iterator for the given list.
+ *
+ *	@relatesalso as_typedlist_iterator
+ */
+AS_EXTERN as_typedlist_iterator* as_typedlist_iterator_new(const as_typedlist* list);
+
+/**
+ *	Tests if there are more values available in the iterator.
+ *
+ *	@relatesalso as_typedlist_iterator
+ */
+AS_EXTERN bool as_typedlist_iterator_has_next(const as_typedlist_iterator* it);
+
+/**
+ *	Get the next value from the iterator.
+ *
+ *	@return The next value in the list if available. Otherwise NULL.
+ *
+ *	@relatesalso as_typedlist_iterator
+ */
+AS_EXTERN const as_val* as_typedlist_iterator_next(as_typedlist_iterator* it);
+
+#ifdef __cplusplus
+} // end extern "C"
+#endif
@@ -78,8 +78,40 @@ typedef struct as_val_s {
      */
     bool free;
 
+    /**
+     *	@private
+     *	Value was allocated with as_slab_alloc() rather than cf_malloc(). Its
+     *	address is not the start of a cf_malloc() block, so it must only be
+     *	released by as_val_destroy(), never by cf_free().
+     */
+    bool slab;
+
+    /**
+     *	@private
+     *	Value is confined to one thread - `as_val.count` is updated without
+     *	atomic instructions. See as_val_confine() and as_val_share().
+     */
+    bool local;
+
 } as_val;
 
+/**
+ *	Heap memory owned by a value tree, see as_val_memory_usage().
+ */
+typedef struct as_val_memory_s {
+	/**
+	 *	Bytes reachable only through this tree.
+	 */
+	size_t exclusive;
+
+	/**
+	 *	Bytes of values (and their contents) also referenced from elsewhere -
+	 *	values with a count above 1, and structure shared between persistent
+	 *	list and map versions.
+	 */
+	size_t shared;
+} as_val_memory;
+
 /******************************************************************************
  *	MACROS
  *****************************************************************************/
@@ -136,6 +168,143 @@ typedef struct as_val_s {
  */
 AS_EXTERN bool as_val_tobool(const as_val* v);
 
+/**
+ *	Confine a value to the calling thread. as_val_reserve() and
+ *	as_val_destroy() then update its count with plain, non-atomic instructions.
+ *
+ *	This only affects the value itself - as_unpack_val_local() confines a whole
+ *	unpacked tree. Before a confined value, or a container holding one, is
+ *	handed to another thread, call as_val_share() on it.
+ *
+ *	~~~~~~~~~~{.c}
+ *	as_integer* i = (as_integer*)as_val_confine((as_val*)as_integer_new(12345));
+ *	~~~~~~~~~~
+ *
+ *	@param v	The value to confine. Static values are left unchanged.
+ *
+ *	@return The value.
+ */
+static inline as_val* as_val_confine(as_val* v)
+{
+	if (v && v->count) {
+		v->local = true;
+	}
+	return v;
+}
+
+/**
+ *	Switch a value and everything it contains (list elements, map keys and
+ *	values, pair members) back to atomic reference counting, so the tree can be
+ *	passed to other threads.
+ *
+ *	Must be called by the thread the values are confined to, before the tree is
+ *	published to other threads.
+ *
+ *	@param v	The root of the value tree.
+ *
+ *	@return The value.
+ */
+AS_EXTERN as_val* as_val_share(as_val* v);
+
+/**
+ *	Create a deep copy of a value tree - every container and every scalar in
+ *	it is copied, so the copy shares nothing with the original. Containers keep
+ *	their type (an as_orderedmap stays ordered, an as_typedlist stays typed),
+ *	and are sized for their contents up front.
+ *
+ *	Static values (nil, booleans, cached integers) are returned as is. Records
+ *	are views of external storage and are reserved rather than copied.
+ *
+ *	@param v	The root of the value tree.
+ *
+ *	@return The copy, to be destroyed by the caller. NULL if v is NULL or
+ *	allocation failed.
+ */
+AS_EXTERN as_val* as_val_clone(const as_val* v);
+
+/**
+ *	Create a copy-on-write copy of a value tree. Only the root is copied - list
+ *	elements, map keys and values and pair members are shared with the original
+ *	through their reference counts. A persistent list or map shares its trie.
+ *
+ *	The root of the copy may be modified freely. Before modifying a nested
+ *	container, detach it with as_list_unshare() or as_map_unshare(), which copy
+ *	it the same way only while it is still shared (count > 1).
+ *
+ *	~~~~~~~~~~{.c}
+ *	// Start from a template record and patch it.
+ *	as_map* rec = (as_map*)as_val_clone_cow((as_val*)template);
+ *	as_stringmap_set_int64(rec, "ttl", 300);
+ *
+ *	as_list* tags = (as_list*)as_map_unshare(rec, (as_val*)&tags_key);
+ *	as_list_append_str(tags, "patched");
+ *	~~~~~~~~~~
+ *
+ *	Shared children are reserved with as_val_reserve(). If the original tree
+ *	is confined to a thread (see as_val_confine()), call as_val_share() on it
+ *	before handing the copy to another thread.
+ *
+ *	@param v	The root of the value tree.
+ *
+ *	@return The copy, to be destroyed by the caller. NULL if v is NULL or
+ *	allocation failed.
+ */
+AS_EXTERN as_val* as_val_clone_cow(const as_val* v);
+
+/**
+ *	@private
+ *	Get an element for a container copy - a deep copy, or a new reference.
+ *	Used by list and map clone hooks.
+ */
+AS_EXTERN as_val* as_val_clone_element(const as_val* v, bool deep);
+
+/**
+ *	Get the heap memory owned by a value tree, split into exclusively owned and
+ *	shared bytes. Counts value headers, string and blob payloads, and list and
+ *	map storage including spare capacity. Allocator overhead and static values
+ *	(for example cached integers) are not counted. A value referenced more than
+ *	once within the tree is counted each time it is reached.
+ *
+ *	~~~~~~~~~~{.c}
+ *	as_val_memory mem = { 0 };
+ *	as_val_memory_usage(val, &mem);
+ *	~~~~~~~~~~
+ *
+ *	@param v	The root of the value tree.
+ *	@param mem	Accumulates the totals.
+ */
+AS_EXTERN void as_val_memory_usage(const as_val* v, as_val_memory* mem);
+
+/**
+ *	Get the total heap memory owned by a value tree, shared or not.
+ *	See as_val_memory_usage().
+ */
+AS_EXTERN size_t as_val_memory_size(const as_val* v);
+
+/**
+ *	@private
+ *	Add the memory of a value tree reached from a container. Used by list and
+ *	map memory hooks.
+ *
+ *	@param shared	true if the containing storage is itself shared.
+ */
+AS_EXTERN void as_val_memory_add(const as_val* v, as_val_memory* mem, bool shared);
+
+/**
+ *	@private
+ *	Add bytes of a container's own storage.
+ */
+static inline void
+as_val_memory_bytes(as_val_memory* mem, bool shared, size_t bytes)
+{
+	if (shared) {
+		mem->shared += bytes;
+	}
+	else {
+		mem->exclusive += bytes;
+	}
+}
+
 /******************************************************************************
  *	FUNCTIONS
  *****************************************************************************/
@@ -179,6 +348,8 @@ static inline void as_val_init(as_val * v, as_val_t type, bool free)
 {
     v->type = type; 
     v->free = free; 
+    v->slab = false;
+    v->local = false;
     v->count = 1;
 }
 
@@ -194,6 +365,8 @@ static inline as_val * as_val_cons(as_val * val, as_val_t type, bool free)
 
     val->type = type; 
     val->free = free; 
+    val->slab = false;
+    val->local = false;
     val->count = 1;
     return val;
 }
@@ -0,0 +1,105 @@
+/*
+ * Copyright 2026 Aerospike, Inc.
+ *
+ * Portions may be licensed to Aerospike, Inc. under one or more contributor
+ * license agreements.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#pragma once
+
+#include <aerospike/as_std.h>
+#include <aerospike/as_val.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/******************************************************************************
+ * TYPES
+ *****************************************************************************/
+
+/**
+ * Background reclaimer statistics.
+ */
+typedef struct as_val_reclaim_stats_s {
+	/**
+	 * Trees handed to the reclaimer thread.
+	 */
+	uint64_t deferred;
+
+	/**
+	 * Trees destroyed by the reclaimer thread.
+	 */
+	uint64_t reclaimed;
+
+	/**
+	 * Trees destroyed by the caller because the backlog was full.
+	 */
+	uint64_t overflows;
+
+	/**
+	 * Trees currently waiting for the reclaimer thread.
+	 */
+	uint32_t backlog;
+
+	/**
+	 * Largest backlog seen.
+	 */
+	uint32_t backlog_peak;
+} as_val_reclaim_stats;
+
+/******************************************************************************
+ * FUNCTIONS
+ *****************************************************************************/
+
+/**
+ * Start the background reclaimer thread.
+ *
+ * @param max_backlog	Most trees waiting to be destroyed. When full,
+ *						as_val_destroy_deferred() destroys in the caller.
+ *
+ * @return 0 on success, -1 if already started, -2 if the thread failed to
+ * start.
+ */
+AS_EXTERN int as_val_reclaim_start(uint32_t max_backlog);
+
+/**
+ * Destroy all waiting trees and stop the reclaimer thread. Must not be called
+ * concurrently with as_val_destroy_deferred().
+ */
+AS_EXTERN void as_val_reclaim_stop(void);
+
+/**
+ * Get reclaimer statistics.
+ */
+AS_EXTERN void as_val_reclaim_get_stats(as_val_reclaim_stats* stats);
+
+/**
+ * Release a reference like as_val_destroy(). If it is the last reference to a
+ * heap allocated list, map or pair and the reclaimer is running, the tree is
+ * destroyed on the reclaimer thread instead of the caller's.
+ *
+ * A thread-confined root (see as_val_confine()) and stack allocated values are
+ * always destroyed in the caller. Otherwise the tree is shared with
+ * as_val_share() before it is handed over, so confined values inside it -
+ * which may have other holders on the caller's thread - switch to atomic
+ * counts. That walks the tree in the caller. The tree must not contain stack
+ * allocated values.
+ *
+ * @return NULL if the reference was consumed, as as_val_destroy().
+ */
+AS_EXTERN as_val* as_val_destroy_deferred(as_val* v);
+
+#ifdef __cplusplus
+} // end extern "C"
+#endif
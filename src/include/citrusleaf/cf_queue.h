@@ -16,6 +16,8 @@
  */
 #pragma once
 
+#include <aerospike/as_eventcount.h>
+#include <aerospike/as_stats.h>
 #include <aerospike/as_std.h>
 #include <pthread.h>
 
@@ -50,6 +52,20 @@ extern "C" {
 
 typedef int (*cf_queue_reduce_fn) (void *buf, void *udata);
 
+/**
+ * Private state of a lock-free queue - see cf_queue_init_mpmc(). The two
+ * positions are kept on separate cache lines so producers and consumers don't
+ * contend.
+ */
+typedef struct cf_queue_ring_s {
+	uint32_t        enqueue_pos;    // next slot to push
+	uint8_t         pad0[60];
+	uint32_t        dequeue_pos;    // next slot to pop
+	uint8_t         pad1[60];
+	uint32_t        mask;           // capacity - 1, capacity is a power of 2
+	uint32_t *      seqs;           // per-slot sequence numbers
+} cf_queue_ring;
+
 /**
  * cf_queue
  */
@@ -65,8 +81,10 @@ typedef struct cf_queue_s {
 	uint32_t        n_eles;         // number of elements in queue
 	size_t          element_sz;     // number of bytes in an element
 	pthread_mutex_t LOCK;           // the mutex lock
-	pthread_cond_t  CV;             // the condvar
+	as_eventcount   EC;             // blocked pops spin, then park on this
 	uint8_t *       elements;       // the block of queue elements
+	cf_queue_ring * ring;           // if not NULL, lock-free bounded mode
+	as_queue_stats * stats;         // if not NULL, counters are kept
 } cf_queue;
 
 /******************************************************************************
@@ -77,14 +95,65 @@ bool cf_queue_init(cf_queue* q, size_t element_sz, uint32_t capacity, bool threa
 
 cf_queue *cf_queue_create(size_t element_sz, bool threadsafe);
 
+/**
+ * Initialize a lock-free, bounded, multi-producer multi-consumer queue. Pushes
+ * and pops claim ring slots with compare-and-swap rather than taking the
+ * mutex, so they scale with the number of threads. Pops with ms_wait != 0
+ * block on an eventcount that producers only signal when a popper is waiting.
+ *
+ * The capacity is rounded up to a power of 2 and never grows - pushes to a
+ * full queue fail with CF_QUEUE_ERR. Only cf_queue_push(),
+ * cf_queue_push_limit(), cf_queue_push_n(), cf_queue_pop(), cf_queue_pop_n(),
+ * cf_queue_sz() and cf_queue_delete_all() are supported. The other functions return
+ * CF_QUEUE_ERR.
+ */
+bool cf_queue_init_mpmc(cf_queue *q, size_t element_sz, uint32_t capacity);
+
+/**
+ * Create a lock-free, bounded queue - see cf_queue_init_mpmc().
+ */
+cf_queue *cf_queue_create_mpmc(size_t element_sz, uint32_t capacity);
+
 void cf_queue_destroy(cf_queue *q);
 
+/**
+ * Set how long a pop on an empty queue spins, checking for an element, before
+ * it parks - see as_eventcount. The default is AS_EVENTCOUNT_SPIN iterations,
+ * and 0 parks at once. Only applies to thread-safe queues.
+ */
+void cf_queue_set_spin(cf_queue *q, uint32_t spin);
+
+/**
+ * Start keeping counters - lock acquisitions and contended lock wait times,
+ * the depth high-water mark, and pop wakeups and parks. Call before the queue
+ * is shared with other threads. Only applies to thread-safe queues. In
+ * lock-free mode there is no lock, so only the depth, wakeup and park counters
+ * are kept.
+ *
+ * @return false if out of memory, or the queue isn't thread-safe.
+ */
+bool cf_queue_enable_stats(cf_queue *q);
+
+/**
+ * Get a snapshot of the queue's counters.
+ *
+ * @return false if counters aren't being kept.
+ */
+bool cf_queue_get_stats(cf_queue *q, as_queue_stats *stats);
+
 /**
  * Get the number of elements currently in the queue.
  */
 static inline uint32_t
 cf_queue_sz(const cf_queue *q)
 {
+	if (q->ring) {
+		// Positions are read without a lock - the result is approximate.
+		uint32_t sz = q->ring->enqueue_pos - q->ring->dequeue_pos;
+
+		return sz > q->alloc_sz ? 0 : sz;
+	}
+
 	return q->n_eles;
 }
 
@@ -98,6 +167,17 @@ int cf_queue_push(cf_queue *q, const void *ptr);
  */
 bool cf_queue_push_limit(cf_queue *q, const void *ptr, uint32_t limit);
 
+/**
+ * Push n elements, laid out contiguously at ptr, with one hold of the lock and
+ * at most two copies per resize. Wakes up to one waiting pop per element.
+ *
+ * In lock-free mode, each push claims the whole run of free slots it finds,
+ * and the batch stops short if the queue fills.
+ *
+ * @return The number of elements pushed.
+ */
+uint32_t cf_queue_push_n(cf_queue *q, const void *ptr, uint32_t n);
+
 /**
  * Push element on the queue at a specified index.
  */
@@ -123,6 +203,15 @@ int cf_queue_peek(cf_queue *q, void *buf);
  */
 int cf_queue_pop(cf_queue *q, void *buf, int ms_wait);
 
+/**
+ * Pop up to n elements into buf, which must have room for n elements, with
+ * one hold of the lock. If the queue is empty, waits for the first element as
+ * cf_queue_pop() does.
+ *
+ * @return The number of elements popped, 0 if none.
+ */
+uint32_t cf_queue_pop_n(cf_queue *q, void *buf, uint32_t n, int ms_wait);
+
 /**
  * Run the entire queue, calling the callback, with the lock held.
  *
@@ -40,6 +40,7 @@ as_arraylist_init(as_arraylist* list, uint32_t capacity, uint32_t block_size)
 	list->block_size = block_size;
 	list->capacity = capacity;
 	list->size = 0;
+	list->front = 0;
 	if (list->capacity > 0) {
 		list->free = true;
 		list->elements = (as_val**) cf_calloc(capacity, sizeof(as_val*));
@@ -61,6 +62,7 @@ as_arraylist_new(uint32_t capacity, uint32_t block_size)
 	list->block_size = block_size;
 	list->capacity = capacity;
 	list->size = 0;
+	list->front = 0;
 	if (list->capacity > 0) {
 		list->free = true;
 		list->elements = (as_val**) cf_calloc(capacity, sizeof(as_val*));
@@ -84,13 +86,14 @@ as_arraylist_release(as_arraylist* list)
 		}
 
 		if (list->free) {
-			cf_free(list->elements);
+			cf_free(list->elements - list->front);
 		}
 	}
 	
 	list->elements = NULL;
 	list->size = 0;
 	list->capacity = 0;
+	list->front = 0;
 
 	return true;
 }
@@ -110,28 +113,43 @@ as_arraylist_ensure(as_arraylist* list, uint32_t delta)
 {
 	// Check for capacity (in terms of elements, NOT size in bytes), and if we
 	// need to allocate more, do a realloc.
-	if ((list->size + delta) > list->capacity) {
+	if ((list->front + list->size + delta) > list->capacity) {
+		// Reuse room left at the front by removals whenever it's enough -
+		// a fixed capacity list must not fail while it has room, and a
+		// growable one need not grow.
+		if ((list->size + delta) <= list->capacity) {
+			as_val** base = list->elements - list->front;
+
+			memmove(base, list->elements, sizeof(as_val*) * list->size);
+			memset(base + list->size, 0,
+					sizeof(as_val*) * (list->capacity - list->size));
+			list->elements = base;
+			list->front = 0;
+			return AS_ARRAYLIST_OK;
+		}
+
 		// by convention - we allocate more space ONLY when the unit of
 		// (new) allocation is > 0.
 		if (list->block_size == 0) {
 			return AS_ARRAYLIST_ERR_MAX;
 		}
 		// Compute how much room we're missing for the new stuff
-		int new_room = (list->size + delta) - list->capacity;
+		int new_room = (list->front + list->size + delta) - list->capacity;
 		// Compute new capacity in terms of multiples of block_size
 		// This will get us (conservatively) at least one block
 		int new_blocks = (new_room + list->block_size) / list->block_size;
 		int new_capacity = list->capacity + (new_blocks * list->block_size);
 		size_t new_bytes = sizeof(as_val*) * new_capacity;
-		as_val** elements = (as_val**) cf_realloc(list->elements, new_bytes);
-		if (! elements) {
+		as_val** base = (as_val**) cf_realloc(list->elements - list->front,
+				new_bytes);
+		if (! base) {
 			return AS_ARRAYLIST_ERR_ALLOC;
 		}
 		// Zero everything beyond the old pointers.
 		size_t old_bytes = sizeof(as_val*) * list->capacity;
-		memset((uint8_t *)elements + old_bytes, 0, new_bytes - old_bytes);
+		memset((uint8_t *)base + old_bytes, 0, new_bytes - old_bytes);
 		// Set the new array pointer and capacity.
-		list->elements = elements;
+		list->elements = base + list->front;
 		list->capacity = new_capacity;
 		list->free = true;
 	}
@@ -139,6 +157,40 @@ as_arraylist_ensure(as_arraylist* list, uint32_t delta)
 	return AS_ARRAYLIST_OK;
 }
 
+// Grow a full list by reserving room before the first element. The room is as
+// large as the list, so repeated insertions at the front copy each element
+// O(1) times.
+static int
+as_arraylist_ensure_front(as_arraylist* list)
+{
+	if (list->block_size == 0) {
+		return AS_ARRAYLIST_ERR_MAX;
+	}
+
+	uint32_t front = list->size > list->block_size ?
+			list->size : list->block_size;
+	as_val** base = (as_val**) cf_malloc(
+			sizeof(as_val*) * (front + list->size));
+
+	if (! base) {
+		return AS_ARRAYLIST_ERR_ALLOC;
+	}
+
+	memset(base, 0, sizeof(as_val*) * front);
+	memcpy(base + front, list->elements, sizeof(as_val*) * list->size);
+
+	if (list->free) {
+		cf_free(list->elements);
+	}
+
+	list->elements = base + front;
+	list->capacity = front + list->size;
+	list->front = front;
+	list->free = true;
+
+	return AS_ARRAYLIST_OK;
+}
+
 /*******************************************************************************
  * INFO FUNCTIONS
  ******************************************************************************/
@@ -192,7 +244,7 @@ as_arraylist_set(as_arraylist* list, uint32_t index, as_val* value)
 {
 	int rc = AS_ARRAYLIST_OK;
 
-	if (index >= list->capacity) {
+	if (index >= list->capacity - list->front) {
 		rc = as_arraylist_ensure(list, (index + 1) - list->size);
 
 		if (rc != AS_ARRAYLIST_OK) {
@@ -247,6 +299,28 @@ as_arraylist_set_str(as_arraylist* list, uint32_t index, const char * value)
 int
 as_arraylist_insert(as_arraylist* list, uint32_t index, as_val* value)
 {
+	if (index == 0 && list->front == 0 && list->size != 0 &&
+			list->size == list->capacity) {
+		// Full - grow at the front, or fall back to growing at the end.
+		as_arraylist_ensure_front(list);
+	}
+
+	if (list->front != 0 && index < list->size / 2 + 1 && index <= list->size) {
+		// Shift the elements before index down into the room at the front.
+		list->elements--;
+		list->front--;
+
+		if (index != 0) {
+			memmove(list->elements, list->elements + 1,
+					sizeof(as_val*) * index);
+		}
+
+		list->elements[index] = value ? value : (as_val*)&as_nil;
+		list->size++;
+
+		return AS_ARRAYLIST_OK;
+	}
+
 	uint32_t delta = 1;
 
 	if (index > list->size) {
@@ -368,6 +442,21 @@ as_arraylist_remove(as_arraylist* list, uint32_t index)
 		as_val_destroy(list->elements[index]);
 	}
 
+	if (index < list->size / 2) {
+		// Shift the elements before index up, leaving room at the front.
+		if (index != 0) {
+			memmove(list->elements + 1, list->elements,
+					sizeof(as_val*) * index);
+		}
+
+		list->elements[0] = NULL; // clean vacated pointer slot
+		list->elements++;
+		list->front++;
+		list->size--;
+
+		return AS_ARRAYLIST_OK;
+	}
+
 	for (uint32_t i = index + 1; i < list->size; i++) {
 		list->elements[i - 1] = list->elements[i];
 	}
@@ -421,6 +510,27 @@ as_arraylist_trim(as_arraylist* list, uint32_t index)
 	return AS_ARRAYLIST_OK;
 }
 
+int
+as_arraylist_trim_front(as_arraylist* list, uint32_t n)
+{
+	if (n > list->size) {
+		return AS_ARRAYLIST_ERR_INDEX;
+	}
+
+	for (uint32_t i = 0; i < n; i++) {
+		if (list->elements[i]) {
+			as_val_destroy(list->elements[i]);
+			list->elements[i] = NULL;
+		}
+	}
+
+	list->elements += n;
+	list->front += n;
+	list->size -= n;
+
+	return AS_ARRAYLIST_OK;
+}
+
 as_val*
 as_arraylist_head(const as_arraylist* list)
 {
@@ -432,19 +542,7 @@ as_arraylist_tail(const as_arraylist* list)
 {
 	if (list->size == 0) return NULL;
 
-	as_arraylist* list2 = as_arraylist_new(list->size-1, list->block_size);
-
-	for(uint32_t i = 1, j = 0; i < list->size; i++, j++) {
-		if (list->elements[i]) {
-			as_val_reserve(list->elements[i]);
-			list2->elements[j] = list2->elements[i];
-		}
-		else {
-			list2->elements[j] = 0;
-		}
-	}
-
-	return list2;
+	return as_arraylist_drop(list, 1);
 }
 
 as_arraylist*
@@ -49,6 +49,27 @@ static uint32_t _as_arraylist_list_size(const as_list * l)
 	return as_arraylist_size((as_arraylist *) l);
 }
 
+static void _as_arraylist_list_memory(const as_list * l, as_val_memory * mem, bool shared)
+{
+	const as_arraylist * list = (const as_arraylist *) l;
+	size_t bytes = 0;
+
+	if (l->_.free) {
+		bytes += sizeof(as_arraylist);
+	}
+
+	// Include spare capacity, the elements are allocated in blocks.
+	if (list->free) {
+		bytes += list->capacity * sizeof(as_val *);
+	}
+
+	as_val_memory_bytes(mem, shared, bytes);
+
+	for (uint32_t i = 0; i < list->size; i++) {
+		as_val_memory_add(list->elements[i], mem, shared);
+	}
+}
+
 /*******************************************************************************
  *	GET FUNCTIONS
  ******************************************************************************/
@@ -231,6 +252,33 @@ static as_list_iterator * _as_arraylist_list_iterator_init(const as_list * l, as
 	return (as_list_iterator *) as_arraylist_iterator_init((as_arraylist_iterator *) it, (as_arraylist *) l);
 }
 
+/*******************************************************************************
+ *	COPY FUNCTIONS
+ ******************************************************************************/
+
+static as_list * _as_arraylist_list_clone(const as_list * l, bool deep)
+{
+	const as_arraylist * list = (const as_arraylist *) l;
+	as_arraylist * copy = as_arraylist_new(list->size, list->block_size);
+
+	if ( !copy ) return NULL;
+
+	for (uint32_t i = 0; i < list->size; i++) {
+		as_val * v = list->elements[i];
+		as_val * c = as_val_clone_element(v, deep);
+
+		if ( v && !c ) {
+			as_arraylist_destroy(copy);
+			return NULL;
+		}
+
+		copy->elements[i] = c;
+		copy->size = i + 1;
+	}
+
+	return (as_list *) copy;
+}
+
 /*******************************************************************************
  *	HOOKS
  ******************************************************************************/
@@ -320,4 +368,16 @@ const as_list_hooks as_arraylist_list_hooks = {
 	.iterator_new	= _as_arraylist_list_iterator_new,
 	.iterator_init	= _as_arraylist_list_iterator_init,
 
+	/***************************************************************************
+	 *	memory hooks
+	 **************************************************************************/
+
+	.memory			= _as_arraylist_list_memory,
+
+	/***************************************************************************
+	 *	copy hooks
+	 **************************************************************************/
+
+	.clone			= _as_arraylist_list_clone,
+
 };
@@ -18,6 +18,7 @@
 #include <aerospike/as_arraylist_iterator.h>
 #include <aerospike/as_iterator.h>
 #include <citrusleaf/alloc.h>
+#include <string.h>
 
 /*******************************************************************************
  *	EXTERNS
@@ -76,3 +77,16 @@ const as_val * as_arraylist_iterator_next(as_arraylist_iterator * iterator)
 	}
 	return NULL;
 }
+
+uint32_t as_arraylist_iterator_next_n(as_arraylist_iterator * iterator, const as_val ** values, uint32_t n)
+{
+	uint32_t avail = iterator->list->size - iterator->pos;
+
+	if ( n > avail ) {
+		n = avail;
+	}
+
+	memcpy(values, iterator->list->elements + iterator->pos, n * sizeof(as_val *));
+	iterator->pos += n;
+	return n;
+}
@@ -43,6 +43,11 @@ static const as_val * _as_arraylist_iterator_next(as_iterator * i)
 	return as_arraylist_iterator_next((as_arraylist_iterator *) i);
 }
 
+static uint32_t _as_arraylist_iterator_next_n(as_iterator * i, const as_val ** values, uint32_t n) 
+{
+	return as_arraylist_iterator_next_n((as_arraylist_iterator *) i, values, n);
+}
+
 /******************************************************************************
  *	HOOKS
  *****************************************************************************/
@@ -50,5 +55,6 @@ static const as_val * _as_arraylist_iterator_next(as_iterator * i)
 const as_iterator_hooks as_arraylist_iterator_hooks = {
 	.destroy    = _as_arraylist_iterator_destroy,
 	.has_next   = _as_arraylist_iterator_has_next,
-	.next       = _as_arraylist_iterator_next
+	.next       = _as_arraylist_iterator_next,
+	.next_n     = _as_arraylist_iterator_next_n
 };
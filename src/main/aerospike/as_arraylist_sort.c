@@ -0,0 +1,526 @@
+/*
+ * Copyright 2026 Aerospike, Inc.
+ *
+ * Portions may be licensed to Aerospike, Inc. under one or more contributor
+ * license agreements.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include <aerospike/as_arraylist.h>
+#include <aerospike/as_double.h>
+#include <aerospike/as_integer.h>
+#include <aerospike/as_msgpack.h>
+#include <aerospike/as_std.h>
+#include <aerospike/as_string.h>
+#include <aerospike/as_thread_pool.h>
+#include <aerospike/as_val.h>
+#include <citrusleaf/alloc.h>
+#include <string.h>
+
+/******************************************************************************
+ * TYPES
+ *****************************************************************************/
+
+// Runs this short are insertion sorted.
+#define SORT_RUN 16
+
+// Lists shorter than this aren't worth handing to a thread pool.
+#define PARALLEL_MIN_RUN (16 * 1024)
+
+typedef enum {
+	KEY_INT64,
+	KEY_DOUBLE,
+	KEY_STRING,
+	KEY_VAL
+} sort_key_kind;
+
+typedef struct sort_entry_s {
+	union {
+		int64_t i;
+		double d;
+		uint64_t prefix;
+	} key;
+	as_val* val;
+} sort_entry;
+
+typedef struct sort_ctx_s {
+	sort_key_kind kind;
+	bool desc;
+	bool stable;
+} sort_ctx;
+
+typedef struct sort_job_s {
+	const sort_ctx* ctx;
+	sort_entry* src;
+	sort_entry* dst;
+	uint32_t lo;
+	uint32_t mid;
+	uint32_t hi;
+} sort_job;
+
+/******************************************************************************
+ * STATIC FUNCTIONS
+ *****************************************************************************/
+
+static inline int
+string_cmp(as_val* v1, as_val* v2)
+{
+	as_string* s1 = (as_string*)v1;
+	as_string* s2 = (as_string*)v2;
+	size_t len1 = as_string_len(s1);
+	size_t len2 = as_string_len(s2);
+	int c = memcmp(as_string_get(s1), as_string_get(s2),
+			len1 < len2 ? len1 : len2);
+
+	if (c != 0) {
+		return c;
+	}
+
+	return (len1 > len2) - (len1 < len2);
+}
+
+static inline int
+entry_cmp(const sort_ctx* ctx, const sort_entry* a, const sort_entry* b)
+{
+	int c;
+
+	switch (ctx->kind) {
+	case KEY_INT64:
+		c = (a->key.i > b->key.i) - (a->key.i < b->key.i);
+		break;
+	case KEY_DOUBLE:
+		c = (a->key.d > b->key.d) - (a->key.d < b->key.d);
+		break;
+	case KEY_STRING:
+		c = (a->key.prefix > b->key.prefix) - (a->key.prefix < b->key.prefix);
+
+		if (c == 0) {
+			c = string_cmp(a->val, b->val);
+		}
+		break;
+	default: {
+		msgpack_compare_t r = as_val_cmp(a->val, b->val);
+
+		c = r == MSGPACK_COMPARE_LESS ? -1 :
+				(r == MSGPACK_COMPARE_GREATER ? 1 : 0);
+		break;
+	}
+	}
+
+	return ctx->desc ? -c : c;
+}
+
+static sort_key_kind
+keys_extract(const as_arraylist* list, sort_entry* entries)
+{
+	as_val_t type = as_val_type(list->elements[0]);
+
+	for (uint32_t i = 1; i < list->size; i++) {
+		if (as_val_type(list->elements[i]) != type) {
+			type = AS_UNDEF;
+			break;
+		}
+	}
+
+	sort_key_kind kind;
+
+	switch (type) {
+	case AS_INTEGER:
+		kind = KEY_INT64;
+		break;
+	case AS_DOUBLE:
+		kind = KEY_DOUBLE;
+		break;
+	case AS_STRING:
+		kind = KEY_STRING;
+		break;
+	default:
+		kind = KEY_VAL;
+		break;
+	}
+
+	for (uint32_t i = 0; i < list->size; i++) {
+		as_val* v = list->elements[i];
+		sort_entry* e = &entries[i];
+
+		e->val = v;
+
+		switch (kind) {
+		case KEY_INT64:
+			e->key.i = as_integer_get((const as_integer*)v);
+			break;
+		case KEY_DOUBLE:
+			e->key.d = as_double_get((const as_double*)v);
+			break;
+		case KEY_STRING: {
+			// Big-endian, so the prefixes compare like memcmp().
+			as_string* s = (as_string*)v;
+			const uint8_t* p = (const uint8_t*)as_string_get(s);
+			size_t len = as_string_len(s);
+			uint64_t prefix = 0;
+
+			for (uint32_t b = 0; b < 8; b++) {
+				prefix = (prefix << 8) | (b < len ? p[b] : 0);
+			}
+
+			e->key.prefix = prefix;
+			break;
+		}
+		default:
+			e->key.prefix = 0;
+			break;
+		}
+	}
+
+	return kind;
+}
+
+static void
+insertion_sort(const sort_ctx* ctx, sort_entry* a, uint32_t n)
+{
+	for (uint32_t i = 1; i < n; i++) {
+		sort_entry e = a[i];
+		uint32_t j = i;
+
+		while (j > 0 && entry_cmp(ctx, &e, &a[j - 1]) < 0) {
+			a[j] = a[j - 1];
+			j--;
+		}
+
+		a[j] = e;
+	}
+}
+
+static inline void
+entry_swap(sort_entry* a, sort_entry* b)
+{
+	sort_entry t = *a;
+
+	*a = *b;
+	*b = t;
+}
+
+static void
+quick_sort(const sort_ctx* ctx, sort_entry* a, uint32_t n)
+{
+	while (n > SORT_RUN) {
+		uint32_t mid = n / 2;
+
+		// Median of three - also places sentinels for the partition loops.
+		if (entry_cmp(ctx, &a[mid], &a[0]) < 0) {
+			entry_swap(&a[mid], &a[0]);
+		}
+
+		if (entry_cmp(ctx, &a[n - 1], &a[0]) < 0) {
+			entry_swap(&a[n - 1], &a[0]);
+		}
+
+		if (entry_cmp(ctx, &a[n - 1], &a[mid]) < 0) {
+			entry_swap(&a[n - 1], &a[mid]);
+		}
+
+		sort_entry pivot = a[mid];
+		int64_t i = -1;
+		int64_t j = n;
+
+		// Hoare partition - splits runs of equal keys evenly.
+		while (true) {
+			do {
+				i++;
+			} while (entry_cmp(ctx, &a[i], &pivot) < 0);
+
+			do {
+				j--;
+			} while (entry_cmp(ctx, &pivot, &a[j]) < 0);
+
+			if (i >= j) {
+				break;
+			}
+
+			entry_swap(&a[i], &a[j]);
+		}
+
+		uint32_t left = (uint32_t)j + 1;
+		uint32_t right = n - left;
+
+		// Recurse into the smaller side to bound the stack depth.
+		if (left < right) {
+			quick_sort(ctx, a, left);
+			a += left;
+			n = right;
+		}
+		else {
+			quick_sort(ctx, a + left, right);
+			n = left;
+		}
+	}
+
+	insertion_sort(ctx, a, n);
+}
+
+static void
+merge(const sort_ctx* ctx, const sort_entry* src, sort_entry* dst,
+		uint32_t lo, uint32_t mid, uint32_t hi)
+{
+	uint32_t i = lo;
+	uint32_t j = mid;
+	uint32_t k = lo;
+
+	while (i < mid && j < hi) {
+		// Take from the right only if strictly less, to keep the sort stable.
+		if (entry_cmp(ctx, &src[j], &src[i]) < 0) {
+			dst[k++] = src[j++];
+		}
+		else {
+			dst[k++] = src[i++];
+		}
+	}
+
+	if (i < mid) {
+		memcpy(&dst[k], &src[i], (mid - i) * sizeof(sort_entry));
+	}
+
+	if (j < hi) {
+		memcpy(&dst[k], &src[j], (hi - j) * sizeof(sort_entry));
+	}
+}
+
+static void
+merge_sort(const sort_ctx* ctx, sort_entry* a, sort_entry* tmp, uint32_t n)
+{
+	for (uint32_t lo = 0; lo < n; lo += SORT_RUN) {
+		insertion_sort(ctx, a + lo, n - lo < SORT_RUN ? n - lo : SORT_RUN);
+	}
+
+	sort_entry* src = a;
+	sort_entry* dst = tmp;
+
+	for (uint32_t width = SORT_RUN; width < n; width *= 2) {
+		for (uint32_t lo = 0; lo < n; lo += 2 * width) {
+			uint32_t mid = n - lo > width ? lo + width : n;
+			uint32_t hi = n - mid > width ? mid + width : n;
+
+			merge(ctx, src, dst, lo, mid, hi);
+		}
+
+		sort_entry* t = src;
+
+		src = dst;
+		dst = t;
+	}
+
+	if (src != a) {
+		memcpy(a, src, n * sizeof(sort_entry));
+	}
+}
+
+static void
+sort_run(const sort_ctx* ctx, sort_entry* a, sort_entry* tmp, uint32_t n)
+{
+	if (ctx->stable) {
+		merge_sort(ctx, a, tmp, n);
+	}
+	else {
+		quick_sort(ctx, a, n);
+	}
+}
+
+static void
+sort_job_run(sort_job* job)
+{
+	if (job->mid == 0) {
+		sort_run(job->ctx, job->src + job->lo, job->dst + job->lo,
+				job->hi - job->lo);
+	}
+	else {
+		merge(job->ctx, job->src, job->dst, job->lo, job->mid, job->hi);
+	}
+}
+
+static void
+sort_job_task(void* udata)
+{
+	sort_job_run((sort_job*)udata);
+}
+
+// Run jobs on the pool, with the calling thread doing the first, and wait for
+// all of them.
+static void
+sort_jobs_run(as_thread_pool* pool, sort_job* jobs, uint32_t n_jobs)
+{
+	as_task_group group;
+
+	as_task_group_init(&group, pool);
+
+	for (uint32_t i = 1; i < n_jobs; i++) {
+		as_task_group_add(&group, sort_job_task, &jobs[i]);
+	}
+
+	sort_job_run(&jobs[0]);
+	as_task_group_wait(&group, -1);
+	as_task_group_destroy(&group);
+}
+
+// Sort runs on the pool, then merge pairs of runs on the pool until one is
+// left. Returns the buffer holding the result.
+static sort_entry*
+parallel_sort(const sort_ctx* ctx, as_thread_pool* pool, sort_entry* a,
+		sort_entry* tmp, uint32_t n, uint32_t n_runs)
+{
+	uint32_t* bounds = (uint32_t*)cf_malloc((n_runs + 1) * sizeof(uint32_t));
+	sort_job* jobs = (sort_job*)cf_malloc(n_runs * sizeof(sort_job));
+
+	if (! bounds || ! jobs) {
+		cf_free(bounds);
+		cf_free(jobs);
+		sort_run(ctx, a, tmp, n);
+		return a;
+	}
+
+	for (uint32_t i = 0; i <= n_runs; i++) {
+		bounds[i] = (uint32_t)((uint64_t)n * i / n_runs);
+	}
+
+	for (uint32_t i = 0; i < n_runs; i++) {
+		jobs[i] = (sort_job){ .ctx = ctx, .src = a, .dst = tmp,
+				.lo = bounds[i], .mid = 0, .hi = bounds[i + 1] };
+	}
+
+	sort_jobs_run(pool, jobs, n_runs);
+
+	sort_entry* src = a;
+	sort_entry* dst = tmp;
+
+	while (n_runs > 1) {
+		uint32_t n_jobs = 0;
+
+		for (uint32_t i = 0; i < n_runs; i += 2) {
+			if (i + 1 < n_runs) {
+				jobs[n_jobs++] = (sort_job){ .ctx = ctx, .src = src,
+						.dst = dst, .lo = bounds[i], .mid = bounds[i + 1],
+						.hi = bounds[i + 2] };
+			}
+			else {
+				// Odd run out - carry it over to the next round.
+				memcpy(&dst[bounds[i]], &src[bounds[i]],
+						(bounds[i + 1] - bounds[i]) * sizeof(sort_entry));
+			}
+		}
+
+		sort_jobs_run(pool, jobs, n_jobs);
+
+		uint32_t n_bounds = 0;
+
+		for (uint32_t i = 0; i < n_runs; i += 2) {
+			bounds[n_bounds++] = bounds[i];
+		}
+
+		bounds[n_bounds] = n;
+		n_runs = n_bounds;
+
+		sort_entry* t = src;
+
+		src = dst;
+		dst = t;
+	}
+
+	cf_free(bounds);
+	cf_free(jobs);
+
+	return src;
+}
+
+static int
+sort_list(as_arraylist* list, uint32_t flags, as_thread_pool* pool)
+{
+	uint32_t n = list->size;
+
+	if (n < 2) {
+		return AS_ARRAYLIST_OK;
+	}
+
+	bool stable = (flags & AS_ARRAYLIST_SORT_STABLE) != 0;
+	uint32_t n_runs = 1;
+
+	if (pool != NULL && n >= 2 * PARALLEL_MIN_RUN) {
+		n_runs = pool->thread_size + 1;
+
+		if (n_runs > n / PARALLEL_MIN_RUN) {
+			n_runs = n / PARALLEL_MIN_RUN;
+		}
+	}
+
+	// Runs are merged, and merging needs a second buffer.
+	bool need_tmp = stable || n_runs > 1;
+	sort_entry* entries = (sort_entry*)cf_malloc(
+			(need_tmp ? 2 : 1) * (size_t)n * sizeof(sort_entry));
+
+	if (! entries) {
+		return AS_ARRAYLIST_ERR_ALLOC;
+	}
+
+	sort_entry* tmp = need_tmp ? entries + n : NULL;
+	sort_ctx ctx = {
+		.kind = keys_extract(list, entries),
+		.desc = (flags & AS_ARRAYLIST_SORT_DESCENDING) != 0,
+		.stable = stable
+	};
+
+	sort_entry* sorted = entries;
+
+	if (n_runs > 1) {
+		sorted = parallel_sort(&ctx, pool, entries, tmp, n, n_runs);
+	}
+	else {
+		sort_run(&ctx, entries, tmp, n);
+	}
+
+	uint32_t size = 0;
+
+	for (uint32_t i = 0; i < n; i++) {
+		if ((flags & AS_ARRAYLIST_SORT_UNIQUE) != 0 && size != 0 &&
+				entry_cmp(&ctx, &sorted[i], &sorted[i - 1]) == 0) {
+			if (sorted[i].val) {
+				as_val_destroy(sorted[i].val);
+			}
+			continue;
+		}
+
+		list->elements[size++] = sorted[i].val;
+	}
+
+	for (uint32_t i = size; i < n; i++) {
+		list->elements[i] = NULL; // clean vacated pointer slot
+	}
+
+	list->size = size;
+	cf_free(entries);
+
+	return AS_ARRAYLIST_OK;
+}
+
+/******************************************************************************
+ * SORT FUNCTIONS
+ *****************************************************************************/
+
+int
+as_arraylist_sort(as_arraylist* list, uint32_t flags)
+{
+	return sort_list(list, flags, NULL);
+}
+
+int
+as_arraylist_sort_parallel(as_arraylist* list, uint32_t flags,
+		as_thread_pool* pool)
+{
+	return sort_list(list, flags, pool);
+}
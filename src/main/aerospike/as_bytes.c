@@ -15,6 +15,7 @@
  * the License.
  */
 #include <aerospike/as_bytes.h>
+#include <aerospike/as_slab.h>
 #include <citrusleaf/alloc.h>
 #include <string.h>
 
@@ -102,9 +103,9 @@ as_bytes * as_bytes_init_wrap(as_bytes * bytes, uint8_t * value, uint32_t size,
  */
 as_bytes * as_bytes_new(uint32_t capacity)
 {
-    as_bytes * bytes = (as_bytes *) cf_malloc(sizeof(as_bytes));
+    as_bytes * bytes = (as_bytes *) as_slab_alloc(sizeof(as_bytes));
     if ( !bytes ) return bytes;
-	return as_bytes_cons(bytes, true, capacity, 0, NULL, true, AS_BYTES_BLOB);
+	return (as_bytes *) as_slab_val((as_val *) as_bytes_cons(bytes, true, capacity, 0, NULL, true, AS_BYTES_BLOB));
 }
 
 /**
@@ -124,9 +125,9 @@ as_bytes * as_bytes_new(uint32_t capacity)
  */
 as_bytes * as_bytes_new_wrap(uint8_t * value, uint32_t size, bool free)
 {
-    as_bytes * bytes = (as_bytes *) cf_malloc(sizeof(as_bytes));
+    as_bytes * bytes = (as_bytes *) as_slab_alloc(sizeof(as_bytes));
     if ( !bytes ) return bytes;
-	return as_bytes_cons(bytes, true, size, size, value, free, AS_BYTES_BLOB);
+	return (as_bytes *) as_slab_val((as_val *) as_bytes_cons(bytes, true, size, size, value, free, AS_BYTES_BLOB));
 }
 
 /******************************************************************************
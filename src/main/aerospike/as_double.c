@@ -15,6 +15,7 @@
  * the License.
  */
 #include <aerospike/as_double.h>
+#include <aerospike/as_slab.h>
 #include <citrusleaf/alloc.h>
 #include <stdio.h>
 
@@ -43,8 +44,8 @@ as_double_init(as_double* value_ptr, double value)
 as_double*
 as_double_new(double value)
 {
-	as_double* value_ptr = (as_double*) cf_malloc(sizeof(as_double));
-	return as_double_cons(value_ptr, true, value);
+	as_double* value_ptr = (as_double*) as_slab_alloc(sizeof(as_double));
+	return (as_double*) as_slab_val((as_val*) as_double_cons(value_ptr, true, value));
 }
 
 /******************************************************************************
@@ -0,0 +1,237 @@
+/*
+ * Copyright 2026 Aerospike, Inc.
+ *
+ * Portions may be licensed to Aerospike, Inc. under one or more contributor
+ * license agreements.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+#include <aerospike/as_eventcount.h>
+#include <aerospike/as_arch.h>
+#include <sched.h>
+
+#if defined(__linux__)
+#include <errno.h>
+#include <limits.h>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#define NS_PER_SEC (1000 * 1000 * 1000ULL)
+
+/******************************************************************************
+ * STATIC FUNCTIONS
+ *****************************************************************************/
+
+static inline void
+as_eventcount_pause(uint32_t i)
+{
+	// Let other threads in now and then, in case the notifier shares our CPU.
+	if ((i & 15) == 15) {
+		sched_yield();
+	}
+	else {
+#if defined(as_arch_pause)
+		as_arch_pause();
+#endif
+	}
+}
+
+static bool
+as_eventcount_spin(as_eventcount* ec, as_eventcount_ready_fn ready, void* udata)
+{
+	uint32_t spin = as_load_uint32(&ec->spin);
+
+	if (spin == 0) {
+		return false;
+	}
+
+	uint32_t limit = as_load_uint32(&ec->spin_limit);
+	uint32_t floor = spin >> 4 != 0 ? spin >> 4 : 1;
+
+	for (uint32_t i = 0; i < limit; i++) {
+		if (ready(udata)) {
+			limit = limit * 2 < spin ? limit * 2 : spin;
+			as_store_uint32(&ec->spin_limit, limit);
+			return true;
+		}
+
+		as_eventcount_pause(i);
+	}
+
+	limit = limit / 2 > floor ? limit / 2 : floor;
+	as_store_uint32(&ec->spin_limit, limit);
+	return false;
+}
+
+/******************************************************************************
+ * FUNCTIONS
+ *****************************************************************************/
+
+void
+as_eventcount_init(as_eventcount* ec, uint32_t spin)
+{
+	ec->epoch = 0;
+	ec->waiters = 0;
+	ec->spin = spin;
+	ec->spin_limit = spin;
+	ec->wakes = 0;
+	ec->parks = 0;
+
+#if defined(__APPLE__) || defined(_MSC_VER)
+	pthread_mutex_init(&ec->lock, NULL);
+	pthread_cond_init(&ec->cond, NULL);
+#elif !defined(__linux__)
+	// Time the condvar on the same clock as cf_getns().
+	pthread_condattr_t attr;
+
+	pthread_condattr_init(&attr);
+	pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+	pthread_mutex_init(&ec->lock, NULL);
+	pthread_cond_init(&ec->cond, &attr);
+	pthread_condattr_destroy(&attr);
+#endif
+}
+
+void
+as_eventcount_destroy(as_eventcount* ec)
+{
+#if !defined(__linux__)
+	pthread_cond_destroy(&ec->cond);
+	pthread_mutex_destroy(&ec->lock);
+#else
+	(void)ec;
+#endif
+}
+
+bool
+as_eventcount_park(as_eventcount* ec, uint32_t key, uint64_t deadline)
+{
+	bool timed_out = false;
+
+	as_incr_uint64(&ec->parks);
+
+#if defined(__linux__)
+	// An absolute CLOCK_MONOTONIC timeout - the clock cf_getns() reads - so
+	// spurious wakeups don't restart the wait. Returns at once if the epoch
+	// already moved.
+	struct timespec ts = {
+		.tv_sec = (time_t)(deadline / NS_PER_SEC),
+		.tv_nsec = (long)(deadline % NS_PER_SEC)
+	};
+
+	if (syscall(SYS_futex, &ec->epoch, FUTEX_WAIT_BITSET_PRIVATE, key,
+			deadline == AS_EVENTCOUNT_FOREVER ? NULL : &ts, NULL,
+			FUTEX_BITSET_MATCH_ANY) != 0) {
+		timed_out = errno == ETIMEDOUT;
+	}
+#else
+	pthread_mutex_lock(&ec->lock);
+
+	while (ec->epoch == key && ! timed_out) {
+		if (deadline == AS_EVENTCOUNT_FOREVER) {
+			pthread_cond_wait(&ec->cond, &ec->lock);
+			continue;
+		}
+
+		uint64_t now = cf_getns();
+
+		if (now >= deadline) {
+			timed_out = true;
+			break;
+		}
+
+#if defined(__APPLE__)
+		// A relative wait, which no wall clock step can stretch.
+		struct timespec ts = {
+			.tv_sec = (time_t)((deadline - now) / NS_PER_SEC),
+			.tv_nsec = (long)((deadline - now) % NS_PER_SEC)
+		};
+
+		pthread_cond_timedwait_relative_np(&ec->cond, &ec->lock, &ts);
+#elif defined(_MSC_VER)
+		// Only a wall clock wait is available - convert the time remaining,
+		// which is recomputed from the monotonic deadline on each pass.
+		struct timespec delta = {
+			.tv_sec = (time_t)((deadline - now) / NS_PER_SEC),
+			.tv_nsec = (long)((deadline - now) % NS_PER_SEC)
+		};
+		struct timespec ts;
+
+		cf_clock_current_add(&delta, &ts);
+		pthread_cond_timedwait(&ec->cond, &ec->lock, &ts);
+#else
+		struct timespec ts = {
+			.tv_sec = (time_t)(deadline / NS_PER_SEC),
+			.tv_nsec = (long)(deadline % NS_PER_SEC)
+		};
+
+		pthread_cond_timedwait(&ec->cond, &ec->lock, &ts);
+#endif
+	}
+
+	pthread_mutex_unlock(&ec->lock);
+#endif
+
+	as_decr_uint32(&ec->waiters);
+	return ! timed_out;
+}
+
+void
+as_eventcount_wake(as_eventcount* ec, uint32_t n)
+{
+	as_incr_uint64(&ec->wakes);
+
+#if defined(__linux__)
+	as_incr_uint32(&ec->epoch);
+	syscall(SYS_futex, &ec->epoch, FUTEX_WAKE_PRIVATE,
+			n > INT_MAX ? INT_MAX : (int)n, NULL, NULL, 0);
+#else
+	pthread_mutex_lock(&ec->lock);
+	ec->epoch++;
+
+	if (n == 1) {
+		pthread_cond_signal(&ec->cond);
+	}
+	else {
+		pthread_cond_broadcast(&ec->cond);
+	}
+
+	pthread_mutex_unlock(&ec->lock);
+#endif
+}
+
+bool
+as_eventcount_await(as_eventcount* ec, as_eventcount_ready_fn ready, void* udata,
+	uint64_t deadline)
+{
+	if (as_eventcount_spin(ec, ready, udata)) {
+		return true;
+	}
+
+	while (true) {
+		uint32_t key = as_eventcount_prepare(ec);
+
+		if (ready(udata)) {
+			as_eventcount_cancel(ec);
+			return true;
+		}
+
+		if (! as_eventcount_park(ec, key, deadline)) {
+			return ready(udata);
+		}
+
+		if (ready(udata)) {
+			return true;
+		}
+	}
+}
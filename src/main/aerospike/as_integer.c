@@ -15,10 +15,26 @@
  * the License.
  */
 #include <aerospike/as_integer.h>
+#include <aerospike/as_slab.h>
 #include <citrusleaf/alloc.h>
 #include <stdio.h>
 #include <string.h>
 
+/******************************************************************************
+ *	CONSTANTS
+ *****************************************************************************/
+
+#define CACHED(_v) { ._ = { .type = AS_INTEGER, .free = false, .count = 0 }, .value = (_v) }
+#define CACHED_4(_v) CACHED(_v), CACHED(_v + 1), CACHED(_v + 2), CACHED(_v + 3)
+#define CACHED_16(_v) CACHED_4(_v), CACHED_4(_v + 4), CACHED_4(_v + 8), CACHED_4(_v + 12)
+#define CACHED_64(_v) CACHED_16(_v), CACHED_16(_v + 16), CACHED_16(_v + 32), CACHED_16(_v + 48)
+#define CACHED_256(_v) CACHED_64(_v), CACHED_64(_v + 64), CACHED_64(_v + 128), CACHED_64(_v + 192)
+
+const as_integer as_integer_cache[AS_INTEGER_CACHE_MAX - AS_INTEGER_CACHE_MIN + 1] = {
+	CACHED_64(-128), CACHED_64(-64),
+	CACHED_256(0), CACHED_256(256), CACHED_256(512), CACHED_256(768)
+};
+
 /******************************************************************************
  *	INSTANCE FUNCTIONS
  ******************************************************************************/
@@ -39,8 +55,8 @@ as_integer * as_integer_init(as_integer * integer, int64_t value)
 
 as_integer * as_integer_new(int64_t value)
 {
-	as_integer * integer = (as_integer *) cf_malloc(sizeof(as_integer));
-	return as_integer_cons(integer, true, value);
+	as_integer * integer = (as_integer *) as_slab_alloc(sizeof(as_integer));
+	return (as_integer *) as_slab_val((as_val *) as_integer_cons(integer, true, value));
 }
 
 /******************************************************************************
@@ -41,3 +41,18 @@ void as_iterator_destroy(as_iterator * iterator)
     	cf_free(iterator);
     }
 }
+
+uint32_t as_iterator_next_n(as_iterator * iterator, const as_val ** values, uint32_t n)
+{
+	if ( iterator->hooks && iterator->hooks->next_n ) {
+		return iterator->hooks->next_n(iterator, values, n);
+	}
+
+	uint32_t count = 0;
+
+	while ( count < n && as_iterator_has_next(iterator) ) {
+		values[count++] = as_iterator_next(iterator);
+	}
+
+	return count;
+}
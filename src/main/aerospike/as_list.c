@@ -14,6 +14,7 @@
  * License for the specific language governing permissions and limitations under
  * the License.
  */
+#include <aerospike/as_atomic.h>
 #include <aerospike/as_iterator.h>
 #include <aerospike/as_list.h>
 #include <aerospike/as_list_iterator.h>
@@ -58,6 +59,29 @@ as_list * as_list_new(const as_list_hooks * hooks)
 	return as_list_cons(list, true, hooks);
 }
 
+/******************************************************************************
+ *	COPY FUNCTIONS
+ *****************************************************************************/
+
+as_val * as_list_unshare(as_list * list, uint32_t index)
+{
+	as_val * v = as_list_get(list, index);
+
+	if ( !v || as_load_uint32(&v->count) <= 1 ) return v;
+
+	as_val * c = as_val_clone_cow(v);
+
+	if ( !c ) return NULL;
+
+	if ( as_list_set(list, index, c) != 0 ) {
+		as_val_destroy(c);
+		return NULL;
+	}
+
+	// Re-read - a list may store the value in another form.
+	return as_list_get(list, index);
+}
+
 /******************************************************************************
  *	as_val FUNCTIONS
  *****************************************************************************/
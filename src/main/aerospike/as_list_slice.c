@@ -0,0 +1,660 @@
+/*
+ * Copyright 2026 Aerospike, Inc.
+ *
+ * Portions may be licensed to Aerospike, Inc. under one or more contributor
+ * license agreements.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include <aerospike/as_list_slice.h>
+
+#include <aerospike/as_arraylist.h>
+#include <aerospike/as_iterator.h>
+#include <aerospike/as_list.h>
+#include <aerospike/as_list_iterator.h>
+#include <aerospike/as_std.h>
+#include <aerospike/as_string.h>
+#include <aerospike/as_val.h>
+#include <citrusleaf/alloc.h>
+
+/******************************************************************************
+ *	TYPES
+ ******************************************************************************/
+
+static const as_list_hooks as_list_slice_list_hooks;
+static const as_iterator_hooks as_list_slice_iterator_hooks;
+
+/******************************************************************************
+ *	STATIC FUNCTIONS
+ ******************************************************************************/
+
+static as_list_slice*
+as_list_slice_cons(as_list_slice* slice, const as_list* list, uint32_t offset,
+		uint32_t count)
+{
+	// View the original list rather than chaining slices.
+	if (list->hooks == &as_list_slice_list_hooks) {
+		const as_list_slice* parent = (const as_list_slice*)list;
+
+		if (parent->copy != NULL) {
+			list = (const as_list*)parent->copy;
+		}
+		else {
+			uint32_t size = parent->size;
+
+			offset = offset < size ? offset : size;
+			count = count < size - offset ? count : size - offset;
+			offset += parent->offset;
+			list = parent->parent;
+		}
+	}
+
+	uint32_t size = as_list_size(list);
+
+	offset = offset < size ? offset : size;
+
+	slice->parent = list;
+	slice->offset = offset;
+	slice->size = count < size - offset ? count : size - offset;
+	slice->copy = NULL;
+
+	// The slice may be handed to other threads, and reserves elements when it
+	// copies on write, so the parent and its elements must all be counted
+	// atomically.
+	if (list->_.local) {
+		as_val_share((as_val*)list);
+	}
+
+	as_val_reserve(list);
+
+	return slice;
+}
+
+static bool
+as_list_slice_release(as_list_slice* slice)
+{
+	if (slice->parent != NULL) {
+		as_val_destroy((as_val*)slice->parent);
+		slice->parent = NULL;
+	}
+
+	if (slice->copy != NULL) {
+		as_arraylist_destroy(slice->copy);
+		slice->copy = NULL;
+	}
+
+	slice->offset = 0;
+	slice->size = 0;
+
+	return true;
+}
+
+// Copy the range so the slice can be modified independently of the parent.
+static as_arraylist*
+slice_copy(as_list_slice* slice)
+{
+	if (slice->copy != NULL) {
+		return slice->copy;
+	}
+
+	as_arraylist* copy = as_arraylist_new(slice->size,
+			slice->size < 8 ? 8 : slice->size);
+
+	if (copy == NULL) {
+		return NULL;
+	}
+
+	for (uint32_t i = 0; i < slice->size; i++) {
+		as_val* v = as_list_get(slice->parent, slice->offset + i);
+
+		as_val_reserve(v);
+		copy->elements[i] = v;
+	}
+
+	copy->size = slice->size;
+
+	as_val_destroy((as_val*)slice->parent);
+	slice->parent = NULL;
+	slice->offset = 0;
+	slice->size = 0;
+	slice->copy = copy;
+
+	return copy;
+}
+
+/*******************************************************************************
+ *	INSTANCE FUNCTIONS
+ ******************************************************************************/
+
+as_list_slice*
+as_list_slice_init(as_list_slice* slice, const as_list* list, uint32_t offset,
+		uint32_t count)
+{
+	if (slice == NULL || list == NULL) {
+		return NULL;
+	}
+
+	as_list_cons((as_list*)slice, false, &as_list_slice_list_hooks);
+
+	return as_list_slice_cons(slice, list, offset, count);
+}
+
+as_list_slice*
+as_list_slice_new(const as_list* list, uint32_t offset, uint32_t count)
+{
+	if (list == NULL) {
+		return NULL;
+	}
+
+	as_list_slice* slice = (as_list_slice*)cf_malloc(sizeof(as_list_slice));
+
+	if (slice == NULL) {
+		return NULL;
+	}
+
+	as_list_cons((as_list*)slice, true, &as_list_slice_list_hooks);
+
+	return as_list_slice_cons(slice, list, offset, count);
+}
+
+void
+as_list_slice_destroy(as_list_slice* slice)
+{
+	as_list_destroy((as_list*)slice);
+}
+
+as_val*
+as_list_slice_get(const as_list_slice* slice, uint32_t index)
+{
+	if (slice->copy != NULL) {
+		return as_arraylist_get(slice->copy, index);
+	}
+
+	return index < slice->size ?
+			as_list_get(slice->parent, slice->offset + index) : NULL;
+}
+
+/*******************************************************************************
+ *	ITERATION FUNCTIONS
+ ******************************************************************************/
+
+bool
+as_list_slice_foreach(const as_list_slice* slice,
+		as_list_foreach_callback callback, void* udata)
+{
+	if (slice->copy != NULL) {
+		return as_arraylist_foreach(slice->copy, callback, udata);
+	}
+
+	for (uint32_t i = 0; i < slice->size; i++) {
+		if (! callback(as_list_get(slice->parent, slice->offset + i), udata)) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+as_list_slice_iterator*
+as_list_slice_iterator_init(as_list_slice_iterator* it,
+		const as_list_slice* slice)
+{
+	if (it == NULL) {
+		return NULL;
+	}
+
+	as_iterator_init((as_iterator*)it, false, NULL,
+			&as_list_slice_iterator_hooks);
+	it->slice = slice;
+	it->pos = 0;
+
+	return it;
+}
+
+as_list_slice_iterator*
+as_list_slice_iterator_new(const as_list_slice* slice)
+{
+	as_list_slice_iterator* it = (as_list_slice_iterator*)
+			cf_malloc(sizeof(as_list_slice_iterator));
+
+	if (it == NULL) {
+		return NULL;
+	}
+
+	as_iterator_init((as_iterator*)it, true, NULL,
+			&as_list_slice_iterator_hooks);
+	it->slice = slice;
+	it->pos = 0;
+
+	return it;
+}
+
+bool
+as_list_slice_iterator_has_next(const as_list_slice_iterator* it)
+{
+	return it->pos < as_list_slice_size(it->slice);
+}
+
+const as_val*
+as_list_slice_iterator_next(as_list_slice_iterator* it)
+{
+	if (it->pos >= as_list_slice_size(it->slice)) {
+		return NULL;
+	}
+
+	return as_list_slice_get(it->slice, it->pos++);
+}
+
+/*******************************************************************************
+ *	HOOKS
+ ******************************************************************************/
+
+static bool
+_list_destroy(as_list* l)
+{
+	return as_list_slice_release((as_list_slice*)l);
+}
+
+static uint32_t
+_list_hashcode(const as_list* l)
+{
+	return 0;
+}
+
+static uint32_t
+_list_size(const as_list* l)
+{
+	return as_list_slice_size((const as_list_slice*)l);
+}
+
+static void
+_list_memory(const as_list* l, as_val_memory* mem, bool shared)
+{
+	const as_list_slice* slice = (const as_list_slice*)l;
+
+	if (l->_.free) {
+		as_val_memory_bytes(mem, shared, sizeof(as_list_slice));
+	}
+
+	// The parent is counted whole - it's kept alive by the slice.
+	as_val_memory_add((const as_val*)slice->parent, mem, shared);
+	as_val_memory_add((const as_val*)slice->copy, mem, shared);
+}
+
+static as_val*
+_list_get(const as_list* l, uint32_t i)
+{
+	return as_list_slice_get((const as_list_slice*)l, i);
+}
+
+static int64_t
+_list_get_int64(const as_list* l, uint32_t i)
+{
+	const as_list_slice* slice = (const as_list_slice*)l;
+
+	if (slice->copy != NULL) {
+		return as_arraylist_get_int64(slice->copy, i);
+	}
+
+	return i < slice->size ?
+			as_list_get_int64(slice->parent, slice->offset + i) : 0;
+}
+
+static double
+_list_get_double(const as_list* l, uint32_t i)
+{
+	const as_list_slice* slice = (const as_list_slice*)l;
+
+	if (slice->copy != NULL) {
+		return as_arraylist_get_double(slice->copy, i);
+	}
+
+	return i < slice->size ?
+			as_list_get_double(slice->parent, slice->offset + i) : 0.0;
+}
+
+static char*
+_list_get_str(const as_list* l, uint32_t i)
+{
+	const as_list_slice* slice = (const as_list_slice*)l;
+
+	if (slice->copy != NULL) {
+		return as_arraylist_get_str(slice->copy, i);
+	}
+
+	return i < slice->size ?
+			as_list_get_str(slice->parent, slice->offset + i) : NULL;
+}
+
+static int
+_list_set(as_list* l, uint32_t i, as_val* v)
+{
+	as_arraylist* copy = slice_copy((as_list_slice*)l);
+
+	return copy ? as_arraylist_set(copy, i, v) : AS_ARRAYLIST_ERR_ALLOC;
+}
+
+static int
+_list_set_int64(as_list* l, uint32_t i, int64_t v)
+{
+	as_arraylist* copy = slice_copy((as_list_slice*)l);
+
+	return copy ? as_arraylist_set_int64(copy, i, v) : AS_ARRAYLIST_ERR_ALLOC;
+}
+
+static int
+_list_set_double(as_list* l, uint32_t i, double v)
+{
+	as_arraylist* copy = slice_copy((as_list_slice*)l);
+
+	return copy ? as_arraylist_set_double(copy, i, v) : AS_ARRAYLIST_ERR_ALLOC;
+}
+
+static int
+_list_set_str(as_list* l, uint32_t i, const char* v)
+{
+	as_arraylist* copy = slice_copy((as_list_slice*)l);
+
+	return copy ? as_arraylist_set_str(copy, i, v) : AS_ARRAYLIST_ERR_ALLOC;
+}
+
+static int
+_list_insert(as_list* l, uint32_t i, as_val* v)
+{
+	as_arraylist* copy = slice_copy((as_list_slice*)l);
+
+	return copy ? as_arraylist_insert(copy, i, v) : AS_ARRAYLIST_ERR_ALLOC;
+}
+
+static int
+_list_insert_int64(as_list* l, uint32_t i, int64_t v)
+{
+	as_arraylist* copy = slice_copy((as_list_slice*)l);
+
+	return copy ? as_arraylist_insert_int64(copy, i, v) :
+			AS_ARRAYLIST_ERR_ALLOC;
+}
+
+static int
+_list_insert_double(as_list* l, uint32_t i, double v)
+{
+	as_arraylist* copy = slice_copy((as_list_slice*)l);
+
+	return copy ? as_arraylist_insert_double(copy, i, v) :
+			AS_ARRAYLIST_ERR_ALLOC;
+}
+
+static int
+_list_insert_str(as_list* l, uint32_t i, const char* v)
+{
+	as_arraylist* copy = slice_copy((as_list_slice*)l);
+
+	return copy ? as_arraylist_insert_str(copy, i, v) : AS_ARRAYLIST_ERR_ALLOC;
+}
+
+static int
+_list_append(as_list* l, as_val* v)
+{
+	return _list_insert(l, as_list_slice_size((as_list_slice*)l), v);
+}
+
+static int
+_list_append_int64(as_list* l, int64_t v)
+{
+	return _list_insert_int64(l, as_list_slice_size((as_list_slice*)l), v);
+}
+
+static int
+_list_append_double(as_list* l, double v)
+{
+	return _list_insert_double(l, as_list_slice_size((as_list_slice*)l), v);
+}
+
+static int
+_list_append_str(as_list* l, const char* v)
+{
+	return _list_insert_str(l, as_list_slice_size((as_list_slice*)l), v);
+}
+
+static int
+_list_prepend(as_list* l, as_val* v)
+{
+	return _list_insert(l, 0, v);
+}
+
+static int
+_list_prepend_int64(as_list* l, int64_t v)
+{
+	return _list_insert_int64(l, 0, v);
+}
+
+static int
+_list_prepend_double(as_list* l, double v)
+{
+	return _list_insert_double(l, 0, v);
+}
+
+static int
+_list_prepend_str(as_list* l, const char* v)
+{
+	return _list_insert_str(l, 0, v);
+}
+
+static int
+_list_remove(as_list* l, uint32_t i)
+{
+	as_list_slice* slice = (as_list_slice*)l;
+
+	if (slice->copy == NULL && i < slice->size) {
+		if (i == 0) {
+			slice->offset++;
+			slice->size--;
+			return AS_ARRAYLIST_OK;
+		}
+
+		if (i == slice->size - 1) {
+			slice->size--;
+			return AS_ARRAYLIST_OK;
+		}
+	}
+
+	as_arraylist* copy = slice_copy(slice);
+
+	return copy ? as_arraylist_remove(copy, i) : AS_ARRAYLIST_ERR_ALLOC;
+}
+
+static int
+_list_concat(as_list* l, const as_list* l2)
+{
+	as_arraylist* copy = slice_copy((as_list_slice*)l);
+
+	return copy ? as_list_concat((as_list*)copy, l2) : AS_ARRAYLIST_ERR_ALLOC;
+}
+
+static int
+_list_trim(as_list* l, uint32_t i)
+{
+	as_list_slice* slice = (as_list_slice*)l;
+
+	if (slice->copy != NULL) {
+		return as_arraylist_trim(slice->copy, i);
+	}
+
+	if (i >= slice->size) {
+		return AS_ARRAYLIST_ERR_INDEX;
+	}
+
+	slice->size = i;
+
+	return AS_ARRAYLIST_OK;
+}
+
+static as_val*
+_list_head(const as_list* l)
+{
+	return as_list_slice_get((const as_list_slice*)l, 0);
+}
+
+static as_list*
+_list_drop(const as_list* l, uint32_t n)
+{
+	return (as_list*)as_list_slice_drop(l, n);
+}
+
+static as_list*
+_list_tail(const as_list* l)
+{
+	return (as_list*)as_list_slice_tail(l);
+}
+
+static as_list*
+_list_take(const as_list* l, uint32_t n)
+{
+	return (as_list*)as_list_slice_take(l, n);
+}
+
+static bool
+_list_foreach(const as_list* l, as_list_foreach_callback callback,
+		void* udata)
+{
+	return as_list_slice_foreach((const as_list_slice*)l, callback, udata);
+}
+
+static as_list_iterator*
+_list_iterator_new(const as_list* l)
+{
+	return (as_list_iterator*)as_list_slice_iterator_new(
+			(const as_list_slice*)l);
+}
+
+static as_list_iterator*
+_list_iterator_init(const as_list* l, as_list_iterator* it)
+{
+	return (as_list_iterator*)as_list_slice_iterator_init(
+			(as_list_slice_iterator*)it, (const as_list_slice*)l);
+}
+
+static const as_list_hooks as_list_slice_list_hooks = {
+
+	/***************************************************************************
+	 *	instance hooks
+	 **************************************************************************/
+
+	.destroy		= _list_destroy,
+
+	/***************************************************************************
+	 *	info hooks
+	 **************************************************************************/
+
+	.hashcode		= _list_hashcode,
+	.size			= _list_size,
+
+	/***************************************************************************
+	 *	get hooks
+	 **************************************************************************/
+
+	.get			= _list_get,
+	.get_int64		= _list_get_int64,
+	.get_double		= _list_get_double,
+	.get_str		= _list_get_str,
+
+	/***************************************************************************
+	 *	set hooks
+	 **************************************************************************/
+
+	.set			= _list_set,
+	.set_int64		= _list_set_int64,
+	.set_double		= _list_set_double,
+	.set_str		= _list_set_str,
+
+	/***************************************************************************
+	 *	insert hooks
+	 **************************************************************************/
+
+	.insert			= _list_insert,
+	.insert_int64	= _list_insert_int64,
+	.insert_double	= _list_insert_double,
+	.insert_str		= _list_insert_str,
+
+	/***************************************************************************
+	 *	append hooks
+	 **************************************************************************/
+
+	.append			= _list_append,
+	.append_int64	= _list_append_int64,
+	.append_double	= _list_append_double,
+	.append_str		= _list_append_str,
+
+	/***************************************************************************
+	 *	prepend hooks
+	 **************************************************************************/
+
+	.prepend		= _list_prepend,
+	.prepend_int64	= _list_prepend_int64,
+	.prepend_double	= _list_prepend_double,
+	.prepend_str	= _list_prepend_str,
+
+	/***************************************************************************
+	 *	remove hook
+	 **************************************************************************/
+
+	.remove			= _list_remove,
+
+	/***************************************************************************
+	 *	accessor and modifier hooks
+	 **************************************************************************/
+
+	.concat			= _list_concat,
+	.trim			= _list_trim,
+	.head			= _list_head,
+	.tail			= _list_tail,
+	.drop			= _list_drop,
+	.take			= _list_take,
+
+	/***************************************************************************
+	 *	iteration hooks
+	 **************************************************************************/
+
+	.foreach		= _list_foreach,
+	.iterator_new	= _list_iterator_new,
+	.iterator_init	= _list_iterator_init,
+
+	/***************************************************************************
+	 *	memory hooks
+	 **************************************************************************/
+
+	.memory			= _list_memory,
+};
+
+static bool
+_iterator_destroy(as_iterator* it)
+{
+	return true;
+}
+
+static bool
+_iterator_has_next(const as_iterator* it)
+{
+	return as_list_slice_iterator_has_next((const as_list_slice_iterator*)it);
+}
+
+static const as_val*
+_iterator_next(as_iterator* it)
+{
+	return as_list_slice_iterator_next((as_list_slice_iterator*)it);
+}
+
+static const as_iterator_hooks as_list_slice_iterator_hooks = {
+	.destroy    = _iterator_destroy,
+	.has_next   = _iterator_has_next,
+	.next       = _iterator_next
+};
@@ -15,6 +15,7 @@
  * the License.
  */
 #include <aerospike/as_map.h>
+#include <aerospike/as_atomic.h>
 #include <aerospike/as_iterator.h>
 #include <aerospike/as_map_iterator.h>
 #include <aerospike/as_pair.h>
@@ -46,6 +47,32 @@ as_map* as_map_new(const as_map_hooks* hooks)
 	return as_map_cons(map, true, 0, hooks);
 }
 
+as_val* as_map_unshare(as_map* map, const as_val* key)
+{
+	as_val* v = as_map_get(map, key);
+
+	if (! v || as_load_uint32(&v->count) <= 1) {
+		return v;
+	}
+
+	as_val* c = as_val_clone_cow(v);
+
+	if (! c) {
+		return NULL;
+	}
+
+	// The map keeps the key it is given, so give it a copy of the caller's.
+	as_val* k = as_val_clone(key);
+
+	if (! k || as_map_set(map, k, c) != 0) {
+		as_val_destroy(k);
+		as_val_destroy(c);
+		return NULL;
+	}
+
+	return as_map_get(map, key);
+}
+
 /******************************************************************************
  * as_val FUNCTIONS
  ******************************************************************************/
@@ -120,6 +147,25 @@ static bool as_map_val_tostring_foreach(const as_val* key, const as_val* val, vo
 	return true;
 }
 
+uint32_t as_map_iterator_next_n(as_iterator* iterator, const as_val** keys, const as_val** values, uint32_t n)
+{
+	if ( iterator->hooks && iterator->hooks->next_entries ) {
+		return iterator->hooks->next_entries(iterator, keys, values, n);
+	}
+
+	uint32_t count = 0;
+
+	while ( count < n && as_iterator_has_next(iterator) ) {
+		const as_pair* pair = (const as_pair*) as_iterator_next(iterator);
+
+		keys[count] = as_pair_1((as_pair*) pair);
+		values[count] = as_pair_2((as_pair*) pair);
+		count++;
+	}
+
+	return count;
+}
+
 char * as_map_val_tostring(const as_val* v)
 {
 	as_map_val_tostring_data data = {
@@ -136,7 +182,25 @@ char * as_map_val_tostring(const as_val* v)
 	data.pos += 1;
 	
 	if ( v ) {
-		as_map_foreach((as_map*) v, as_map_val_tostring_foreach, &data);
+		as_map_iterator it;
+
+		if ( as_map_iterator_init(&it, (as_map*) v) ) {
+			const as_val* keys[32];
+			const as_val* vals[32];
+			uint32_t n;
+			bool ok = true;
+
+			while ( ok && (n = as_map_iterator_next_n((as_iterator*) &it, keys, vals, 32)) != 0 ) {
+				for ( uint32_t i = 0; ok && i < n; i++ ) {
+					ok = as_map_val_tostring_foreach(keys[i], vals[i], &data);
+				}
+			}
+
+			as_iterator_destroy((as_iterator*) &it);
+		}
+		else {
+			as_map_foreach((as_map*) v, as_map_val_tostring_foreach, &data);
+		}
 	}
 
 	if ( data.pos + 2 >= data.cap ) {
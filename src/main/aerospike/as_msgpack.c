@@ -20,8 +20,11 @@
 #include <string.h>
 
 #include <aerospike/as_msgpack_ext.h>
+#include <aerospike/as_list_iterator.h>
+#include <aerospike/as_map_iterator.h>
 #include <aerospike/as_orderedmap.h>
 #include <aerospike/as_serializer.h>
+#include <aerospike/as_typedlist.h>
 #include <aerospike/as_types.h>
 #include <aerospike/as_vector.h>
 
@@ -39,6 +42,14 @@
 #define ASVAL_CMP_WILDCARD	0x00
 #define ASVAL_CMP_INF		0x01
 
+// unpack_val() modes
+#define UNPACK_LOCAL	0x1 // confine values to the unpacking thread
+#define UNPACK_TYPED	0x2 // unpack homogeneous numeric lists as as_typedlist
+#define UNPACK_CACHED	0x4 // box small integers from the integer cache
+
+// Elements read per as_iterator_next_n() call.
+#define ITER_BATCH 32
+
 typedef struct msgpack_parse_state_s {
 	uint32_t len1;
 	uint32_t len2;
@@ -110,6 +121,7 @@ static inline as_val_t bytes_internal_type_to_as_val_t(uint8_t type);
 static int64_t unpack_size_non_recursive(as_unpacker *pk, msgpack_parse_memblock *block, msgpack_parse_state *state);
 static inline int64_t unpack_size_internal(as_unpacker *pk, uint32_t depth);
 static inline const uint8_t *unpack_str_bin(as_unpacker *pk, uint32_t *sz_r);
+static int unpack_val(as_unpacker *pk, as_val **val, uint32_t mode);
 
 
 /******************************************************************************
@@ -580,11 +592,44 @@ pack_list(as_packer *pk, as_list *l)
 		rc = pack_type_uint32(pk, 0xdd, size, true);
 	}
 
-	if (rc == 0) {
-		rc = as_list_foreach(l, pack_list_foreach, pk) ? 0 : 1;
+	if (rc != 0) {
+		return rc;
 	}
 
-	return rc;
+	const as_typedlist *typed = as_typedlist_fromlist(l);
+
+	if (typed) {
+		for (uint32_t i = 0; i < size && rc == 0; i++) {
+			if (typed->type == AS_TYPEDLIST_INT64) {
+				rc = pack_int64(pk, typed->values.int64s[i], true);
+			}
+			else {
+				rc = pack_double(pk, typed->values.doubles[i], true);
+			}
+		}
+
+		return rc;
+	}
+
+	as_list_iterator it;
+
+	if (! as_list_iterator_init(&it, l)) {
+		return as_list_foreach(l, pack_list_foreach, pk) ? 0 : 1;
+	}
+
+	const as_val* batch[ITER_BATCH];
+	uint32_t n;
+
+	while (rc == 0 &&
+			(n = as_iterator_next_n((as_iterator*)&it, batch, ITER_BATCH)) != 0) {
+		for (uint32_t i = 0; i < n && rc == 0; i++) {
+			rc = as_pack_val(pk, (as_val*)batch[i]);
+		}
+	}
+
+	as_iterator_destroy((as_iterator*)&it);
+
+	return rc == 0 ? 0 : 1;
 }
 
 static bool
@@ -610,6 +655,20 @@ str_cmp(const char* v1, const char* v2)
 	return MSGPACK_COMPARE_EQUAL;
 }
 
+static inline msgpack_compare_t
+as_string_cmp(as_string* v1, as_string* v2)
+{
+	size_t len1 = as_string_len(v1);
+	size_t len2 = as_string_len(v2);
+	int c = memcmp(as_string_get(v1), as_string_get(v2),
+			len1 < len2 ? len1 : len2);
+
+	MSGPACK_COMPARE_RET_LESS_OR_GREATER(c, 0);
+	MSGPACK_COMPARE_RET_LESS_OR_GREATER(len1, len2);
+
+	return MSGPACK_COMPARE_EQUAL;
+}
+
 static inline msgpack_compare_t
 as_bytes_cmp(as_bytes* v1, as_bytes* v2)
 {
@@ -625,29 +684,80 @@ as_bytes_cmp(as_bytes* v1, as_bytes* v2)
 	return MSGPACK_COMPARE_EQUAL;
 }
 
+// Compare the first n elements. Sets *wildcard if a wildcard was reached,
+// which makes the lists equal regardless of size.
 static msgpack_compare_t
-as_list_cmp(const as_list* list1, const as_list* list2)
+list_cmp_elements(const as_list* list1, const as_list* list2, uint32_t n,
+		bool* wildcard)
 {
-	uint32_t s1 = as_list_size(list1);
-	uint32_t s2 = as_list_size(list2);
-	uint32_t min_sz = s1 < s2 ? s1 : s2;
+	as_list_iterator it1;
+	as_list_iterator it2;
+	bool iterate = as_list_iterator_init(&it1, list1) != NULL;
 
-	for (uint32_t i = 0; i < min_sz; i++) {
-		as_val* v1 = as_list_get(list1, i);
-		as_val* v2 = as_list_get(list2, i);
+	if (iterate && ! as_list_iterator_init(&it2, list2)) {
+		as_iterator_destroy((as_iterator*)&it1);
+		iterate = false;
+	}
+
+	const as_val* batch1[ITER_BATCH];
+	const as_val* batch2[ITER_BATCH];
+	msgpack_compare_t cmp = MSGPACK_COMPARE_EQUAL;
 
-		if (as_val_type(v1) == AS_CMP_WILDCARD ||
-				as_val_type(v2) == AS_CMP_WILDCARD) {
-			return MSGPACK_COMPARE_EQUAL;
+	for (uint32_t i = 0; i < n && cmp == MSGPACK_COMPARE_EQUAL;
+			i += ITER_BATCH) {
+		uint32_t count = n - i < ITER_BATCH ? n - i : ITER_BATCH;
+
+		if (iterate) {
+			as_iterator_next_n((as_iterator*)&it1, batch1, count);
+			as_iterator_next_n((as_iterator*)&it2, batch2, count);
+		}
+		else {
+			for (uint32_t j = 0; j < count; j++) {
+				batch1[j] = as_list_get(list1, i + j);
+				batch2[j] = as_list_get(list2, i + j);
+			}
 		}
 
-		msgpack_compare_t cmp = as_val_cmp(v1, v2);
+		for (uint32_t j = 0; j < count; j++) {
+			if (as_val_type(batch1[j]) == AS_CMP_WILDCARD ||
+					as_val_type(batch2[j]) == AS_CMP_WILDCARD) {
+				*wildcard = true;
+				break;
+			}
+
+			cmp = as_val_cmp(batch1[j], batch2[j]);
 
-		if (cmp != MSGPACK_COMPARE_EQUAL) {
-			return cmp;
+			if (cmp != MSGPACK_COMPARE_EQUAL) {
+				break;
+			}
+		}
+
+		if (*wildcard) {
+			break;
 		}
 	}
 
+	if (iterate) {
+		as_iterator_destroy((as_iterator*)&it1);
+		as_iterator_destroy((as_iterator*)&it2);
+	}
+
+	return cmp;
+}
+
+static msgpack_compare_t
+as_list_cmp(const as_list* list1, const as_list* list2)
+{
+	uint32_t s1 = as_list_size(list1);
+	uint32_t s2 = as_list_size(list2);
+	bool wildcard = false;
+	msgpack_compare_t cmp = list_cmp_elements(list1, list2,
+			s1 < s2 ? s1 : s2, &wildcard);
+
+	if (wildcard || cmp != MSGPACK_COMPARE_EQUAL) {
+		return cmp;
+	}
+
 	MSGPACK_COMPARE_RET_LESS_OR_GREATER(s1, s2);
 
 	return MSGPACK_COMPARE_EQUAL;
@@ -663,23 +773,38 @@ as_map_cmp(const as_map* map1, const as_map* map2)
 	MSGPACK_COMPARE_RET_LESS_OR_GREATER(size1, size2);
 
 	uint32_t sz = as_map_size(map1);
-	as_orderedmap_iterator it1;
-	as_orderedmap_iterator it2;
+	as_map_iterator it1;
+	as_map_iterator it2;
 
-	as_orderedmap_iterator_init(&it1, (const as_orderedmap*)map1);
-	as_orderedmap_iterator_init(&it2, (const as_orderedmap*)map2);
+	// Both maps iterate in key order - orderedmap or persistent map.
+	as_map_iterator_init(&it1, map1);
+	as_map_iterator_init(&it2, map2);
 
-	for (uint32_t i = 0; i < sz; i++) {
-		as_pair* p1 = (as_pair*)as_orderedmap_iterator_next(&it1);
-		as_pair* p2 = (as_pair*)as_orderedmap_iterator_next(&it2);
-		msgpack_compare_t cmp = as_val_cmp(as_pair_1(p1), as_pair_1(p2));
+	const as_val* keys1[ITER_BATCH];
+	const as_val* keys2[ITER_BATCH];
+	const as_val* vals[ITER_BATCH];
+	msgpack_compare_t cmp = MSGPACK_COMPARE_EQUAL;
 
-		if (cmp != MSGPACK_COMPARE_EQUAL) {
-			return cmp;
+	for (uint32_t i = 0; i < sz && cmp == MSGPACK_COMPARE_EQUAL;
+			i += ITER_BATCH) {
+		uint32_t n = sz - i < ITER_BATCH ? sz - i : ITER_BATCH;
+
+		as_map_iterator_next_n((as_iterator*)&it1, keys1, vals, n);
+		as_map_iterator_next_n((as_iterator*)&it2, keys2, vals, n);
+
+		for (uint32_t j = 0; j < n; j++) {
+			cmp = as_val_cmp(keys1[j], keys2[j]);
+
+			if (cmp != MSGPACK_COMPARE_EQUAL) {
+				break;
+			}
 		}
 	}
 
-	return MSGPACK_COMPARE_EQUAL;
+	as_iterator_destroy((as_iterator*)&it1);
+	as_iterator_destroy((as_iterator*)&it2);
+
+	return cmp;
 }
 
 msgpack_compare_t
@@ -712,8 +837,7 @@ as_val_cmp(const as_val* v1, const as_val* v2)
 				as_double_get((const as_double*)v2));
 		break;
 	case AS_STRING:
-		return str_cmp(as_string_get((const as_string*)v1),
-				as_string_get((const as_string*)v2));
+		return as_string_cmp((as_string*)v1, (as_string*)v2);
 	case AS_GEOJSON:
 		return str_cmp(as_geojson_get((const as_geojson*)v1),
 				as_geojson_get((const as_geojson*)v2));
@@ -926,14 +1050,19 @@ unpack_ext(as_unpacker *pk, uint8_t type, as_val **v)
 static inline int
 unpack_boolean(bool b, as_val **v)
 {
-	*v = (as_val *)as_boolean_new(b);
+	*v = (as_val *)(b ? &as_true : &as_false);
 	return 0;
 }
 
 static inline int
-unpack_integer_val(int64_t i, as_val **v)
+unpack_integer_val(int64_t i, as_val **v, uint32_t mode)
 {
-	*v = (as_val *)as_integer_new(i);
+	if ((mode & UNPACK_CACHED) != 0) {
+		*v = (as_val *)as_integer_new_cached(i);
+	}
+	else {
+		*v = (as_val *)as_integer_new(i);
+	}
 	return 0;
 }
 
@@ -955,8 +1084,8 @@ unpack_blob(as_unpacker *pk, uint32_t size, as_val **val)
 	}
 
 	if (type == AS_BYTES_STRING) {
-		char *v = cf_strndup((const char *)pk->buffer + pk->offset, size);
-		*val = (as_val*)as_string_new(v, true);
+		*val = (as_val*)as_string_new_strndup(
+				(const char *)pk->buffer + pk->offset, size);
 	}
 	else if (type == AS_BYTES_GEOJSON) {
 		char *v = cf_strndup((const char *)pk->buffer + pk->offset, size);
@@ -1001,8 +1130,50 @@ unpack_blob(as_unpacker *pk, uint32_t size, as_val **val)
 	return 0;
 }
 
+// Unpack straight into contiguous storage if every element is an integer, or
+// every element is a double. Otherwise leave the unpacker where it was.
 static int
-unpack_list(as_unpacker *pk, uint32_t size, as_val **val)
+unpack_typedlist(as_unpacker *pk, uint32_t size, as_val **val)
+{
+	as_val_t type = as_unpack_peek_type(pk);
+
+	if (type != AS_INTEGER && type != AS_DOUBLE) {
+		return -1;
+	}
+
+	uint32_t offset = pk->offset;
+	as_typedlist *list = as_typedlist_new(type == AS_INTEGER ?
+			AS_TYPEDLIST_INT64 : AS_TYPEDLIST_DOUBLE, size);
+
+	if (! list) {
+		return -2;
+	}
+
+	for (uint32_t i = 0; i < size; i++) {
+		int rc;
+
+		if (type == AS_INTEGER) {
+			rc = as_unpack_int64(pk, &list->values.int64s[i]);
+		}
+		else {
+			rc = as_unpack_double(pk, &list->values.doubles[i]);
+		}
+
+		if (rc != 0) {
+			as_typedlist_destroy(list);
+			pk->offset = offset;
+			return -3;
+		}
+	}
+
+	list->size = size;
+	*val = (as_val *)list;
+
+	return 0;
+}
+
+static int
+unpack_list(as_unpacker *pk, uint32_t size, as_val **val, uint32_t mode)
 {
 	uint8_t flags = 0;
 
@@ -1018,6 +1189,12 @@ unpack_list(as_unpacker *pk, uint32_t size, as_val **val)
 		size--;
 	}
 
+	if ((mode & UNPACK_TYPED) != 0 && size != 0 &&
+			unpack_typedlist(pk, size, val) == 0) {
+		((as_list *)*val)->flags = flags;
+		return 0;
+	}
+
 	as_arraylist *list = as_arraylist_new(size, 8);
 
 	if (! list) {
@@ -1027,7 +1204,7 @@ unpack_list(as_unpacker *pk, uint32_t size, as_val **val)
 	for (uint32_t i = 0; i < size; i++) {
 		as_val *v = NULL;
 
-		if (as_unpack_val(pk, &v) != 0 || ! v) {
+		if (unpack_val(pk, &v, mode) != 0 || ! v) {
 			as_arraylist_destroy(list);
 			return -3;
 		}
@@ -1042,7 +1219,8 @@ unpack_list(as_unpacker *pk, uint32_t size, as_val **val)
 }
 
 static int
-unpack_map_create_list(as_unpacker *pk, uint32_t size, as_val **val)
+unpack_map_create_list(as_unpacker *pk, uint32_t size, as_val **val,
+		uint32_t mode)
 {
 	// Create list of key value pairs.
 	as_arraylist *list = as_arraylist_new(2 * size, 2 * size);
@@ -1055,12 +1233,12 @@ unpack_map_create_list(as_unpacker *pk, uint32_t size, as_val **val)
 		as_val *k = NULL;
 		as_val *v = NULL;
 
-		if (as_unpack_val(pk, &k) != 0) {
+		if (unpack_val(pk, &k, mode) != 0) {
 			as_arraylist_destroy(list);
 			return -2;
 		}
 
-		if (as_unpack_val(pk, &v) != 0) {
+		if (unpack_val(pk, &v, mode) != 0) {
 			as_val_destroy(k);
 			as_arraylist_destroy(list);
 			return -3;
@@ -1083,7 +1261,7 @@ unpack_map_create_list(as_unpacker *pk, uint32_t size, as_val **val)
 
 static int
 unpack_orderedmap(as_unpacker* pk, uint32_t ele_count, as_val** val,
-		uint8_t flags)
+		uint8_t flags, uint32_t mode)
 {
 	as_orderedmap *map = as_orderedmap_new(ele_count);
 
@@ -1095,12 +1273,12 @@ unpack_orderedmap(as_unpacker* pk, uint32_t ele_count, as_val** val,
 		as_val* k = NULL;
 		as_val* v = NULL;
 
-		if (as_unpack_val(pk, &k) != 0) {
+		if (unpack_val(pk, &k, mode) != 0) {
 			as_orderedmap_destroy(map);
 			return -3;
 		}
 
-		if (as_unpack_val(pk, &v) != 0) {
+		if (unpack_val(pk, &v, mode) != 0) {
 			as_val_destroy(k);
 			as_orderedmap_destroy(map);
 			return -4;
@@ -1121,7 +1299,7 @@ unpack_orderedmap(as_unpacker* pk, uint32_t ele_count, as_val** val,
 }
 
 static int
-unpack_map(as_unpacker* pk, uint32_t ele_count, as_val** val)
+unpack_map(as_unpacker* pk, uint32_t ele_count, as_val** val, uint32_t mode)
 {
 	uint8_t flags = 0;
 
@@ -1139,14 +1317,14 @@ unpack_map(as_unpacker* pk, uint32_t ele_count, as_val** val)
 
 	// Check preserve order bit.
 	if ((flags & AS_PACKED_MAP_FLAG_PRESERVE_ORDER) != 0) {
-		return unpack_map_create_list(pk, ele_count, val);
+		return unpack_map_create_list(pk, ele_count, val, mode);
 	}
 
-	return unpack_orderedmap(pk, ele_count, val, flags);
+	return unpack_orderedmap(pk, ele_count, val, flags, mode);
 }
 
-int
-as_unpack_val(as_unpacker *pk, as_val **val)
+static int
+unpack_val_internal(as_unpacker *pk, as_val **val, uint32_t mode)
 {
 	if (as_unpack_peek_is_ext(pk)) {
 		as_unpack_size(pk);
@@ -1172,23 +1350,23 @@ as_unpack_val(as_unpacker *pk, as_val **val)
 
 	case 0xd0: // signed 8 bit integer
 		return unpack_integer_val((int64_t)(int8_t)pk->buffer[pk->offset++],
-				val);
+				val, mode);
 	case 0xcc: // unsigned 8 bit integer
-		return unpack_integer_val((int64_t)pk->buffer[pk->offset++], val);
+		return unpack_integer_val((int64_t)pk->buffer[pk->offset++], val, mode);
 
 	case 0xd1: // signed 16 bit integer
-		return unpack_integer_val((int64_t)(int16_t)extract_uint16(pk), val);
+		return unpack_integer_val((int64_t)(int16_t)extract_uint16(pk), val, mode);
 	case 0xcd: // unsigned 16 bit integer
-		return unpack_integer_val((int64_t)extract_uint16(pk), val);
+		return unpack_integer_val((int64_t)extract_uint16(pk), val, mode);
 
 	case 0xd2: // signed 32 bit integer
-		return unpack_integer_val((int64_t)(int32_t)extract_uint32(pk), val);
+		return unpack_integer_val((int64_t)(int32_t)extract_uint32(pk), val, mode);
 	case 0xce: // unsigned 32 bit integer
-		return unpack_integer_val((int64_t)extract_uint32(pk), val);
+		return unpack_integer_val((int64_t)extract_uint32(pk), val, mode);
 
 	case 0xd3: // signed 64 bit integer
 	case 0xcf: // unsigned 64 bit integer
-		return unpack_integer_val((int64_t)extract_uint64(pk), val);
+		return unpack_integer_val((int64_t)extract_uint64(pk), val, mode);
 
 	case 0xc4:
 	case 0xd9: // string/raw bytes with 8 bit header
@@ -1201,14 +1379,14 @@ as_unpack_val(as_unpacker *pk, as_val **val)
 		return unpack_blob(pk, extract_uint32(pk), val);
 
 	case 0xdc: // list with 16 bit header
-		return unpack_list(pk, (uint32_t)extract_uint16(pk), val);
+		return unpack_list(pk, (uint32_t)extract_uint16(pk), val, mode);
 	case 0xdd: // list with 32 bit header
-		return unpack_list(pk, extract_uint32(pk), val);
+		return unpack_list(pk, extract_uint32(pk), val, mode);
 
 	case 0xde: // map with 16 bit header
-		return unpack_map(pk, (uint32_t)extract_uint16(pk), val);
+		return unpack_map(pk, (uint32_t)extract_uint16(pk), val, mode);
 	case 0xdf: // map with 32 bit header
-		return unpack_map(pk, extract_uint32(pk), val);
+		return unpack_map(pk, extract_uint32(pk), val, mode);
 
 	case 0xd4: // fixext 1
 		return unpack_ext(pk, type, val);
@@ -1219,25 +1397,62 @@ as_unpack_val(as_unpacker *pk, as_val **val)
 		}
 
 		if ((type & 0xf0) == 0x80) { // map with 8 bit combined header
-			return unpack_map(pk, (uint32_t)(type & 0x0f), val);
+			return unpack_map(pk, (uint32_t)(type & 0x0f), val, mode);
 		}
 
 		if ((type & 0xf0) == 0x90) { // list with 8 bit combined header
-			return unpack_list(pk, (uint32_t)(type & 0x0f), val);
+			return unpack_list(pk, (uint32_t)(type & 0x0f), val, mode);
 		}
 
 		if (type < 0x80) { // 8 bit combined unsigned integer
-			return unpack_integer_val((int64_t)type, val);
+			return unpack_integer_val((int64_t)type, val, mode);
 		}
 
 		if (type >= 0xe0) { // 8 bit combined signed integer
-			return unpack_integer_val((int64_t)(type & 0x1f) - 32, val);
+			return unpack_integer_val((int64_t)(type & 0x1f) - 32, val, mode);
 		}
 
 		return -2;
 	}
 }
 
+static int
+unpack_val(as_unpacker *pk, as_val **val, uint32_t mode)
+{
+	int rv = unpack_val_internal(pk, val, mode);
+
+	// Children were confined by the recursive calls.
+	if ((mode & UNPACK_LOCAL) != 0 && rv == 0) {
+		as_val_confine(*val);
+	}
+
+	return rv;
+}
+
+int
+as_unpack_val(as_unpacker *pk, as_val **val)
+{
+	return unpack_val(pk, val, 0);
+}
+
+int
+as_unpack_val_local(as_unpacker *pk, as_val **val)
+{
+	return unpack_val(pk, val, UNPACK_LOCAL);
+}
+
+int
+as_unpack_val_typed(as_unpacker *pk, as_val **val)
+{
+	return unpack_val(pk, val, UNPACK_TYPED);
+}
+
+int
+as_unpack_val_cached(as_unpacker *pk, as_val **val)
+{
+	return unpack_val(pk, val, UNPACK_CACHED);
+}
+
 /******************************************************************************
  * Pack direct functions
  ******************************************************************************/
@@ -21,6 +21,7 @@
 #include <stddef.h>
 #include <string.h>
 
+#include <aerospike/as_atomic.h>
 #include <aerospike/as_boolean.h>
 #include <aerospike/as_bytes.h>
 #include <aerospike/as_double.h>
@@ -69,9 +70,20 @@ as_orderedmap_cons(as_orderedmap* map, uint32_t capacity)
 	map->hold_table = NULL;
 	map->hold_locations = NULL;
 
+	map->value_order = NULL;
+
 	return map;
 }
 
+static inline void
+value_order_invalidate(as_orderedmap* map)
+{
+	if (map->value_order != NULL) {
+		cf_free(map->value_order);
+		map->value_order = NULL;
+	}
+}
+
 static bool
 is_valid_key_type(const as_val* key)
 {
@@ -135,6 +147,52 @@ key_find(const map_entry* table, uint32_t count, const as_val* key,
 	return false;
 }
 
+static void
+value_order_sort(const map_entry* table, uint32_t* order, uint32_t* tmp,
+		uint32_t count)
+{
+	// Bottom-up merge sort - stable, so equal values stay in key order.
+	uint32_t* src = order;
+	uint32_t* dst = tmp;
+
+	for (uint32_t width = 1; width < count; width *= 2) {
+		for (uint32_t lo = 0; lo < count; lo += 2 * width) {
+			uint32_t mid = lo + width < count ? lo + width : count;
+			uint32_t hi = mid + width < count ? mid + width : count;
+			uint32_t i = lo;
+			uint32_t j = mid;
+			uint32_t k = lo;
+
+			while (i < mid && j < hi) {
+				if (as_val_cmp(table[src[j]].value, table[src[i]].value) ==
+						MSGPACK_COMPARE_LESS) {
+					dst[k++] = src[j++];
+				}
+				else {
+					dst[k++] = src[i++];
+				}
+			}
+
+			while (i < mid) {
+				dst[k++] = src[i++];
+			}
+
+			while (j < hi) {
+				dst[k++] = src[j++];
+			}
+		}
+
+		uint32_t* t = src;
+
+		src = dst;
+		dst = t;
+	}
+
+	if (src != order) {
+		memcpy(order, src, count * sizeof(uint32_t));
+	}
+}
+
 static bool
 as_orderedmap_merge(as_orderedmap* map)
 {
@@ -176,6 +234,7 @@ as_orderedmap_merge(as_orderedmap* map)
 			(map->count - src_ix) * sizeof(map_entry));
 
 	cf_free(map->table);
+	value_order_invalidate(map);
 
 	map->count += map->hold_count;
 	map->capacity = new_capacity;
@@ -241,6 +300,16 @@ as_orderedmap_destroy(as_orderedmap* map)
 	as_map_destroy((as_map*)map);
 }
 
+const as_orderedmap*
+as_orderedmap_frommap(const as_map* map)
+{
+	if (map == NULL || map->hooks != &as_orderedmap_map_hooks) {
+		return NULL;
+	}
+
+	return (const as_orderedmap*)map;
+}
+
 uint32_t
 as_orderedmap_size(const as_orderedmap* map)
 {
@@ -283,6 +352,8 @@ as_orderedmap_set(as_orderedmap* map, const as_val* key, const as_val* val)
 		return -1;
 	}
 
+	value_order_invalidate(map);
+
 	if (found) {
 		as_val_destroy(map->table[ix].key);
 		as_val_destroy(map->table[ix].value);
@@ -385,6 +456,8 @@ as_orderedmap_clear(as_orderedmap* map)
 
 	map->hold_count = 0;
 
+	value_order_invalidate(map);
+
 	return 0;
 }
 
@@ -402,6 +475,7 @@ as_orderedmap_remove(as_orderedmap* map, const as_val* key)
 	uint32_t ix;
 
 	if (key_find(map->table, map->count, key, &ix, false)) {
+		value_order_invalidate(map);
 		as_val_destroy(map->table[ix].key);
 		as_val_destroy(map->table[ix].value);
 		memmove(&map->table[ix], &map->table[ix + 1],
@@ -412,6 +486,190 @@ as_orderedmap_remove(as_orderedmap* map, const as_val* key)
 	return 0;
 }
 
+as_val*
+as_orderedmap_get_by_index(const as_orderedmap* map, uint32_t index,
+		as_val** key_r)
+{
+	if (map == NULL || ! as_orderedmap_merge((as_orderedmap*)map) ||
+			index >= map->count) {
+		return NULL;
+	}
+
+	if (key_r != NULL) {
+		*key_r = map->table[index].key;
+	}
+
+	return map->table[index].value;
+}
+
+int
+as_orderedmap_range_by_key(const as_orderedmap* map, const as_val* lo,
+		const as_val* hi, uint32_t* index_r, uint32_t* count_r)
+{
+	if (map == NULL || ! as_orderedmap_merge((as_orderedmap*)map)) {
+		return -1;
+	}
+
+	uint32_t start = 0;
+	uint32_t end = map->count;
+
+	if (lo != NULL) {
+		key_find(map->table, map->count, lo, &start, false);
+
+		if (start == UINT32_MAX) {
+			return -1;
+		}
+	}
+
+	if (hi != NULL) {
+		key_find(map->table, map->count, hi, &end, false);
+
+		if (end == UINT32_MAX) {
+			return -1;
+		}
+	}
+
+	*index_r = start;
+	*count_r = end > start ? end - start : 0;
+
+	return 0;
+}
+
+static uint32_t*
+value_order_get(const as_orderedmap* map)
+{
+	uint32_t* cached = as_load_ptr_acq((void* const*)&map->value_order);
+
+	if (cached != NULL) {
+		return cached;
+	}
+
+	uint32_t* order = cf_malloc(map->count * sizeof(uint32_t));
+	uint32_t* tmp = cf_malloc(map->count * sizeof(uint32_t));
+
+	if (order == NULL || tmp == NULL) {
+		cf_free(order);
+		cf_free(tmp);
+		return NULL;
+	}
+
+	for (uint32_t i = 0; i < map->count; i++) {
+		order[i] = i;
+	}
+
+	value_order_sort(map->table, order, tmp, map->count);
+	cf_free(tmp);
+
+	if ((map->_.flags & AS_PACKED_MAP_FLAG_KV_ORDERED) ==
+			AS_PACKED_MAP_FLAG_KV_ORDERED) {
+		// Readers may race to build the index - the first one in keeps it.
+		if (as_cas_ptr((void**)&((as_orderedmap*)map)->value_order, NULL,
+				order)) {
+			return order;
+		}
+
+		cf_free(order);
+		return as_load_ptr_acq((void* const*)&map->value_order);
+	}
+
+	return order;
+}
+
+static inline void
+value_order_put(const as_orderedmap* map, uint32_t* order)
+{
+	if (order != as_load_ptr((void* const*)&map->value_order)) {
+		cf_free(order);
+	}
+}
+
+static uint32_t
+value_order_find(const as_orderedmap* map, const uint32_t* order,
+		const as_val* val)
+{
+	// Returns rank of the first entry whose value is >= val.
+	uint32_t low = 0;
+	uint32_t high = map->count;
+
+	while (low < high) {
+		uint32_t mid = low + (high - low) / 2;
+		msgpack_compare_t cmp = as_val_cmp(map->table[order[mid]].value, val);
+
+		if (cmp == MSGPACK_COMPARE_LESS) {
+			low = mid + 1;
+		}
+		else if (cmp == MSGPACK_COMPARE_ERROR) {
+			return UINT32_MAX;
+		}
+		else {
+			high = mid;
+		}
+	}
+
+	return low;
+}
+
+as_val*
+as_orderedmap_get_by_rank(const as_orderedmap* map, uint32_t rank,
+		as_val** key_r)
+{
+	if (map == NULL || ! as_orderedmap_merge((as_orderedmap*)map) ||
+			rank >= map->count) {
+		return NULL;
+	}
+
+	uint32_t* order = value_order_get(map);
+
+	if (order == NULL) {
+		return NULL;
+	}
+
+	uint32_t ix = order[rank];
+
+	value_order_put(map, order);
+
+	if (key_r != NULL) {
+		*key_r = map->table[ix].key;
+	}
+
+	return map->table[ix].value;
+}
+
+int
+as_orderedmap_range_by_value(const as_orderedmap* map, const as_val* lo,
+		const as_val* hi, uint32_t* rank_r, uint32_t* count_r)
+{
+	if (map == NULL || ! as_orderedmap_merge((as_orderedmap*)map)) {
+		return -1;
+	}
+
+	if (map->count == 0) {
+		*rank_r = 0;
+		*count_r = 0;
+		return 0;
+	}
+
+	uint32_t* order = value_order_get(map);
+
+	if (order == NULL) {
+		return -1;
+	}
+
+	uint32_t start = lo != NULL ? value_order_find(map, order, lo) : 0;
+	uint32_t end = hi != NULL ? value_order_find(map, order, hi) : map->count;
+
+	value_order_put(map, order);
+
+	if (start == UINT32_MAX || end == UINT32_MAX) {
+		return -1;
+	}
+
+	*rank_r = start;
+	*count_r = end > start ? end - start : 0;
+
+	return 0;
+}
+
 
 /*******************************************************************************
  *	ITERATION FUNCTIONS
@@ -458,6 +716,25 @@ as_orderedmap_iterator_init(as_orderedmap_iterator* it,
 	return it;
 }
 
+as_orderedmap_iterator*
+as_orderedmap_iterator_init_from(as_orderedmap_iterator* it,
+		const as_orderedmap* map, const as_val* key)
+{
+	if (as_orderedmap_iterator_init(it, map) == NULL) {
+		return NULL;
+	}
+
+	if (map != NULL && key != NULL) {
+		key_find(map->table, map->count, key, &it->ix, false);
+
+		if (it->ix == UINT32_MAX) {
+			return NULL;
+		}
+	}
+
+	return it;
+}
+
 as_orderedmap_iterator*
 as_orderedmap_iterator_new(const as_orderedmap* map)
 {
@@ -514,6 +791,28 @@ as_orderedmap_iterator_next(as_orderedmap_iterator* it)
 	return (as_val*)&it->pair;
 }
 
+uint32_t
+as_orderedmap_iterator_next_n(as_orderedmap_iterator* it, const as_val** keys,
+		const as_val** values, uint32_t n)
+{
+	uint32_t avail = it->map->count - it->ix;
+
+	if (n > avail) {
+		n = avail;
+	}
+
+	const map_entry* entries = it->map->table + it->ix;
+
+	for (uint32_t i = 0; i < n; i++) {
+		keys[i] = entries[i].key;
+		values[i] = entries[i].value;
+	}
+
+	it->ix += n;
+
+	return n;
+}
+
 
 /*******************************************************************************
  *	HOOKS
@@ -537,6 +836,74 @@ _map_size(const as_map* map)
 	return as_orderedmap_size((const as_orderedmap*)map);
 }
 
+static void
+_map_memory(const as_map* map, as_val_memory* mem, bool shared)
+{
+	const as_orderedmap* m = (const as_orderedmap*)map;
+	size_t bytes = m->capacity * sizeof(map_entry);
+
+	if (map->_.free) {
+		bytes += sizeof(as_orderedmap);
+	}
+
+	if (m->hold_table != NULL) {
+		bytes += HOLD_TABLE_CAP * (sizeof(map_entry) + sizeof(uint32_t));
+	}
+
+	if (m->value_order != NULL) {
+		bytes += m->count * sizeof(uint32_t);
+	}
+
+	as_val_memory_bytes(mem, shared, bytes);
+
+	for (uint32_t i = 0; i < m->count; i++) {
+		as_val_memory_add(m->table[i].key, mem, shared);
+		as_val_memory_add(m->table[i].value, mem, shared);
+	}
+
+	for (uint32_t i = 0; i < m->hold_count; i++) {
+		as_val_memory_add(m->hold_table[i].key, mem, shared);
+		as_val_memory_add(m->hold_table[i].value, mem, shared);
+	}
+}
+
+static as_map*
+_map_clone(const as_map* map, bool deep)
+{
+	as_orderedmap* m = (as_orderedmap*)map;
+
+	if (! as_orderedmap_merge(m)) {
+		return NULL;
+	}
+
+	as_orderedmap* copy = as_orderedmap_new(m->count);
+
+	if (copy == NULL) {
+		return NULL;
+	}
+
+	copy->_.flags = map->flags;
+
+	for (uint32_t i = 0; i < m->count; i++) {
+		map_entry* e = &m->table[i];
+		as_val* key = as_val_clone_element(e->key, deep);
+		as_val* value = as_val_clone_element(e->value, deep);
+
+		if (key == NULL || value == NULL) {
+			as_val_destroy(key);
+			as_val_destroy(value);
+			as_orderedmap_destroy(copy);
+			return NULL;
+		}
+
+		copy->table[i].key = key;
+		copy->table[i].value = value;
+		copy->count = i + 1;
+	}
+
+	return (as_map*)copy;
+}
+
 static int
 _map_set(as_map* map, const as_val* key, const as_val* val)
 {
@@ -619,6 +986,18 @@ static const as_map_hooks as_orderedmap_map_hooks = {
 	.foreach		= _map_foreach,
 	.iterator_new	= _map_iterator_new,
 	.iterator_init	= _map_iterator_init,
+
+	/***************************************************************************
+	 *	memory hooks
+	 **************************************************************************/
+
+	.memory			= _map_memory,
+
+	/***************************************************************************
+	 *	copy hooks
+	 **************************************************************************/
+
+	.clone			= _map_clone,
 };
 
 static bool
@@ -639,8 +1018,17 @@ _iterator_next(as_iterator* it)
 	return as_orderedmap_iterator_next((as_orderedmap_iterator*) it);
 }
 
+static uint32_t
+_iterator_next_entries(as_iterator* it, const as_val** keys,
+		const as_val** values, uint32_t n)
+{
+	return as_orderedmap_iterator_next_n((as_orderedmap_iterator*)it, keys,
+			values, n);
+}
+
 static const as_iterator_hooks as_orderedmap_iterator_hooks = {
 	.destroy    = _iterator_destroy,
 	.has_next   = _iterator_has_next,
-	.next       = _iterator_next
+	.next       = _iterator_next,
+	.next_entries = _iterator_next_entries
 };
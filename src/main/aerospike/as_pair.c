@@ -15,6 +15,7 @@
  * the License.
  */
 #include <aerospike/as_pair.h>
+#include <aerospike/as_slab.h>
 #include <aerospike/as_util.h>
 #include <citrusleaf/alloc.h>
 #include <string.h>
@@ -35,10 +36,11 @@ as_pair * as_pair_init(as_pair * pair, as_val * _1, as_val * _2)
 
 as_pair * as_pair_new(as_val * _1, as_val * _2)
 {
-	as_pair * pair = (as_pair *) cf_malloc(sizeof(as_pair));
+	as_pair * pair = (as_pair *) as_slab_alloc(sizeof(as_pair));
 	if ( !pair ) return pair;
 
 	as_val_init((as_val *) pair, AS_PAIR, true);
+	as_slab_val((as_val *) pair);
 	pair->_1 = _1;
 	pair->_2 = _2;
 	return pair;
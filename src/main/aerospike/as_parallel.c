@@ -0,0 +1,380 @@
+/*
+ * Copyright 2026 Aerospike, Inc.
+ *
+ * Portions may be licensed to Aerospike, Inc. under one or more contributor
+ * license agreements.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include <aerospike/as_parallel.h>
+#include <aerospike/as_arraylist.h>
+#include <aerospike/as_atomic.h>
+#include <aerospike/as_orderedmap.h>
+#include <citrusleaf/alloc.h>
+#include <string.h>
+
+/******************************************************************************
+ * TYPES
+ *****************************************************************************/
+
+// Smallest chunk handed to a pool thread.
+#define MIN_CHUNK 1024
+
+extern const as_list_hooks as_arraylist_list_hooks;
+
+typedef struct par_ctx_s {
+	as_val* const* elements;
+	const map_entry* entries;
+
+	as_val** out;
+
+	as_list_foreach_callback list_fn;
+	as_list_map_callback list_map_fn;
+	as_map_foreach_callback map_fn;
+	as_list_reduce_callback list_reduce_fn;
+	as_map_reduce_callback map_reduce_fn;
+	void* udata;
+
+	uint8_t stop;
+} par_ctx;
+
+typedef struct par_chunk_s {
+	par_ctx* ctx;
+	uint32_t lo;
+	uint32_t hi;
+	void* acc;
+} par_chunk;
+
+typedef struct seq_map_s {
+	as_list_map_callback fn;
+	as_arraylist* out;
+	void* udata;
+} seq_map;
+
+typedef struct seq_reduce_s {
+	as_list_reduce_callback list_fn;
+	as_map_reduce_callback map_fn;
+	void* acc;
+	void* udata;
+} seq_reduce;
+
+/******************************************************************************
+ * STATIC FUNCTIONS
+ *****************************************************************************/
+
+static inline bool
+visit(const par_ctx* ctx, uint32_t i, void* acc)
+{
+	if (ctx->elements) {
+		as_val* v = ctx->elements[i];
+
+		if (ctx->list_map_fn) {
+			ctx->out[i] = ctx->list_map_fn(v, ctx->udata);
+			return ctx->out[i] != NULL;
+		}
+
+		return ctx->list_fn ? ctx->list_fn(v, ctx->udata) :
+				ctx->list_reduce_fn(v, acc, ctx->udata);
+	}
+
+	const map_entry* e = &ctx->entries[i];
+
+	return ctx->map_fn ? ctx->map_fn(e->key, e->value, ctx->udata) :
+			ctx->map_reduce_fn(e->key, e->value, acc, ctx->udata);
+}
+
+static void
+chunk_run(par_chunk* chunk)
+{
+	par_ctx* ctx = chunk->ctx;
+
+	for (uint32_t i = chunk->lo; i < chunk->hi; i++) {
+		if (as_load_uint8(&ctx->stop) != 0) {
+			return;
+		}
+
+		if (! visit(ctx, i, chunk->acc)) {
+			as_store_uint8(&ctx->stop, 1);
+			return;
+		}
+	}
+}
+
+static void
+chunk_task(void* udata)
+{
+	chunk_run((par_chunk*)udata);
+}
+
+static bool
+par_run(par_ctx* ctx, as_thread_pool* pool, uint32_t size,
+		as_reduce_merge_callback merge, void* acc, size_t acc_size)
+{
+	uint32_t n_chunks = 1;
+
+	if (pool != NULL && size >= 2 * MIN_CHUNK) {
+		n_chunks = pool->thread_size + 1;
+
+		if (n_chunks > size / MIN_CHUNK) {
+			n_chunks = size / MIN_CHUNK;
+		}
+	}
+
+	par_chunk* chunks = NULL;
+	void** tasks = NULL;
+	uint8_t* accs = NULL;
+
+	if (n_chunks > 1) {
+		chunks = (par_chunk*)cf_malloc(n_chunks * sizeof(par_chunk));
+		tasks = (void**)cf_malloc((n_chunks - 1) * sizeof(void*));
+
+		if (chunks && tasks && acc_size != 0) {
+			accs = (uint8_t*)cf_malloc((n_chunks - 1) * acc_size);
+
+			if (! accs) {
+				cf_free(tasks);
+				cf_free(chunks);
+				return false;
+			}
+		}
+
+		if (! chunks || ! tasks) {
+			cf_free(tasks);
+			cf_free(chunks);
+			n_chunks = 1;
+		}
+	}
+
+	if (n_chunks == 1) {
+		par_chunk chunk = { .ctx = ctx, .lo = 0, .hi = size, .acc = acc };
+
+		chunk_run(&chunk);
+		return ctx->stop == 0;
+	}
+
+	for (uint32_t i = 0; i < n_chunks; i++) {
+		chunks[i].ctx = ctx;
+		chunks[i].lo = (uint32_t)((uint64_t)size * i / n_chunks);
+		chunks[i].hi = (uint32_t)((uint64_t)size * (i + 1) / n_chunks);
+		chunks[i].acc = acc;
+
+		if (i != 0) {
+			tasks[i - 1] = &chunks[i];
+
+			if (accs) {
+				chunks[i].acc = accs + (i - 1) * acc_size;
+				memcpy(chunks[i].acc, acc, acc_size);
+			}
+		}
+	}
+
+	as_task_group group;
+
+	as_task_group_init(&group, pool);
+	as_task_group_add_n(&group, chunk_task, tasks, n_chunks - 1);
+
+	chunk_run(&chunks[0]);
+	as_task_group_wait(&group, -1);
+	as_task_group_destroy(&group);
+
+	bool completed = as_load_uint8(&ctx->stop) == 0;
+
+	if (completed && accs) {
+		for (uint32_t i = 1; i < n_chunks; i++) {
+			merge(acc, chunks[i].acc, ctx->udata);
+		}
+	}
+
+	cf_free(accs);
+	cf_free(tasks);
+	cf_free(chunks);
+
+	return completed;
+}
+
+static bool
+seq_list_map(as_val* v, void* udata)
+{
+	seq_map* m = (seq_map*)udata;
+	as_val* r = m->fn(v, m->udata);
+
+	return r != NULL && as_arraylist_append(m->out, r) == AS_ARRAYLIST_OK;
+}
+
+static bool
+seq_list_reduce(as_val* v, void* udata)
+{
+	seq_reduce* r = (seq_reduce*)udata;
+
+	return r->list_fn(v, r->acc, r->udata);
+}
+
+static bool
+seq_map_reduce(const as_val* k, const as_val* v, void* udata)
+{
+	seq_reduce* r = (seq_reduce*)udata;
+
+	return r->map_fn(k, v, r->acc, r->udata);
+}
+
+static const as_orderedmap*
+orderedmap_get(const as_map* map)
+{
+	const as_orderedmap* om = as_orderedmap_frommap(map);
+	as_orderedmap_iterator it;
+
+	// Initializing an iterator merges pending insertions into the table.
+	if (om == NULL || as_orderedmap_iterator_init(&it, om) == NULL) {
+		return NULL;
+	}
+
+	as_orderedmap_iterator_destroy(&it);
+
+	return om;
+}
+
+/******************************************************************************
+ * FUNCTIONS
+ *****************************************************************************/
+
+bool
+as_list_parallel_foreach(const as_list* list, as_thread_pool* pool,
+		as_list_foreach_callback callback, void* udata)
+{
+	if (list->hooks != &as_arraylist_list_hooks) {
+		return as_list_foreach(list, callback, udata);
+	}
+
+	const as_arraylist* al = (const as_arraylist*)list;
+	par_ctx ctx = {
+		.elements = al->elements,
+		.list_fn = callback,
+		.udata = udata
+	};
+
+	return par_run(&ctx, pool, al->size, NULL, NULL, 0);
+}
+
+bool
+as_map_parallel_foreach(const as_map* map, as_thread_pool* pool,
+		as_map_foreach_callback callback, void* udata)
+{
+	const as_orderedmap* om = orderedmap_get(map);
+
+	if (om == NULL) {
+		return as_map_foreach(map, callback, udata);
+	}
+
+	par_ctx ctx = {
+		.entries = om->table,
+		.map_fn = callback,
+		.udata = udata
+	};
+
+	return par_run(&ctx, pool, om->count, NULL, NULL, 0);
+}
+
+as_arraylist*
+as_list_parallel_map(const as_list* list, as_thread_pool* pool,
+		as_list_map_callback callback, void* udata)
+{
+	uint32_t size = as_list_size(list);
+	as_arraylist* out = as_arraylist_new(size, 0);
+
+	if (! out) {
+		return NULL;
+	}
+
+	bool completed = true;
+
+	if (list->hooks != &as_arraylist_list_hooks) {
+		seq_map m = {
+			.fn = callback,
+			.out = out,
+			.udata = udata
+		};
+
+		completed = as_list_foreach(list, seq_list_map, &m);
+	}
+	else if (size != 0) {
+		// Results land in place, so the list is filled (with NULLs) up front.
+		memset(out->elements, 0, size * sizeof(as_val*));
+		out->size = size;
+
+		par_ctx ctx = {
+			.elements = ((const as_arraylist*)list)->elements,
+			.out = out->elements,
+			.list_map_fn = callback,
+			.udata = udata
+		};
+
+		completed = par_run(&ctx, pool, size, NULL, NULL, 0);
+	}
+
+	if (! completed) {
+		as_arraylist_destroy(out);
+		return NULL;
+	}
+
+	return out;
+}
+
+bool
+as_list_parallel_reduce(const as_list* list, as_thread_pool* pool,
+		as_list_reduce_callback callback, as_reduce_merge_callback merge,
+		void* acc, size_t acc_size, void* udata)
+{
+	if (list->hooks != &as_arraylist_list_hooks) {
+		seq_reduce r = {
+			.list_fn = callback,
+			.acc = acc,
+			.udata = udata
+		};
+
+		return as_list_foreach(list, seq_list_reduce, &r);
+	}
+
+	const as_arraylist* al = (const as_arraylist*)list;
+	par_ctx ctx = {
+		.elements = al->elements,
+		.list_reduce_fn = callback,
+		.udata = udata
+	};
+
+	return par_run(&ctx, pool, al->size, merge, acc, acc_size);
+}
+
+bool
+as_map_parallel_reduce(const as_map* map, as_thread_pool* pool,
+		as_map_reduce_callback callback, as_reduce_merge_callback merge,
+		void* acc, size_t acc_size, void* udata)
+{
+	const as_orderedmap* om = orderedmap_get(map);
+
+	if (om == NULL) {
+		seq_reduce r = {
+			.map_fn = callback,
+			.acc = acc,
+			.udata = udata
+		};
+
+		return as_map_foreach(map, seq_map_reduce, &r);
+	}
+
+	par_ctx ctx = {
+		.entries = om->table,
+		.map_reduce_fn = callback,
+		.udata = udata
+	};
+
+	return par_run(&ctx, pool, om->count, merge, acc, acc_size);
+}
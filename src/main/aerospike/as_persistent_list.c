@@ -0,0 +1,1035 @@
+/*
+ * Copyright 2026 Aerospike, Inc.
+ *
+ * Portions may be licensed to Aerospike, Inc. under one or more contributor
+ * license agreements.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include <aerospike/as_persistent_list.h>
+
+#include <aerospike/as_atomic.h>
+#include <aerospike/as_double.h>
+#include <aerospike/as_integer.h>
+#include <aerospike/as_iterator.h>
+#include <aerospike/as_list.h>
+#include <aerospike/as_list_iterator.h>
+#include <aerospike/as_nil.h>
+#include <aerospike/as_std.h>
+#include <aerospike/as_string.h>
+#include <aerospike/as_val.h>
+#include <citrusleaf/alloc.h>
+#include <string.h>
+
+/******************************************************************************
+ *	TYPES
+ ******************************************************************************/
+
+static const as_list_hooks as_persistent_list_list_hooks;
+static const as_iterator_hooks as_persistent_list_iterator_hooks;
+
+#define SLOT_MASK (AS_PERSISTENT_LIST_WIDTH - 1)
+
+/******************************************************************************
+ *	STATIC FUNCTIONS
+ ******************************************************************************/
+
+static as_persistent_list*
+as_persistent_list_cons(as_persistent_list* list)
+{
+	list->size = 0;
+	list->shift = 0;
+	list->root = NULL;
+
+	return list;
+}
+
+static as_persistent_list_node*
+node_new(void)
+{
+	as_persistent_list_node* node = (as_persistent_list_node*)
+			cf_calloc(1, sizeof(as_persistent_list_node));
+
+	if (node == NULL) {
+		return NULL;
+	}
+
+	node->count = 1;
+
+	return node;
+}
+
+static void
+node_release(as_persistent_list_node* node, uint32_t level)
+{
+	if (node == NULL || as_aaf_uint32_rls(&node->count, -1) != 0) {
+		return;
+	}
+
+	as_fence_acq();
+
+	for (uint32_t i = 0; i < AS_PERSISTENT_LIST_WIDTH; i++) {
+		if (node->slots[i] == NULL) {
+			continue;
+		}
+
+		if (level == 0) {
+			as_val_destroy((as_val*)node->slots[i]);
+		}
+		else {
+			node_release((as_persistent_list_node*)node->slots[i],
+					level - AS_PERSISTENT_LIST_BITS);
+		}
+	}
+
+	cf_free(node);
+}
+
+static void
+node_memory(const as_persistent_list_node* node, uint32_t level,
+		as_val_memory* mem, bool shared)
+{
+	if (node == NULL) {
+		return;
+	}
+
+	// Nodes are shared between list versions.
+	shared = shared || as_load_uint32(&node->count) > 1;
+	as_val_memory_bytes(mem, shared, sizeof(as_persistent_list_node));
+
+	for (uint32_t i = 0; i < AS_PERSISTENT_LIST_WIDTH; i++) {
+		if (node->slots[i] == NULL) {
+			continue;
+		}
+
+		if (level == 0) {
+			as_val_memory_add((const as_val*)node->slots[i], mem, shared);
+		}
+		else {
+			node_memory((const as_persistent_list_node*)node->slots[i],
+					level - AS_PERSISTENT_LIST_BITS, mem, shared);
+		}
+	}
+}
+
+// Make *p a node owned only by the caller, copying it if it is shared with
+// another list version, or creating it if it doesn't exist yet.
+static bool
+node_unique(as_persistent_list_node** p, uint32_t level)
+{
+	as_persistent_list_node* node = *p;
+
+	if (node == NULL) {
+		*p = node_new();
+		return *p != NULL;
+	}
+
+	if (as_load_uint32_acq(&node->count) == 1) {
+		return true;
+	}
+
+	as_persistent_list_node* dup = (as_persistent_list_node*)
+			cf_malloc(sizeof(as_persistent_list_node));
+
+	if (dup == NULL) {
+		return false;
+	}
+
+	dup->count = 1;
+	memcpy(dup->slots, node->slots, sizeof(dup->slots));
+
+	for (uint32_t i = 0; i < AS_PERSISTENT_LIST_WIDTH; i++) {
+		if (dup->slots[i] == NULL) {
+			continue;
+		}
+
+		if (level == 0) {
+			as_val_reserve((as_val*)dup->slots[i]);
+		}
+		else {
+			as_incr_uint32(&((as_persistent_list_node*)dup->slots[i])->count);
+		}
+	}
+
+	node_release(node, level);
+	*p = dup;
+
+	return true;
+}
+
+// Get the leaf slots holding the element at index. Index must be in range.
+static inline as_val* const*
+leaf_for(const as_persistent_list* list, uint32_t index)
+{
+	const as_persistent_list_node* node = list->root;
+
+	for (uint32_t level = list->shift; level > 0;
+			level -= AS_PERSISTENT_LIST_BITS) {
+		node = (const as_persistent_list_node*)
+				node->slots[(index >> level) & SLOT_MASK];
+	}
+
+	return (as_val* const*)node->slots;
+}
+
+// Get a writable pointer to the leaf slot for index, copying shared nodes on
+// the path. Index must be below the current capacity of the trie.
+static as_val**
+slot_for_write(as_persistent_list* list, uint32_t index)
+{
+	as_persistent_list_node** p = &list->root;
+
+	for (uint32_t level = list->shift; ; level -= AS_PERSISTENT_LIST_BITS) {
+		if (! node_unique(p, level)) {
+			return NULL;
+		}
+
+		if (level == 0) {
+			return (as_val**)&(*p)->slots[index & SLOT_MASK];
+		}
+
+		p = (as_persistent_list_node**)
+				&(*p)->slots[(index >> level) & SLOT_MASK];
+	}
+}
+
+static int
+as_persistent_list_push(as_persistent_list* list, as_val* value)
+{
+	if (list->root != NULL &&
+			(uint64_t)list->size ==
+					(uint64_t)AS_PERSISTENT_LIST_WIDTH << list->shift) {
+		// Trie is full - grow a new root level.
+		as_persistent_list_node* root = node_new();
+
+		if (root == NULL) {
+			return -1;
+		}
+
+		root->slots[0] = list->root;
+		list->root = root;
+		list->shift += AS_PERSISTENT_LIST_BITS;
+	}
+
+	as_val** slot = slot_for_write(list, list->size);
+
+	if (slot == NULL) {
+		return -1;
+	}
+
+	*slot = value;
+	list->size++;
+
+	return 0;
+}
+
+static void
+as_persistent_list_pop(as_persistent_list* list)
+{
+	as_val** slot = slot_for_write(list, list->size - 1);
+
+	// Values are only destroyed here when the leaf was exclusively owned -
+	// otherwise node_unique() reserved a reference for this version.
+	if (slot != NULL) {
+		as_val_destroy(*slot);
+		*slot = NULL;
+	}
+
+	list->size--;
+
+	if (list->size == 0) {
+		node_release(list->root, list->shift);
+		as_persistent_list_cons(list);
+	}
+}
+
+// Append elements [from, to) of src to dst, sharing the values.
+static int
+append_range(as_persistent_list* dst, const as_persistent_list* src,
+		uint32_t from, uint32_t to)
+{
+	as_val* const* leaf = NULL;
+
+	for (uint32_t i = from; i < to; i++) {
+		if (leaf == NULL || (i & SLOT_MASK) == 0) {
+			leaf = leaf_for(src, i);
+		}
+
+		as_val* v = leaf[i & SLOT_MASK];
+
+		as_val_reserve(v);
+
+		if (as_persistent_list_push(dst, v) != 0) {
+			as_val_destroy(v);
+			return -1;
+		}
+	}
+
+	return 0;
+}
+
+static void
+replace_trie(as_persistent_list* list, as_persistent_list* src)
+{
+	node_release(list->root, list->shift);
+
+	list->size = src->size;
+	list->shift = src->shift;
+	list->root = src->root;
+}
+
+/*******************************************************************************
+ *	INSTANCE FUNCTIONS
+ ******************************************************************************/
+
+as_persistent_list*
+as_persistent_list_init(as_persistent_list* list)
+{
+	if (list == NULL) {
+		return NULL;
+	}
+
+	as_list_cons((as_list*)list, false, &as_persistent_list_list_hooks);
+
+	return as_persistent_list_cons(list);
+}
+
+as_persistent_list*
+as_persistent_list_new(void)
+{
+	as_persistent_list* list = (as_persistent_list*)
+			cf_malloc(sizeof(as_persistent_list));
+
+	if (list == NULL) {
+		return NULL;
+	}
+
+	as_list_cons((as_list*)list, true, &as_persistent_list_list_hooks);
+
+	return as_persistent_list_cons(list);
+}
+
+as_persistent_list*
+as_persistent_list_copy(const as_persistent_list* list)
+{
+	as_persistent_list* copy = as_persistent_list_new();
+
+	if (copy == NULL) {
+		return NULL;
+	}
+
+	if (list->root != NULL) {
+		as_incr_uint32(&list->root->count);
+	}
+
+	copy->size = list->size;
+	copy->shift = list->shift;
+	copy->root = list->root;
+
+	return copy;
+}
+
+static bool
+as_persistent_list_release(as_persistent_list* list)
+{
+	node_release(list->root, list->shift);
+	as_persistent_list_cons(list);
+
+	return true;
+}
+
+void
+as_persistent_list_destroy(as_persistent_list* list)
+{
+	as_list_destroy((as_list*)list);
+}
+
+as_val*
+as_persistent_list_get(const as_persistent_list* list, uint32_t index)
+{
+	if (index >= list->size) {
+		return NULL;
+	}
+
+	return leaf_for(list, index)[index & SLOT_MASK];
+}
+
+int
+as_persistent_list_set(as_persistent_list* list, uint32_t index,
+		as_val* value)
+{
+	while (index > list->size) {
+		if (as_persistent_list_push(list, (as_val*)&as_nil) != 0) {
+			return -1;
+		}
+	}
+
+	if (index == list->size) {
+		return as_persistent_list_push(list, value);
+	}
+
+	as_val** slot = slot_for_write(list, index);
+
+	if (slot == NULL) {
+		return -1;
+	}
+
+	as_val_destroy(*slot);
+	*slot = value;
+
+	return 0;
+}
+
+int
+as_persistent_list_insert(as_persistent_list* list, uint32_t index,
+		as_val* value)
+{
+	if (index >= list->size) {
+		return as_persistent_list_set(list, index, value);
+	}
+
+	as_persistent_list tmp;
+
+	as_persistent_list_cons(&tmp);
+
+	if (append_range(&tmp, list, 0, index) != 0 ||
+			as_persistent_list_push(&tmp, value) != 0 ||
+			append_range(&tmp, list, index, list->size) != 0) {
+		node_release(tmp.root, tmp.shift);
+		return -1;
+	}
+
+	replace_trie(list, &tmp);
+
+	return 0;
+}
+
+int
+as_persistent_list_append(as_persistent_list* list, as_val* value)
+{
+	return as_persistent_list_push(list, value);
+}
+
+int
+as_persistent_list_append_int64(as_persistent_list* list, int64_t value)
+{
+	as_integer* v = as_integer_new(value);
+
+	if (v == NULL) {
+		return -1;
+	}
+
+	if (as_persistent_list_push(list, (as_val*)v) != 0) {
+		as_integer_destroy(v);
+		return -1;
+	}
+
+	return 0;
+}
+
+int
+as_persistent_list_set_int64(as_persistent_list* list, uint32_t index,
+		int64_t value)
+{
+	as_integer* v = as_integer_new(value);
+
+	if (v == NULL) {
+		return -1;
+	}
+
+	if (as_persistent_list_set(list, index, (as_val*)v) != 0) {
+		as_integer_destroy(v);
+		return -1;
+	}
+
+	return 0;
+}
+
+int
+as_persistent_list_remove(as_persistent_list* list, uint32_t index)
+{
+	if (index >= list->size) {
+		return -1;
+	}
+
+	if (index == list->size - 1) {
+		as_persistent_list_pop(list);
+		return 0;
+	}
+
+	as_persistent_list tmp;
+
+	as_persistent_list_cons(&tmp);
+
+	if (append_range(&tmp, list, 0, index) != 0 ||
+			append_range(&tmp, list, index + 1, list->size) != 0) {
+		node_release(tmp.root, tmp.shift);
+		return -1;
+	}
+
+	replace_trie(list, &tmp);
+
+	return 0;
+}
+
+int
+as_persistent_list_trim(as_persistent_list* list, uint32_t index)
+{
+	if (index >= list->size) {
+		return 0;
+	}
+
+	// Popping copies at most one path per element - rebuild instead when
+	// most of the list goes away.
+	if (list->size - index <= index) {
+		while (list->size > index) {
+			as_persistent_list_pop(list);
+		}
+
+		return 0;
+	}
+
+	as_persistent_list tmp;
+
+	as_persistent_list_cons(&tmp);
+
+	if (append_range(&tmp, list, 0, index) != 0) {
+		node_release(tmp.root, tmp.shift);
+		return -1;
+	}
+
+	replace_trie(list, &tmp);
+
+	return 0;
+}
+
+/*******************************************************************************
+ *	ITERATION FUNCTIONS
+ ******************************************************************************/
+
+bool
+as_persistent_list_foreach(const as_persistent_list* list,
+		as_list_foreach_callback callback, void* udata)
+{
+	as_val* const* leaf = NULL;
+
+	for (uint32_t i = 0; i < list->size; i++) {
+		if ((i & SLOT_MASK) == 0) {
+			leaf = leaf_for(list, i);
+		}
+
+		if (! callback(leaf[i & SLOT_MASK], udata)) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+as_persistent_list_iterator*
+as_persistent_list_iterator_init(as_persistent_list_iterator* it,
+		const as_persistent_list* list)
+{
+	if (it == NULL) {
+		return NULL;
+	}
+
+	as_iterator_init((as_iterator*)it, false, NULL,
+			&as_persistent_list_iterator_hooks);
+	it->list = list;
+	it->pos = 0;
+	it->leaf = NULL;
+
+	return it;
+}
+
+as_persistent_list_iterator*
+as_persistent_list_iterator_new(const as_persistent_list* list)
+{
+	as_persistent_list_iterator* it = (as_persistent_list_iterator*)
+			cf_malloc(sizeof(as_persistent_list_iterator));
+
+	if (it == NULL) {
+		return NULL;
+	}
+
+	as_iterator_init((as_iterator*)it, true, NULL,
+			&as_persistent_list_iterator_hooks);
+	it->list = list;
+	it->pos = 0;
+	it->leaf = NULL;
+
+	return it;
+}
+
+bool
+as_persistent_list_iterator_has_next(const as_persistent_list_iterator* it)
+{
+	return it->pos < it->list->size;
+}
+
+const as_val*
+as_persistent_list_iterator_next(as_persistent_list_iterator* it)
+{
+	if (it->pos >= it->list->size) {
+		return NULL;
+	}
+
+	if ((it->pos & SLOT_MASK) == 0 || it->leaf == NULL) {
+		it->leaf = leaf_for(it->list, it->pos);
+	}
+
+	return it->leaf[it->pos++ & SLOT_MASK];
+}
+
+/*******************************************************************************
+ *	HOOKS
+ ******************************************************************************/
+
+static bool
+_list_destroy(as_list* l)
+{
+	return as_persistent_list_release((as_persistent_list*)l);
+}
+
+static uint32_t
+_list_hashcode(const as_list* l)
+{
+	return 0;
+}
+
+static uint32_t
+_list_size(const as_list* l)
+{
+	return as_persistent_list_size((const as_persistent_list*)l);
+}
+
+static void
+_list_memory(const as_list* l, as_val_memory* mem, bool shared)
+{
+	const as_persistent_list* list = (const as_persistent_list*)l;
+
+	if (l->_.free) {
+		as_val_memory_bytes(mem, shared, sizeof(as_persistent_list));
+	}
+
+	node_memory(list->root, list->shift, mem, shared);
+}
+
+static bool
+clone_append(as_val* v, void* udata)
+{
+	as_val* c = as_val_clone(v);
+
+	if (v != NULL && c == NULL) {
+		return false;
+	}
+
+	if (as_persistent_list_append((as_persistent_list*)udata, c) != 0) {
+		as_val_destroy(c);
+		return false;
+	}
+
+	return true;
+}
+
+static as_list*
+_list_clone(const as_list* l, bool deep)
+{
+	const as_persistent_list* list = (const as_persistent_list*)l;
+
+	if (! deep) {
+		return (as_list*)as_persistent_list_copy(list);
+	}
+
+	as_persistent_list* copy = as_persistent_list_new();
+
+	if (copy == NULL) {
+		return NULL;
+	}
+
+	if (! as_persistent_list_foreach(list, clone_append, copy)) {
+		as_persistent_list_destroy(copy);
+		return NULL;
+	}
+
+	return (as_list*)copy;
+}
+
+static as_val*
+_list_get(const as_list* l, uint32_t i)
+{
+	return as_persistent_list_get((const as_persistent_list*)l, i);
+}
+
+static int64_t
+_list_get_int64(const as_list* l, uint32_t i)
+{
+	as_integer* v = as_integer_fromval(
+			as_persistent_list_get((const as_persistent_list*)l, i));
+
+	return v != NULL ? as_integer_get(v) : 0;
+}
+
+static double
+_list_get_double(const as_list* l, uint32_t i)
+{
+	as_double* v = as_double_fromval(
+			as_persistent_list_get((const as_persistent_list*)l, i));
+
+	return v != NULL ? as_double_get(v) : 0.0;
+}
+
+static char*
+_list_get_str(const as_list* l, uint32_t i)
+{
+	as_string* v = as_string_fromval(
+			as_persistent_list_get((const as_persistent_list*)l, i));
+
+	return v != NULL ? as_string_get(v) : NULL;
+}
+
+static int
+_list_set(as_list* l, uint32_t i, as_val* v)
+{
+	return as_persistent_list_set((as_persistent_list*)l, i, v);
+}
+
+static int
+_list_set_int64(as_list* l, uint32_t i, int64_t v)
+{
+	return as_persistent_list_set_int64((as_persistent_list*)l, i, v);
+}
+
+static int
+_list_set_double(as_list* l, uint32_t i, double v)
+{
+	return as_persistent_list_set((as_persistent_list*)l, i,
+			(as_val*)as_double_new(v));
+}
+
+static int
+_list_set_str(as_list* l, uint32_t i, const char* v)
+{
+	return as_persistent_list_set((as_persistent_list*)l, i,
+			(as_val*)as_string_new_strdup(v));
+}
+
+static int
+_list_insert(as_list* l, uint32_t i, as_val* v)
+{
+	return as_persistent_list_insert((as_persistent_list*)l, i, v);
+}
+
+static int
+_list_insert_int64(as_list* l, uint32_t i, int64_t v)
+{
+	return as_persistent_list_insert((as_persistent_list*)l, i,
+			(as_val*)as_integer_new(v));
+}
+
+static int
+_list_insert_double(as_list* l, uint32_t i, double v)
+{
+	return as_persistent_list_insert((as_persistent_list*)l, i,
+			(as_val*)as_double_new(v));
+}
+
+static int
+_list_insert_str(as_list* l, uint32_t i, const char* v)
+{
+	return as_persistent_list_insert((as_persistent_list*)l, i,
+			(as_val*)as_string_new_strdup(v));
+}
+
+static int
+_list_append(as_list* l, as_val* v)
+{
+	return as_persistent_list_append((as_persistent_list*)l, v);
+}
+
+static int
+_list_append_int64(as_list* l, int64_t v)
+{
+	return as_persistent_list_append_int64((as_persistent_list*)l, v);
+}
+
+static int
+_list_append_double(as_list* l, double v)
+{
+	return as_persistent_list_append((as_persistent_list*)l,
+			(as_val*)as_double_new(v));
+}
+
+static int
+_list_append_str(as_list* l, const char* v)
+{
+	return as_persistent_list_append((as_persistent_list*)l,
+			(as_val*)as_string_new_strdup(v));
+}
+
+static int
+_list_prepend(as_list* l, as_val* v)
+{
+	return as_persistent_list_insert((as_persistent_list*)l, 0, v);
+}
+
+static int
+_list_prepend_int64(as_list* l, int64_t v)
+{
+	return _list_insert_int64(l, 0, v);
+}
+
+static int
+_list_prepend_double(as_list* l, double v)
+{
+	return _list_insert_double(l, 0, v);
+}
+
+static int
+_list_prepend_str(as_list* l, const char* v)
+{
+	return _list_insert_str(l, 0, v);
+}
+
+static int
+_list_remove(as_list* l, uint32_t i)
+{
+	return as_persistent_list_remove((as_persistent_list*)l, i);
+}
+
+static bool
+_list_concat_callback(as_val* v, void* udata)
+{
+	as_val_reserve(v);
+
+	if (as_persistent_list_push((as_persistent_list*)udata, v) != 0) {
+		as_val_destroy(v);
+		return false;
+	}
+
+	return true;
+}
+
+static int
+_list_concat(as_list* l, const as_list* l2)
+{
+	return as_list_foreach(l2, _list_concat_callback, l) ? 0 : -1;
+}
+
+static int
+_list_trim(as_list* l, uint32_t i)
+{
+	return as_persistent_list_trim((as_persistent_list*)l, i);
+}
+
+static as_val*
+_list_head(const as_list* l)
+{
+	return as_persistent_list_get((const as_persistent_list*)l, 0);
+}
+
+static as_list*
+_list_drop(const as_list* l, uint32_t n)
+{
+	const as_persistent_list* list = (const as_persistent_list*)l;
+
+	if (n == 0) {
+		return (as_list*)as_persistent_list_copy(list);
+	}
+
+	as_persistent_list* drop = as_persistent_list_new();
+
+	if (drop == NULL) {
+		return NULL;
+	}
+
+	if (n < list->size && append_range(drop, list, n, list->size) != 0) {
+		as_persistent_list_destroy(drop);
+		return NULL;
+	}
+
+	return (as_list*)drop;
+}
+
+static as_list*
+_list_tail(const as_list* l)
+{
+	if (((const as_persistent_list*)l)->size == 0) {
+		return NULL;
+	}
+
+	return _list_drop(l, 1);
+}
+
+static as_list*
+_list_take(const as_list* l, uint32_t n)
+{
+	as_persistent_list* take =
+			as_persistent_list_copy((const as_persistent_list*)l);
+
+	if (take == NULL) {
+		return NULL;
+	}
+
+	if (as_persistent_list_trim(take, n) != 0) {
+		as_persistent_list_destroy(take);
+		return NULL;
+	}
+
+	return (as_list*)take;
+}
+
+static bool
+_list_foreach(const as_list* l, as_list_foreach_callback callback,
+		void* udata)
+{
+	return as_persistent_list_foreach((const as_persistent_list*)l, callback,
+			udata);
+}
+
+static as_list_iterator*
+_list_iterator_new(const as_list* l)
+{
+	return (as_list_iterator*)as_persistent_list_iterator_new(
+			(const as_persistent_list*)l);
+}
+
+static as_list_iterator*
+_list_iterator_init(const as_list* l, as_list_iterator* it)
+{
+	return (as_list_iterator*)as_persistent_list_iterator_init(
+			(as_persistent_list_iterator*)it, (const as_persistent_list*)l);
+}
+
+static const as_list_hooks as_persistent_list_list_hooks = {
+
+	/***************************************************************************
+	 *	instance hooks
+	 **************************************************************************/
+
+	.destroy		= _list_destroy,
+
+	/***************************************************************************
+	 *	info hooks
+	 **************************************************************************/
+
+	.hashcode		= _list_hashcode,
+	.size			= _list_size,
+
+	/***************************************************************************
+	 *	get hooks
+	 **************************************************************************/
+
+	.get			= _list_get,
+	.get_int64		= _list_get_int64,
+	.get_double		= _list_get_double,
+	.get_str		= _list_get_str,
+
+	/***************************************************************************
+	 *	set hooks
+	 **************************************************************************/
+
+	.set			= _list_set,
+	.set_int64		= _list_set_int64,
+	.set_double		= _list_set_double,
+	.set_str		= _list_set_str,
+
+	/***************************************************************************
+	 *	insert hooks
+	 **************************************************************************/
+
+	.insert			= _list_insert,
+	.insert_int64	= _list_insert_int64,
+	.insert_double	= _list_insert_double,
+	.insert_str		= _list_insert_str,
+
+	/***************************************************************************
+	 *	append hooks
+	 **************************************************************************/
+
+	.append			= _list_append,
+	.append_int64	= _list_append_int64,
+	.append_double	= _list_append_double,
+	.append_str		= _list_append_str,
+
+	/***************************************************************************
+	 *	prepend hooks
+	 **************************************************************************/
+
+	.prepend		= _list_prepend,
+	.prepend_int64	= _list_prepend_int64,
+	.prepend_double	= _list_prepend_double,
+	.prepend_str	= _list_prepend_str,
+
+	/***************************************************************************
+	 *	remove hook
+	 **************************************************************************/
+
+	.remove			= _list_remove,
+
+	/***************************************************************************
+	 *	accessor and modifier hooks
+	 **************************************************************************/
+
+	.concat			= _list_concat,
+	.trim			= _list_trim,
+	.head			= _list_head,
+	.tail			= _list_tail,
+	.drop			= _list_drop,
+	.take			= _list_take,
+
+	/***************************************************************************
+	 *	iteration hooks
+	 **************************************************************************/
+
+	.foreach		= _list_foreach,
+	.iterator_new	= _list_iterator_new,
+	.iterator_init	= _list_iterator_init,
+
+	/***************************************************************************
+	 *	memory hooks
+	 **************************************************************************/
+
+	.memory			= _list_memory,
+
+	/***************************************************************************
+	 *	copy hooks
+	 **************************************************************************/
+
+	.clone			= _list_clone,
+};
+
+static bool
+_iterator_destroy(as_iterator* it)
+{
+	return true;
+}
+
+static bool
+_iterator_has_next(const as_iterator* it)
+{
+	return as_persistent_list_iterator_has_next(
+			(const as_persistent_list_iterator*)it);
+}
+
+static const as_val*
+_iterator_next(as_iterator* it)
+{
+	return as_persistent_list_iterator_next((as_persistent_list_iterator*)it);
+}
+
+static const as_iterator_hooks as_persistent_list_iterator_hooks = {
+	.destroy    = _iterator_destroy,
+	.has_next   = _iterator_has_next,
+	.next       = _iterator_next
+};
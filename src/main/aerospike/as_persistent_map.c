@@ -0,0 +1,736 @@
+/*
+ * Copyright 2026 Aerospike, Inc.
+ *
+ * Portions may be licensed to Aerospike, Inc. under one or more contributor
+ * license agreements.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include <aerospike/as_persistent_map.h>
+
+#include <aerospike/as_atomic.h>
+#include <aerospike/as_iterator.h>
+#include <aerospike/as_map.h>
+#include <aerospike/as_map_iterator.h>
+#include <aerospike/as_msgpack.h>
+#include <aerospike/as_nil.h>
+#include <aerospike/as_pair.h>
+#include <aerospike/as_std.h>
+#include <aerospike/as_val.h>
+#include <citrusleaf/alloc.h>
+
+/******************************************************************************
+ *	TYPES
+ ******************************************************************************/
+
+static const as_map_hooks as_persistent_map_map_hooks;
+static const as_iterator_hooks as_persistent_map_iterator_hooks;
+
+// Source of node priorities - mixed, so consecutive values look random.
+static uint32_t g_priority_seq = 0;
+
+/******************************************************************************
+ *	STATIC FUNCTIONS
+ ******************************************************************************/
+
+static inline uint32_t
+next_priority(void)
+{
+	uint32_t h = as_faa_uint32(&g_priority_seq, 1);
+
+	h ^= h >> 16;
+	h *= 0x85ebca6b;
+	h ^= h >> 13;
+	h *= 0xc2b2ae35;
+	h ^= h >> 16;
+
+	return h;
+}
+
+static inline uint32_t
+node_size(const as_persistent_map_node* node)
+{
+	return node == NULL ? 0 : node->size;
+}
+
+static inline void
+node_update(as_persistent_map_node* node)
+{
+	node->size = 1 + node_size(node->left) + node_size(node->right);
+}
+
+static void
+node_release(as_persistent_map_node* node)
+{
+	while (node != NULL && as_aaf_uint32_rls(&node->count, -1) == 0) {
+		as_fence_acq();
+
+		as_persistent_map_node* right = node->right;
+
+		node_release(node->left);
+		as_val_destroy(node->key);
+		as_val_destroy(node->value);
+		cf_free(node);
+
+		node = right;
+	}
+}
+
+static void
+node_memory(const as_persistent_map_node* node, as_val_memory* mem,
+		bool shared)
+{
+	while (node != NULL) {
+		// Nodes are shared between map versions.
+		bool node_shared = shared || as_load_uint32(&node->count) > 1;
+
+		as_val_memory_bytes(mem, node_shared, sizeof(as_persistent_map_node));
+		as_val_memory_add(node->key, mem, node_shared);
+		as_val_memory_add(node->value, mem, node_shared);
+		node_memory(node->left, mem, node_shared);
+
+		shared = node_shared;
+		node = node->right;
+	}
+}
+
+// Make *p a node owned only by the caller, copying it if it is shared with
+// another map version.
+static bool
+node_unique(as_persistent_map_node** p)
+{
+	as_persistent_map_node* node = *p;
+
+	if (as_load_uint32_acq(&node->count) == 1) {
+		return true;
+	}
+
+	as_persistent_map_node* dup = (as_persistent_map_node*)
+			cf_malloc(sizeof(as_persistent_map_node));
+
+	if (dup == NULL) {
+		return false;
+	}
+
+	*dup = *node;
+	dup->count = 1;
+
+	as_val_reserve(dup->key);
+	as_val_reserve(dup->value);
+
+	if (dup->left != NULL) {
+		as_incr_uint32(&dup->left->count);
+	}
+
+	if (dup->right != NULL) {
+		as_incr_uint32(&dup->right->count);
+	}
+
+	node_release(node);
+	*p = dup;
+
+	return true;
+}
+
+static inline void
+rotate_right(as_persistent_map_node** p)
+{
+	as_persistent_map_node* node = *p;
+	as_persistent_map_node* left = node->left;
+
+	node->left = left->right;
+	left->right = node;
+	node_update(node);
+	node_update(left);
+	*p = left;
+}
+
+static inline void
+rotate_left(as_persistent_map_node** p)
+{
+	as_persistent_map_node* node = *p;
+	as_persistent_map_node* right = node->right;
+
+	node->right = right->left;
+	right->left = node;
+	node_update(node);
+	node_update(right);
+	*p = right;
+}
+
+static int
+node_insert(as_persistent_map_node** p, as_val* key, as_val* val)
+{
+	if (*p == NULL) {
+		as_persistent_map_node* node = (as_persistent_map_node*)
+				cf_malloc(sizeof(as_persistent_map_node));
+
+		if (node == NULL) {
+			return -1;
+		}
+
+		node->count = 1;
+		node->priority = next_priority();
+		node->size = 1;
+		node->key = key;
+		node->value = val;
+		node->left = NULL;
+		node->right = NULL;
+		*p = node;
+
+		return 0;
+	}
+
+	msgpack_compare_t cmp = as_val_cmp(key, (*p)->key);
+
+	if (cmp == MSGPACK_COMPARE_ERROR || ! node_unique(p)) {
+		return -1;
+	}
+
+	as_persistent_map_node* node = *p;
+
+	if (cmp == MSGPACK_COMPARE_EQUAL) {
+		as_val_destroy(node->key);
+		as_val_destroy(node->value);
+		node->key = key;
+		node->value = val;
+
+		return 0;
+	}
+
+	// Children touched by the insert are unique after it returns, so they can
+	// be rotated in place.
+	if (cmp == MSGPACK_COMPARE_LESS) {
+		if (node_insert(&node->left, key, val) != 0) {
+			return -1;
+		}
+
+		node_update(node);
+
+		if (node->left->priority > node->priority) {
+			rotate_right(p);
+		}
+	}
+	else {
+		if (node_insert(&node->right, key, val) != 0) {
+			return -1;
+		}
+
+		node_update(node);
+
+		if (node->right->priority > node->priority) {
+			rotate_left(p);
+		}
+	}
+
+	return 0;
+}
+
+// Join two subtrees where all keys in a sort before all keys in b. Takes over
+// the callers' references to a and b.
+static as_persistent_map_node*
+node_join(as_persistent_map_node* a, as_persistent_map_node* b)
+{
+	if (a == NULL) {
+		return b;
+	}
+
+	if (b == NULL) {
+		return a;
+	}
+
+	if (a->priority > b->priority) {
+		if (! node_unique(&a)) {
+			return NULL;
+		}
+
+		a->right = node_join(a->right, b);
+		node_update(a);
+
+		return a;
+	}
+
+	if (! node_unique(&b)) {
+		return NULL;
+	}
+
+	b->left = node_join(a, b->left);
+	node_update(b);
+
+	return b;
+}
+
+static int
+node_remove(as_persistent_map_node** p, const as_val* key)
+{
+	msgpack_compare_t cmp = as_val_cmp(key, (*p)->key);
+
+	if (! node_unique(p)) {
+		return -1;
+	}
+
+	as_persistent_map_node* node = *p;
+
+	if (cmp == MSGPACK_COMPARE_EQUAL) {
+		*p = node_join(node->left, node->right);
+		as_val_destroy(node->key);
+		as_val_destroy(node->value);
+		cf_free(node);
+
+		return 0;
+	}
+
+	int rv = node_remove(cmp == MSGPACK_COMPARE_LESS ?
+			&node->left : &node->right, key);
+
+	node_update(node);
+
+	return rv;
+}
+
+static const as_persistent_map_node*
+node_find(const as_persistent_map_node* node, const as_val* key)
+{
+	while (node != NULL) {
+		msgpack_compare_t cmp = as_val_cmp(key, node->key);
+
+		if (cmp == MSGPACK_COMPARE_EQUAL) {
+			return node;
+		}
+
+		if (cmp == MSGPACK_COMPARE_ERROR) {
+			return NULL;
+		}
+
+		node = cmp == MSGPACK_COMPARE_LESS ? node->left : node->right;
+	}
+
+	return NULL;
+}
+
+static const as_persistent_map_node*
+node_at(const as_persistent_map_node* node, uint32_t index)
+{
+	while (node != NULL) {
+		uint32_t left_size = node_size(node->left);
+
+		if (index == left_size) {
+			return node;
+		}
+
+		if (index < left_size) {
+			node = node->left;
+		}
+		else {
+			index -= left_size + 1;
+			node = node->right;
+		}
+	}
+
+	return NULL;
+}
+
+static bool
+node_foreach(const as_persistent_map_node* node,
+		as_map_foreach_callback callback, void* udata)
+{
+	while (node != NULL) {
+		if (! node_foreach(node->left, callback, udata) ||
+				! callback(node->key, node->value, udata)) {
+			return false;
+		}
+
+		node = node->right;
+	}
+
+	return true;
+}
+
+/*******************************************************************************
+ *	INSTANCE FUNCTIONS
+ ******************************************************************************/
+
+as_persistent_map*
+as_persistent_map_init(as_persistent_map* map)
+{
+	if (map == NULL) {
+		return NULL;
+	}
+
+	as_map_cons((as_map*)map, false, 1, &as_persistent_map_map_hooks);
+	map->root = NULL;
+
+	return map;
+}
+
+as_persistent_map*
+as_persistent_map_new(void)
+{
+	as_persistent_map* map = (as_persistent_map*)
+			cf_malloc(sizeof(as_persistent_map));
+
+	if (map == NULL) {
+		return NULL;
+	}
+
+	as_map_cons((as_map*)map, true, 1, &as_persistent_map_map_hooks);
+	map->root = NULL;
+
+	return map;
+}
+
+as_persistent_map*
+as_persistent_map_copy(const as_persistent_map* map)
+{
+	as_persistent_map* copy = as_persistent_map_new();
+
+	if (copy == NULL) {
+		return NULL;
+	}
+
+	if (map->root != NULL) {
+		as_incr_uint32(&map->root->count);
+	}
+
+	copy->_.flags = map->_.flags;
+	copy->root = map->root;
+
+	return copy;
+}
+
+void
+as_persistent_map_destroy(as_persistent_map* map)
+{
+	as_map_destroy((as_map*)map);
+}
+
+as_val*
+as_persistent_map_get(const as_persistent_map* map, const as_val* key)
+{
+	if (key == NULL) {
+		return NULL;
+	}
+
+	const as_persistent_map_node* node = node_find(map->root, key);
+
+	return node == NULL ? NULL : node->value;
+}
+
+int
+as_persistent_map_set(as_persistent_map* map, const as_val* key,
+		const as_val* val)
+{
+	if (key == NULL) {
+		return -1;
+	}
+
+	return node_insert(&map->root, (as_val*)key,
+			(as_val*)(val != NULL ? val : &as_nil));
+}
+
+int
+as_persistent_map_remove(as_persistent_map* map, const as_val* key)
+{
+	if (key == NULL || node_find(map->root, key) == NULL) {
+		return -1;
+	}
+
+	return node_remove(&map->root, key);
+}
+
+int
+as_persistent_map_clear(as_persistent_map* map)
+{
+	node_release(map->root);
+	map->root = NULL;
+
+	return 0;
+}
+
+as_val*
+as_persistent_map_get_by_index(const as_persistent_map* map, uint32_t index,
+		as_val** key_r)
+{
+	const as_persistent_map_node* node = node_at(map->root, index);
+
+	if (node == NULL) {
+		return NULL;
+	}
+
+	if (key_r != NULL) {
+		*key_r = node->key;
+	}
+
+	return node->value;
+}
+
+/*******************************************************************************
+ *	ITERATION FUNCTIONS
+ ******************************************************************************/
+
+bool
+as_persistent_map_foreach(const as_persistent_map* map,
+		as_map_foreach_callback callback, void* udata)
+{
+	return node_foreach(map->root, callback, udata);
+}
+
+as_persistent_map_iterator*
+as_persistent_map_iterator_init(as_persistent_map_iterator* it,
+		const as_persistent_map* map)
+{
+	if (it == NULL) {
+		return NULL;
+	}
+
+	as_iterator_init((as_iterator*)it, false, NULL,
+			&as_persistent_map_iterator_hooks);
+	it->map = map;
+	it->ix = 0;
+
+	return it;
+}
+
+as_persistent_map_iterator*
+as_persistent_map_iterator_new(const as_persistent_map* map)
+{
+	as_persistent_map_iterator* it = (as_persistent_map_iterator*)
+			cf_malloc(sizeof(as_persistent_map_iterator));
+
+	if (it == NULL) {
+		return NULL;
+	}
+
+	as_iterator_init((as_iterator*)it, true, NULL,
+			&as_persistent_map_iterator_hooks);
+	it->map = map;
+	it->ix = 0;
+
+	return it;
+}
+
+bool
+as_persistent_map_iterator_has_next(const as_persistent_map_iterator* it)
+{
+	return it->ix < as_persistent_map_size(it->map);
+}
+
+const as_val*
+as_persistent_map_iterator_next(as_persistent_map_iterator* it)
+{
+	const as_persistent_map_node* node = node_at(it->map->root, it->ix);
+
+	if (node == NULL) {
+		return NULL;
+	}
+
+	as_pair_init(&it->pair, node->key, node->value);
+	it->ix++;
+
+	return (as_val*)&it->pair;
+}
+
+/*******************************************************************************
+ *	HOOKS
+ ******************************************************************************/
+
+static bool
+_map_destroy(as_map* map)
+{
+	as_persistent_map_clear((as_persistent_map*)map);
+	return true;
+}
+
+static uint32_t
+_map_hashcode(const as_map* map)
+{
+	return 1;
+}
+
+static uint32_t
+_map_size(const as_map* map)
+{
+	return as_persistent_map_size((const as_persistent_map*)map);
+}
+
+static void
+_map_memory(const as_map* map, as_val_memory* mem, bool shared)
+{
+	if (map->_.free) {
+		as_val_memory_bytes(mem, shared, sizeof(as_persistent_map));
+	}
+
+	node_memory(((const as_persistent_map*)map)->root, mem, shared);
+}
+
+static bool
+clone_set(const as_val* key, const as_val* value, void* udata)
+{
+	as_val* k = as_val_clone(key);
+	as_val* v = as_val_clone(value);
+
+	if (k == NULL || v == NULL ||
+			as_persistent_map_set((as_persistent_map*)udata, k, v) != 0) {
+		as_val_destroy(k);
+		as_val_destroy(v);
+		return false;
+	}
+
+	return true;
+}
+
+static as_map*
+_map_clone(const as_map* map, bool deep)
+{
+	const as_persistent_map* m = (const as_persistent_map*)map;
+
+	if (! deep) {
+		return (as_map*)as_persistent_map_copy(m);
+	}
+
+	as_persistent_map* copy = as_persistent_map_new();
+
+	if (copy == NULL) {
+		return NULL;
+	}
+
+	copy->_.flags = map->flags;
+
+	if (! as_persistent_map_foreach(m, clone_set, copy)) {
+		as_persistent_map_destroy(copy);
+		return NULL;
+	}
+
+	return (as_map*)copy;
+}
+
+static int
+_map_set(as_map* map, const as_val* key, const as_val* val)
+{
+	return as_persistent_map_set((as_persistent_map*)map, key, val);
+}
+
+static as_val*
+_map_get(const as_map* map, const as_val* key)
+{
+	return as_persistent_map_get((const as_persistent_map*)map, key);
+}
+
+static int
+_map_clear(as_map* map)
+{
+	return as_persistent_map_clear((as_persistent_map*)map);
+}
+
+static int
+_map_remove(as_map* map, const as_val* key)
+{
+	return as_persistent_map_remove((as_persistent_map*)map, key);
+}
+
+static void
+_map_set_flags(as_map* map, uint32_t flags)
+{
+	as_persistent_map_set_flags((as_persistent_map*)map, flags);
+}
+
+static bool
+_map_foreach(const as_map* map, as_map_foreach_callback callback, void* udata)
+{
+	return as_persistent_map_foreach((const as_persistent_map*)map, callback,
+			udata);
+}
+
+static as_map_iterator*
+_map_iterator_new(const as_map* map)
+{
+	return (as_map_iterator*)as_persistent_map_iterator_new(
+			(const as_persistent_map*)map);
+}
+
+static as_map_iterator*
+_map_iterator_init(const as_map* map, as_map_iterator* it)
+{
+	return (as_map_iterator*)as_persistent_map_iterator_init(
+			(as_persistent_map_iterator*)it, (const as_persistent_map*)map);
+}
+
+static const as_map_hooks as_persistent_map_map_hooks = {
+
+	/***************************************************************************
+	 *	instance hooks
+	 **************************************************************************/
+
+	.destroy	= _map_destroy,
+
+	/***************************************************************************
+	 *	info hooks
+	 **************************************************************************/
+
+	.hashcode	= _map_hashcode,
+	.size		= _map_size,
+
+	/***************************************************************************
+	 *	accessor and modifier hooks
+	 **************************************************************************/
+
+	.set		= _map_set,
+	.get		= _map_get,
+	.clear		= _map_clear,
+	.remove		= _map_remove,
+	.set_flags	= _map_set_flags,
+
+	/***************************************************************************
+	 *	iteration hooks
+	 **************************************************************************/
+
+	.foreach		= _map_foreach,
+	.iterator_new	= _map_iterator_new,
+	.iterator_init	= _map_iterator_init,
+
+	/***************************************************************************
+	 *	memory hooks
+	 **************************************************************************/
+
+	.memory			= _map_memory,
+
+	/***************************************************************************
+	 *	copy hooks
+	 **************************************************************************/
+
+	.clone			= _map_clone,
+};
+
+static bool
+_iterator_destroy(as_iterator* it)
+{
+	return true;
+}
+
+static bool
+_iterator_has_next(const as_iterator* it)
+{
+	return as_persistent_map_iterator_has_next(
+			(const as_persistent_map_iterator*)it);
+}
+
+static const as_val*
+_iterator_next(as_iterator* it)
+{
+	return as_persistent_map_iterator_next((as_persistent_map_iterator*)it);
+}
+
+static const as_iterator_hooks as_persistent_map_iterator_hooks = {
+	.destroy    = _iterator_destroy,
+	.has_next   = _iterator_has_next,
+	.next       = _iterator_next
+};
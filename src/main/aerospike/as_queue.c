@@ -98,6 +98,41 @@ as_queue_increase_capacity(as_queue* queue)
 	return true;
 }
 
+/**
+ * Copy count items in at virtual index, in at most two segments - up to the
+ * end of the block, then from its start.
+ */
+static inline void
+as_queue_copy_in(as_queue* queue, uint32_t index, const uint8_t* src, uint32_t count)
+{
+	uint32_t offset = index % queue->capacity;
+	uint32_t end_count = queue->capacity - offset;
+
+	if (end_count > count) {
+		end_count = count;
+	}
+
+	memcpy(&queue->data[offset * queue->item_size], src, end_count * queue->item_size);
+	memcpy(queue->data, &src[end_count * queue->item_size], (count - end_count) * queue->item_size);
+}
+
+/**
+ * Copy count items out from virtual index, in at most two segments.
+ */
+static inline void
+as_queue_copy_out(as_queue* queue, uint32_t index, uint8_t* dst, uint32_t count)
+{
+	uint32_t offset = index % queue->capacity;
+	uint32_t end_count = queue->capacity - offset;
+
+	if (end_count > count) {
+		end_count = count;
+	}
+
+	memcpy(dst, &queue->data[offset * queue->item_size], end_count * queue->item_size);
+	memcpy(&dst[end_count * queue->item_size], queue->data, (count - end_count) * queue->item_size);
+}
+
 /******************************************************************************
  * FUNCTIONS
  ******************************************************************************/
@@ -213,3 +248,56 @@ as_queue_push_head_limit(as_queue *queue, const void* ptr)
 	as_queue_unwrap(queue);
 	return true;
 }
+
+uint32_t
+as_queue_push_n(as_queue* queue, const void* ptr, uint32_t n)
+{
+	const uint8_t* src = (const uint8_t*)ptr;
+	uint32_t pushed = 0;
+
+	while (pushed < n) {
+		uint32_t size = as_queue_size(queue);
+
+		// Capacity only ever grows from full, so fill up before doubling.
+		if (size == queue->capacity) {
+			if (! as_queue_increase_capacity(queue)) {
+				break;
+			}
+			size = as_queue_size(queue);
+		}
+
+		uint32_t count = queue->capacity - size;
+
+		if (count > n - pushed) {
+			count = n - pushed;
+		}
+
+		as_queue_copy_in(queue, queue->tail, &src[pushed * queue->item_size], count);
+		queue->tail += count;
+		as_queue_unwrap(queue);
+		pushed += count;
+	}
+	return pushed;
+}
+
+uint32_t
+as_queue_pop_n(as_queue* queue, void* ptr, uint32_t n)
+{
+	uint32_t count = as_queue_size(queue);
+
+	if (count > n) {
+		count = n;
+	}
+
+	if (count == 0) {
+		return 0;
+	}
+
+	as_queue_copy_out(queue, queue->head, (uint8_t*)ptr, count);
+	queue->head += count;
+
+	if (queue->head == queue->tail) {
+		queue->head = queue->tail = 0;
+	}
+	return count;
+}
@@ -25,6 +25,15 @@
  * STATIC FUNCTIONS
  ******************************************************************************/
 
+static bool
+as_queue_mt_ready(void* udata)
+{
+	as_queue* queue = &((as_queue_mt*)udata)->queue;
+
+	// A hint only - checked again under the lock.
+	return as_load_uint32(&queue->tail) != as_load_uint32(&queue->head);
+}
+
 static void
 as_queue_mt_wait(as_queue_mt* queue, int wait_ms)
 {
@@ -34,21 +43,24 @@ as_queue_mt_wait(as_queue_mt* queue, int wait_ms)
 		return;
 	}
 
-	if (wait_ms == AS_QUEUE_FOREVER) {
-		// Note that we have to use a while() loop. The pthread_cond_signal()
-		// documentation says that AT LEAST ONE waiting thread will be awakened.
-		// If more than one are awakened, the first will get the popped element,
-		// others will find the queue empty and go back to waiting.
-		do {
-			pthread_cond_wait(&queue->cond, &queue->lock);
-		} while (as_queue_empty(&queue->queue));
+	// A monotonic deadline, so clock adjustments don't affect the wait.
+	uint64_t deadline = as_eventcount_deadline(wait_ms);
 
-		return;
-	}
+	// Note that we have to use a while() loop. Other pops may get in ahead of
+	// us and take the element, in which case we go back to waiting for the
+	// time that remains.
+	do {
+		pthread_mutex_unlock(&queue->lock);
+
+		bool ready = as_eventcount_await(&queue->ec, as_queue_mt_ready, queue,
+			deadline);
+
+		as_queue_mt_lock(queue);
 
-	struct timespec tp;
-	cf_set_wait_timespec(wait_ms, &tp);
-	pthread_cond_timedwait(&queue->cond, &queue->lock, &tp);
+		if (! ready) {
+			return;
+		}
+	} while (as_queue_empty(&queue->queue));
 }
 
 /******************************************************************************
@@ -67,11 +79,8 @@ as_queue_mt_init(as_queue_mt* queue, uint32_t item_size, uint32_t capacity)
 		return false;
 	}
 
-	if (pthread_cond_init(&queue->cond, NULL) != 0) {
-		pthread_mutex_destroy(&queue->lock);
-		as_queue_destroy(&queue->queue);
-		return false;
-	}
+	as_eventcount_init(&queue->ec, AS_EVENTCOUNT_SPIN);
+	queue->stats = NULL;
 	return true;
 }
 
@@ -92,22 +101,70 @@ as_queue_mt_create(uint32_t item_size, uint32_t capacity)
 	return queue;
 }
 
+void
+as_queue_mt_destroy(as_queue_mt* queue)
+{
+	cf_free(queue->stats);
+	queue->stats = NULL;
+	as_eventcount_destroy(&queue->ec);
+	pthread_mutex_destroy(&queue->lock);
+	as_queue_destroy(&queue->queue);
+}
+
 bool
-as_queue_mt_pop(as_queue_mt* queue, void* ptr, int wait_ms)
+as_queue_mt_enable_stats(as_queue_mt* queue)
 {
+	if (queue->stats) {
+		return true;
+	}
+
+	as_stats_clock_init();
+	queue->stats = cf_calloc(1, sizeof(as_queue_stats));
+	return queue->stats != NULL;
+}
+
+bool
+as_queue_mt_get_stats(as_queue_mt* queue, as_queue_stats* stats)
+{
+	if (! queue->stats) {
+		return false;
+	}
+
 	pthread_mutex_lock(&queue->lock);
+	*stats = *queue->stats;
+	pthread_mutex_unlock(&queue->lock);
+
+	stats->wakeups = as_load_uint64(&queue->ec.wakes);
+	stats->parks = as_load_uint64(&queue->ec.parks);
+	return true;
+}
+
+bool
+as_queue_mt_pop(as_queue_mt* queue, void* ptr, int wait_ms)
+{
+	as_queue_mt_lock(queue);
 	as_queue_mt_wait(queue, wait_ms);
 	bool status = as_queue_pop(&queue->queue, ptr);
-	pthread_mutex_unlock(&queue->lock);
+	as_queue_mt_unlock(queue);
 	return status;
 }
 
 bool
 as_queue_mt_pop_tail(as_queue_mt* queue, void* ptr, int wait_ms)
 {
-	pthread_mutex_lock(&queue->lock);
+	as_queue_mt_lock(queue);
 	as_queue_mt_wait(queue, wait_ms);
 	bool status = as_queue_pop_tail(&queue->queue, ptr);
-	pthread_mutex_unlock(&queue->lock);
+	as_queue_mt_unlock(queue);
 	return status;
 }
+
+uint32_t
+as_queue_mt_pop_n(as_queue_mt* queue, void* ptr, uint32_t n, int wait_ms)
+{
+	as_queue_mt_lock(queue);
+	as_queue_mt_wait(queue, wait_ms);
+	uint32_t count = as_queue_pop_n(&queue->queue, ptr, n);
+	as_queue_mt_unlock(queue);
+	return count;
+}
@@ -0,0 +1,469 @@
+/*
+ * Copyright 2026 Aerospike, Inc.
+ *
+ * Portions may be licensed to Aerospike, Inc. under one or more contributor
+ * license agreements.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include <aerospike/as_slab.h>
+#include <aerospike/as_atomic.h>
+#include <citrusleaf/alloc.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined ENHANCED_ALLOC
+
+// The server's allocator already keeps per-thread arenas.
+
+void*
+as_slab_alloc(size_t size)
+{
+	return cf_malloc(size);
+}
+
+void
+as_slab_free(void* p)
+{
+	cf_free(p);
+}
+
+uint64_t
+as_slab_trim(void)
+{
+	return 0;
+}
+
+void
+as_slab_get_stats(as_slab_stats* stats)
+{
+	memset(stats, 0, sizeof(as_slab_stats));
+}
+
+#else // ! defined ENHANCED_ALLOC
+
+/******************************************************************************
+ * TYPES
+ *****************************************************************************/
+
+#define CLASS_GRANULE 16
+#define N_CLASSES (AS_SLAB_MAX_SIZE / CLASS_GRANULE)
+#define SLAB_SIZE (16 * 1024)
+
+// Each block is preceded by a pointer to its owning size class, and each slab
+// by a link to the next slab of its class. Keep blocks 8 byte aligned on
+// 32-bit platforms too.
+#define PREFIX_SIZE 8
+#define SLAB_HEADER_SIZE 8
+
+typedef struct block_s {
+	struct block_s* next;
+} block;
+
+typedef struct slab_s {
+	struct slab_s* next;
+} slab;
+
+// A slab's free blocks, counted when trimming.
+typedef struct slab_ref_s {
+	uint8_t* start;
+	uint32_t n_free;
+} slab_ref;
+
+struct slab_cache_s;
+
+typedef struct slab_class_s {
+	// Owner thread only.
+	block* free_list;
+	uint64_t allocs;
+	uint64_t frees;
+	uint64_t slab_bytes;
+	struct slab_cache_s* cache;
+	uint32_t block_size;
+	slab* slabs;
+	uint32_t n_slabs;
+
+	// Pushed by other threads, taken whole by the owner.
+	block* remote_list;
+	uint64_t remote_frees;
+} slab_class;
+
+typedef struct slab_cache_s {
+	slab_class classes[N_CLASSES];
+	struct slab_cache_s* next;
+	struct slab_cache_s* next_orphan;
+} slab_cache;
+
+/******************************************************************************
+ * GLOBALS
+ *****************************************************************************/
+
+static __thread slab_cache* t_cache = NULL;
+
+static pthread_once_t g_once = PTHREAD_ONCE_INIT;
+static pthread_key_t g_key;
+static pthread_mutex_t g_lock = PTHREAD_MUTEX_INITIALIZER;
+static slab_cache* g_caches = NULL;
+static slab_cache* g_orphans = NULL;
+static uint32_t g_n_caches = 0;
+static uint32_t g_n_orphans = 0;
+
+/******************************************************************************
+ * STATIC FUNCTIONS
+ *****************************************************************************/
+
+static void
+cache_orphan(void* udata)
+{
+	slab_cache* cache = (slab_cache*)udata;
+
+	// Frees later in this thread's exit path go through the remote lists.
+	t_cache = NULL;
+
+	pthread_mutex_lock(&g_lock);
+	cache->next_orphan = g_orphans;
+	g_orphans = cache;
+	g_n_orphans++;
+	pthread_mutex_unlock(&g_lock);
+}
+
+static void
+key_init(void)
+{
+	pthread_key_create(&g_key, cache_orphan);
+}
+
+static slab_cache*
+cache_get(void)
+{
+	slab_cache* cache = t_cache;
+
+	if (cache != NULL) {
+		return cache;
+	}
+
+	pthread_once(&g_once, key_init);
+	pthread_mutex_lock(&g_lock);
+
+	if (g_orphans != NULL) {
+		cache = g_orphans;
+		g_orphans = cache->next_orphan;
+		g_n_orphans--;
+	}
+	else {
+		cache = (slab_cache*)cf_calloc(1, sizeof(slab_cache));
+
+		if (cache == NULL) {
+			pthread_mutex_unlock(&g_lock);
+			return NULL;
+		}
+
+		for (uint32_t i = 0; i < N_CLASSES; i++) {
+			cache->classes[i].cache = cache;
+			cache->classes[i].block_size = (i + 1) * CLASS_GRANULE;
+		}
+
+		cache->next = g_caches;
+		g_caches = cache;
+		g_n_caches++;
+	}
+
+	pthread_mutex_unlock(&g_lock);
+
+	pthread_setspecific(g_key, cache);
+	t_cache = cache;
+
+	return cache;
+}
+
+static block*
+class_refill(slab_class* cls)
+{
+	block* head = (block*)as_load_ptr((void* const*)&cls->remote_list);
+
+	if (head != NULL) {
+		head = (block*)as_fas_ptr((void**)&cls->remote_list, NULL);
+		as_fence_acq();
+		return head;
+	}
+
+	uint32_t stride = PREFIX_SIZE + cls->block_size;
+	uint32_t n_blocks = (SLAB_SIZE - SLAB_HEADER_SIZE) / stride;
+	slab* s = (slab*)cf_malloc(SLAB_SIZE);
+
+	if (s == NULL) {
+		return NULL;
+	}
+
+	s->next = cls->slabs;
+	cls->slabs = s;
+	cls->n_slabs++;
+
+	uint8_t* start = (uint8_t*)s + SLAB_HEADER_SIZE;
+
+	for (uint32_t i = n_blocks; i > 0; i--) {
+		uint8_t* p = start + (i - 1) * stride;
+		block* b = (block*)(p + PREFIX_SIZE);
+
+		*(slab_class**)p = cls;
+		b->next = head;
+		head = b;
+	}
+
+	as_store_uint64(&cls->slab_bytes, cls->slab_bytes + SLAB_SIZE);
+
+	return head;
+}
+
+static int
+slab_ref_cmp(const void* a, const void* b)
+{
+	uint8_t* sa = ((const slab_ref*)a)->start;
+	uint8_t* sb = ((const slab_ref*)b)->start;
+
+	return sa < sb ? -1 : (sa > sb ? 1 : 0);
+}
+
+// Find the slab holding p, in refs sorted by address.
+static slab_ref*
+slab_ref_find(slab_ref* refs, uint32_t n, const void* p)
+{
+	uint32_t lo = 0;
+	uint32_t hi = n;
+
+	while (hi - lo > 1) {
+		uint32_t mid = (lo + hi) / 2;
+
+		if ((const uint8_t*)p < refs[mid].start) {
+			hi = mid;
+		}
+		else {
+			lo = mid;
+		}
+	}
+	return &refs[lo];
+}
+
+//
+// Free the class's slabs whose blocks are all free. Called by the owner, or
+// with g_lock held for an orphaned cache.
+//
+static uint64_t
+class_trim(slab_class* cls)
+{
+	// Blocks freed by other threads so far count as free too.
+	block* remote = (block*)as_fas_ptr((void**)&cls->remote_list, NULL);
+
+	if (remote != NULL) {
+		as_fence_acq();
+
+		block* tail = remote;
+
+		while (tail->next != NULL) {
+			tail = tail->next;
+		}
+
+		tail->next = cls->free_list;
+		cls->free_list = remote;
+	}
+
+	uint32_t n = cls->n_slabs;
+
+	if (n == 0 || cls->free_list == NULL) {
+		return 0;
+	}
+
+	slab_ref* refs = (slab_ref*)cf_malloc(n * sizeof(slab_ref));
+
+	if (refs == NULL) {
+		return 0;
+	}
+
+	uint32_t i = 0;
+
+	for (slab* s = cls->slabs; s != NULL; s = s->next) {
+		refs[i].start = (uint8_t*)s;
+		refs[i].n_free = 0;
+		i++;
+	}
+
+	qsort(refs, n, sizeof(slab_ref), slab_ref_cmp);
+
+	for (block* b = cls->free_list; b != NULL; b = b->next) {
+		slab_ref_find(refs, n, b)->n_free++;
+	}
+
+	uint32_t n_blocks = (SLAB_SIZE - SLAB_HEADER_SIZE) /
+			(PREFIX_SIZE + cls->block_size);
+
+	// Drop the blocks of empty slabs from the free list, then the slabs.
+	block** pb = &cls->free_list;
+
+	while (*pb != NULL) {
+		if (slab_ref_find(refs, n, *pb)->n_free == n_blocks) {
+			*pb = (*pb)->next;
+		}
+		else {
+			pb = &(*pb)->next;
+		}
+	}
+
+	uint64_t bytes = 0;
+	slab** ps = &cls->slabs;
+
+	while (*ps != NULL) {
+		slab* s = *ps;
+
+		if (slab_ref_find(refs, n, s)->n_free == n_blocks) {
+			*ps = s->next;
+			cf_free(s);
+			cls->n_slabs--;
+			bytes += SLAB_SIZE;
+		}
+		else {
+			ps = &s->next;
+		}
+	}
+
+	cf_free(refs);
+	as_store_uint64(&cls->slab_bytes, cls->slab_bytes - bytes);
+
+	return bytes;
+}
+
+static uint64_t
+cache_trim(slab_cache* cache)
+{
+	uint64_t bytes = 0;
+
+	for (uint32_t i = 0; i < N_CLASSES; i++) {
+		bytes += class_trim(&cache->classes[i]);
+	}
+	return bytes;
+}
+
+/******************************************************************************
+ * FUNCTIONS
+ *****************************************************************************/
+
+void*
+as_slab_alloc(size_t size)
+{
+	slab_cache* cache;
+
+	if (size > AS_SLAB_MAX_SIZE || (cache = cache_get()) == NULL) {
+		uint8_t* p = (uint8_t*)cf_malloc(PREFIX_SIZE + size);
+
+		if (p == NULL) {
+			return NULL;
+		}
+
+		*(slab_class**)p = NULL;
+		return p + PREFIX_SIZE;
+	}
+
+	slab_class* cls = &cache->classes[
+			size == 0 ? 0 : (size - 1) / CLASS_GRANULE];
+	block* b = cls->free_list;
+
+	if (b == NULL && (b = class_refill(cls)) == NULL) {
+		return NULL;
+	}
+
+	cls->free_list = b->next;
+	as_store_uint64(&cls->allocs, cls->allocs + 1);
+
+	return b;
+}
+
+void
+as_slab_free(void* p)
+{
+	uint8_t* prefix = (uint8_t*)p - PREFIX_SIZE;
+	slab_class* cls = *(slab_class**)prefix;
+
+	if (cls == NULL) {
+		cf_free(prefix);
+		return;
+	}
+
+	block* b = (block*)p;
+
+	if (cls->cache == t_cache) {
+		b->next = cls->free_list;
+		cls->free_list = b;
+		as_store_uint64(&cls->frees, cls->frees + 1);
+		return;
+	}
+
+	// Lock-free push - the owner only ever takes the whole list, so there
+	// is no ABA problem.
+	block* head;
+
+	do {
+		head = (block*)as_load_ptr((void* const*)&cls->remote_list);
+		b->next = head;
+		as_fence_rls();
+	} while (! as_cas_ptr((void**)&cls->remote_list, head, b));
+
+	as_incr_uint64(&cls->remote_frees);
+}
+
+uint64_t
+as_slab_trim(void)
+{
+	uint64_t bytes = 0;
+
+	if (t_cache != NULL) {
+		bytes += cache_trim(t_cache);
+	}
+
+	// Orphaned caches have no owner - holding the lock keeps new threads
+	// from adopting them meanwhile.
+	pthread_mutex_lock(&g_lock);
+
+	for (slab_cache* cache = g_orphans; cache != NULL;
+			cache = cache->next_orphan) {
+		bytes += cache_trim(cache);
+	}
+
+	pthread_mutex_unlock(&g_lock);
+
+	return bytes;
+}
+
+void
+as_slab_get_stats(as_slab_stats* stats)
+{
+	memset(stats, 0, sizeof(as_slab_stats));
+
+	pthread_mutex_lock(&g_lock);
+
+	for (slab_cache* cache = g_caches; cache != NULL; cache = cache->next) {
+		for (uint32_t i = 0; i < N_CLASSES; i++) {
+			slab_class* cls = &cache->classes[i];
+
+			stats->allocs += as_load_uint64(&cls->allocs);
+			stats->frees += as_load_uint64(&cls->frees);
+			stats->remote_frees += as_load_uint64(&cls->remote_frees);
+			stats->slab_bytes += as_load_uint64(&cls->slab_bytes);
+		}
+	}
+
+	stats->caches = g_n_caches;
+	stats->orphans = g_n_orphans;
+
+	pthread_mutex_unlock(&g_lock);
+}
+
+#endif // defined ENHANCED_ALLOC
@@ -0,0 +1,223 @@
+/*
+ * Copyright 2026 Aerospike, Inc.
+ *
+ * Portions may be licensed to Aerospike, Inc. under one or more contributor
+ * license agreements.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+#include <aerospike/as_spsc.h>
+#include <aerospike/as_arch.h>
+#include <citrusleaf/alloc.h>
+#include <sched.h>
+
+/******************************************************************************
+ * STATIC FUNCTIONS
+ *****************************************************************************/
+
+static bool
+as_spsc_readable(void* udata)
+{
+	as_spsc* q = (as_spsc*)udata;
+
+	// Called by the consumer, which owns head.
+	return as_load_uint32_acq(&q->tail) != q->head;
+}
+
+static bool
+as_spsc_writable(void* udata)
+{
+	as_spsc* q = (as_spsc*)udata;
+
+	// Called by the producer, which owns tail.
+	return q->tail - as_load_uint32_acq(&q->head) <= q->mask;
+}
+
+//
+// Wait until ready() or the deadline. A non-blocking ring has no one to wake
+// it, so it polls - pausing, and now and then letting other threads in.
+//
+static bool
+as_spsc_wait(as_spsc* q, as_eventcount* ec, as_eventcount_ready_fn ready,
+	uint64_t deadline)
+{
+	if (q->blocking) {
+		return as_eventcount_await(ec, ready, q, deadline);
+	}
+
+	for (uint32_t i = 0; ! ready(q); i++) {
+		if ((i & 15) == 15) {
+			if (deadline != AS_EVENTCOUNT_FOREVER && cf_getns() >= deadline) {
+				return ready(q);
+			}
+
+			sched_yield();
+		}
+		else {
+#if defined(as_arch_pause)
+			as_arch_pause();
+#endif
+		}
+	}
+	return true;
+}
+
+//
+// Copy in up to n items, in at most two segments - up to the end of the ring,
+// then from its start.
+//
+static uint32_t
+as_spsc_put(as_spsc* q, const uint8_t* src, uint32_t n)
+{
+	uint32_t tail = q->tail;
+	uint32_t room = q->mask + 1 - (tail - q->head_cache);
+
+	if (room < n) {
+		q->head_cache = as_load_uint32_acq(&q->head);
+		room = q->mask + 1 - (tail - q->head_cache);
+	}
+
+	uint32_t count = room < n ? room : n;
+
+	if (count == 0) {
+		return 0;
+	}
+
+	uint32_t offset = tail & q->mask;
+	uint32_t end_count = q->mask + 1 - offset;
+
+	if (end_count > count) {
+		end_count = count;
+	}
+
+	memcpy(&q->items[offset * q->item_size], src, end_count * q->item_size);
+	memcpy(q->items, src + end_count * q->item_size,
+			(count - end_count) * q->item_size);
+
+	as_store_uint32_rls(&q->tail, tail + count);
+
+	if (q->blocking) {
+		as_eventcount_notify(&q->not_empty, 1);
+	}
+	return count;
+}
+
+//
+// Copy out up to n items, in at most two segments.
+//
+static uint32_t
+as_spsc_take(as_spsc* q, uint8_t* dst, uint32_t n)
+{
+	uint32_t head = q->head;
+	uint32_t avail = q->tail_cache - head;
+
+	if (avail < n) {
+		q->tail_cache = as_load_uint32_acq(&q->tail);
+		avail = q->tail_cache - head;
+	}
+
+	uint32_t count = avail < n ? avail : n;
+
+	if (count == 0) {
+		return 0;
+	}
+
+	uint32_t offset = head & q->mask;
+	uint32_t end_count = q->mask + 1 - offset;
+
+	if (end_count > count) {
+		end_count = count;
+	}
+
+	memcpy(dst, &q->items[offset * q->item_size], end_count * q->item_size);
+	memcpy(dst + end_count * q->item_size, q->items,
+			(count - end_count) * q->item_size);
+
+	as_store_uint32_rls(&q->head, head + count);
+
+	if (q->blocking) {
+		as_eventcount_notify(&q->not_full, 1);
+	}
+	return count;
+}
+
+/******************************************************************************
+ * FUNCTIONS
+ *****************************************************************************/
+
+bool
+as_spsc_init(as_spsc* q, uint32_t item_size, uint32_t capacity, bool blocking)
+{
+	uint32_t n = 1;
+
+	while (n < capacity && n < 0x80000000) {
+		n <<= 1;
+	}
+
+	memset(q, 0, sizeof(as_spsc));
+	q->items = cf_malloc((size_t)n * item_size);
+
+	if (! q->items) {
+		return false;
+	}
+
+	q->mask = n - 1;
+	q->item_size = item_size;
+	q->blocking = blocking;
+	as_eventcount_init(&q->not_empty, AS_EVENTCOUNT_SPIN);
+	as_eventcount_init(&q->not_full, AS_EVENTCOUNT_SPIN);
+	return true;
+}
+
+void
+as_spsc_destroy(as_spsc* q)
+{
+	as_eventcount_destroy(&q->not_full);
+	as_eventcount_destroy(&q->not_empty);
+	cf_free(q->items);
+	q->items = NULL;
+}
+
+uint32_t
+as_spsc_push_n(as_spsc* q, const void* ptr, uint32_t n, int wait_ms)
+{
+	const uint8_t* src = (const uint8_t*)ptr;
+	uint32_t pushed = as_spsc_put(q, src, n);
+
+	if (pushed == n || wait_ms == 0) {
+		return pushed;
+	}
+
+	uint64_t deadline = as_eventcount_deadline(wait_ms);
+
+	while (pushed < n &&
+			as_spsc_wait(q, &q->not_full, as_spsc_writable, deadline)) {
+		pushed += as_spsc_put(q, src + pushed * q->item_size, n - pushed);
+	}
+	return pushed;
+}
+
+uint32_t
+as_spsc_pop_n(as_spsc* q, void* ptr, uint32_t n, int wait_ms)
+{
+	uint32_t count = as_spsc_take(q, (uint8_t*)ptr, n);
+
+	if (count != 0 || n == 0 || wait_ms == 0) {
+		return count;
+	}
+
+	uint64_t deadline = as_eventcount_deadline(wait_ms);
+
+	if (! as_spsc_wait(q, &q->not_empty, as_spsc_readable, deadline)) {
+		return 0;
+	}
+	return as_spsc_take(q, (uint8_t*)ptr, n);
+}
@@ -0,0 +1,139 @@
+/*
+ * Copyright 2026 Aerospike, Inc.
+ *
+ * Portions may be licensed to Aerospike, Inc. under one or more contributor
+ * license agreements.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+#include <aerospike/as_stats.h>
+#include <aerospike/as_atomic.h>
+
+// How long the tick clock is timed against cf_getns().
+#define CALIBRATE_NS (1000 * 1000)
+
+/******************************************************************************
+ * GLOBALS
+ *****************************************************************************/
+
+uint64_t g_as_stats_tick_mult = 1ULL << 32;
+
+static pthread_once_t g_clock_once = PTHREAD_ONCE_INIT;
+
+/******************************************************************************
+ * STATIC FUNCTIONS
+ *****************************************************************************/
+
+static void
+clock_calibrate(void)
+{
+#if defined(__aarch64__) && defined(as_arch_ticks)
+	// The timer's frequency is published by the system.
+	uint64_t freq;
+
+	asm volatile("mrs %0, cntfrq_el0" : "=r" (freq));
+
+	if (freq != 0) {
+		g_as_stats_tick_mult = (1000ULL * 1000 * 1000 << 32) / freq;
+	}
+#elif defined(as_arch_ticks)
+	// Count ticks across a short busy wait on the monotonic clock.
+	uint64_t ns0 = cf_getns();
+	uint64_t ticks0 = as_stats_ticks();
+	uint64_t ns1;
+
+	do {
+		ns1 = cf_getns();
+	} while (ns1 - ns0 < CALIBRATE_NS);
+
+	uint64_t ticks = as_stats_ticks() - ticks0;
+
+	if (ticks != 0) {
+		g_as_stats_tick_mult = ((ns1 - ns0) << 32) / ticks;
+	}
+#endif
+}
+
+/******************************************************************************
+ * FUNCTIONS
+ *****************************************************************************/
+
+void
+as_stats_clock_init(void)
+{
+	pthread_once(&g_clock_once, clock_calibrate);
+}
+
+void
+as_histogram_merge(as_histogram* dst, const as_histogram* src)
+{
+	dst->count += as_load_uint64(&src->count);
+	dst->sum += as_load_uint64(&src->sum);
+
+	uint64_t max = as_load_uint64(&src->max);
+
+	if (max > dst->max) {
+		dst->max = max;
+	}
+
+	for (uint32_t i = 0; i < AS_HISTOGRAM_BUCKETS; i++) {
+		dst->buckets[i] += as_load_uint64(&src->buckets[i]);
+	}
+}
+
+uint64_t
+as_histogram_percentile(const as_histogram* h, double pct)
+{
+	uint64_t total = 0;
+
+	for (uint32_t i = 0; i < AS_HISTOGRAM_BUCKETS; i++) {
+		total += h->buckets[i];
+	}
+
+	if (total == 0) {
+		return 0;
+	}
+
+	// The rank of the sample wanted, counting from 1.
+	uint64_t rank = (uint64_t)(pct / 100.0 * (double)total + 0.5);
+
+	if (rank == 0) {
+		rank = 1;
+	}
+
+	uint64_t seen = 0;
+
+	for (uint32_t i = 0; i < AS_HISTOGRAM_BUCKETS - 1; i++) {
+		seen += h->buckets[i];
+
+		if (seen >= rank) {
+			uint64_t top = i == 0 ? 0 : (1ULL << i) - 1;
+
+			return top < h->max ? top : h->max;
+		}
+	}
+	return h->max;
+}
+
+void
+as_queue_stats_merge(as_queue_stats* dst, const as_queue_stats* src)
+{
+	dst->lock_count += src->lock_count;
+	dst->lock_contended += src->lock_contended;
+	dst->wakeups += src->wakeups;
+	dst->parks += src->parks;
+
+	if (src->depth_max > dst->depth_max) {
+		dst->depth_max = src->depth_max;
+	}
+
+	as_histogram_merge(&dst->lock_wait, &src->lock_wait);
+}
@@ -15,6 +15,8 @@
  * the License.
  */
 #include <aerospike/as_string.h>
+#include <aerospike/as_slab.h>
+#include <aerospike/as_atomic.h>
 #include <citrusleaf/alloc.h>
 #include <string.h>
 
@@ -28,6 +30,7 @@ static inline as_string * as_string_cons(as_string * string, bool free, char * v
 
 	as_val_cons((as_val *) string, AS_STRING, free);
 	string->free = value_free;
+	string->hash = 0;
 	string->value = value;
 	string->len = len;
 	return string;
@@ -45,14 +48,14 @@ as_string * as_string_init_wlen(as_string * string, char * value, size_t len, bo
 
 as_string * as_string_new(char * value, bool free)
 {
-	as_string * string = (as_string *) cf_malloc(sizeof(as_string));
-	return as_string_cons(string, true, value, SIZE_MAX, free);
+	as_string * string = (as_string *) as_slab_alloc(sizeof(as_string));
+	return (as_string *) as_slab_val((as_val *) as_string_cons(string, true, value, SIZE_MAX, free));
 }
 
 as_string * as_string_new_wlen(char * value, size_t len, bool free)
 {
-	as_string * string = (as_string *) cf_malloc(sizeof(as_string));
-	return as_string_cons(string, true, value, len, free);
+	as_string * string = (as_string *) as_slab_alloc(sizeof(as_string));
+	return (as_string *) as_slab_val((as_val *) as_string_cons(string, true, value, len, free));
 }
 
 as_string *as_string_new_strdup(const char * s)
@@ -60,6 +63,19 @@ as_string *as_string_new_strdup(const char * s)
 	return as_string_new(cf_strdup(s), true);
 }
 
+as_string * as_string_new_strndup(const char * value, size_t len)
+{
+	// The characters follow the header - short strings still fit a slab block.
+	as_string * string = (as_string *) as_slab_alloc(sizeof(as_string) + len + 1);
+	if ( !string ) return string;
+
+	char * str = (char *) (string + 1);
+
+	memcpy(str, value, len);
+	str[len] = 0;
+	return (as_string *) as_slab_val((as_val *) as_string_cons(string, true, str, len, false));
+}
+
 /******************************************************************************
  *	VALUE FUNCTIONS
  ******************************************************************************/
@@ -165,12 +181,17 @@ uint32_t as_string_val_hashcode(const as_val * v)
 {
 	as_string * string = as_string_fromval(v);
 	if ( string == NULL || string->value == NULL) return 0;
-	uint32_t hash = 0;
+
+	// Strings are immutable once shared, so a racing store writes the same hash.
+	uint32_t hash = as_load_uint32(&string->hash);
+	if ( hash != 0 ) return hash;
+
 	int c;
 	char * str = string->value;
 	while ( (c = *str++) ) {
 		hash = c + (hash << 6) + (hash << 16) - hash;
 	}
+	as_store_uint32(&string->hash, hash);
 	return hash;
 }
 
@@ -18,6 +18,7 @@
 #include <aerospike/as_atomic.h>
 #include <aerospike/as_thread.h>
 #include <citrusleaf/alloc.h>
+#include <sched.h>
 #include <string.h>
 
 //---------------------------------
@@ -27,8 +28,877 @@
 typedef struct as_thread_pool_task_s {
 	as_task_fn task_fn;
 	void* task_data;
+	as_task_group* group;
+	as_task_fn cancel_fn;
+	uint64_t deadline;
+
+	// When queued, in as_stats_ticks(), if the pool keeps stats.
+	uint64_t queued;
 } as_thread_pool_task;
 
+// Circular array of a worker's deque. An array replaced by a bigger one is
+// kept until the pool is destroyed, since a thief may still be reading it.
+typedef struct as_deque_array_s {
+	struct as_deque_array_s* prev;
+	uint64_t mask;
+	as_thread_pool_task tasks[];
+} as_deque_array;
+
+// Chase-Lev work-stealing deque, plus the worker's other state. The owner
+// pushes and takes at bottom, thieves take at top - kept on separate cache
+// lines.
+typedef struct as_thread_pool_worker_s {
+	uint64_t top;
+	uint8_t pad0[56];
+	uint64_t bottom;
+	as_deque_array* array;
+	as_thread_pool* pool;
+	uint32_t index;
+	uint32_t seed;
+
+	// Position in the pool's lane schedule.
+	uint32_t tick;
+
+	// The slot has a thread, not yet joined. Guarded by the pool lock.
+	uint8_t used;
+
+	// The worker is told to stop once it finds no task - WORKER_RETIRING - or
+	// has committed to stopping - WORKER_LEAVING. Set under the pool lock.
+	uint8_t retire;
+
+	// The worker's thread is returning, and can be joined without waiting.
+	uint8_t exited;
+
+	uint8_t pad1[25];
+} as_thread_pool_worker;
+
+// Counters of a worker slot, written only by the slot's worker. Padded to a
+// multiple of the cache line size.
+typedef struct as_thread_pool_worker_stats_s {
+	uint64_t tasks;
+	uint64_t expired;
+	uint64_t steals;
+	as_histogram wait;
+	as_histogram run;
+	uint8_t pad[56];
+} as_thread_pool_worker_stats;
+
+#define WORKER_RETIRING 1
+#define WORKER_LEAVING 2
+
+#define DEQUE_INIT_SIZE 256
+
+// Most tasks a worker moves from the injection queue at once.
+#define INJECT_BATCH 16
+
+// Most tasks pushed onto the injection queue at once.
+#define QUEUE_BATCH 64
+
+// Longest lane schedule - weights are scaled down to fit.
+#define LANE_SCHEDULE_MAX 1024
+
+//---------------------------------
+// Globals
+//---------------------------------
+
+static __thread as_thread_pool_worker* t_worker = NULL;
+
+void* as_thread_worker(void* data);
+
+//---------------------------------
+// Static Functions
+//---------------------------------
+
+static as_deque_array*
+deque_array_create(uint64_t size, as_deque_array* prev)
+{
+	as_deque_array* a = cf_malloc(sizeof(as_deque_array) + size * sizeof(as_thread_pool_task));
+
+	if (a) {
+		a->prev = prev;
+		a->mask = size - 1;
+	}
+	return a;
+}
+
+static as_deque_array*
+deque_grow(as_thread_pool_worker* w, as_deque_array* a, uint64_t top, uint64_t bottom)
+{
+	as_deque_array* n = deque_array_create((a->mask + 1) * 2, a);
+
+	if (! n) {
+		return NULL;
+	}
+
+	for (uint64_t i = top; i < bottom; i++) {
+		n->tasks[i & n->mask] = a->tasks[i & a->mask];
+	}
+
+	as_store_ptr_rls((void**)&w->array, n);
+	return n;
+}
+
+// Owner only.
+static bool
+deque_push(as_thread_pool_worker* w, const as_thread_pool_task* task)
+{
+	uint64_t b = w->bottom;
+	uint64_t t = as_load_uint64_acq(&w->top);
+	as_deque_array* a = w->array;
+
+	if (b - t > a->mask) {
+		a = deque_grow(w, a, t, b);
+
+		if (! a) {
+			return false;
+		}
+	}
+
+	a->tasks[b & a->mask] = *task;
+
+	// Publish the task before the new bottom.
+	as_fence_rls();
+	as_store_uint64(&w->bottom, b + 1);
+	return true;
+}
+
+// Owner only - takes the newest task.
+static bool
+deque_take(as_thread_pool_worker* w, as_thread_pool_task* task)
+{
+	uint64_t b = w->bottom - 1;
+	as_deque_array* a = w->array;
+
+	as_store_uint64(&w->bottom, b);
+
+	// Pairs with the fence in deque_steal() - a thief and the owner can't
+	// both miss each other's claim on the last task.
+	as_fence_seq();
+
+	uint64_t t = as_load_uint64(&w->top);
+
+	if ((int64_t)(b - t) < 0) {
+		as_store_uint64(&w->bottom, b + 1);
+		return false;
+	}
+
+	*task = a->tasks[b & a->mask];
+
+	if (b != t) {
+		return true;
+	}
+
+	// The last task - race the thieves for it.
+	bool won = as_cas_uint64(&w->top, t, t + 1);
+
+	as_store_uint64(&w->bottom, b + 1);
+	return won;
+}
+
+// Takes the oldest task. Returns 1 on success, 0 if the deque was empty and
+// -1 if another thread took the task first.
+static int
+deque_steal(as_thread_pool_worker* v, as_thread_pool_task* task)
+{
+	uint64_t t = as_load_uint64_acq(&v->top);
+
+	as_fence_seq();
+
+	uint64_t b = as_load_uint64_acq(&v->bottom);
+
+	if ((int64_t)(b - t) <= 0) {
+		return 0;
+	}
+
+	as_deque_array* a = as_load_ptr_acq((void* const*)&v->array);
+
+	// The slot may be overwritten as we copy it, but only after top moves -
+	// then the CAS fails and the copy is thrown away.
+	*task = a->tasks[t & a->mask];
+
+	as_fence_seq();
+	return as_cas_uint64(&v->top, t, t + 1) ? 1 : -1;
+}
+
+static inline bool
+deque_empty(as_thread_pool_worker* w)
+{
+	return (int64_t)(as_load_uint64(&w->bottom) - as_load_uint64(&w->top)) <= 0;
+}
+
+static inline uint32_t
+next_rand(uint32_t* seed)
+{
+	// xorshift32
+	uint32_t x = *seed;
+
+	x ^= x << 13;
+	x ^= x >> 17;
+	x ^= x << 5;
+	*seed = x;
+	return x;
+}
+
+// Steal from the other workers, starting from a random one. Self is NULL for
+// a thread outside the pool.
+static bool
+pool_steal(as_thread_pool* pool, as_thread_pool_worker* self, uint32_t* seed,
+	as_thread_pool_task* task)
+{
+	uint32_t n_workers = pool->worker_size;
+
+	while (n_workers > (self ? 1 : 0)) {
+		uint32_t start = next_rand(seed) % n_workers;
+		bool contended = false;
+
+		for (uint32_t i = 0; i < n_workers; i++) {
+			as_thread_pool_worker* v = &pool->workers[(start + i) % n_workers];
+
+			if (v == self) {
+				continue;
+			}
+
+			int rv = deque_steal(v, task);
+
+			if (rv > 0) {
+				if (self && pool->stats) {
+					pool->stats[self->index].steals++;
+				}
+				return true;
+			}
+
+			if (rv < 0) {
+				contended = true;
+			}
+		}
+
+		// Only give up after a sweep without lost races.
+		if (! contended) {
+			break;
+		}
+	}
+	return false;
+}
+
+static void
+task_group_done(as_task_group* group)
+{
+	// Publish the task's work to the waiter.
+	as_fence_rls();
+
+	uint32_t pending = as_load_uint32(&group->pending);
+
+	while (true) {
+		if (pending == 2) {
+			// The last task - close the group.
+			if (as_cas_uint32(&group->pending, 2, 1)) {
+				break;
+			}
+		}
+		else if (as_cas_uint32(&group->pending, pending, pending - 2)) {
+			return;
+		}
+
+		pending = as_load_uint32(&group->pending);
+	}
+
+	as_fence_seq();
+	as_eventcount_notify(&group->ec, UINT32_MAX);
+
+	if (as_load_uint32(&group->pool_waiters) != 0) {
+		as_eventcount_notify(&group->pool->ec, UINT32_MAX);
+	}
+
+	// Done with the group - the waiter may now destroy it.
+	as_aaf_uint32_rls(&group->pending, -1);
+}
+
+// Run a task, or cancel it if past its deadline. Returns false if cancelled.
+static inline bool
+task_run(const as_thread_pool_task* task)
+{
+	bool ran = task->deadline == 0 || cf_getns() <= task->deadline;
+
+	if (ran) {
+		task->task_fn(task->task_data);
+	}
+	else if (task->cancel_fn) {
+		// Too late to be of use.
+		task->cancel_fn(task->task_data);
+	}
+
+	if (task->group) {
+		task_group_done(task->group);
+	}
+	return ran;
+}
+
+// Run a task on a worker of its pool, counting it if the pool keeps stats.
+static void
+worker_run(as_thread_pool_worker* w, const as_thread_pool_task* task)
+{
+	as_thread_pool* pool = w->pool;
+
+	if (! pool->stats) {
+		task_run(task);
+		return;
+	}
+
+	as_thread_pool_worker_stats* st = &pool->stats[w->index];
+	uint64_t start = as_stats_ticks();
+
+	as_histogram_add(&st->wait, as_stats_ns(start - task->queued));
+
+	if (! task_run(task)) {
+		st->expired++;
+	}
+
+	st->tasks++;
+	as_histogram_add(&st->run, as_stats_ns(as_stats_ticks() - start));
+}
+
+// Stamp tasks with the time they are queued.
+static inline void
+pool_stamp(as_thread_pool* pool, as_thread_pool_task* tasks, uint32_t n)
+{
+	uint64_t now = pool->stats ? as_stats_ticks() : 0;
+
+	for (uint32_t i = 0; i < n; i++) {
+		tasks[i].queued = now;
+	}
+}
+
+static inline bool
+lane_pop(cf_queue* q, as_thread_pool_task* task)
+{
+	return as_load_uint32(&q->n_eles) != 0 &&
+			cf_queue_pop(q, task, CF_QUEUE_NOWAIT) == CF_QUEUE_OK;
+}
+
+static bool
+worker_inject(as_thread_pool_worker* w, as_thread_pool_task* task)
+{
+	as_thread_pool* pool = w->pool;
+	uint32_t size = as_load_uint32(&pool->dispatch_queue->n_eles);
+
+	if (size != 0) {
+		// Move a fair share of the injection queue over, so that one lock
+		// hold serves several tasks. Other workers can steal the extras.
+		as_thread_pool_task batch[INJECT_BATCH];
+		uint32_t max = size / pool->worker_size + 1;
+		uint32_t n = cf_queue_pop_n(pool->dispatch_queue, batch,
+				max < INJECT_BATCH ? max : INJECT_BATCH, CF_QUEUE_NOWAIT);
+
+		if (n != 0) {
+			// Reversed, so this worker still runs them in order.
+			for (uint32_t i = n - 1; i > 0; i--) {
+				if (! deque_push(w, &batch[i])) {
+					worker_run(w, &batch[i]);
+				}
+			}
+
+			if (n > 1) {
+				as_eventcount_notify(&pool->ec, n - 1);
+			}
+
+			*task = batch[0];
+			return true;
+		}
+	}
+	return false;
+}
+
+// Find a lane 0 task - on the calling thread's own deque, in the injection
+// queue, or on other workers' deques. W is NULL for a thread outside the pool.
+static inline bool
+pool_find_first(as_thread_pool* pool, as_thread_pool_worker* w, uint32_t* seed,
+	as_thread_pool_task* task)
+{
+	if (! w) {
+		return lane_pop(pool->dispatch_queue, task) ||
+				pool_steal(pool, NULL, seed, task);
+	}
+
+	return deque_take(w, task) || worker_inject(w, task) ||
+			pool_steal(pool, w, seed, task);
+}
+
+// Find a task in the lower lanes set in mask, highest first. Lane skip was
+// already tried.
+static inline bool
+pool_find_lanes(as_thread_pool* pool, uint32_t mask, uint32_t skip,
+	as_thread_pool_task* task)
+{
+	for (uint32_t i = 1; i < pool->n_lanes; i++) {
+		if ((mask & (1u << i)) != 0 && i != skip &&
+				lane_pop(pool->lanes[i], task)) {
+			return true;
+		}
+	}
+	return false;
+}
+
+// Find a task in any lane, highest first - but lanes of weight 0 only after
+// all the others.
+static bool
+pool_find(as_thread_pool* pool, as_thread_pool_worker* w, uint32_t* seed,
+	uint32_t skip, as_thread_pool_task* task)
+{
+	uint32_t unweighted = pool->lanes_unweighted;
+
+	if ((unweighted & 1) == 0 && pool_find_first(pool, w, seed, task)) {
+		return true;
+	}
+
+	if (pool_find_lanes(pool, ~unweighted, skip, task)) {
+		return true;
+	}
+
+	if ((unweighted & 1) != 0 && pool_find_first(pool, w, seed, task)) {
+		return true;
+	}
+
+	return pool_find_lanes(pool, unweighted, skip, task);
+}
+
+static inline bool
+worker_find(as_thread_pool_worker* w, as_thread_pool_task* task)
+{
+	as_thread_pool* pool = w->pool;
+	uint32_t first = 0;
+
+	// With lane weights, each search is a turn. A lower lane's turn comes
+	// before the worker's own deque, which holds lane 0 tasks. An empty lane
+	// passes its turn on.
+	if (pool->lane_schedule) {
+		first = pool->lane_schedule[w->tick++ % pool->lane_schedule_size];
+
+		if (first != 0 && lane_pop(pool->lanes[first], task)) {
+			return true;
+		}
+	}
+
+	return pool_find(pool, w, &w->seed, first, task);
+}
+
+// Find a task for the calling thread, which need not be a worker.
+static bool
+pool_help(as_thread_pool* pool, as_thread_pool_task* task)
+{
+	as_thread_pool_worker* w = t_worker;
+
+	if (w && w->pool == pool) {
+		return worker_find(w, task);
+	}
+
+	if (pool->worker_size == 0) {
+		return false;
+	}
+
+	uint32_t seed = (uint32_t)(uintptr_t)task | 1;
+
+	return pool_find(pool, NULL, &seed, 0, task);
+}
+
+static bool
+pool_has_work(as_thread_pool* pool)
+{
+	for (uint32_t i = 0; i < pool->n_lanes; i++) {
+		if (as_load_uint32(&pool->lanes[i]->n_eles) != 0) {
+			return true;
+		}
+	}
+
+	for (uint32_t i = 0; i < pool->worker_size; i++) {
+		if (! deque_empty(&pool->workers[i])) {
+			return true;
+		}
+	}
+	return false;
+}
+
+static bool
+pool_ready(void* udata)
+{
+	as_thread_pool* pool = udata;
+
+	return as_load_uint8(&pool->shutdown) != 0 || pool_has_work(pool);
+}
+
+static bool
+worker_ready(void* udata)
+{
+	as_thread_pool_worker* w = udata;
+
+	return as_load_uint8(&w->retire) != 0 || pool_ready(w->pool);
+}
+
+// Whether the pool takes tasks from the calling thread. Workers may still
+// queue tasks while the pool is being destroyed - they run them before
+// exiting.
+static inline bool
+pool_accepts(as_thread_pool* pool)
+{
+	return as_load_uint32(&pool->thread_size) != 0 ||
+			(t_worker && t_worker->pool == pool);
+}
+
+// Start a worker in a free slot. Call with the pool lock held.
+static bool
+pool_start_worker(as_thread_pool* pool)
+{
+	// A worker told to stop, but still running, can simply carry on.
+	for (uint32_t i = 0; i < pool->worker_size; i++) {
+		as_thread_pool_worker* w = &pool->workers[i];
+
+		if (w->used && w->retire == WORKER_RETIRING) {
+			as_store_uint8(&w->retire, 0);
+			as_incr_uint32(&pool->thread_size);
+			return true;
+		}
+	}
+
+	for (uint32_t i = 0; i < pool->worker_size; i++) {
+		as_thread_pool_worker* w = &pool->workers[i];
+
+		if (w->used) {
+			// A stopped worker's slot is free once its thread has returned -
+			// which a leaving worker is about to do.
+			if (as_load_uint8_acq(&w->exited) == 0 && w->retire != WORKER_LEAVING) {
+				continue;
+			}
+
+			pthread_join(pool->threads[i], NULL);
+			w->used = 0;
+		}
+
+		// Deques are created on first use, and kept for later workers in
+		// the slot.
+		if (! w->array) {
+			w->array = deque_array_create(DEQUE_INIT_SIZE, NULL);
+
+			if (! w->array) {
+				return false;
+			}
+		}
+
+		w->retire = 0;
+		w->exited = 0;
+
+		if (pthread_create(&pool->threads[i], NULL, as_thread_worker, w) != 0) {
+			return false;
+		}
+
+		w->used = 1;
+		as_incr_uint32(&pool->thread_size);
+		return true;
+	}
+	return false;
+}
+
+// Start a worker if reaping left the pool below its size and no worker is
+// idle to take new tasks.
+static void
+pool_regrow(as_thread_pool* pool)
+{
+	if (pthread_mutex_trylock(&pool->lock) != 0) {
+		return;
+	}
+
+	if (as_load_uint8(&pool->shutdown) == 0 &&
+			pool->thread_size < pool->target_size) {
+		pool_start_worker(pool);
+	}
+
+	pthread_mutex_unlock(&pool->lock);
+}
+
+// Stop a worker idle for the pool's quiet period, unless that leaves too few.
+static void
+worker_reap(as_thread_pool_worker* w)
+{
+	as_thread_pool* pool = w->pool;
+
+	pthread_mutex_lock(&pool->lock);
+
+	if (as_load_uint8(&w->retire) == 0 && pool->thread_size > pool->thread_min) {
+		as_store_uint8(&w->retire, WORKER_RETIRING);
+		as_decr_uint32(&pool->thread_size);
+	}
+
+	pthread_mutex_unlock(&pool->lock);
+}
+
+// Commit a worker told to stop to exiting, unless the pool grew again and
+// took it back first.
+static bool
+worker_leave(as_thread_pool_worker* w)
+{
+	as_thread_pool* pool = w->pool;
+
+	pthread_mutex_lock(&pool->lock);
+
+	bool leave = w->retire != 0;
+
+	if (leave) {
+		as_store_uint8(&w->retire, WORKER_LEAVING);
+	}
+
+	pthread_mutex_unlock(&pool->lock);
+	return leave;
+}
+
+static void
+worker_set_affinity(as_thread_pool_worker* w)
+{
+#if defined(__linux__)
+	as_thread_pool* pool = w->pool;
+
+	if (pool->n_cpus == 0) {
+		return;
+	}
+
+	cpu_set_t set;
+
+	CPU_ZERO(&set);
+
+	if (pool->cpu_per_worker) {
+		CPU_SET(pool->cpus[w->index % pool->n_cpus], &set);
+	}
+	else {
+		for (uint32_t i = 0; i < pool->n_cpus; i++) {
+			CPU_SET(pool->cpus[i], &set);
+		}
+	}
+
+	pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+#else
+	(void)w;
+#endif
+}
+
+// Wake workers for n new tasks.
+static inline void
+pool_notify(as_thread_pool* pool, uint32_t n)
+{
+	as_eventcount_notify(&pool->ec, n);
+
+	if (as_load_uint32(&pool->thread_size) < as_load_uint32(&pool->target_size) &&
+			as_load_uint32(&pool->ec.waiters) == 0) {
+		pool_regrow(pool);
+	}
+}
+
+// Queue tasks, returning how many were queued.
+static uint32_t
+pool_queue(as_thread_pool* pool, as_thread_pool_task* tasks, uint32_t n)
+{
+	as_thread_pool_worker* w = t_worker;
+	uint32_t queued = 0;
+
+	pool_stamp(pool, tasks, n);
+
+	// A worker of this pool keeps its own tasks - no lock, no shared cache line.
+	if (w && w->pool == pool) {
+		while (queued < n && deque_push(w, &tasks[queued])) {
+			queued++;
+		}
+	}
+
+	if (queued < n) {
+		queued += cf_queue_push_n(pool->dispatch_queue, &tasks[queued], n - queued);
+	}
+
+	if (queued != 0) {
+		pool_notify(pool, queued);
+	}
+	return queued;
+}
+
+// Queue a task with options.
+static bool
+pool_queue_opts(as_thread_pool* pool, as_thread_pool_task* task,
+	const as_task_opts* opts)
+{
+	uint32_t lane = opts->lane < pool->n_lanes ? opts->lane : pool->n_lanes - 1;
+
+	if (lane == 0 && ! opts->front) {
+		return pool_queue(pool, task, 1) == 1;
+	}
+
+	pool_stamp(pool, task, 1);
+
+	cf_queue* q = pool->lanes[lane];
+	int rv = opts->front ? cf_queue_push_head(q, task) : cf_queue_push(q, task);
+
+	if (rv != CF_QUEUE_OK) {
+		return false;
+	}
+
+	pool_notify(pool, 1);
+	return true;
+}
+
+// Queue tasks from an array of task data, in runs of QUEUE_BATCH.
+static uint32_t
+pool_queue_n(as_thread_pool* pool, as_task_fn task_fn, void* const* tasks,
+	uint32_t n, as_task_group* group)
+{
+	as_thread_pool_task batch[QUEUE_BATCH];
+	uint32_t queued = 0;
+
+	while (queued < n) {
+		uint32_t n_batch = n - queued < QUEUE_BATCH ? n - queued : QUEUE_BATCH;
+
+		for (uint32_t i = 0; i < n_batch; i++) {
+			batch[i].task_fn = task_fn;
+			batch[i].task_data = tasks[queued + i];
+			batch[i].group = group;
+			batch[i].cancel_fn = NULL;
+			batch[i].deadline = 0;
+		}
+
+		uint32_t rv = pool_queue(pool, batch, n_batch);
+
+		queued += rv;
+
+		if (rv < n_batch) {
+			break;
+		}
+	}
+	return queued;
+}
+
+static bool
+task_group_ready(void* udata)
+{
+	return as_load_uint32_acq(&((as_task_group*)udata)->pending) <= 1;
+}
+
+// For a waiter that is a worker of the group's pool - it wakes to help too.
+static bool
+task_group_ready_worker(void* udata)
+{
+	as_task_group* group = udata;
+
+	return task_group_ready(group) || pool_has_work(group->pool);
+}
+
+static inline bool
+task_group_has_pool(as_task_group* group)
+{
+	return group->pool && pool_accepts(group->pool);
+}
+
+// Lay out the order workers take lanes in, by smooth weighted round-robin -
+// each lane's turns are spread evenly rather than bunched.
+static bool
+pool_schedule_lanes(as_thread_pool* pool, const uint32_t* lane_weights)
+{
+	uint32_t weights[AS_THREAD_POOL_MAX_LANES];
+	uint32_t total;
+
+	memcpy(weights, lane_weights, pool->n_lanes * sizeof(uint32_t));
+
+	while (true) {
+		total = 0;
+
+		for (uint32_t i = 0; i < pool->n_lanes; i++) {
+			total += weights[i];
+		}
+
+		if (total <= LANE_SCHEDULE_MAX) {
+			break;
+		}
+
+		// Scale down, keeping nonzero weights nonzero.
+		for (uint32_t i = 0; i < pool->n_lanes; i++) {
+			weights[i] = (weights[i] + 1) / 2;
+		}
+	}
+
+	if (total == 0) {
+		// All lanes only run when the others are empty - strict priority.
+		return true;
+	}
+
+	pool->lane_schedule = cf_malloc(total);
+
+	if (! pool->lane_schedule) {
+		return false;
+	}
+
+	int64_t current[AS_THREAD_POOL_MAX_LANES] = { 0 };
+
+	for (uint32_t k = 0; k < total; k++) {
+		uint32_t best = 0;
+
+		for (uint32_t i = 0; i < pool->n_lanes; i++) {
+			current[i] += weights[i];
+
+			if (current[i] > current[best]) {
+				best = i;
+			}
+		}
+
+		current[best] -= total;
+		pool->lane_schedule[k] = (uint8_t)best;
+	}
+
+	pool->lane_schedule_size = total;
+
+	for (uint32_t i = 0; i < pool->n_lanes; i++) {
+		if (weights[i] == 0) {
+			pool->lanes_unweighted |= 1u << i;
+		}
+	}
+	return true;
+}
+
+static void
+pool_free(as_thread_pool* pool)
+{
+	for (uint32_t i = 0; i < pool->worker_size; i++) {
+		as_deque_array* a = pool->workers[i].array;
+
+		while (a) {
+			as_deque_array* prev = a->prev;
+
+			cf_free(a);
+			a = prev;
+		}
+	}
+
+	cf_free(pool->workers);
+	cf_free(pool->threads);
+	cf_free(pool->cpus);
+
+	for (uint32_t i = 0; i < AS_THREAD_POOL_MAX_LANES; i++) {
+		if (pool->lanes[i]) {
+			cf_queue_destroy(pool->lanes[i]);
+			pool->lanes[i] = NULL;
+		}
+	}
+
+	cf_free(pool->lane_schedule);
+	pool->lane_schedule = NULL;
+	pool->lane_schedule_size = 0;
+	pool->lanes_unweighted = 0;
+
+	cf_free(pool->stats);
+	pool->stats = NULL;
+
+	as_eventcount_destroy(&pool->ec);
+	pthread_mutex_destroy(&pool->lock);
+
+	pool->cpus = NULL;
+	pool->n_cpus = 0;
+	pool->workers = NULL;
+	pool->worker_size = 0;
+	pool->threads = NULL;
+	pool->dispatch_queue = NULL;
+}
+
 //---------------------------------
 // Functions
 //---------------------------------
@@ -36,58 +906,221 @@ typedef struct as_thread_pool_task_s {
 void*
 as_thread_worker(void* data)
 {
-	as_thread_pool* pool = data;
+	as_thread_pool_worker* w = data;
+	as_thread_pool* pool = w->pool;
 
 	as_thread_set_name("tpool");
+	worker_set_affinity(w);
+	t_worker = w;
+
+	// Run the initialization function, if present.
+	if (pool->init_fn) {
+		pool->init_fn(w->index);
+	}
 
 	// Run variable tasks.
 	as_thread_pool_task task;
 
-	// Retrieve tasks from queue and execute.
-	while (cf_queue_pop(pool->dispatch_queue, &task, CF_QUEUE_FOREVER) == CF_QUEUE_OK) {
-		// A null task indicates thread should be shut down.
-		if (! task.task_fn) {
+	while (true) {
+		if (worker_find(w, &task)) {
+			worker_run(w, &task);
+			continue;
+		}
+
+		// Nothing left anywhere we can reach. Tasks still queued on other
+		// workers' deques are run by those workers.
+		if (as_load_uint8(&pool->shutdown) != 0 ||
+				(as_load_uint8(&w->retire) != 0 && worker_leave(w))) {
 			break;
 		}
 
-		// Run task
-		task.task_fn(task.task_data);
+		uint64_t deadline = AS_EVENTCOUNT_FOREVER;
+
+		if (pool->idle_ms != 0 && as_load_uint32(&pool->thread_size) > pool->thread_min) {
+			deadline = as_eventcount_deadline((int)pool->idle_ms);
+		}
+
+		// Reaped workers make one more pass for tasks before exiting.
+		if (! as_eventcount_await(&pool->ec, worker_ready, w, deadline)) {
+			worker_reap(w);
+		}
 	}
 
+	t_worker = NULL;
+
 	// Run the finalization function, if present.
 	if (pool->fini_fn) {
 		pool->fini_fn();
 	}
+
+	as_store_uint8_rls(&w->exited, 1);
 	return NULL;
 }
 
 int
 as_thread_pool_init(as_thread_pool* pool, uint32_t thread_size)
 {
-	if (thread_size != 0) {
-		pool->threads = cf_calloc(thread_size, sizeof(pthread_t));
-		pool->dispatch_queue = cf_queue_create(sizeof(as_thread_pool_task), true);
+	as_thread_pool_config config = { .thread_size = thread_size };
+
+	return as_thread_pool_init_config(pool, &config);
+}
+
+int
+as_thread_pool_init_config(as_thread_pool* pool, const as_thread_pool_config* config)
+{
+	uint32_t thread_size = config->thread_size;
+	uint32_t thread_max = config->thread_max > thread_size ? config->thread_max : thread_size;
+
+	pool->threads = NULL;
+	pool->dispatch_queue = NULL;
+	pool->workers = NULL;
+	pool->worker_size = 0;
+	pool->init_fn = config->init_fn;
+	pool->fini_fn = config->fini_fn;
+	pool->thread_size = 0;
+	pool->shutdown = 0;
+	pool->target_size = thread_size;
+	pool->thread_min = config->thread_min != 0 ? config->thread_min : 1;
+	pool->idle_ms = config->idle_ms;
+	pool->cpus = NULL;
+	pool->n_cpus = 0;
+	pool->cpu_per_worker = config->cpu_per_worker;
+	memset(pool->lanes, 0, sizeof(pool->lanes));
+	pool->n_lanes = 0;
+	pool->lane_schedule = NULL;
+	pool->lane_schedule_size = 0;
+	pool->lanes_unweighted = 0;
+	pool->stats = NULL;
+	as_eventcount_init(&pool->ec, AS_EVENTCOUNT_SPIN);
+
+	if (thread_max == 0) {
+		return 0;
 	}
-	else {
-		pool->threads = NULL;
-		pool->dispatch_queue = NULL;
+
+	pthread_mutex_init(&pool->lock, NULL);
+	pool->threads = cf_calloc(thread_max, sizeof(pthread_t));
+	pool->workers = cf_calloc(thread_max, sizeof(as_thread_pool_worker));
+
+	uint32_t n_lanes = config->n_lanes;
+
+	if (n_lanes == 0) {
+		n_lanes = 1;
 	}
-	pool->fini_fn = NULL;
-	pool->thread_size = 0;
+	else if (n_lanes > AS_THREAD_POOL_MAX_LANES) {
+		n_lanes = AS_THREAD_POOL_MAX_LANES;
+	}
+
+	bool lanes_ok = true;
+
+	for (uint32_t i = 0; i < n_lanes; i++) {
+		pool->lanes[i] = cf_queue_create(sizeof(as_thread_pool_task), true);
+		lanes_ok = lanes_ok && pool->lanes[i];
+
+		if (lanes_ok && config->stats) {
+			lanes_ok = cf_queue_enable_stats(pool->lanes[i]);
+		}
+	}
+
+	if (config->stats) {
+		as_stats_clock_init();
+		pool->stats = cf_calloc(thread_max, sizeof(as_thread_pool_worker_stats));
+	}
+
+	pool->n_lanes = n_lanes;
+	pool->dispatch_queue = pool->lanes[0];
+
+	if (lanes_ok && n_lanes > 1 && config->lane_weights) {
+		lanes_ok = pool_schedule_lanes(pool, config->lane_weights);
+	}
+
+	if (config->cpus && config->n_cpus != 0) {
+		pool->cpus = cf_malloc(config->n_cpus * sizeof(uint32_t));
+
+		if (pool->cpus) {
+			memcpy(pool->cpus, config->cpus, config->n_cpus * sizeof(uint32_t));
+			pool->n_cpus = config->n_cpus;
+		}
+	}
+
+	if (! pool->threads || ! lanes_ok || ! pool->workers ||
+			(config->n_cpus != 0 && ! pool->cpus) ||
+			(config->stats && ! pool->stats)) {
+		pool_free(pool);
+		return -3;
+	}
+
+	for (uint32_t i = 0; i < thread_max; i++) {
+		as_thread_pool_worker* w = &pool->workers[i];
+
+		w->pool = pool;
+		w->index = i;
+		w->seed = i * 2654435761u + 1;
+	}
+
+	pool->worker_size = thread_max;
 
 	// Start threads.
-	for (uint32_t i = 0; i < thread_size; i++) {
-		if (pthread_create(&pool->threads[i], NULL, as_thread_worker, pool) == 0) {
-			pool->thread_size++;
+	pthread_mutex_lock(&pool->lock);
+
+	while (pool->thread_size < thread_size && pool_start_worker(pool)) {
+	}
+
+	uint32_t started = pool->thread_size;
+
+	pthread_mutex_unlock(&pool->lock);
+
+	if (started == 0 && thread_size != 0) {
+		pool_free(pool);
+	}
+	return (started == thread_size)? 0 : -3;
+}
+
+int
+as_thread_pool_resize(as_thread_pool* pool, uint32_t thread_size)
+{
+	if (thread_size == 0 || thread_size > pool->worker_size) {
+		return -1;
+	}
+
+	pthread_mutex_lock(&pool->lock);
+
+	if (as_load_uint8(&pool->shutdown) != 0) {
+		pthread_mutex_unlock(&pool->lock);
+		return -1;
+	}
+
+	as_store_uint32(&pool->target_size, thread_size);
+
+	while (pool->thread_size < thread_size && pool_start_worker(pool)) {
+	}
+
+	// Stop the highest slots first.
+	bool stopped = false;
+
+	for (uint32_t i = pool->worker_size; i > 0 && pool->thread_size > thread_size; i--) {
+		as_thread_pool_worker* w = &pool->workers[i - 1];
+
+		if (w->used && as_load_uint8(&w->retire) == 0) {
+			as_store_uint8(&w->retire, WORKER_RETIRING);
+			as_decr_uint32(&pool->thread_size);
+			stopped = true;
 		}
 	}
-	return (pool->thread_size == thread_size)? 0 : -3;
+
+	int rv = (pool->thread_size == thread_size)? 0 : -3;
+
+	pthread_mutex_unlock(&pool->lock);
+
+	if (stopped) {
+		as_eventcount_notify(&pool->ec, UINT32_MAX);
+	}
+	return rv;
 }
 
 int
 as_thread_pool_queue_task(as_thread_pool* pool, as_task_fn task_fn, void* task)
 {
-	if (pool->thread_size == 0) {
+	if (! pool_accepts(pool)) {
 		// No threads are running to process task.
 		return -1;
 	}
@@ -96,42 +1129,245 @@ as_thread_pool_queue_task(as_thread_pool* pool, as_task_fn task_fn, void* task)
 	as_thread_pool_task vtask;
 	vtask.task_fn = task_fn;
 	vtask.task_data = task;
+	vtask.group = NULL;
+	vtask.cancel_fn = NULL;
+	vtask.deadline = 0;
+
+	return pool_queue(pool, &vtask, 1) == 1 ? 0 : -2;
+}
 
-	if (cf_queue_push(pool->dispatch_queue, &vtask) != CF_QUEUE_OK) {
-		return -2;
+int
+as_thread_pool_queue_task_opts(as_thread_pool* pool, as_task_fn task_fn, void* task, const as_task_opts* opts)
+{
+	if (! pool_accepts(pool)) {
+		// No threads are running to process task.
+		return -1;
 	}
-	return 0;
+
+	as_thread_pool_task vtask;
+	vtask.task_fn = task_fn;
+	vtask.task_data = task;
+	vtask.group = NULL;
+	vtask.cancel_fn = opts->cancel_fn;
+	vtask.deadline = opts->deadline;
+
+	return pool_queue_opts(pool, &vtask, opts) ? 0 : -2;
+}
+
+uint32_t
+as_thread_pool_queue_tasks(as_thread_pool* pool, as_task_fn task_fn, void* const* tasks, uint32_t n)
+{
+	if (! pool_accepts(pool)) {
+		// No threads are running to process tasks.
+		return 0;
+	}
+
+	return pool_queue_n(pool, task_fn, tasks, n, NULL);
+}
+
+bool
+as_thread_pool_get_stats(as_thread_pool* pool, as_thread_pool_stats* stats)
+{
+	if (! pool->stats) {
+		return false;
+	}
+
+	memset(stats, 0, sizeof(as_thread_pool_stats));
+
+	for (uint32_t i = 0; i < pool->worker_size; i++) {
+		as_thread_pool_worker_stats* st = &pool->stats[i];
+
+		stats->tasks += as_load_uint64(&st->tasks);
+		stats->expired += as_load_uint64(&st->expired);
+		stats->steals += as_load_uint64(&st->steals);
+		as_histogram_merge(&stats->wait, &st->wait);
+		as_histogram_merge(&stats->run, &st->run);
+	}
+
+	for (uint32_t i = 0; i < pool->n_lanes; i++) {
+		as_queue_stats qs;
+
+		if (cf_queue_get_stats(pool->lanes[i], &qs)) {
+			as_queue_stats_merge(&stats->lanes, &qs);
+		}
+	}
+
+	stats->wakeups = as_load_uint64(&pool->ec.wakes);
+	stats->parks = as_load_uint64(&pool->ec.parks);
+	stats->threads = as_load_uint32(&pool->thread_size);
+	return true;
 }
 
 int
 as_thread_pool_destroy(as_thread_pool* pool)
 {
 	// Prevent double destroy.
-	uint32_t thread_size = as_fas_uint32(&pool->thread_size, 0);
-
-	if (thread_size == 0) {
+	if (pool->worker_size == 0) {
 		return 0;
 	}
 
-	// Tells worker threads to stop by setting NULL task_fn. We do this to allow the
-	// workers to "wait forever" on processing the work dispatch queue, which has
-	// minimum impact when the queue is empty. This also means all queued requests
-	// get processed before shutting down.
+	// Tells worker threads to stop once they find no more tasks. We do this to
+	// allow the workers to park while the pool is idle, which has minimum
+	// impact. This also means all queued requests get processed before
+	// shutting down.
+	pthread_mutex_lock(&pool->lock);
+	as_store_uint32(&pool->thread_size, 0);
+	as_store_uint8(&pool->shutdown, 1);
+	pthread_mutex_unlock(&pool->lock);
+
+	as_eventcount_notify(&pool->ec, UINT32_MAX);
+
+	// Wait till threads finish, including stopped ones not yet joined.
+	for (uint32_t i = 0; i < pool->worker_size; i++) {
+		if (pool->workers[i].used) {
+			pthread_join(pool->threads[i], NULL);
+		}
+	}
+
+	pool_free(pool);
+	return 0;
+}
+
+void
+as_task_group_init(as_task_group* group, as_thread_pool* pool)
+{
+	group->pool = pool;
+	group->pending = 0;
+	group->pool_waiters = 0;
+	as_eventcount_init(&group->ec, AS_EVENTCOUNT_SPIN);
+}
+
+void
+as_task_group_destroy(as_task_group* group)
+{
+	as_eventcount_destroy(&group->ec);
+}
+
+void
+as_task_group_add(as_task_group* group, as_task_fn task_fn, void* task)
+{
+	as_task_group_add_n(group, task_fn, &task, 1);
+}
+
+void
+as_task_group_add_n(as_task_group* group, as_task_fn task_fn, void* const* tasks, uint32_t n)
+{
+	if (n == 0) {
+		return;
+	}
+
+	uint32_t queued = 0;
+
+	if (task_group_has_pool(group)) {
+		as_aaf_uint32(&group->pending, (int32_t)(n * 2));
+		queued = pool_queue_n(group->pool, task_fn, tasks, n, group);
+
+		if (queued < n) {
+			as_aaf_uint32(&group->pending, -(int32_t)((n - queued) * 2));
+		}
+	}
+
+	for (uint32_t i = queued; i < n; i++) {
+		task_fn(tasks[i]);
+	}
+}
+
+void
+as_task_group_add_opts(as_task_group* group, as_task_fn task_fn, void* task, const as_task_opts* opts)
+{
+	as_thread_pool_task vtask;
+	vtask.task_fn = task_fn;
+	vtask.task_data = task;
+	vtask.group = NULL;
+	vtask.cancel_fn = opts->cancel_fn;
+	vtask.deadline = opts->deadline;
+
+	if (task_group_has_pool(group)) {
+		vtask.group = group;
+		as_aaf_uint32(&group->pending, 2);
+
+		if (pool_queue_opts(group->pool, &vtask, opts)) {
+			return;
+		}
+
+		as_aaf_uint32(&group->pending, -2);
+		vtask.group = NULL;
+	}
+
+	task_run(&vtask);
+}
+
+bool
+as_task_group_wait(as_task_group* group, int wait_ms)
+{
+	uint64_t deadline = as_eventcount_deadline(wait_ms);
+	as_thread_pool* pool = group->pool;
 	as_thread_pool_task task;
-	task.task_fn = NULL;
-	task.task_data = NULL;
 
-	// Send shutdown signal for variable tasks.
-	for (uint32_t i = 0; i < thread_size; i++) {
-		cf_queue_push(pool->dispatch_queue, &task);
+	while (! task_group_ready(group)) {
+		// Help rather than block.
+		if (pool_help(pool, &task)) {
+			if (t_worker && t_worker->pool == pool) {
+				worker_run(t_worker, &task);
+			}
+			else {
+				task_run(&task);
+			}
+
+			if (deadline != AS_EVENTCOUNT_FOREVER && cf_getns() >= deadline) {
+				break;
+			}
+			continue;
+		}
+
+		if (t_worker && t_worker->pool == pool) {
+			// A worker waits on the pool's eventcount, so it also wakes for
+			// tasks it could help with - which may be the ones this group
+			// waits for.
+			as_incr_uint32(&group->pool_waiters);
+			as_fence_seq();
+
+			bool ready = as_eventcount_await(&pool->ec, task_group_ready_worker,
+					group, deadline);
+
+			as_decr_uint32(&group->pool_waiters);
+
+			if (! ready) {
+				break;
+			}
+		}
+		else if (! as_eventcount_await(&group->ec, task_group_ready, group,
+				deadline)) {
+			break;
+		}
 	}
 
-	// Wait till threads finish.
-	for (uint32_t i = 0; i < thread_size; i++) {
-		pthread_join(pool->threads[i], NULL);
+	if (! task_group_ready(group)) {
+		return false;
 	}
 
-	cf_free(pool->threads);
-	cf_queue_destroy(pool->dispatch_queue);
-	return 0;
+	// Wait out the end of task_group_done(), which is only a few instructions
+	// away.
+	while (as_load_uint32_acq(&group->pending) != 0) {
+		sched_yield();
+	}
+	return true;
+}
+
+static void
+future_task(void* udata)
+{
+	as_future* future = udata;
+
+	future->result = future->fn(future->user_data);
+}
+
+void
+as_future_submit(as_future* future, as_thread_pool* pool, as_future_fn fn, void* user_data)
+{
+	as_task_group_init(&future->group, pool);
+	future->fn = fn;
+	future->user_data = user_data;
+	future->result = NULL;
+	as_task_group_add(&future->group, future_task, future);
 }
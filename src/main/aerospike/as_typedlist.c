@@ -0,0 +1,1137 @@
+/*
+ * Copyright 2026 Aerospike, Inc.
+ *
+ * Portions may be licensed to Aerospike, Inc. under one or more contributor
+ * license agreements.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include <aerospike/as_typedlist.h>
+
+#include <aerospike/as_arraylist.h>
+#include <aerospike/as_atomic.h>
+#include <aerospike/as_double.h>
+#include <aerospike/as_integer.h>
+#include <aerospike/as_iterator.h>
+#include <aerospike/as_list.h>
+#include <aerospike/as_list_iterator.h>
+#include <aerospike/as_std.h>
+#include <aerospike/as_string.h>
+#include <aerospike/as_val.h>
+#include <citrusleaf/alloc.h>
+#include <string.h>
+
+/******************************************************************************
+ *	TYPES
+ ******************************************************************************/
+
+static const as_list_hooks as_typedlist_list_hooks;
+static const as_iterator_hooks as_typedlist_iterator_hooks;
+
+// Both element types are 8 bytes, so storage is moved regardless of type.
+#define VALUE_SIZE sizeof(int64_t)
+
+#define MIN_CAPACITY 8
+
+typedef union typed_value_u {
+	int64_t i;
+	double d;
+} typed_value;
+
+/******************************************************************************
+ *	STATIC FUNCTIONS
+ ******************************************************************************/
+
+static as_typedlist*
+as_typedlist_cons(as_typedlist* list, as_typedlist_type type,
+		uint32_t capacity)
+{
+	list->type = type;
+	list->size = 0;
+	list->capacity = 0;
+	list->values.int64s = NULL;
+	list->boxed = NULL;
+	list->promoted = NULL;
+
+	if (capacity != 0) {
+		list->values.int64s = (int64_t*)cf_malloc(capacity * VALUE_SIZE);
+
+		if (list->values.int64s == NULL) {
+			return NULL;
+		}
+
+		list->capacity = capacity;
+	}
+
+	return list;
+}
+
+static bool
+as_typedlist_release(as_typedlist* list)
+{
+	if (list->boxed != NULL) {
+		for (uint32_t i = 0; i < list->size; i++) {
+			if (list->boxed[i] != NULL) {
+				as_val_destroy(list->boxed[i]);
+			}
+		}
+
+		cf_free(list->boxed);
+	}
+
+	if (list->values.int64s != NULL) {
+		cf_free(list->values.int64s);
+	}
+
+	if (list->promoted != NULL) {
+		as_arraylist_destroy(list->promoted);
+	}
+
+	as_typedlist_cons(list, list->type, 0);
+
+	return true;
+}
+
+static inline bool
+value_matches(const as_typedlist* list, const as_val* v)
+{
+	return v != NULL && v->type == (list->type == AS_TYPEDLIST_INT64 ?
+			AS_INTEGER : AS_DOUBLE);
+}
+
+static inline typed_value
+value_from_val(const as_typedlist* list, const as_val* v)
+{
+	typed_value tv;
+
+	if (list->type == AS_TYPEDLIST_INT64) {
+		tv.i = as_integer_get((const as_integer*)v);
+	}
+	else {
+		tv.d = as_double_get((const as_double*)v);
+	}
+
+	return tv;
+}
+
+static inline void
+value_write(as_typedlist* list, uint32_t index, typed_value tv)
+{
+	if (list->type == AS_TYPEDLIST_INT64) {
+		list->values.int64s[index] = tv.i;
+	}
+	else {
+		list->values.doubles[index] = tv.d;
+	}
+}
+
+static as_val*
+value_box(const as_typedlist* list, uint32_t index)
+{
+	if (list->type == AS_TYPEDLIST_INT64) {
+		return (as_val*)as_integer_new_cached(list->values.int64s[index]);
+	}
+
+	return (as_val*)as_double_new(list->values.doubles[index]);
+}
+
+static as_val**
+boxed_get(const as_typedlist* list)
+{
+	as_val** boxed = (as_val**)as_load_ptr((void* const*)&list->boxed);
+
+	if (boxed != NULL) {
+		return boxed;
+	}
+
+	boxed = (as_val**)cf_calloc(list->capacity, sizeof(as_val*));
+
+	if (boxed == NULL) {
+		return NULL;
+	}
+
+	// Readers may box concurrently - the first array wins.
+	if (! as_cas_ptr((void**)&((as_typedlist*)list)->boxed, NULL, boxed)) {
+		cf_free(boxed);
+		boxed = (as_val**)as_load_ptr((void* const*)&list->boxed);
+	}
+
+	return boxed;
+}
+
+static inline void
+boxed_clear(as_typedlist* list, uint32_t index)
+{
+	if (list->boxed != NULL && list->boxed[index] != NULL) {
+		as_val_destroy(list->boxed[index]);
+		list->boxed[index] = NULL;
+	}
+}
+
+static int
+typed_ensure(as_typedlist* list, uint32_t delta)
+{
+	uint32_t need = list->size + delta;
+
+	if (need <= list->capacity) {
+		return AS_ARRAYLIST_OK;
+	}
+
+	uint32_t capacity = list->capacity * 2;
+
+	if (capacity < need) {
+		capacity = need;
+	}
+
+	if (capacity < MIN_CAPACITY) {
+		capacity = MIN_CAPACITY;
+	}
+
+	int64_t* values = (int64_t*)cf_realloc(list->values.int64s,
+			capacity * VALUE_SIZE);
+
+	if (values == NULL) {
+		return AS_ARRAYLIST_ERR_ALLOC;
+	}
+
+	list->values.int64s = values;
+
+	if (list->boxed != NULL) {
+		as_val** boxed = (as_val**)cf_realloc(list->boxed,
+				capacity * sizeof(as_val*));
+
+		if (boxed == NULL) {
+			return AS_ARRAYLIST_ERR_ALLOC;
+		}
+
+		memset(boxed + list->capacity, 0,
+				(capacity - list->capacity) * sizeof(as_val*));
+		list->boxed = boxed;
+	}
+
+	list->capacity = capacity;
+
+	return AS_ARRAYLIST_OK;
+}
+
+static int
+typed_insert(as_typedlist* list, uint32_t index, typed_value tv)
+{
+	int rc = typed_ensure(list, 1);
+
+	if (rc != AS_ARRAYLIST_OK) {
+		return rc;
+	}
+
+	uint32_t n_move = list->size - index;
+
+	if (n_move != 0) {
+		memmove(list->values.int64s + index + 1, list->values.int64s + index,
+				n_move * VALUE_SIZE);
+
+		if (list->boxed != NULL) {
+			memmove(list->boxed + index + 1, list->boxed + index,
+					n_move * sizeof(as_val*));
+			list->boxed[index] = NULL;
+		}
+	}
+
+	value_write(list, index, tv);
+	list->size++;
+
+	return AS_ARRAYLIST_OK;
+}
+
+static int
+typed_set(as_typedlist* list, uint32_t index, typed_value tv)
+{
+	if (index == list->size) {
+		return typed_insert(list, index, tv);
+	}
+
+	boxed_clear(list, index);
+	value_write(list, index, tv);
+
+	return AS_ARRAYLIST_OK;
+}
+
+// Move all elements to a generic list.
+static int
+typedlist_promote(as_typedlist* list)
+{
+	if (list->promoted != NULL) {
+		return AS_ARRAYLIST_OK;
+	}
+
+	uint32_t block_size = list->capacity > MIN_CAPACITY ?
+			list->capacity : MIN_CAPACITY;
+	as_arraylist* promoted = as_arraylist_new(list->size + 1, block_size);
+
+	if (promoted == NULL) {
+		return AS_ARRAYLIST_ERR_ALLOC;
+	}
+
+	for (uint32_t i = 0; i < list->size; i++) {
+		as_val* v = NULL;
+
+		if (list->boxed != NULL && list->boxed[i] != NULL) {
+			v = list->boxed[i];
+			list->boxed[i] = NULL;
+		}
+		else if ((v = value_box(list, i)) == NULL) {
+			as_arraylist_destroy(promoted);
+			return AS_ARRAYLIST_ERR_ALLOC;
+		}
+
+		promoted->elements[promoted->size++] = v;
+	}
+
+	as_typedlist_release(list);
+	list->promoted = promoted;
+
+	return AS_ARRAYLIST_OK;
+}
+
+static as_typedlist*
+typedlist_range(const as_typedlist* list, uint32_t from, uint32_t to)
+{
+	uint32_t n = to > from ? to - from : 0;
+	as_typedlist* list2 = as_typedlist_new(list->type, n);
+
+	if (list2 == NULL) {
+		return NULL;
+	}
+
+	if (n != 0) {
+		memcpy(list2->values.int64s, list->values.int64s + from,
+				n * VALUE_SIZE);
+	}
+
+	list2->size = n;
+
+	return list2;
+}
+
+/*******************************************************************************
+ *	INSTANCE FUNCTIONS
+ ******************************************************************************/
+
+as_typedlist*
+as_typedlist_init(as_typedlist* list, as_typedlist_type type,
+		uint32_t capacity)
+{
+	if (list == NULL) {
+		return NULL;
+	}
+
+	as_list_cons((as_list*)list, false, &as_typedlist_list_hooks);
+
+	return as_typedlist_cons(list, type, capacity);
+}
+
+as_typedlist*
+as_typedlist_new(as_typedlist_type type, uint32_t capacity)
+{
+	as_typedlist* list = (as_typedlist*)cf_malloc(sizeof(as_typedlist));
+
+	if (list == NULL) {
+		return NULL;
+	}
+
+	as_list_cons((as_list*)list, true, &as_typedlist_list_hooks);
+
+	if (as_typedlist_cons(list, type, capacity) == NULL) {
+		cf_free(list);
+		return NULL;
+	}
+
+	return list;
+}
+
+void
+as_typedlist_destroy(as_typedlist* list)
+{
+	as_list_destroy((as_list*)list);
+}
+
+const as_typedlist*
+as_typedlist_fromlist(const as_list* list)
+{
+	if (list == NULL || list->hooks != &as_typedlist_list_hooks) {
+		return NULL;
+	}
+
+	const as_typedlist* typed = (const as_typedlist*)list;
+
+	return typed->promoted == NULL ? typed : NULL;
+}
+
+as_val*
+as_typedlist_get(const as_typedlist* list, uint32_t index)
+{
+	if (list->promoted != NULL) {
+		return as_arraylist_get(list->promoted, index);
+	}
+
+	if (index >= list->size) {
+		return NULL;
+	}
+
+	as_val** boxed = (as_val**)as_load_ptr((void* const*)&list->boxed);
+	as_val* v;
+
+	if (boxed != NULL &&
+			(v = (as_val*)as_load_ptr((void* const*)&boxed[index])) != NULL) {
+		return v;
+	}
+
+	v = value_box(list, index);
+
+	// Cached integers need not be kept.
+	if (v == NULL || ! v->count) {
+		return v;
+	}
+
+	if ((boxed = boxed_get(list)) == NULL) {
+		as_val_destroy(v);
+		return NULL;
+	}
+
+	if (! as_cas_ptr((void**)&boxed[index], NULL, v)) {
+		as_val_destroy(v);
+		v = (as_val*)as_load_ptr((void* const*)&boxed[index]);
+	}
+
+	return v;
+}
+
+int64_t
+as_typedlist_get_int64(const as_typedlist* list, uint32_t index)
+{
+	if (list->promoted != NULL) {
+		return as_arraylist_get_int64(list->promoted, index);
+	}
+
+	if (list->type != AS_TYPEDLIST_INT64 || index >= list->size) {
+		return 0;
+	}
+
+	return list->values.int64s[index];
+}
+
+double
+as_typedlist_get_double(const as_typedlist* list, uint32_t index)
+{
+	if (list->promoted != NULL) {
+		return as_arraylist_get_double(list->promoted, index);
+	}
+
+	if (list->type != AS_TYPEDLIST_DOUBLE || index >= list->size) {
+		return 0.0;
+	}
+
+	return list->values.doubles[index];
+}
+
+int
+as_typedlist_set(as_typedlist* list, uint32_t index, as_val* value)
+{
+	if (list->promoted == NULL && value_matches(list, value) &&
+			index <= list->size) {
+		int rc = typed_set(list, index, value_from_val(list, value));
+
+		if (rc == AS_ARRAYLIST_OK) {
+			as_val_destroy(value);
+		}
+
+		return rc;
+	}
+
+	int rc = typedlist_promote(list);
+
+	if (rc != AS_ARRAYLIST_OK) {
+		return rc;
+	}
+
+	return as_arraylist_set(list->promoted, index, value);
+}
+
+int
+as_typedlist_set_int64(as_typedlist* list, uint32_t index, int64_t value)
+{
+	if (list->promoted == NULL && list->type == AS_TYPEDLIST_INT64 &&
+			index <= list->size) {
+		typed_value tv = { .i = value };
+		return typed_set(list, index, tv);
+	}
+
+	int rc = typedlist_promote(list);
+
+	if (rc != AS_ARRAYLIST_OK) {
+		return rc;
+	}
+
+	return as_arraylist_set_int64(list->promoted, index, value);
+}
+
+int
+as_typedlist_set_double(as_typedlist* list, uint32_t index, double value)
+{
+	if (list->promoted == NULL && list->type == AS_TYPEDLIST_DOUBLE &&
+			index <= list->size) {
+		typed_value tv = { .d = value };
+		return typed_set(list, index, tv);
+	}
+
+	int rc = typedlist_promote(list);
+
+	if (rc != AS_ARRAYLIST_OK) {
+		return rc;
+	}
+
+	return as_arraylist_set_double(list->promoted, index, value);
+}
+
+int
+as_typedlist_insert(as_typedlist* list, uint32_t index, as_val* value)
+{
+	if (list->promoted == NULL && value_matches(list, value) &&
+			index <= list->size) {
+		int rc = typed_insert(list, index, value_from_val(list, value));
+
+		if (rc == AS_ARRAYLIST_OK) {
+			as_val_destroy(value);
+		}
+
+		return rc;
+	}
+
+	int rc = typedlist_promote(list);
+
+	if (rc != AS_ARRAYLIST_OK) {
+		return rc;
+	}
+
+	return as_arraylist_insert(list->promoted, index, value);
+}
+
+int
+as_typedlist_insert_int64(as_typedlist* list, uint32_t index, int64_t value)
+{
+	if (list->promoted == NULL && list->type == AS_TYPEDLIST_INT64 &&
+			index <= list->size) {
+		typed_value tv = { .i = value };
+		return typed_insert(list, index, tv);
+	}
+
+	int rc = typedlist_promote(list);
+
+	if (rc != AS_ARRAYLIST_OK) {
+		return rc;
+	}
+
+	return as_arraylist_insert_int64(list->promoted, index, value);
+}
+
+int
+as_typedlist_insert_double(as_typedlist* list, uint32_t index, double value)
+{
+	if (list->promoted == NULL && list->type == AS_TYPEDLIST_DOUBLE &&
+			index <= list->size) {
+		typed_value tv = { .d = value };
+		return typed_insert(list, index, tv);
+	}
+
+	int rc = typedlist_promote(list);
+
+	if (rc != AS_ARRAYLIST_OK) {
+		return rc;
+	}
+
+	return as_arraylist_insert_double(list->promoted, index, value);
+}
+
+int
+as_typedlist_append(as_typedlist* list, as_val* value)
+{
+	return as_typedlist_insert(list, as_typedlist_size(list), value);
+}
+
+int
+as_typedlist_append_int64(as_typedlist* list, int64_t value)
+{
+	return as_typedlist_insert_int64(list, as_typedlist_size(list), value);
+}
+
+int
+as_typedlist_append_double(as_typedlist* list, double value)
+{
+	return as_typedlist_insert_double(list, as_typedlist_size(list), value);
+}
+
+int
+as_typedlist_remove(as_typedlist* list, uint32_t index)
+{
+	if (list->promoted != NULL) {
+		return as_arraylist_remove(list->promoted, index);
+	}
+
+	if (index >= list->size) {
+		return AS_ARRAYLIST_ERR_INDEX;
+	}
+
+	boxed_clear(list, index);
+
+	uint32_t n_move = list->size - index - 1;
+
+	if (n_move != 0) {
+		memmove(list->values.int64s + index, list->values.int64s + index + 1,
+				n_move * VALUE_SIZE);
+
+		if (list->boxed != NULL) {
+			memmove(list->boxed + index, list->boxed + index + 1,
+					n_move * sizeof(as_val*));
+		}
+	}
+
+	list->size--;
+
+	if (list->boxed != NULL) {
+		list->boxed[list->size] = NULL;
+	}
+
+	return AS_ARRAYLIST_OK;
+}
+
+int
+as_typedlist_trim(as_typedlist* list, uint32_t index)
+{
+	if (list->promoted != NULL) {
+		return as_arraylist_trim(list->promoted, index);
+	}
+
+	if (index >= list->size) {
+		return AS_ARRAYLIST_ERR_INDEX;
+	}
+
+	for (uint32_t i = index; i < list->size; i++) {
+		boxed_clear(list, i);
+	}
+
+	list->size = index;
+
+	return AS_ARRAYLIST_OK;
+}
+
+/*******************************************************************************
+ *	ITERATION FUNCTIONS
+ ******************************************************************************/
+
+bool
+as_typedlist_foreach(const as_typedlist* list,
+		as_list_foreach_callback callback, void* udata)
+{
+	if (list->promoted != NULL) {
+		return as_arraylist_foreach(list->promoted, callback, udata);
+	}
+
+	for (uint32_t i = 0; i < list->size; i++) {
+		if (! callback(as_typedlist_get(list, i), udata)) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+as_typedlist_iterator*
+as_typedlist_iterator_init(as_typedlist_iterator* it, const as_typedlist* list)
+{
+	if (it == NULL) {
+		return NULL;
+	}
+
+	as_iterator_init((as_iterator*)it, false, NULL,
+			&as_typedlist_iterator_hooks);
+	it->list = list;
+	it->pos = 0;
+
+	return it;
+}
+
+as_typedlist_iterator*
+as_typedlist_iterator_new(const as_typedlist* list)
+{
+	as_typedlist_iterator* it = (as_typedlist_iterator*)
+			cf_malloc(sizeof(as_typedlist_iterator));
+
+	if (it == NULL) {
+		return NULL;
+	}
+
+	as_iterator_init((as_iterator*)it, true, NULL,
+			&as_typedlist_iterator_hooks);
+	it->list = list;
+	it->pos = 0;
+
+	return it;
+}
+
+bool
+as_typedlist_iterator_has_next(const as_typedlist_iterator* it)
+{
+	return it->pos < as_typedlist_size(it->list);
+}
+
+const as_val*
+as_typedlist_iterator_next(as_typedlist_iterator* it)
+{
+	if (it->pos >= as_typedlist_size(it->list)) {
+		return NULL;
+	}
+
+	return as_typedlist_get(it->list, it->pos++);
+}
+
+/*******************************************************************************
+ *	HOOKS
+ ******************************************************************************/
+
+static bool
+_list_destroy(as_list* l)
+{
+	return as_typedlist_release((as_typedlist*)l);
+}
+
+static uint32_t
+_list_hashcode(const as_list* l)
+{
+	return 0;
+}
+
+static uint32_t
+_list_size(const as_list* l)
+{
+	return as_typedlist_size((const as_typedlist*)l);
+}
+
+static void
+_list_memory(const as_list* l, as_val_memory* mem, bool shared)
+{
+	const as_typedlist* list = (const as_typedlist*)l;
+	size_t bytes = list->capacity * VALUE_SIZE;
+
+	if (l->_.free) {
+		bytes += sizeof(as_typedlist);
+	}
+
+	if (list->boxed != NULL) {
+		bytes += list->capacity * sizeof(as_val*);
+	}
+
+	as_val_memory_bytes(mem, shared, bytes);
+
+	if (list->boxed != NULL) {
+		for (uint32_t i = 0; i < list->size; i++) {
+			as_val_memory_add(list->boxed[i], mem, shared);
+		}
+	}
+
+	as_val_memory_add((const as_val*)list->promoted, mem, shared);
+}
+
+static as_list*
+_list_clone(const as_list* l, bool deep)
+{
+	const as_typedlist* list = (const as_typedlist*)l;
+
+	if (list->promoted != NULL) {
+		const as_val* v = (const as_val*)list->promoted;
+
+		return (as_list*)(deep ? as_val_clone(v) : as_val_clone_cow(v));
+	}
+
+	// The elements are plain numbers - a copy is always deep.
+	as_typedlist* copy = as_typedlist_new(list->type, list->size);
+
+	if (copy == NULL) {
+		return NULL;
+	}
+
+	if (list->size != 0) {
+		memcpy(copy->values.int64s, list->values.int64s,
+				list->size * VALUE_SIZE);
+	}
+
+	copy->size = list->size;
+
+	return (as_list*)copy;
+}
+
+static as_val*
+_list_get(const as_list* l, uint32_t i)
+{
+	return as_typedlist_get((const as_typedlist*)l, i);
+}
+
+static int64_t
+_list_get_int64(const as_list* l, uint32_t i)
+{
+	return as_typedlist_get_int64((const as_typedlist*)l, i);
+}
+
+static double
+_list_get_double(const as_list* l, uint32_t i)
+{
+	return as_typedlist_get_double((const as_typedlist*)l, i);
+}
+
+static char*
+_list_get_str(const as_list* l, uint32_t i)
+{
+	const as_typedlist* list = (const as_typedlist*)l;
+
+	return list->promoted != NULL ?
+			as_arraylist_get_str(list->promoted, i) : NULL;
+}
+
+static int
+_list_set(as_list* l, uint32_t i, as_val* v)
+{
+	return as_typedlist_set((as_typedlist*)l, i, v);
+}
+
+static int
+_list_set_int64(as_list* l, uint32_t i, int64_t v)
+{
+	return as_typedlist_set_int64((as_typedlist*)l, i, v);
+}
+
+static int
+_list_set_double(as_list* l, uint32_t i, double v)
+{
+	return as_typedlist_set_double((as_typedlist*)l, i, v);
+}
+
+static int
+_list_set_str(as_list* l, uint32_t i, const char* v)
+{
+	return as_typedlist_set((as_typedlist*)l, i,
+			(as_val*)as_string_new_strdup(v));
+}
+
+static int
+_list_insert(as_list* l, uint32_t i, as_val* v)
+{
+	return as_typedlist_insert((as_typedlist*)l, i, v);
+}
+
+static int
+_list_insert_int64(as_list* l, uint32_t i, int64_t v)
+{
+	return as_typedlist_insert_int64((as_typedlist*)l, i, v);
+}
+
+static int
+_list_insert_double(as_list* l, uint32_t i, double v)
+{
+	return as_typedlist_insert_double((as_typedlist*)l, i, v);
+}
+
+static int
+_list_insert_str(as_list* l, uint32_t i, const char* v)
+{
+	return as_typedlist_insert((as_typedlist*)l, i,
+			(as_val*)as_string_new_strdup(v));
+}
+
+static int
+_list_append(as_list* l, as_val* v)
+{
+	return as_typedlist_append((as_typedlist*)l, v);
+}
+
+static int
+_list_append_int64(as_list* l, int64_t v)
+{
+	return as_typedlist_append_int64((as_typedlist*)l, v);
+}
+
+static int
+_list_append_double(as_list* l, double v)
+{
+	return as_typedlist_append_double((as_typedlist*)l, v);
+}
+
+static int
+_list_append_str(as_list* l, const char* v)
+{
+	return as_typedlist_append((as_typedlist*)l,
+			(as_val*)as_string_new_strdup(v));
+}
+
+static int
+_list_prepend(as_list* l, as_val* v)
+{
+	return as_typedlist_insert((as_typedlist*)l, 0, v);
+}
+
+static int
+_list_prepend_int64(as_list* l, int64_t v)
+{
+	return as_typedlist_insert_int64((as_typedlist*)l, 0, v);
+}
+
+static int
+_list_prepend_double(as_list* l, double v)
+{
+	return as_typedlist_insert_double((as_typedlist*)l, 0, v);
+}
+
+static int
+_list_prepend_str(as_list* l, const char* v)
+{
+	return _list_insert_str(l, 0, v);
+}
+
+static int
+_list_remove(as_list* l, uint32_t i)
+{
+	return as_typedlist_remove((as_typedlist*)l, i);
+}
+
+static bool
+_list_concat_callback(as_val* v, void* udata)
+{
+	as_val_reserve(v);
+
+	if (as_typedlist_append((as_typedlist*)udata, v) != AS_ARRAYLIST_OK) {
+		as_val_destroy(v);
+		return false;
+	}
+
+	return true;
+}
+
+static int
+_list_concat(as_list* l, const as_list* l2)
+{
+	as_typedlist* list = (as_typedlist*)l;
+	const as_typedlist* typed2 = as_typedlist_fromlist(l2);
+
+	if (list->promoted == NULL && typed2 != NULL &&
+			typed2->type == list->type) {
+		int rc = typed_ensure(list, typed2->size);
+
+		if (rc != AS_ARRAYLIST_OK) {
+			return rc;
+		}
+
+		memcpy(list->values.int64s + list->size, typed2->values.int64s,
+				typed2->size * VALUE_SIZE);
+		list->size += typed2->size;
+
+		return AS_ARRAYLIST_OK;
+	}
+
+	return as_list_foreach(l2, _list_concat_callback, list) ?
+			AS_ARRAYLIST_OK : AS_ARRAYLIST_ERR_ALLOC;
+}
+
+static int
+_list_trim(as_list* l, uint32_t i)
+{
+	return as_typedlist_trim((as_typedlist*)l, i);
+}
+
+static as_val*
+_list_head(const as_list* l)
+{
+	return as_typedlist_get((const as_typedlist*)l, 0);
+}
+
+static as_list*
+_list_drop(const as_list* l, uint32_t n)
+{
+	const as_typedlist* list = (const as_typedlist*)l;
+
+	if (list->promoted != NULL) {
+		return (as_list*)as_arraylist_drop(list->promoted, n);
+	}
+
+	return (as_list*)typedlist_range(list, n, list->size);
+}
+
+static as_list*
+_list_tail(const as_list* l)
+{
+	if (as_typedlist_size((const as_typedlist*)l) == 0) {
+		return NULL;
+	}
+
+	return _list_drop(l, 1);
+}
+
+static as_list*
+_list_take(const as_list* l, uint32_t n)
+{
+	const as_typedlist* list = (const as_typedlist*)l;
+
+	if (list->promoted != NULL) {
+		return (as_list*)as_arraylist_take(list->promoted, n);
+	}
+
+	return (as_list*)typedlist_range(list, 0, n < list->size ? n : list->size);
+}
+
+static bool
+_list_foreach(const as_list* l, as_list_foreach_callback callback,
+		void* udata)
+{
+	return as_typedlist_foreach((const as_typedlist*)l, callback, udata);
+}
+
+static as_list_iterator*
+_list_iterator_new(const as_list* l)
+{
+	return (as_list_iterator*)as_typedlist_iterator_new(
+			(const as_typedlist*)l);
+}
+
+static as_list_iterator*
+_list_iterator_init(const as_list* l, as_list_iterator* it)
+{
+	return (as_list_iterator*)as_typedlist_iterator_init(
+			(as_typedlist_iterator*)it, (const as_typedlist*)l);
+}
+
+static const as_list_hooks as_typedlist_list_hooks = {
+
+	/***************************************************************************
+	 *	instance hooks
+	 **************************************************************************/
+
+	.destroy		= _list_destroy,
+
+	/***************************************************************************
+	 *	info hooks
+	 **************************************************************************/
+
+	.hashcode		= _list_hashcode,
+	.size			= _list_size,
+
+	/***************************************************************************
+	 *	get hooks
+	 **************************************************************************/
+
+	.get			= _list_get,
+	.get_int64		= _list_get_int64,
+	.get_double		= _list_get_double,
+	.get_str		= _list_get_str,
+
+	/***************************************************************************
+	 *	set hooks
+	 **************************************************************************/
+
+	.set			= _list_set,
+	.set_int64		= _list_set_int64,
+	.set_double		= _list_set_double,
+	.set_str		= _list_set_str,
+
+	/***************************************************************************
+	 *	insert hooks
+	 **************************************************************************/
+
+	.insert			= _list_insert,
+	.insert_int64	= _list_insert_int64,
+	.insert_double	= _list_insert_double,
+	.insert_str		= _list_insert_str,
+
+	/***************************************************************************
+	 *	append hooks
+	 **************************************************************************/
+
+	.append			= _list_append,
+	.append_int64	= _list_append_int64,
+	.append_double	= _list_append_double,
+	.append_str		= _list_append_str,
+
+	/***************************************************************************
+	 *	prepend hooks
+	 **************************************************************************/
+
+	.prepend		= _list_prepend,
+	.prepend_int64	= _list_prepend_int64,
+	.prepend_double	= _list_prepend_double,
+	.prepend_str	= _list_prepend_str,
+
+	/***************************************************************************
+	 *	remove hook
+	 **************************************************************************/
+
+	.remove			= _list_remove,
+
+	/***************************************************************************
+	 *	accessor and modifier hooks
+	 **************************************************************************/
+
+	.concat			= _list_concat,
+	.trim			= _list_trim,
+	.head			= _list_head,
+	.tail			= _list_tail,
+	.drop			= _list_drop,
+	.take			= _list_take,
+
+	/***************************************************************************
+	 *	iteration hooks
+	 **************************************************************************/
+
+	.foreach		= _list_foreach,
+	.iterator_new	= _list_iterator_new,
+	.iterator_init	= _list_iterator_init,
+
+	/***************************************************************************
+	 *	memory hooks
+	 **************************************************************************/
+
+	.memory			= _list_memory,
+
+	/***************************************************************************
+	 *	copy hooks
+	 **************************************************************************/
+
+	.clone			= _list_clone,
+};
+
+static bool
+_iterator_destroy(as_iterator* it)
+{
+	return true;
+}
+
+static bool
+_iterator_has_next(const as_iterator* it)
+{
+	return as_typedlist_iterator_has_next((const as_typedlist_iterator*)it);
+}
+
+static const as_val*
+_iterator_next(as_iterator* it)
+{
+	return as_typedlist_iterator_next((as_typedlist_iterator*)it);
+}
+
+static const as_iterator_hooks as_typedlist_iterator_hooks = {
+	.destroy    = _iterator_destroy,
+	.has_next   = _iterator_has_next,
+	.next       = _iterator_next
+};
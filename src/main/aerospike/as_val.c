@@ -15,6 +15,7 @@
  * the License.
  */
 #include <aerospike/as_val.h>
+#include <aerospike/as_arraylist.h>
 #include <aerospike/as_atomic.h>
 #include <aerospike/as_boolean.h>
 #include <aerospike/as_bytes.h>
@@ -25,10 +26,13 @@
 #include <aerospike/as_map.h>
 #include <aerospike/as_msgpack_ext.h>
 #include <aerospike/as_nil.h>
+#include <aerospike/as_orderedmap.h>
 #include <aerospike/as_pair.h>
 #include <aerospike/as_rec.h>
+#include <aerospike/as_slab.h>
 #include <aerospike/as_string.h>
 #include <citrusleaf/alloc.h>
+#include <string.h>
 
 /******************************************************************************
  *	TYPES
@@ -121,6 +125,111 @@ static const as_val_reserve_callback as_val_reserve_callbacks[] = {
 	[AS_CMP_INF]		= as_val_reserve_noop
 };
 
+/******************************************************************************
+ *	DESTROY WORKLIST
+ *****************************************************************************/
+
+// Containers whose last reference is dropped while another container is being
+// destroyed on the same thread are queued here rather than destroyed in place,
+// so destroying a deep tree does not recurse. Only the outermost
+// as_val_destroy() call drains the worklist.
+
+#define DESTROY_INLINE_CAPACITY 64
+
+typedef struct destroy_worklist_s {
+	as_val ** items;
+	uint32_t size;
+	uint32_t capacity;
+} destroy_worklist;
+
+static __thread destroy_worklist * t_worklist = NULL;
+
+static inline bool as_val_is_container(const as_val * v)
+{
+	return v->type == AS_LIST || v->type == AS_MAP || v->type == AS_PAIR;
+}
+
+static void as_val_free(as_val * v)
+{
+	as_val_destroy_callbacks[v->type](v);
+
+	if (v->free) {
+		if (v->slab) {
+			as_slab_free(v);
+		}
+		else {
+			cf_free(v);
+		}
+	}
+}
+
+static bool destroy_worklist_push(destroy_worklist * wl, as_val * v)
+{
+	if (wl->size == wl->capacity) {
+		uint32_t capacity = wl->capacity * 2;
+		as_val ** items;
+
+		if (wl->capacity == DESTROY_INLINE_CAPACITY) {
+			items = (as_val **)cf_malloc(sizeof(as_val *) * capacity);
+
+			if (items) {
+				memcpy(items, wl->items, sizeof(as_val *) * wl->size);
+			}
+		}
+		else {
+			items = (as_val **)cf_realloc(wl->items, sizeof(as_val *) * capacity);
+		}
+
+		if (! items) {
+			return false;
+		}
+
+		wl->items = items;
+		wl->capacity = capacity;
+	}
+
+	wl->items[wl->size++] = v;
+	return true;
+}
+
+static void as_val_release(as_val * v)
+{
+	destroy_worklist * wl = t_worklist;
+
+	if (wl) {
+		// Already draining on this thread - defer containers, leaves are cheap.
+		if (! as_val_is_container(v) || ! destroy_worklist_push(wl, v)) {
+			as_val_free(v);
+		}
+		return;
+	}
+
+	if (! as_val_is_container(v)) {
+		as_val_free(v);
+		return;
+	}
+
+	as_val * inline_items[DESTROY_INLINE_CAPACITY];
+	destroy_worklist local = {
+		.items = inline_items,
+		.size = 0,
+		.capacity = DESTROY_INLINE_CAPACITY
+	};
+
+	t_worklist = &local;
+	as_val_free(v);
+
+	while (local.size != 0) {
+		as_val_free(local.items[--local.size]);
+	}
+
+	t_worklist = NULL;
+
+	if (local.items != inline_items) {
+		cf_free(local.items);
+	}
+}
+
 /******************************************************************************
  *	FUNCTIONS
  *****************************************************************************/
@@ -138,7 +247,12 @@ static as_val * as_val_reserve_noop(as_val * v)
 
 static as_val * as_val_reserve_count(as_val * v)
 {
-	as_incr_uint32(&v->count);
+	if (v->local) {
+		v->count++;
+	}
+	else {
+		as_incr_uint32(&v->count);
+	}
 	return v;
 }
 
@@ -154,7 +268,8 @@ static char * as_val_tostring_noop(const as_val * v)
 
 as_val * as_val_val_reserve(as_val * v) 
 {
-	if ( !v ) return v;
+	// Static values (e.g. cached integers) have no count and are never freed.
+	if ( !v || !v->count ) return v;
 	return as_val_reserve_callbacks[ v->type ](v);
 }
 
@@ -164,21 +279,269 @@ as_val * as_val_val_destroy(as_val * v)
 		return v;
 	}
 
-	// if we reach the last reference, call the destructor, and free
-	if (as_aaf_uint32_rls(&v->count, -1) == 0) {
+	if (v->local) {
+		if (--v->count != 0) {
+			return v;
+		}
+	}
+	else {
+		if (as_aaf_uint32_rls(&v->count, -1) != 0) {
+			return v;
+		}
+
 		// Subsequent destructor may require an 'acquire' barrier.
 		as_fence_acq();
+	}
 
-		as_val_destroy_callbacks[v->type](v);
+	// we reached the last reference, call the destructor, and free
+	as_val_release(v);
+	return NULL;
+}
 
-		if (v->free) {
-			cf_free(v);
-		}
-		v = NULL;
+static bool as_val_share_list_cb(as_val * v, void * udata)
+{
+	as_val_share(v);
+	return true;
+}
+
+static bool as_val_share_map_cb(const as_val * k, const as_val * v, void * udata)
+{
+	as_val_share((as_val *)k);
+	as_val_share((as_val *)v);
+	return true;
+}
+
+as_val * as_val_share(as_val * v)
+{
+	if (v == NULL || !v->count) {
+		return v;
+	}
+
+	v->local = false;
+
+	switch (v->type) {
+	case AS_LIST:
+		as_list_foreach((as_list *)v, as_val_share_list_cb, NULL);
+		break;
+	case AS_MAP:
+		as_map_foreach((as_map *)v, as_val_share_map_cb, NULL);
+		break;
+	case AS_PAIR:
+		as_val_share(as_pair_1((as_pair *)v));
+		as_val_share(as_pair_2((as_pair *)v));
+		break;
+	default:
+		break;
 	}
+
 	return v;
 }
 
+typedef struct as_val_clone_udata_s {
+	void * target;
+	bool deep;
+	bool ok;
+} as_val_clone_udata;
+
+static bool as_val_clone_list_cb(as_val * v, void * udata)
+{
+	as_val_clone_udata * u = (as_val_clone_udata *)udata;
+	as_val * c = as_val_clone_element(v, u->deep);
+
+	if (v && ! c) {
+		u->ok = false;
+		return false;
+	}
+
+	if (as_arraylist_append((as_arraylist *)u->target, c) != AS_ARRAYLIST_OK) {
+		as_val_destroy(c);
+		u->ok = false;
+		return false;
+	}
+
+	return true;
+}
+
+static bool as_val_clone_map_cb(const as_val * k, const as_val * v, void * udata)
+{
+	as_val_clone_udata * u = (as_val_clone_udata *)udata;
+	as_val * ck = as_val_clone_element(k, u->deep);
+	as_val * cv = as_val_clone_element(v, u->deep);
+
+	if (! ck || (v && ! cv) || as_orderedmap_set((as_orderedmap *)u->target, ck, cv) != 0) {
+		as_val_destroy(ck);
+		as_val_destroy(cv);
+		u->ok = false;
+		return false;
+	}
+
+	return true;
+}
+
+static as_val * as_val_clone_list(const as_list * l, bool deep)
+{
+	if (l->hooks && l->hooks->clone) {
+		return (as_val *)l->hooks->clone(l, deep);
+	}
+
+	uint32_t size = as_list_size(l);
+	as_arraylist * list = as_arraylist_new(size, size > 8 ? size : 8);
+
+	if (! list) {
+		return NULL;
+	}
+
+	as_val_clone_udata u = { .target = list, .deep = deep, .ok = true };
+
+	as_list_foreach(l, as_val_clone_list_cb, &u);
+
+	if (! u.ok) {
+		as_arraylist_destroy(list);
+		return NULL;
+	}
+
+	return (as_val *)list;
+}
+
+static as_val * as_val_clone_map(const as_map * m, bool deep)
+{
+	if (m->hooks && m->hooks->clone) {
+		return (as_val *)m->hooks->clone(m, deep);
+	}
+
+	uint32_t size = as_map_size(m);
+	as_orderedmap * map = as_orderedmap_new(size != 0 ? size : 1);
+
+	if (! map) {
+		return NULL;
+	}
+
+	as_orderedmap_set_flags(map, m->flags);
+
+	as_val_clone_udata u = { .target = map, .deep = deep, .ok = true };
+
+	as_map_foreach(m, as_val_clone_map_cb, &u);
+
+	if (! u.ok) {
+		as_orderedmap_destroy(map);
+		return NULL;
+	}
+
+	return (as_val *)map;
+}
+
+static as_val * as_val_clone_pair(const as_pair * p, bool deep)
+{
+	as_val * _1 = as_val_clone_element(p->_1, deep);
+	as_val * _2 = as_val_clone_element(p->_2, deep);
+
+	if ((p->_1 && ! _1) || (p->_2 && ! _2)) {
+		as_val_destroy(_1);
+		as_val_destroy(_2);
+		return NULL;
+	}
+
+	as_pair * pair = as_pair_new(_1, _2);
+
+	if (! pair) {
+		as_val_destroy(_1);
+		as_val_destroy(_2);
+	}
+
+	return (as_val *)pair;
+}
+
+static as_val * as_val_clone_bytes(const as_bytes * b)
+{
+	as_bytes * bytes = as_bytes_new(b->size);
+
+	if (! bytes) {
+		return NULL;
+	}
+
+	if (b->size != 0) {
+		memcpy(bytes->value, b->value, b->size);
+	}
+
+	bytes->size = b->size;
+	bytes->type = b->type;
+	return (as_val *)bytes;
+}
+
+// Copy v itself. Containers copy (deep) or share (!deep) their children.
+static as_val * as_val_clone_root(const as_val * v, bool deep)
+{
+	if (v == NULL) {
+		return NULL;
+	}
+
+	switch (v->type) {
+	case AS_BOOLEAN:
+		// Booleans are not reference counted - use the static instances.
+		return (as_val *)(((const as_boolean *)v)->value ? &as_true : &as_false);
+	case AS_INTEGER:
+		if (! v->count) {
+			return (as_val *)v;
+		}
+		return (as_val *)as_integer_new(((const as_integer *)v)->value);
+	case AS_DOUBLE:
+		if (! v->count) {
+			return (as_val *)v;
+		}
+		return (as_val *)as_double_new(((const as_double *)v)->value);
+	case AS_STRING: {
+		as_string * s = (as_string *)v;
+
+		if (! s->value) {
+			return (as_val *)as_string_new(NULL, false);
+		}
+		return (as_val *)as_string_new_strndup(s->value, as_string_len(s));
+	}
+	case AS_GEOJSON: {
+		as_geojson * g = (as_geojson *)v;
+
+		if (! g->value) {
+			return (as_val *)as_geojson_new(NULL, false);
+		}
+
+		size_t len = as_geojson_len(g);
+		char * value = cf_strndup(g->value, len);
+
+		return value ? (as_val *)as_geojson_new_wlen(value, len, true) : NULL;
+	}
+	case AS_BYTES:
+		return as_val_clone_bytes((const as_bytes *)v);
+	case AS_LIST:
+		return as_val_clone_list((const as_list *)v, deep);
+	case AS_MAP:
+		return as_val_clone_map((const as_map *)v, deep);
+	case AS_PAIR:
+		return as_val_clone_pair((const as_pair *)v, deep);
+	default:
+		// nil and comparison markers are static, records are views.
+		return as_val_reserve((as_val *)v);
+	}
+}
+
+as_val * as_val_clone_element(const as_val * v, bool deep)
+{
+	if (deep || (v && v->type == AS_BOOLEAN)) {
+		return as_val_clone_root(v, true);
+	}
+
+	return as_val_reserve((as_val *)v);
+}
+
+as_val * as_val_clone(const as_val * v)
+{
+	return as_val_clone_root(v, true);
+}
+
+as_val * as_val_clone_cow(const as_val * v)
+{
+	return as_val_clone_root(v, false);
+}
+
 uint32_t as_val_val_hashcode(const as_val * v)
 {
 	if (v == 0) return 0;
@@ -206,3 +569,131 @@ bool as_val_tobool(const as_val* v)
 	}
 	return false;
 }
+
+typedef struct as_val_memory_udata_s {
+	as_val_memory * mem;
+	bool shared;
+} as_val_memory_udata;
+
+static bool as_val_memory_list_cb(as_val * v, void * udata)
+{
+	as_val_memory_udata * u = (as_val_memory_udata *)udata;
+	as_val_memory_add(v, u->mem, u->shared);
+	return true;
+}
+
+static bool as_val_memory_map_cb(const as_val * k, const as_val * v, void * udata)
+{
+	as_val_memory_udata * u = (as_val_memory_udata *)udata;
+	as_val_memory_add(k, u->mem, u->shared);
+	as_val_memory_add(v, u->mem, u->shared);
+	return true;
+}
+
+void as_val_memory_add(const as_val * v, as_val_memory * mem, bool shared)
+{
+	// Static values are not owned by anyone.
+	if (v == NULL || !v->count) {
+		return;
+	}
+
+	shared = shared || as_load_uint32(&v->count) > 1;
+
+	size_t header = 0;
+	size_t bytes = 0;
+
+	switch (v->type) {
+	case AS_BOOLEAN:
+		header = sizeof(as_boolean);
+		break;
+	case AS_INTEGER:
+		header = sizeof(as_integer);
+		break;
+	case AS_DOUBLE:
+		header = sizeof(as_double);
+		break;
+	case AS_STRING: {
+		const as_string * s = (const as_string *)v;
+		header = sizeof(as_string);
+
+		// From as_string_new_strndup(), the characters follow the header.
+		if (s->value && (s->free || s->value == (const char *)(s + 1))) {
+			bytes = (s->len != SIZE_MAX ? s->len : strlen(s->value)) + 1;
+		}
+		break;
+	}
+	case AS_BYTES: {
+		const as_bytes * b = (const as_bytes *)v;
+		header = sizeof(as_bytes);
+
+		if (b->free) {
+			bytes = b->capacity;
+		}
+		break;
+	}
+	case AS_GEOJSON: {
+		const as_geojson * g = (const as_geojson *)v;
+		header = sizeof(as_geojson);
+
+		if (g->free && g->value) {
+			bytes = g->len + 1;
+		}
+		break;
+	}
+	case AS_PAIR: {
+		const as_pair * p = (const as_pair *)v;
+		header = sizeof(as_pair);
+		as_val_memory_add(p->_1, mem, shared);
+		as_val_memory_add(p->_2, mem, shared);
+		break;
+	}
+	case AS_LIST: {
+		const as_list * l = (const as_list *)v;
+
+		if (l->hooks && l->hooks->memory) {
+			l->hooks->memory(l, mem, shared);
+			return;
+		}
+
+		as_val_memory_udata u = { .mem = mem, .shared = shared };
+		header = sizeof(as_list);
+		bytes = as_list_size(l) * sizeof(as_val *);
+		as_list_foreach(l, as_val_memory_list_cb, &u);
+		break;
+	}
+	case AS_MAP: {
+		const as_map * m = (const as_map *)v;
+
+		if (m->hooks && m->hooks->memory) {
+			m->hooks->memory(m, mem, shared);
+			return;
+		}
+
+		as_val_memory_udata u = { .mem = mem, .shared = shared };
+		header = sizeof(as_map);
+		bytes = as_map_size(m) * 2 * sizeof(as_val *);
+		as_map_foreach(m, as_val_memory_map_cb, &u);
+		break;
+	}
+	case AS_REC:
+		// Records are views of external storage.
+		header = sizeof(as_rec);
+		break;
+	default:
+		break;
+	}
+
+	as_val_memory_bytes(mem, shared, (v->free ? header : 0) + bytes);
+}
+
+void as_val_memory_usage(const as_val * v, as_val_memory * mem)
+{
+	as_val_memory_add(v, mem, false);
+}
+
+size_t as_val_memory_size(const as_val * v)
+{
+	as_val_memory mem = { 0 };
+	as_val_memory_add(v, &mem, false);
+	return mem.exclusive + mem.shared;
+}
@@ -0,0 +1,139 @@
+/*
+ * Copyright 2026 Aerospike, Inc.
+ *
+ * Portions may be licensed to Aerospike, Inc. under one or more contributor
+ * license agreements.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include <aerospike/as_val_reclaim.h>
+#include <aerospike/as_atomic.h>
+#include <aerospike/as_thread_pool.h>
+#include <citrusleaf/alloc.h>
+
+/******************************************************************************
+ * GLOBALS
+ *****************************************************************************/
+
+static as_thread_pool g_pool;
+static uint8_t g_running = 0;
+static uint32_t g_max_backlog = 0;
+static uint32_t g_backlog = 0;
+static uint32_t g_backlog_peak = 0;
+static uint64_t g_deferred = 0;
+static uint64_t g_reclaimed = 0;
+static uint64_t g_overflows = 0;
+
+/******************************************************************************
+ * STATIC FUNCTIONS
+ *****************************************************************************/
+
+static void
+reclaim_task(void* udata)
+{
+	as_val_destroy((as_val*)udata);
+	as_decr_uint32(&g_backlog);
+	as_incr_uint64(&g_reclaimed);
+}
+
+static void
+backlog_peak_update(uint32_t backlog)
+{
+	uint32_t peak = as_load_uint32(&g_backlog_peak);
+
+	while (backlog > peak) {
+		if (as_cas_uint32(&g_backlog_peak, peak, backlog)) {
+			break;
+		}
+
+		peak = as_load_uint32(&g_backlog_peak);
+	}
+}
+
+/******************************************************************************
+ * FUNCTIONS
+ *****************************************************************************/
+
+int
+as_val_reclaim_start(uint32_t max_backlog)
+{
+	if (as_load_uint8(&g_running)) {
+		return -1;
+	}
+
+	// With a single thread, a failed init has already cleaned up.
+	if (as_thread_pool_init(&g_pool, 1) != 0) {
+		return -2;
+	}
+
+	as_store_uint32(&g_max_backlog, max_backlog);
+	as_store_uint8(&g_running, 1);
+	return 0;
+}
+
+void
+as_val_reclaim_stop(void)
+{
+	if (! as_load_uint8(&g_running)) {
+		return;
+	}
+
+	as_store_uint8(&g_running, 0);
+
+	// Runs all queued tasks before the thread exits.
+	as_thread_pool_destroy(&g_pool);
+}
+
+void
+as_val_reclaim_get_stats(as_val_reclaim_stats* stats)
+{
+	stats->deferred = as_load_uint64(&g_deferred);
+	stats->reclaimed = as_load_uint64(&g_reclaimed);
+	stats->overflows = as_load_uint64(&g_overflows);
+	stats->backlog = as_load_uint32(&g_backlog);
+	stats->backlog_peak = as_load_uint32(&g_backlog_peak);
+}
+
+as_val*
+as_val_destroy_deferred(as_val* v)
+{
+	// A count of 1 is our reference, so no other thread can reserve it.
+	if (v == NULL || v->local || ! v->free ||
+			as_load_uint32(&v->count) != 1 ||
+			! (v->type == AS_LIST || v->type == AS_MAP || v->type == AS_PAIR) ||
+			! as_load_uint8(&g_running)) {
+		return as_val_destroy(v);
+	}
+
+	uint32_t backlog = as_aaf_uint32(&g_backlog, 1);
+
+	if (backlog > as_load_uint32(&g_max_backlog)) {
+		as_decr_uint32(&g_backlog);
+		as_incr_uint64(&g_overflows);
+		return as_val_destroy(v);
+	}
+
+	backlog_peak_update(backlog);
+
+	// Confined values in the tree may be held elsewhere on this thread - the
+	// reclaimer must update their counts atomically.
+	as_val_share(v);
+
+	if (as_thread_pool_queue_task(&g_pool, reclaim_task, v) != 0) {
+		as_decr_uint32(&g_backlog);
+		as_incr_uint64(&g_overflows);
+		return as_val_destroy(v);
+	}
+
+	as_incr_uint64(&g_deferred);
+	return NULL;
+}
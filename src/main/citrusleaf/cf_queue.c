@@ -17,6 +17,8 @@
 #include <citrusleaf/cf_queue.h>
 #include <citrusleaf/cf_clock.h>
 #include <citrusleaf/alloc.h>
+#include <aerospike/as_atomic.h>
+#include <sched.h>
 #include <string.h>
 
 /******************************************************************************
@@ -43,6 +45,8 @@ cf_queue_init(cf_queue *q, size_t element_sz, uint32_t capacity,
 	q->element_sz = element_sz;
 	q->threadsafe = threadsafe;
 	q->free_struct = false;
+	q->ring = NULL;
+	q->stats = NULL;
 
 	q->elements = (uint8_t*)cf_malloc(capacity * element_sz);
 
@@ -59,11 +63,7 @@ cf_queue_init(cf_queue *q, size_t element_sz, uint32_t capacity,
 		return false;
 	}
 
-	if (0 != pthread_cond_init(&q->CV, NULL)) {
-		pthread_mutex_destroy(&q->LOCK);
-		cf_free(q->elements);
-		return false;
-	}
+	as_eventcount_init(&q->EC, AS_EVENTCOUNT_SPIN);
 
 	return true;
 }
@@ -87,14 +87,80 @@ cf_queue_create(size_t element_sz, bool threadsafe)
 	return q;
 }
 
+bool
+cf_queue_init_mpmc(cf_queue *q, size_t element_sz, uint32_t capacity)
+{
+	uint32_t n = 2;
+
+	while (n < capacity && n < 0x80000000) {
+		n <<= 1;
+	}
+
+	cf_queue_ring *ring = (cf_queue_ring*)cf_malloc(sizeof(cf_queue_ring));
+
+	if (! ring) {
+		return false;
+	}
+
+	memset(ring, 0, sizeof(cf_queue_ring));
+	ring->mask = n - 1;
+	ring->seqs = (uint32_t*)cf_malloc(n * sizeof(uint32_t));
+
+	if (! ring->seqs) {
+		cf_free(ring);
+		return false;
+	}
+
+	// Slot i is free for the push at position i.
+	for (uint32_t i = 0; i < n; i++) {
+		ring->seqs[i] = i;
+	}
+
+	// The mutex is unused, and the eventcount only wakes blocked pops.
+	if (! cf_queue_init(q, element_sz, n, true)) {
+		cf_free(ring->seqs);
+		cf_free(ring);
+		return false;
+	}
+
+	q->ring = ring;
+
+	return true;
+}
+
+cf_queue *
+cf_queue_create_mpmc(size_t element_sz, uint32_t capacity)
+{
+	cf_queue *q = (cf_queue*)cf_malloc(sizeof(cf_queue));
+
+	if (! q) {
+		return NULL;
+	}
+
+	if (! cf_queue_init_mpmc(q, element_sz, capacity)) {
+		cf_free(q);
+		return NULL;
+	}
+
+	q->free_struct = true;
+
+	return q;
+}
+
 void
 cf_queue_destroy(cf_queue *q)
 {
 	if (q->threadsafe) {
-		pthread_cond_destroy(&q->CV);
+		as_eventcount_destroy(&q->EC);
 		pthread_mutex_destroy(&q->LOCK);
 	}
 
+	if (q->ring) {
+		cf_free(q->ring->seqs);
+		cf_free(q->ring);
+	}
+
+	cf_free(q->stats);
 	cf_free(q->elements);
 
 	if (q->free_struct) {
@@ -103,11 +169,64 @@ cf_queue_destroy(cf_queue *q)
 	}
 }
 
+void
+cf_queue_set_spin(cf_queue *q, uint32_t spin)
+{
+	if (q->threadsafe) {
+		as_eventcount_set_spin(&q->EC, spin);
+	}
+}
+
+bool
+cf_queue_enable_stats(cf_queue *q)
+{
+	if (! q->threadsafe) {
+		return false;
+	}
+
+	if (q->stats) {
+		return true;
+	}
+
+	as_stats_clock_init();
+	q->stats = (as_queue_stats*)cf_calloc(1, sizeof(as_queue_stats));
+
+	return q->stats != NULL;
+}
+
+bool
+cf_queue_get_stats(cf_queue *q, as_queue_stats *stats)
+{
+	if (! q->stats) {
+		return false;
+	}
+
+	if (q->ring) {
+		memset(stats, 0, sizeof(as_queue_stats));
+		stats->depth_max = as_load_uint32(&q->stats->depth_max);
+	}
+	else {
+		pthread_mutex_lock(&q->LOCK);
+		*stats = *q->stats;
+		pthread_mutex_unlock(&q->LOCK);
+	}
+
+	stats->wakeups = as_load_uint64(&q->EC.wakes);
+	stats->parks = as_load_uint64(&q->EC.parks);
+
+	return true;
+}
+
 static inline void
 cf_queue_lock(cf_queue *q)
 {
 	if (q->threadsafe) {
-		pthread_mutex_lock(&q->LOCK);
+		if (q->stats) {
+			as_queue_stats_lock(q->stats, &q->LOCK);
+		}
+		else {
+			pthread_mutex_lock(&q->LOCK);
+		}
 	}
 }
 
@@ -115,10 +234,55 @@ static inline void
 cf_queue_unlock(cf_queue *q)
 {
 	if (q->threadsafe) {
+		if (q->stats) {
+			as_queue_stats_depth(q->stats, q->n_eles);
+		}
+
 		pthread_mutex_unlock(&q->LOCK);
 	}
 }
 
+static bool
+cf_queue_ready(void *udata)
+{
+	return as_load_uint32(&((cf_queue*)udata)->n_eles) != 0;
+}
+
+//
+// Wait until the queue is not empty. Call with lock held - it is released
+// while spinning or parked. If the queue is still empty at the deadline,
+// returns false with the lock released.
+//
+static bool
+cf_queue_wait(cf_queue *q, int ms_wait, uint64_t deadline)
+{
+	if (! q->threadsafe) {
+		return ! CF_Q_EMPTY(q);
+	}
+
+	// The while() loop covers pops that got in ahead of us - they take the
+	// element, and we go back to waiting for the time that remains.
+	while (CF_Q_EMPTY(q)) {
+		if (CF_QUEUE_NOWAIT == ms_wait) {
+			pthread_mutex_unlock(&q->LOCK);
+			return false;
+		}
+
+		pthread_mutex_unlock(&q->LOCK);
+
+		bool ready = as_eventcount_await(&q->EC, cf_queue_ready, q, deadline);
+
+		cf_queue_lock(q);
+
+		if (! ready && CF_Q_EMPTY(q)) {
+			pthread_mutex_unlock(&q->LOCK);
+			return false;
+		}
+	}
+
+	return true;
+}
+
 //
 // Internal function. Call with new size with lock held and
 // CF_Q_SZ(q) == q->alloc_sz -- only works on full queues.
@@ -181,9 +345,229 @@ cf_queue_unwrap(cf_queue *q)
 	}
 }
 
+//
+// Copy count elements in at (or out from) an offset, in at most two segments
+// - up to the end of the buffer, then from its start. Call with lock held.
+//
+static inline void
+cf_queue_copy_in(cf_queue *q, uint32_t offset, const uint8_t *src,
+		uint32_t count)
+{
+	uint32_t end_count = q->alloc_sz - (offset % q->alloc_sz);
+
+	if (end_count > count) {
+		end_count = count;
+	}
+
+	memcpy(CF_Q_ELEM_PTR(q, offset), src, end_count * q->element_sz);
+	memcpy(&q->elements[0], &src[end_count * q->element_sz],
+			(count - end_count) * q->element_sz);
+}
+
+static inline void
+cf_queue_copy_out(cf_queue *q, uint32_t offset, uint8_t *dst, uint32_t count)
+{
+	uint32_t end_count = q->alloc_sz - (offset % q->alloc_sz);
+
+	if (end_count > count) {
+		end_count = count;
+	}
+
+	memcpy(dst, CF_Q_ELEM_PTR(q, offset), end_count * q->element_sz);
+	memcpy(&dst[end_count * q->element_sz], &q->elements[0],
+			(count - end_count) * q->element_sz);
+}
+
+//
+// Lock-free mode - Vyukov's bounded MPMC queue. Each slot's sequence number
+// tells whether it is free for the push at position pos (seq == pos) or holds
+// the element for the pop at position pos (seq == pos + 1). Threads claim a
+// position with compare-and-swap, then copy the element and publish the slot
+// with a release store of its sequence.
+//
+
+#define CF_Q_RING_ELEM_PTR(__q, __pos) \
+	(&__q->elements[(__pos & __q->ring->mask) * __q->element_sz])
+
+//
+// Push up to n elements. A push claims the whole run of free slots from its
+// position, up to n and the limit, with one compare-and-swap.
+//
+static uint32_t
+cf_queue_ring_push(cf_queue *q, const void *ptr, uint32_t n, uint32_t limit)
+{
+	cf_queue_ring *ring = q->ring;
+	uint32_t pos = as_load_uint32(&ring->enqueue_pos);
+	uint32_t count;
+
+	while (true) {
+		uint32_t seq = as_load_uint32_acq(&ring->seqs[pos & ring->mask]);
+		int32_t diff = (int32_t)(seq - pos);
+
+		if (diff == 0) {
+			uint32_t size = pos - as_load_uint32(&ring->dequeue_pos);
+
+			if (size >= limit) {
+				return 0;
+			}
+
+			uint32_t max = limit - size < n ? limit - size : n;
+
+			count = 1;
+
+			while (count < max && as_load_uint32_acq(
+					&ring->seqs[(pos + count) & ring->mask]) == pos + count) {
+				count++;
+			}
+
+			if (as_cas_uint32(&ring->enqueue_pos, pos, pos + count)) {
+				break;
+			}
+
+			pos = as_load_uint32(&ring->enqueue_pos);
+		}
+		else if (diff < 0) {
+			if (pos - as_load_uint32(&ring->dequeue_pos) > ring->mask) {
+				return 0; // full
+			}
+
+			// A pop claimed the slot but hasn't released it yet.
+			sched_yield();
+			pos = as_load_uint32(&ring->enqueue_pos);
+		}
+		else {
+			pos = as_load_uint32(&ring->enqueue_pos);
+		}
+	}
+
+	// Copy in at most two segments - up to the end of the ring, then from its
+	// start.
+	uint32_t offset = pos & ring->mask;
+	uint32_t end_count = ring->mask + 1 - offset;
+
+	if (end_count > count) {
+		end_count = count;
+	}
+
+	memcpy(CF_Q_RING_ELEM_PTR(q, pos), ptr, end_count * q->element_sz);
+	memcpy(q->elements, (const uint8_t*)ptr + end_count * q->element_sz,
+			(count - end_count) * q->element_sz);
+
+	for (uint32_t i = 0; i < count; i++) {
+		as_store_uint32_rls(&ring->seqs[(pos + i) & ring->mask], pos + i + 1);
+	}
+
+	if (q->stats) {
+		// Pops may already have passed later pushes' slots - skip if so.
+		int32_t depth = (int32_t)(pos + count - as_load_uint32(&ring->dequeue_pos));
+
+		if (depth > 0) {
+			as_setmax_uint32(&q->stats->depth_max, (uint32_t)depth);
+		}
+	}
+
+	as_eventcount_notify(&q->EC, count);
+
+	return count;
+}
+
+//
+// Pop up to n elements - the run of published slots from the pop position.
+//
+static uint32_t
+cf_queue_ring_try_pop(cf_queue *q, void *buf, uint32_t n)
+{
+	cf_queue_ring *ring = q->ring;
+	uint32_t pos = as_load_uint32(&ring->dequeue_pos);
+	uint32_t count;
+
+	while (true) {
+		uint32_t seq = as_load_uint32_acq(&ring->seqs[pos & ring->mask]);
+		int32_t diff = (int32_t)(seq - (pos + 1));
+
+		if (diff == 0) {
+			count = 1;
+
+			while (count < n && as_load_uint32_acq(
+					&ring->seqs[(pos + count) & ring->mask]) == pos + count + 1) {
+				count++;
+			}
+
+			if (as_cas_uint32(&ring->dequeue_pos, pos, pos + count)) {
+				break;
+			}
+
+			pos = as_load_uint32(&ring->dequeue_pos);
+		}
+		else if (diff < 0) {
+			return 0; // empty
+		}
+		else {
+			pos = as_load_uint32(&ring->dequeue_pos);
+		}
+	}
+
+	uint32_t offset = pos & ring->mask;
+	uint32_t end_count = ring->mask + 1 - offset;
+
+	if (end_count > count) {
+		end_count = count;
+	}
+
+	memcpy(buf, CF_Q_RING_ELEM_PTR(q, pos), end_count * q->element_sz);
+	memcpy((uint8_t*)buf + end_count * q->element_sz, q->elements,
+			(count - end_count) * q->element_sz);
+
+	for (uint32_t i = 0; i < count; i++) {
+		as_store_uint32_rls(&ring->seqs[(pos + i) & ring->mask],
+				pos + i + ring->mask + 1);
+	}
+
+	return count;
+}
+
+typedef struct cf_queue_ring_wait_s {
+	cf_queue *q;
+	void *buf;
+	uint32_t n;
+	uint32_t count;
+} cf_queue_ring_wait;
+
+static bool
+cf_queue_ring_ready(void *udata)
+{
+	cf_queue_ring_wait *w = (cf_queue_ring_wait*)udata;
+
+	w->count = cf_queue_ring_try_pop(w->q, w->buf, w->n);
+	return w->count != 0;
+}
+
+static uint32_t
+cf_queue_ring_pop(cf_queue *q, void *buf, uint32_t n, int ms_wait)
+{
+	uint32_t count = cf_queue_ring_try_pop(q, buf, n);
+
+	if (count != 0 || ms_wait == CF_QUEUE_NOWAIT) {
+		return count;
+	}
+
+	// Each readiness check is a pop attempt.
+	cf_queue_ring_wait w = { .q = q, .buf = buf, .n = n, .count = 0 };
+
+	as_eventcount_await(&q->EC, cf_queue_ring_ready, &w,
+			as_eventcount_deadline(ms_wait));
+
+	return w.count;
+}
+
 int
 cf_queue_push(cf_queue *q, const void *ptr)
 {
+	if (q->ring) {
+		return cf_queue_ring_push(q, ptr, 1, UINT32_MAX) == 1 ?
+				CF_QUEUE_OK : CF_QUEUE_ERR;
+	}
+
 	cf_queue_lock(q);
 
 	// Check queue length.
@@ -200,11 +584,12 @@ cf_queue_push(cf_queue *q, const void *ptr)
 	q->n_eles++;
 	cf_queue_unwrap(q);
 
+	cf_queue_unlock(q);
+
 	if (q->threadsafe) {
-		pthread_cond_signal(&q->CV);
+		as_eventcount_notify(&q->EC, 1);
 	}
 
-	cf_queue_unlock(q);
 	return CF_QUEUE_OK;
 }
 
@@ -214,6 +599,10 @@ cf_queue_push(cf_queue *q, const void *ptr)
 bool
 cf_queue_push_limit(cf_queue *q, const void *ptr, uint32_t limit)
 {
+	if (q->ring) {
+		return cf_queue_ring_push(q, ptr, 1, limit) == 1;
+	}
+
 	cf_queue_lock(q);
 
 	uint32_t size = CF_Q_SZ(q);
@@ -236,20 +625,83 @@ cf_queue_push_limit(cf_queue *q, const void *ptr, uint32_t limit)
 	q->n_eles++;
 	cf_queue_unwrap(q);
 
+	cf_queue_unlock(q);
+
 	if (q->threadsafe) {
-		pthread_cond_signal(&q->CV);
+		as_eventcount_notify(&q->EC, 1);
 	}
 
-	cf_queue_unlock(q);
 	return true;
 }
 
+//
+// Push n elements, laid out contiguously at ptr, under one hold of the lock.
+//
+uint32_t
+cf_queue_push_n(cf_queue *q, const void *ptr, uint32_t n)
+{
+	const uint8_t *src = (const uint8_t*)ptr;
+	uint32_t pushed = 0;
+
+	if (q->ring) {
+		while (pushed < n) {
+			uint32_t count = cf_queue_ring_push(q, &src[pushed * q->element_sz],
+					n - pushed, UINT32_MAX);
+
+			if (count == 0) {
+				break; // full
+			}
+
+			pushed += count;
+		}
+
+		return pushed;
+	}
+
+	cf_queue_lock(q);
+
+	while (pushed < n) {
+		// Resize only works on full queues, so fill up before doubling.
+		if (CF_Q_SZ(q) == q->alloc_sz) {
+			if (0 != cf_queue_resize(q, q->alloc_sz * 2)) {
+				break;
+			}
+		}
+
+		uint32_t count = q->alloc_sz - CF_Q_SZ(q);
+
+		if (count > n - pushed) {
+			count = n - pushed;
+		}
+
+		cf_queue_copy_in(q, q->write_offset, &src[pushed * q->element_sz],
+				count);
+		q->write_offset += count;
+		q->n_eles += count;
+		cf_queue_unwrap(q);
+		pushed += count;
+	}
+
+	cf_queue_unlock(q);
+
+	// Wake at most one parked pop per element.
+	if (q->threadsafe && pushed != 0) {
+		as_eventcount_notify(&q->EC, pushed);
+	}
+
+	return pushed;
+}
+
 //
 // Push element on the queue at a specified index.
 //
 int
 cf_queue_push_index(cf_queue *q, const void *ptr, uint32_t ix)
 {
+	if (q->ring) {
+		return CF_QUEUE_ERR;
+	}
+
 	cf_queue_lock(q);
 
 	uint32_t size = CF_Q_SZ(q);
@@ -312,11 +764,12 @@ cf_queue_push_index(cf_queue *q, const void *ptr, uint32_t ix)
 	q->n_eles++;
 	cf_queue_unwrap(q);
 
+	cf_queue_unlock(q);
+
 	if (q->threadsafe) {
-		pthread_cond_signal(&q->CV);
+		as_eventcount_notify(&q->EC, 1);
 	}
 
-	cf_queue_unlock(q);
 	return CF_QUEUE_OK;
 }
 
@@ -326,6 +779,10 @@ cf_queue_push_index(cf_queue *q, const void *ptr, uint32_t ix)
 int
 cf_queue_push_unique(cf_queue *q, const void *ptr)
 {
+	if (q->ring) {
+		return CF_QUEUE_ERR;
+	}
+
 	cf_queue_lock(q);
 
 	// Check if element is already queued.
@@ -353,11 +810,12 @@ cf_queue_push_unique(cf_queue *q, const void *ptr)
 	q->n_eles++;
 	cf_queue_unwrap(q);
 
+	cf_queue_unlock(q);
+
 	if (q->threadsafe) {
-		pthread_cond_signal(&q->CV);
+		as_eventcount_notify(&q->EC, 1);
 	}
 
-	cf_queue_unlock(q);
 	return CF_QUEUE_OK;
 }
 
@@ -367,6 +825,10 @@ cf_queue_push_unique(cf_queue *q, const void *ptr)
 int
 cf_queue_push_head(cf_queue *q, const void *ptr)
 {
+	if (q->ring) {
+		return CF_QUEUE_ERR;
+	}
+
 	cf_queue_lock(q);
 
 	if (CF_Q_SZ(q) == q->alloc_sz) {
@@ -386,11 +848,12 @@ cf_queue_push_head(cf_queue *q, const void *ptr)
 	q->n_eles++;
 	cf_queue_unwrap(q);
 
+	cf_queue_unlock(q);
+
 	if (q->threadsafe) {
-		pthread_cond_signal(&q->CV);
+		as_eventcount_notify(&q->EC, 1);
 	}
 
-	cf_queue_unlock(q);
 	return CF_QUEUE_OK;
 }
 
@@ -400,6 +863,10 @@ cf_queue_push_head(cf_queue *q, const void *ptr)
 int
 cf_queue_peek(cf_queue *q, void *buf)
 {
+	if (q->ring) {
+		return CF_QUEUE_ERR;
+	}
+
 	cf_queue_lock(q);
 
 	if (CF_Q_EMPTY(q)) {
@@ -421,40 +888,17 @@ cf_queue_peek(cf_queue *q, void *buf)
 int
 cf_queue_pop(cf_queue *q, void *buf, int ms_wait)
 {
-	struct timespec tp;
-
-	if (ms_wait > 0) {
-		cf_set_wait_timespec(ms_wait, &tp);
+	if (q->ring) {
+		return cf_queue_ring_pop(q, buf, 1, ms_wait) == 1 ?
+				CF_QUEUE_OK : CF_QUEUE_EMPTY;
 	}
 
-	cf_queue_lock(q);
+	// A monotonic deadline, so clock adjustments don't affect the wait.
+	uint64_t deadline = as_eventcount_deadline(ms_wait);
 
-	if (q->threadsafe) {
-
-		// Note that we have to use a while() loop. The pthread_cond_signal()
-		// documentation says that AT LEAST ONE waiting thread will be awakened.
-		// If more than one are awakened, the first will get the popped element,
-		// others will find the queue empty and go back to waiting.
-
-		while (CF_Q_EMPTY(q)) {
-			if (CF_QUEUE_FOREVER == ms_wait) {
-				pthread_cond_wait(&q->CV, &q->LOCK);
-			}
-			else if (CF_QUEUE_NOWAIT == ms_wait) {
-				pthread_mutex_unlock(&q->LOCK);
-				return CF_QUEUE_EMPTY;
-			}
-			else {
-				pthread_cond_timedwait(&q->CV, &q->LOCK, &tp);
+	cf_queue_lock(q);
 
-				if (CF_Q_EMPTY(q)) {
-					pthread_mutex_unlock(&q->LOCK);
-					return CF_QUEUE_EMPTY;
-				}
-			}
-		}
-	}
-	else if (CF_Q_EMPTY(q)) {
+	if (! cf_queue_wait(q, ms_wait, deadline)) {
 		return CF_QUEUE_EMPTY;
 	}
 
@@ -471,6 +915,48 @@ cf_queue_pop(cf_queue *q, void *buf, int ms_wait)
 	return CF_QUEUE_OK;
 }
 
+//
+// Pop up to n elements under one hold of the lock. Waits as cf_queue_pop()
+// does, but only for the first element.
+//
+uint32_t
+cf_queue_pop_n(cf_queue *q, void *buf, uint32_t n, int ms_wait)
+{
+	if (n == 0) {
+		return 0;
+	}
+
+	if (q->ring) {
+		return cf_queue_ring_pop(q, buf, n, ms_wait);
+	}
+
+	// A monotonic deadline, so clock adjustments don't affect the wait.
+	uint64_t deadline = as_eventcount_deadline(ms_wait);
+
+	cf_queue_lock(q);
+
+	if (! cf_queue_wait(q, ms_wait, deadline)) {
+		return 0;
+	}
+
+	uint32_t count = CF_Q_SZ(q);
+
+	if (count > n) {
+		count = n;
+	}
+
+	cf_queue_copy_out(q, q->read_offset, (uint8_t*)buf, count);
+	q->read_offset += count;
+	q->n_eles -= count;
+
+	if (q->read_offset == q->write_offset) {
+		q->read_offset = q->write_offset = 0;
+	}
+
+	cf_queue_unlock(q);
+	return count;
+}
+
 void
 cf_queue_delete_offset(cf_queue *q, uint32_t index)
 {
@@ -519,6 +1005,10 @@ cf_queue_delete_offset(cf_queue *q, uint32_t index)
 int
 cf_queue_reduce(cf_queue *q, cf_queue_reduce_fn cb, void *udata)
 {
+	if (q->ring) {
+		return CF_QUEUE_ERR;
+	}
+
 	cf_queue_lock(q);
 
 	if (CF_Q_SZ(q) != 0) {
@@ -554,40 +1044,16 @@ int
 cf_queue_reduce_pop(cf_queue *q, void *buf, int ms_wait, cf_queue_reduce_fn cb,
 		void *udata)
 {
-	struct timespec tp;
-
-	if (ms_wait > 0) {
-		cf_set_wait_timespec(ms_wait, &tp);
+	if (q->ring) {
+		return CF_QUEUE_ERR;
 	}
 
-	cf_queue_lock(q);
-
-	if (q->threadsafe) {
-
-		// Note that we have to use a while() loop. The pthread_cond_signal()
-		// documentation says that AT LEAST ONE waiting thread will be awakened.
-		// If more than one are awakened, the first will get the popped element,
-		// others will find the queue empty and go back to waiting.
+	// A monotonic deadline, so clock adjustments don't affect the wait.
+	uint64_t deadline = as_eventcount_deadline(ms_wait);
 
-		while (CF_Q_EMPTY(q)) {
-			if (CF_QUEUE_FOREVER == ms_wait) {
-				pthread_cond_wait(&q->CV, &q->LOCK);
-			}
-			else if (CF_QUEUE_NOWAIT == ms_wait) {
-				pthread_mutex_unlock(&q->LOCK);
-				return CF_QUEUE_EMPTY;
-			}
-			else {
-				pthread_cond_timedwait(&q->CV, &q->LOCK, &tp);
+	cf_queue_lock(q);
 
-				if (CF_Q_EMPTY(q)) {
-					pthread_mutex_unlock(&q->LOCK);
-					return CF_QUEUE_EMPTY;
-				}
-			}
-		}
-	}
-	else if (CF_Q_EMPTY(q)) {
+	if (! cf_queue_wait(q, ms_wait, deadline)) {
 		return CF_QUEUE_EMPTY;
 	}
 
@@ -626,6 +1092,10 @@ cf_queue_reduce_pop(cf_queue *q, void *buf, int ms_wait, cf_queue_reduce_fn cb,
 int
 cf_queue_reduce_reverse(cf_queue *q, cf_queue_reduce_fn cb, void *udata)
 {
+	if (q->ring) {
+		return CF_QUEUE_ERR;
+	}
+
 	cf_queue_lock(q);
 
 	if (CF_Q_SZ(q) != 0) {
@@ -660,6 +1130,10 @@ cf_queue_reduce_reverse(cf_queue *q, cf_queue_reduce_fn cb, void *udata)
 int
 cf_queue_delete(cf_queue *q, const void *ptr, bool only_one)
 {
+	if (q->ring) {
+		return CF_QUEUE_ERR;
+	}
+
 	cf_queue_lock(q);
 
 	bool found = false;
@@ -691,5 +1165,20 @@ cf_queue_delete(cf_queue *q, const void *ptr, bool only_one)
 int
 cf_queue_delete_all(cf_queue *q)
 {
+	if (q->ring) {
+		uint8_t *buf = (uint8_t*)cf_malloc(q->element_sz);
+
+		if (! buf) {
+			return CF_QUEUE_ERR;
+		}
+
+		while (cf_queue_ring_try_pop(q, buf, 1) != 0) {
+			;
+		}
+
+		cf_free(buf);
+		return CF_QUEUE_OK;
+	}
+
 	return cf_queue_delete(q, NULL, false);
 }
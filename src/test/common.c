@@ -10,6 +10,7 @@ before(atf_plan* plan)
 PLAN(common) {
 	plan_before(before);
 
+	plan_add(types_val);
 	plan_add(types_boolean);
 	plan_add(types_integer);
 	plan_add(types_double);
@@ -19,12 +20,21 @@ PLAN(common) {
 	plan_add(types_hashmap);
 	plan_add(types_nil);
 	plan_add(types_orderedmap);
+	plan_add(types_persistent_list);
+	plan_add(types_persistent_map);
+	plan_add(types_typedlist);
+	plan_add(types_list_slice);
+	plan_add(types_parallel);
 	plan_add(types_queue);
 	plan_add(types_queue_mt);
+	plan_add(types_cf_queue);
+	plan_add(types_spsc);
+	plan_add(types_thread_pool);
 
 	plan_add(password);
 	plan_add(string_builder);
 	plan_add(random_numbers);
+	plan_add(slab);
 
 	plan_add(msgpack_roundtrip);
 	plan_add(msgpack_direct);
@@ -10,6 +10,7 @@
 #include <aerospike/as_map.h>
 #include <aerospike/as_msgpack.h>
 #include <aerospike/as_serializer.h>
+#include <aerospike/as_slab.h>
 #include <aerospike/as_string.h>
 #include <aerospike/as_stringmap.h>
 
@@ -181,6 +182,100 @@ TEST( msgpack_roundtrip_map2, "roundtrip: {'abc': [1,2,3], 'def': [4,5,6], 'ghi'
  * TEST SUITE
  *****************************************************************************/
 
+TEST( msgpack_roundtrip_local, "roundtrip: thread-confined unpack and share" )
+{
+	as_arraylist l1;
+	as_arraylist_inita(&l1,2);
+	as_arraylist_append_str(&l1, "a string longer than the inline buffer");
+	as_arraylist_append_int64(&l1, 1L << 40);
+
+	as_serializer ser;
+	as_msgpack_init(&ser);
+
+	as_buffer b;
+	as_buffer_init(&b);
+	as_serializer_serialize(&ser, (as_val *) &l1, &b);
+
+	as_unpacker pk = {
+			.buffer = b.data,
+			.offset = 0,
+			.length = b.size
+	};
+
+	as_val * v2 = NULL;
+	assert_int_eq(as_unpack_val_local(&pk, &v2), 0);
+	assert_not_null(v2);
+	assert_val_eq(v2, &l1);
+
+	as_list * l2 = as_list_fromval(v2);
+	as_val * e0 = as_list_get(l2, 0);
+	assert_true(v2->local);
+	assert_true(e0->local);
+
+	as_val_reserve(e0);
+	assert_int_eq(e0->count, 2);
+	as_val_destroy(e0);
+	assert_int_eq(e0->count, 1);
+
+	as_val_share(v2);
+	assert_false(v2->local);
+	assert_false(e0->local);
+	assert_false(as_list_get(l2, 1)->local);
+
+	as_val_destroy(v2);
+	as_buffer_destroy(&b);
+	as_serializer_destroy(&ser);
+	as_arraylist_destroy(&l1);
+}
+
+TEST( msgpack_roundtrip_cached, "roundtrip: integers boxed from the cache" )
+{
+	as_arraylist l1;
+	as_arraylist_init(&l1, 1000, 0);
+
+	for (int64_t i = 0; i < 1000; i++) {
+		as_arraylist_append_int64(&l1, i % (AS_INTEGER_CACHE_MAX + 1));
+	}
+
+	as_serializer ser;
+	as_msgpack_init(&ser);
+
+	as_buffer b;
+	as_buffer_init(&b);
+	as_serializer_serialize(&ser, (as_val *) &l1, &b);
+
+	// Integers come from the slab allocator - count its allocations.
+	as_slab_stats s0, s1, s2;
+	as_val * v1 = NULL;
+	as_val * v2 = NULL;
+
+	as_unpacker pk = { .buffer = b.data, .offset = 0, .length = b.size };
+
+	as_slab_get_stats(&s0);
+	assert_int_eq(as_unpack_val(&pk, &v1), 0);
+	as_slab_get_stats(&s1);
+
+	pk.offset = 0;
+	assert_int_eq(as_unpack_val_cached(&pk, &v2), 0);
+	as_slab_get_stats(&s2);
+
+	assert_true(s1.allocs - s0.allocs >= 1000);
+	assert_int_eq(s2.allocs - s1.allocs, 0);
+
+	assert_val_eq(v1, &l1);
+	assert_val_eq(v2, &l1);
+
+	as_list * l2 = as_list_fromval(v2);
+	assert_true(as_list_get(l2, 7) == (as_val *)as_integer_new_cached(7));
+	assert_true(as_list_get(as_list_fromval(v1), 7)->count == 1);
+
+	as_val_destroy(v1);
+	as_val_destroy(v2);
+	as_buffer_destroy(&b);
+	as_serializer_destroy(&ser);
+	as_arraylist_destroy(&l1);
+}
+
 SUITE( msgpack_roundtrip, "as_msgpack roundtrip serialize/deserialize" ) {
 	suite_add( msgpack_roundtrip_integer1 );
 	suite_add( msgpack_roundtrip_double1 );
@@ -189,4 +284,6 @@ SUITE( msgpack_roundtrip, "as_msgpack roundtrip serialize/deserialize" ) {
 	suite_add( msgpack_roundtrip_list2 );
 	suite_add( msgpack_roundtrip_map1 );
 	suite_add( msgpack_roundtrip_map2 );
+	suite_add( msgpack_roundtrip_local );
+	suite_add( msgpack_roundtrip_cached );
 }
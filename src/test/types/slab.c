@@ -0,0 +1,137 @@
+#include "../test.h"
+
+#include <aerospike/as_integer.h>
+#include <aerospike/as_pair.h>
+#include <aerospike/as_slab.h>
+#include <aerospike/as_string.h>
+#include <pthread.h>
+
+/******************************************************************************
+ * TEST CASES
+ *****************************************************************************/
+
+#define N_VALS 5000
+
+static as_val* vals[N_VALS];
+
+static void*
+slab_alloc_worker(void* udata)
+{
+	for (int i = 0; i < N_VALS; i++) {
+		vals[i] = (as_val*)as_integer_new(1000000 + i);
+	}
+	return NULL;
+}
+
+static void*
+slab_churn_worker(void* udata)
+{
+	for (int i = 0; i < N_VALS; i++) {
+		vals[i] = (as_val*)as_integer_new(1000000 + i);
+	}
+
+	for (int i = 0; i < N_VALS; i++) {
+		as_val_destroy(vals[i]);
+	}
+	return NULL;
+}
+
+TEST(slab_local, "slab allocator reuses freed blocks")
+{
+	as_integer* a = as_integer_new(1000000);
+	assert_true(a->_.slab);
+	as_integer_destroy(a);
+
+	// Same size class, freed by this thread - the block is reused.
+	as_integer* b = as_integer_new(2000000);
+	assert_true((void*)a == (void*)b);
+	as_integer_destroy(b);
+
+	as_string* s = as_string_new_strdup("slab");
+	as_pair* p = as_pair_new((as_val*)s, (as_val*)as_integer_new(2000000));
+	assert_true(p->_.slab);
+	assert_string_eq(as_string_get(s), "slab");
+	as_pair_destroy(p);
+
+	void* big = as_slab_alloc(AS_SLAB_MAX_SIZE + 1);
+	assert_not_null(big);
+	as_slab_free(big);
+}
+
+TEST(slab_remote, "slab allocator frees across threads")
+{
+	as_slab_stats before;
+	as_slab_get_stats(&before);
+
+	pthread_t thread;
+	pthread_create(&thread, NULL, slab_alloc_worker, NULL);
+	pthread_join(thread, NULL);
+
+	for (int i = 0; i < N_VALS; i++) {
+		assert_int_eq(as_integer_get((as_integer*)vals[i]), 1000000 + i);
+		as_val_destroy(vals[i]);
+	}
+
+	as_slab_stats after;
+	as_slab_get_stats(&after);
+
+	assert_true(after.remote_frees - before.remote_frees >= N_VALS);
+	assert_true(after.orphans >= 1);
+
+	// A new thread adopts the exited thread's cache, and its remote frees.
+	pthread_create(&thread, NULL, slab_alloc_worker, NULL);
+	pthread_join(thread, NULL);
+
+	as_slab_stats again;
+	as_slab_get_stats(&again);
+	assert_int_eq(again.caches, after.caches);
+	assert_int_eq(again.slab_bytes, after.slab_bytes);
+
+	for (int i = 0; i < N_VALS; i++) {
+		as_val_destroy(vals[i]);
+	}
+}
+
+TEST(slab_trim, "slab allocator returns empty slabs")
+{
+	// Empty slabs of this thread's cache.
+	for (int i = 0; i < N_VALS; i++) {
+		vals[i] = (as_val*)as_integer_new(1000000 + i);
+	}
+
+	for (int i = 0; i < N_VALS; i++) {
+		as_val_destroy(vals[i]);
+	}
+
+	as_slab_stats before;
+	as_slab_get_stats(&before);
+
+	uint64_t trimmed = as_slab_trim();
+	assert_true(trimmed > 0);
+
+	as_slab_stats after;
+	as_slab_get_stats(&after);
+	assert_int_eq(before.slab_bytes - after.slab_bytes, trimmed);
+
+	// Empty slabs of an exited thread's cache.
+	pthread_t thread;
+	pthread_create(&thread, NULL, slab_churn_worker, NULL);
+	pthread_join(thread, NULL);
+
+	assert_true(as_slab_trim() > 0);
+
+	// The caches still work.
+	as_integer* a = as_integer_new(3000000);
+	assert_int_eq(as_integer_get(a), 3000000);
+	as_integer_destroy(a);
+}
+
+/******************************************************************************
+ * TEST SUITE
+ *****************************************************************************/
+
+SUITE(slab, "slab allocator") {
+	suite_add(slab_local);
+	suite_add(slab_remote);
+	suite_add(slab_trim);
+}
@@ -7,6 +7,8 @@
 #include <aerospike/as_list_iterator.h>
 #include <aerospike/as_msgpack.h>
 #include <aerospike/as_serializer.h>
+#include <aerospike/as_string.h>
+#include <aerospike/as_thread_pool.h>
 #include <string.h>
 
 /******************************************************************************
@@ -402,7 +404,220 @@ TEST(types_arraylist_iterator, "as_arraylist w/ as_iterator ops")
 
 	as_iterator_destroy(i);
 
+	// Batched.
+	as_list_iterator it;
+	as_list_iterator_init(&it, (as_list *) &l);
+
+	const as_val * batch[3];
+
+	assert_int_eq(as_iterator_next_n((as_iterator *) &it, batch, 3), 3);
+	assert_int_eq(as_integer_toint((as_integer *) batch[2]), 3);
+	assert_int_eq(as_iterator_next_n((as_iterator *) &it, batch, 3), 2);
+	assert_int_eq(as_integer_toint((as_integer *) batch[0]), 4);
+	assert_int_eq(as_integer_toint((as_integer *) batch[1]), 5);
+	assert_int_eq(as_iterator_next_n((as_iterator *) &it, batch, 3), 0);
+
+	as_iterator_destroy((as_iterator *) &it);
+
+	as_arraylist_destroy(&l);
+}
+
+TEST(types_arraylist_deque, "as_arraylist w/ front insertion and removal")
+{
+	as_arraylist l;
+	as_arraylist_init(&l, 4, 4);
+
+	// Prepend - the list reserves room at the front.
+	for (int64_t i = 0; i < 1000; i++) {
+		assert_int_eq(as_arraylist_insert_int64(&l, 0, i), AS_ARRAYLIST_OK);
+	}
+
+	assert_int_eq(as_arraylist_size(&l), 1000);
+
+	for (uint32_t i = 0; i < 1000; i++) {
+		assert_int_eq(as_arraylist_get_int64(&l, i), 999 - i);
+	}
+
+	// Insert and remove near either end.
+	assert_int_eq(as_arraylist_insert_int64(&l, 2, -1), AS_ARRAYLIST_OK);
+	assert_int_eq(as_arraylist_get_int64(&l, 1), 998);
+	assert_int_eq(as_arraylist_get_int64(&l, 2), -1);
+	assert_int_eq(as_arraylist_get_int64(&l, 3), 997);
+	assert_int_eq(as_arraylist_remove(&l, 2), AS_ARRAYLIST_OK);
+	assert_int_eq(as_arraylist_remove(&l, 999), AS_ARRAYLIST_OK);
+	assert_int_eq(as_arraylist_size(&l), 999);
+	assert_int_eq(as_arraylist_get_int64(&l, 2), 997);
+	assert_int_eq(as_arraylist_get_int64(&l, 998), 1);
+
+	assert_int_eq(as_arraylist_trim_front(&l, 1000), AS_ARRAYLIST_ERR_INDEX);
+	assert_int_eq(as_arraylist_trim_front(&l, 499), AS_ARRAYLIST_OK);
+	assert_int_eq(as_arraylist_size(&l), 500);
+	assert_int_eq(as_arraylist_get_int64(&l, 0), 500);
+
+	as_arraylist_iterator it;
+	as_arraylist_iterator_init(&it, &l);
+
+	int64_t expect = 500;
+
+	while (as_iterator_has_next((as_iterator*)&it)) {
+		as_integer* v = (as_integer*)as_iterator_next((as_iterator*)&it);
+		assert_int_eq(as_integer_get(v), expect);
+		expect--;
+	}
+
+	as_iterator_destroy((as_iterator*)&it);
+	assert_int_eq(expect, 0);
+
+	// A rolling window - removed slots are reused, the allocation stays put.
+	uint32_t allocated = l.capacity;
+
+	for (int64_t i = 0; i < 100000; i++) {
+		assert_int_eq(as_arraylist_remove(&l, 0), AS_ARRAYLIST_OK);
+		assert_int_eq(as_arraylist_append_int64(&l, i), AS_ARRAYLIST_OK);
+	}
+
+	assert_int_eq(as_arraylist_size(&l), 500);
+	assert_int_eq(l.capacity, allocated);
+	assert_int_eq(as_arraylist_get_int64(&l, 0), 99500);
+	assert_int_eq(as_arraylist_get_int64(&l, 499), 99999);
+
+	as_arraylist_destroy(&l);
+}
+
+TEST(types_arraylist_fixed_remove_head, "as_arraylist w/ fixed capacity reuses a removed head")
+{
+	as_arraylist l;
+	as_arraylist_init(&l, 4, 0);
+
+	for (int64_t i = 0; i < 4; i++) {
+		assert_int_eq(as_arraylist_append_int64(&l, i), AS_ARRAYLIST_OK);
+	}
+
+	assert_int_eq(as_arraylist_append_int64(&l, 4), AS_ARRAYLIST_ERR_MAX);
+
+	// The slot freed at the front makes room at the back.
+	assert_int_eq(as_arraylist_remove(&l, 0), AS_ARRAYLIST_OK);
+	assert_int_eq(as_arraylist_append_int64(&l, 4), AS_ARRAYLIST_OK);
+	assert_int_eq(as_arraylist_size(&l), 4);
+	assert_int_eq(l.capacity, 4);
+
+	for (uint32_t i = 0; i < 4; i++) {
+		assert_int_eq(as_arraylist_get_int64(&l, i), i + 1);
+	}
+
+	as_arraylist_destroy(&l);
+}
+
+TEST(types_arraylist_sort, "as_arraylist sort")
+{
+	as_arraylist l;
+	as_arraylist_init(&l, 1000, 100);
+
+	// Integers, with duplicates - equal values are distinct objects.
+	for (uint32_t i = 0; i < 1000; i++) {
+		as_arraylist_append(&l, (as_val*)as_integer_new((i * 7919) % 500));
+	}
+
+	as_val* dup1 = NULL;
+
+	for (uint32_t i = 0; i < 1000 && ! dup1; i++) {
+		if (as_arraylist_get_int64(&l, i) == 42) {
+			dup1 = as_arraylist_get(&l, i);
+		}
+	}
+
+	assert_int_eq(as_arraylist_sort(&l, AS_ARRAYLIST_SORT_STABLE), AS_ARRAYLIST_OK);
+
+	for (uint32_t i = 0; i < 1000; i++) {
+		assert_int_eq(as_arraylist_get_int64(&l, i), i / 2);
+	}
+
+	assert_true(as_arraylist_get(&l, 84) == dup1);
+
+	assert_int_eq(as_arraylist_sort(&l, AS_ARRAYLIST_SORT_DESCENDING |
+			AS_ARRAYLIST_SORT_UNIQUE), AS_ARRAYLIST_OK);
+	assert_int_eq(as_arraylist_size(&l), 500);
+
+	for (uint32_t i = 0; i < 500; i++) {
+		assert_int_eq(as_arraylist_get_int64(&l, i), 499 - i);
+	}
+
+	as_arraylist_destroy(&l);
+
+	// Strings sharing long prefixes.
+	const char* strs[] = { "abcdefghij", "abcdefgh", "b", "", "abcdefghi",
+			"abcdefgh\xff", "a" };
+	as_arraylist_init(&l, 7, 0);
+
+	for (uint32_t i = 0; i < 7; i++) {
+		as_arraylist_append_str(&l, strs[i]);
+	}
+
+	assert_int_eq(as_arraylist_sort(&l, 0), AS_ARRAYLIST_OK);
+	assert_string_eq(as_arraylist_get_str(&l, 0), "");
+	assert_string_eq(as_arraylist_get_str(&l, 1), "a");
+	assert_string_eq(as_arraylist_get_str(&l, 2), "abcdefgh");
+	assert_string_eq(as_arraylist_get_str(&l, 3), "abcdefghi");
+	assert_string_eq(as_arraylist_get_str(&l, 4), "abcdefghij");
+	assert_string_eq(as_arraylist_get_str(&l, 5), "abcdefgh\xff");
+	assert_string_eq(as_arraylist_get_str(&l, 6), "b");
+	as_arraylist_destroy(&l);
+
+	// Mixed types sort in as_val_cmp() order.
+	as_arraylist_init(&l, 5, 0);
+	as_arraylist_append_str(&l, "x");
+	as_arraylist_append_double(&l, 1.5);
+	as_arraylist_append_int64(&l, 7);
+	as_arraylist_append(&l, (as_val*)&as_nil);
+	as_arraylist_append_int64(&l, -7);
+
+	assert_int_eq(as_arraylist_sort(&l, 0), AS_ARRAYLIST_OK);
+
+	for (uint32_t i = 1; i < 5; i++) {
+		assert_int_eq(as_val_cmp(as_arraylist_get(&l, i - 1),
+				as_arraylist_get(&l, i)), MSGPACK_COMPARE_LESS);
+	}
+
+	as_arraylist_destroy(&l);
+}
+
+TEST(types_arraylist_sort_parallel, "as_arraylist parallel sort")
+{
+	as_thread_pool pool;
+	assert_int_eq(as_thread_pool_init(&pool, 3), 0);
+
+	as_arraylist l;
+	as_arraylist_init(&l, 200000, 0);
+
+	uint64_t x = 88172645463325252ULL;
+
+	for (uint32_t i = 0; i < 200000; i++) {
+		x ^= x << 13;
+		x ^= x >> 7;
+		x ^= x << 17;
+		as_arraylist_append_double(&l, (double)(x % 100000) / 8);
+	}
+
+	assert_int_eq(as_arraylist_sort_parallel(&l, 0, &pool), AS_ARRAYLIST_OK);
+	assert_int_eq(as_arraylist_size(&l), 200000);
+
+	for (uint32_t i = 1; i < 200000; i++) {
+		assert_true(as_arraylist_get_double(&l, i - 1) <=
+				as_arraylist_get_double(&l, i));
+	}
+
+	assert_int_eq(as_arraylist_sort_parallel(&l, AS_ARRAYLIST_SORT_STABLE |
+			AS_ARRAYLIST_SORT_DESCENDING | AS_ARRAYLIST_SORT_UNIQUE, &pool),
+			AS_ARRAYLIST_OK);
+	assert_true(as_arraylist_size(&l) <= 100000);
+
+	for (uint32_t i = 1; i < as_arraylist_size(&l); i++) {
+		assert_true(as_arraylist_get_double(&l, i - 1) >
+				as_arraylist_get_double(&l, i));
+	}
+
 	as_arraylist_destroy(&l);
+	as_thread_pool_destroy(&pool);
 }
 
 TEST(types_arraylist_msgpack, "as_arraylist msgpack")
@@ -467,5 +682,9 @@ SUITE(types_arraylist, "as_arraylist")
 	suite_add(types_arraylist_1);
 	suite_add(types_arraylist_list);
 	suite_add(types_arraylist_iterator);
+	suite_add(types_arraylist_deque);
+	suite_add(types_arraylist_fixed_remove_head);
+	suite_add(types_arraylist_sort);
+	suite_add(types_arraylist_sort_parallel);
 	suite_add(types_arraylist_msgpack);
 }
@@ -0,0 +1,566 @@
+#include "../test.h"
+
+#include <aerospike/as_atomic.h>
+#include <citrusleaf/cf_clock.h>
+#include <citrusleaf/cf_queue.h>
+#include <pthread.h>
+#include <sched.h>
+
+/******************************************************************************
+ * STATIC FUNCTIONS
+ *****************************************************************************/
+
+#define MPMC_THREADS 4
+#define MPMC_ITEMS 100000
+
+typedef struct mpmc_arg_s {
+	cf_queue* q;
+	uint32_t start;
+	uint32_t count;
+	uint64_t sum;
+} mpmc_arg;
+
+static void*
+mpmc_producer(void* udata)
+{
+	mpmc_arg* arg = (mpmc_arg*)udata;
+
+	for (uint32_t i = 0; i < arg->count; i++) {
+		uint32_t v = arg->start + i;
+
+		// Bounded - retry while full.
+		while (cf_queue_push(arg->q, &v) != CF_QUEUE_OK) {
+			sched_yield();
+		}
+	}
+	return NULL;
+}
+
+static void*
+mpmc_consumer(void* udata)
+{
+	mpmc_arg* arg = (mpmc_arg*)udata;
+
+	for (uint32_t i = 0; i < arg->count; i++) {
+		uint32_t v;
+
+		if (cf_queue_pop(arg->q, &v, CF_QUEUE_FOREVER) == CF_QUEUE_OK) {
+			arg->sum += v;
+		}
+	}
+	return NULL;
+}
+
+static void*
+batch_producer(void* udata)
+{
+	mpmc_arg* arg = (mpmc_arg*)udata;
+	uint32_t vals[32];
+
+	for (uint32_t i = 0; i < arg->count; i += 32) {
+		uint32_t n = arg->count - i < 32 ? arg->count - i : 32;
+
+		for (uint32_t j = 0; j < n; j++) {
+			vals[j] = arg->start + i + j;
+		}
+
+		// Bounded - push the rest while full.
+		uint32_t pushed = 0;
+
+		while ((pushed += cf_queue_push_n(arg->q, &vals[pushed], n - pushed))
+				< n) {
+			sched_yield();
+		}
+	}
+	return NULL;
+}
+
+static void*
+batch_consumer(void* udata)
+{
+	mpmc_arg* arg = (mpmc_arg*)udata;
+	uint32_t vals[32];
+	uint32_t remaining = arg->count;
+
+	while (remaining != 0) {
+		uint32_t n = cf_queue_pop_n(arg->q, vals,
+				remaining < 32 ? remaining : 32, CF_QUEUE_FOREVER);
+
+		for (uint32_t j = 0; j < n; j++) {
+			arg->sum += vals[j];
+		}
+		remaining -= n;
+	}
+	return NULL;
+}
+
+static uint64_t
+batch_run(cf_queue* q)
+{
+	pthread_t producers[MPMC_THREADS];
+	pthread_t consumers[MPMC_THREADS];
+	mpmc_arg pargs[MPMC_THREADS];
+	mpmc_arg cargs[MPMC_THREADS];
+	uint32_t per_thread = MPMC_ITEMS / MPMC_THREADS;
+
+	for (uint32_t i = 0; i < MPMC_THREADS; i++) {
+		cargs[i] = (mpmc_arg){ .q = q, .count = per_thread };
+		pthread_create(&consumers[i], NULL, batch_consumer, &cargs[i]);
+	}
+
+	for (uint32_t i = 0; i < MPMC_THREADS; i++) {
+		pargs[i] = (mpmc_arg){ .q = q, .start = i * per_thread,
+				.count = per_thread };
+		pthread_create(&producers[i], NULL, batch_producer, &pargs[i]);
+	}
+
+	uint64_t sum = 0;
+
+	for (uint32_t i = 0; i < MPMC_THREADS; i++) {
+		pthread_join(producers[i], NULL);
+		pthread_join(consumers[i], NULL);
+		sum += cargs[i].sum;
+	}
+
+	return sum;
+}
+
+typedef struct pong_arg_s {
+	cf_queue* ping;
+	cf_queue* pong;
+	uint32_t rounds;
+} pong_arg;
+
+static void*
+pong_worker(void* udata)
+{
+	pong_arg* arg = (pong_arg*)udata;
+
+	for (uint32_t i = 0; i < arg->rounds; i++) {
+		uint32_t v;
+
+		cf_queue_pop(arg->ping, &v, CF_QUEUE_FOREVER);
+		cf_queue_push(arg->pong, &v);
+	}
+	return NULL;
+}
+
+// Returns the mean round trip in ns.
+static uint64_t
+pong_run(uint32_t spin, uint32_t rounds, uint64_t* sum)
+{
+	cf_queue* ping = cf_queue_create(sizeof(uint32_t), true);
+	cf_queue* pong = cf_queue_create(sizeof(uint32_t), true);
+
+	cf_queue_set_spin(ping, spin);
+	cf_queue_set_spin(pong, spin);
+
+	pong_arg arg = { .ping = ping, .pong = pong, .rounds = rounds };
+	pthread_t thread;
+
+	pthread_create(&thread, NULL, pong_worker, &arg);
+
+	uint64_t start = cf_getns();
+
+	for (uint32_t i = 0; i < rounds; i++) {
+		uint32_t v;
+
+		cf_queue_push(ping, &i);
+
+		if (cf_queue_pop(pong, &v, 1000) == CF_QUEUE_OK) {
+			*sum += v;
+		}
+	}
+
+	uint64_t ns = cf_getns() - start;
+
+	pthread_join(thread, NULL);
+	cf_queue_destroy(ping);
+	cf_queue_destroy(pong);
+
+	return ns / rounds;
+}
+
+typedef struct nudge_arg_s {
+	cf_queue* q;
+	uint32_t stop;
+} nudge_arg;
+
+static void*
+nudge_worker(void* udata)
+{
+	nudge_arg* arg = (nudge_arg*)udata;
+
+	// Wake the waiting pop over and over, with nothing to pop.
+	while (as_load_uint32(&arg->stop) == 0) {
+		as_eventcount_notify(&arg->q->EC, 1);
+		sched_yield();
+	}
+	return NULL;
+}
+
+typedef struct bench_arg_s {
+	cf_queue* q;
+	uint32_t ops;
+} bench_arg;
+
+static void*
+bench_worker(void* udata)
+{
+	bench_arg* arg = (bench_arg*)udata;
+
+	// Each thread pushes before it pops, so a pop always finds an element
+	// eventually.
+	for (uint32_t i = 0; i < arg->ops; i++) {
+		cf_queue_push(arg->q, &i);
+
+		uint32_t v;
+		cf_queue_pop(arg->q, &v, CF_QUEUE_FOREVER);
+	}
+	return NULL;
+}
+
+static uint64_t
+bench_run(cf_queue* q, uint32_t n_threads, uint32_t total_ops)
+{
+	pthread_t threads[64];
+	bench_arg arg = { .q = q, .ops = total_ops / n_threads };
+	uint64_t start = cf_getns();
+
+	for (uint32_t i = 0; i < n_threads; i++) {
+		pthread_create(&threads[i], NULL, bench_worker, &arg);
+	}
+
+	for (uint32_t i = 0; i < n_threads; i++) {
+		pthread_join(threads[i], NULL);
+	}
+
+	uint64_t ns = cf_getns() - start;
+
+	// Push/pop pairs per second.
+	return ns == 0 ? 0 : (uint64_t)arg.ops * n_threads * 1000000000 / ns;
+}
+
+/******************************************************************************
+ * TEST CASES
+ *****************************************************************************/
+
+TEST(types_cf_queue_mpmc, "cf_queue lock-free mode") {
+	cf_queue* q = cf_queue_create_mpmc(sizeof(uint32_t), 5);
+	assert_not_null(q);
+
+	// Rounded up to a power of 2, and bounded.
+	assert_int_eq(q->alloc_sz, 8);
+
+	uint32_t v;
+	assert_int_eq(cf_queue_pop(q, &v, CF_QUEUE_NOWAIT), CF_QUEUE_EMPTY);
+	assert_int_eq(cf_queue_pop(q, &v, 10), CF_QUEUE_EMPTY);
+
+	// Wrap around the ring a few times.
+	for (uint32_t round = 0; round < 5; round++) {
+		for (uint32_t i = 0; i < 8; i++) {
+			v = round * 8 + i;
+			assert_int_eq(cf_queue_push(q, &v), CF_QUEUE_OK);
+		}
+
+		assert_int_eq(cf_queue_push(q, &v), CF_QUEUE_ERR);
+		assert_int_eq(cf_queue_sz(q), 8);
+
+		for (uint32_t i = 0; i < 8; i++) {
+			assert_int_eq(cf_queue_pop(q, &v, CF_QUEUE_NOWAIT), CF_QUEUE_OK);
+			assert_int_eq(v, round * 8 + i);
+		}
+
+		assert_int_eq(cf_queue_sz(q), 0);
+	}
+
+	v = 1;
+	assert_true(cf_queue_push_limit(q, &v, 2));
+	assert_true(cf_queue_push_limit(q, &v, 2));
+	assert_false(cf_queue_push_limit(q, &v, 2));
+
+	// Not supported in lock-free mode.
+	assert_int_eq(cf_queue_push_head(q, &v), CF_QUEUE_ERR);
+	assert_int_eq(cf_queue_peek(q, &v), CF_QUEUE_ERR);
+
+	assert_int_eq(cf_queue_delete_all(q), CF_QUEUE_OK);
+	assert_int_eq(cf_queue_sz(q), 0);
+
+	cf_queue_destroy(q);
+}
+
+TEST(types_cf_queue_mpmc_threads, "cf_queue lock-free mode with blocking pops") {
+	cf_queue q;
+	assert_true(cf_queue_init_mpmc(&q, sizeof(uint32_t), 256));
+
+	pthread_t producers[MPMC_THREADS];
+	pthread_t consumers[MPMC_THREADS];
+	mpmc_arg pargs[MPMC_THREADS];
+	mpmc_arg cargs[MPMC_THREADS];
+	uint32_t per_thread = MPMC_ITEMS / MPMC_THREADS;
+
+	// Start the consumers first, so they block.
+	for (uint32_t i = 0; i < MPMC_THREADS; i++) {
+		cargs[i] = (mpmc_arg){ .q = &q, .count = per_thread };
+		pthread_create(&consumers[i], NULL, mpmc_consumer, &cargs[i]);
+	}
+
+	for (uint32_t i = 0; i < MPMC_THREADS; i++) {
+		pargs[i] = (mpmc_arg){ .q = &q, .start = i * per_thread,
+				.count = per_thread };
+		pthread_create(&producers[i], NULL, mpmc_producer, &pargs[i]);
+	}
+
+	uint64_t sum = 0;
+
+	for (uint32_t i = 0; i < MPMC_THREADS; i++) {
+		pthread_join(producers[i], NULL);
+		pthread_join(consumers[i], NULL);
+		sum += cargs[i].sum;
+	}
+
+	uint64_t n = per_thread * MPMC_THREADS;
+
+	assert_int_eq(sum, n * (n - 1) / 2);
+	assert_int_eq(cf_queue_sz(&q), 0);
+
+	cf_queue_destroy(&q);
+}
+
+TEST(types_cf_queue_batch, "cf_queue batch push and pop") {
+	uint32_t in[40];
+	uint32_t out[40];
+
+	for (uint32_t i = 0; i < 40; i++) {
+		in[i] = i;
+	}
+
+	cf_queue mq;
+	cf_queue* q = &mq;
+	assert_true(cf_queue_init(q, sizeof(uint32_t), 16, true));
+
+	assert_int_eq(cf_queue_pop_n(q, out, 40, CF_QUEUE_NOWAIT), 0);
+	assert_int_eq(cf_queue_pop_n(q, out, 40, 10), 0);
+
+	// Offset the read position, so batches wrap and resize fragmented.
+	assert_int_eq(cf_queue_push_n(q, in, 10), 10);
+	assert_int_eq(cf_queue_pop_n(q, out, 7, CF_QUEUE_NOWAIT), 7);
+	assert_int_eq(out[6], 6);
+
+	assert_int_eq(cf_queue_push_n(q, &in[10], 30), 30);
+	assert_int_eq(cf_queue_sz(q), 33);
+	assert_int_eq(q->alloc_sz, 64);
+
+	assert_int_eq(cf_queue_pop_n(q, out, 40, CF_QUEUE_NOWAIT), 33);
+
+	for (uint32_t i = 0; i < 33; i++) {
+		assert_int_eq(out[i], i + 7);
+	}
+
+	assert_int_eq(cf_queue_sz(q), 0);
+	cf_queue_destroy(q);
+
+	q = cf_queue_create_mpmc(sizeof(uint32_t), 16);
+	assert_not_null(q);
+
+	assert_int_eq(cf_queue_pop_n(q, out, 40, CF_QUEUE_NOWAIT), 0);
+	assert_int_eq(cf_queue_push_n(q, in, 10), 10);
+	assert_int_eq(cf_queue_pop_n(q, out, 7, CF_QUEUE_NOWAIT), 7);
+
+	// Bounded - stops when full, wrapping around the ring.
+	assert_int_eq(cf_queue_push_n(q, &in[10], 30), 13);
+	assert_int_eq(cf_queue_sz(q), 16);
+
+	assert_int_eq(cf_queue_pop_n(q, out, 40, 10), 16);
+
+	for (uint32_t i = 0; i < 16; i++) {
+		assert_int_eq(out[i], i + 7);
+	}
+
+	assert_int_eq(cf_queue_sz(q), 0);
+	cf_queue_destroy(q);
+}
+
+TEST(types_cf_queue_batch_threads, "cf_queue batch push and pop, threaded") {
+	uint64_t n = (MPMC_ITEMS / MPMC_THREADS) * MPMC_THREADS;
+
+	cf_queue* q = cf_queue_create(sizeof(uint32_t), true);
+	assert_int_eq(batch_run(q), n * (n - 1) / 2);
+	assert_int_eq(cf_queue_sz(q), 0);
+	cf_queue_destroy(q);
+
+	q = cf_queue_create_mpmc(sizeof(uint32_t), 64);
+	assert_int_eq(batch_run(q), n * (n - 1) / 2);
+	assert_int_eq(cf_queue_sz(q), 0);
+	cf_queue_destroy(q);
+}
+
+TEST(types_cf_queue_handoff, "cf_queue request-response handoff, park vs spin") {
+	uint64_t expect = 20000ULL * 19999 / 2;
+	uint64_t sum = 0;
+	uint64_t park = pong_run(0, 20000, &sum);
+	assert_int_eq(sum, expect);
+
+	sum = 0;
+	uint64_t spin = pong_run(AS_EVENTCOUNT_SPIN, 20000, &sum);
+	assert_int_eq(sum, expect);
+
+	info("round trip: park %lu ns, spin %lu ns", (unsigned long)park,
+			(unsigned long)spin);
+
+	// A timed pop still times out, and a non-thread-safe queue ignores spin.
+	cf_queue* q = cf_queue_create(sizeof(uint32_t), true);
+	uint32_t v;
+	uint64_t start = cf_getms();
+
+	assert_int_eq(cf_queue_pop(q, &v, 50), CF_QUEUE_EMPTY);
+	assert_true(cf_getms() - start >= 49);
+	cf_queue_destroy(q);
+
+	q = cf_queue_create(sizeof(uint32_t), false);
+	cf_queue_set_spin(q, 1000);
+	assert_int_eq(cf_queue_pop(q, &v, CF_QUEUE_FOREVER), CF_QUEUE_EMPTY);
+	cf_queue_destroy(q);
+}
+
+TEST(types_cf_queue_deadline, "cf_queue timed pops keep their deadline") {
+	cf_queue* queues[2] = {
+		cf_queue_create(sizeof(uint32_t), true),
+		cf_queue_create_mpmc(sizeof(uint32_t), 16)
+	};
+
+	for (uint32_t i = 0; i < 2; i++) {
+		nudge_arg arg = { .q = queues[i], .stop = 0 };
+		pthread_t thread;
+
+		pthread_create(&thread, NULL, nudge_worker, &arg);
+
+		// Spurious wakeups don't restart the wait, or end it early.
+		uint32_t v;
+		uint64_t start = cf_getms();
+
+		assert_int_eq(cf_queue_pop(queues[i], &v, 100), CF_QUEUE_EMPTY);
+
+		uint64_t ms = cf_getms() - start;
+
+		as_store_uint32(&arg.stop, 1);
+		pthread_join(thread, NULL);
+
+		assert_true(ms >= 99);
+		assert_true(ms < 1000);
+
+		cf_queue_destroy(queues[i]);
+	}
+}
+
+TEST(types_cf_queue_stats, "cf_queue counters") {
+	cf_queue* q = cf_queue_create(sizeof(uint32_t), true);
+	as_queue_stats stats;
+
+	assert_false(cf_queue_get_stats(q, &stats));
+	assert_true(cf_queue_enable_stats(q));
+
+	for (uint32_t i = 0; i < 10; i++) {
+		assert_int_eq(cf_queue_push(q, &i), CF_QUEUE_OK);
+	}
+
+	uint32_t v;
+
+	for (uint32_t i = 0; i < 10; i++) {
+		assert_int_eq(cf_queue_pop(q, &v, CF_QUEUE_NOWAIT), CF_QUEUE_OK);
+	}
+
+	assert_true(cf_queue_get_stats(q, &stats));
+	assert_int_eq(stats.lock_count, 20);
+	assert_int_eq(stats.lock_contended, 0);
+	assert_int_eq(stats.depth_max, 10);
+	assert_int_eq(stats.lock_wait.count, 0);
+
+	// Contended - every contended lock is timed.
+	pthread_t producers[MPMC_THREADS];
+	pthread_t consumers[MPMC_THREADS];
+	mpmc_arg pargs[MPMC_THREADS];
+	mpmc_arg cargs[MPMC_THREADS];
+	uint32_t per_thread = MPMC_ITEMS / MPMC_THREADS;
+
+	for (uint32_t i = 0; i < MPMC_THREADS; i++) {
+		cargs[i] = (mpmc_arg){ .q = q, .count = per_thread };
+		pargs[i] = (mpmc_arg){ .q = q, .start = i * per_thread,
+				.count = per_thread };
+		pthread_create(&consumers[i], NULL, mpmc_consumer, &cargs[i]);
+		pthread_create(&producers[i], NULL, mpmc_producer, &pargs[i]);
+	}
+
+	for (uint32_t i = 0; i < MPMC_THREADS; i++) {
+		pthread_join(producers[i], NULL);
+		pthread_join(consumers[i], NULL);
+	}
+
+	assert_true(cf_queue_get_stats(q, &stats));
+	assert_true(stats.lock_count >= 20 + 2 * MPMC_ITEMS);
+	assert_int_eq(stats.lock_wait.count, stats.lock_contended);
+	assert_true(stats.depth_max <= MPMC_ITEMS);
+	assert_true(as_histogram_percentile(&stats.lock_wait, 50) <=
+			as_histogram_percentile(&stats.lock_wait, 99));
+
+	info("%lu locks, %lu contended, p99 wait %lu ns, %lu wakeups, %lu parks",
+			(unsigned long)stats.lock_count, (unsigned long)stats.lock_contended,
+			(unsigned long)as_histogram_percentile(&stats.lock_wait, 99),
+			(unsigned long)stats.wakeups, (unsigned long)stats.parks);
+
+	cf_queue_destroy(q);
+
+	// Lock-free mode keeps only the depth and eventcount counters.
+	q = cf_queue_create_mpmc(sizeof(uint32_t), 16);
+	assert_true(cf_queue_enable_stats(q));
+
+	for (uint32_t i = 0; i < 5; i++) {
+		assert_int_eq(cf_queue_push(q, &i), CF_QUEUE_OK);
+	}
+
+	assert_int_eq(cf_queue_pop_n(q, &v, 1, CF_QUEUE_NOWAIT), 1);
+	assert_true(cf_queue_get_stats(q, &stats));
+	assert_int_eq(stats.depth_max, 5);
+	assert_int_eq(stats.lock_count, 0);
+
+	cf_queue_destroy(q);
+
+	// Unlocked queues have nothing to count.
+	q = cf_queue_create(sizeof(uint32_t), false);
+	assert_false(cf_queue_enable_stats(q));
+	cf_queue_destroy(q);
+}
+
+TEST(types_cf_queue_bench, "cf_queue contention, mutex vs lock-free") {
+	for (uint32_t n_threads = 1; n_threads <= 64; n_threads *= 2) {
+		cf_queue* mq = cf_queue_create(sizeof(uint32_t), true);
+		cf_queue* lq = cf_queue_create_mpmc(sizeof(uint32_t), 1024);
+
+		uint64_t m = bench_run(mq, n_threads, 200000);
+		uint64_t l = bench_run(lq, n_threads, 200000);
+
+		info("%2u threads: mutex %9lu ops/s, lock-free %9lu ops/s", n_threads,
+				(unsigned long)m, (unsigned long)l);
+
+		assert_int_eq(cf_queue_sz(mq), 0);
+		assert_int_eq(cf_queue_sz(lq), 0);
+
+		cf_queue_destroy(mq);
+		cf_queue_destroy(lq);
+	}
+}
+
+/******************************************************************************
+ * TEST SUITE
+ *****************************************************************************/
+
+SUITE(types_cf_queue, "cf_queue") {
+	suite_add(types_cf_queue_mpmc);
+	suite_add(types_cf_queue_mpmc_threads);
+	suite_add(types_cf_queue_batch);
+	suite_add(types_cf_queue_batch_threads);
+	suite_add(types_cf_queue_handoff);
+	suite_add(types_cf_queue_deadline);
+	suite_add(types_cf_queue_stats);
+	suite_add(types_cf_queue_bench);
+}
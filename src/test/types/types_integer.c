@@ -45,6 +45,30 @@ TEST( types_integer_long_min, "as_integer containing LONG_MIN" ) {
     assert( as_integer_toint(&i) == LONG_MIN );
 }
 
+TEST( types_integer_cached, "as_integer from the integer cache" ) {
+    for ( int64_t v = AS_INTEGER_CACHE_MIN - 2; v <= AS_INTEGER_CACHE_MAX + 2; v++ ) {
+        const as_integer * i = as_integer_new_cached(v);
+        assert_int_eq( as_integer_get(i), v );
+        assert_int_eq( as_val_type(i), AS_INTEGER );
+        as_val_destroy(i);
+    }
+
+    const as_integer * a = as_integer_new_cached(7);
+    const as_integer * b = as_integer_new_cached(7);
+    assert_true( a == b );
+
+    // Cached values are not ref-counted.
+    as_val_reserve(a);
+    as_val_destroy(a);
+    as_val_destroy(a);
+    assert_int_eq( a->_.count, 0 );
+    assert_int_eq( as_integer_get(b), 7 );
+
+    const as_integer * c = as_integer_new_cached(AS_INTEGER_CACHE_MAX + 1);
+    assert_int_eq( c->_.count, 1 );
+    as_val_destroy(c);
+}
+
 /******************************************************************************
  * TEST SUITE
  *****************************************************************************/
@@ -56,4 +80,5 @@ SUITE( types_integer, "as_integer" ) {
     suite_add( types_integer_ulong_max );
     suite_add( types_integer_long_max );
     suite_add( types_integer_long_min );
+    suite_add( types_integer_cached );
 }
\ No newline at end of file
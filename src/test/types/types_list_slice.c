@@ -0,0 +1,231 @@
+#include "../test.h"
+
+#include <aerospike/as_arraylist.h>
+#include <aerospike/as_integer.h>
+#include <aerospike/as_list.h>
+#include <aerospike/as_list_iterator.h>
+#include <aerospike/as_list_slice.h>
+#include <aerospike/as_msgpack.h>
+#include <aerospike/as_serializer.h>
+#include <aerospike/as_string.h>
+#include <pthread.h>
+
+/******************************************************************************
+ * STATIC FUNCTIONS
+ *****************************************************************************/
+
+// Reserves and releases each element of a slice, over and over.
+static void*
+slice_churn(void* udata)
+{
+	as_list* slice = (as_list*)udata;
+	uint32_t size = as_list_size(slice);
+
+	for (uint32_t round = 0; round < 20000; round++) {
+		for (uint32_t i = 0; i < size; i++) {
+			as_val* v = as_list_get(slice, i);
+
+			as_val_reserve(v);
+			as_val_destroy(v);
+		}
+	}
+	return NULL;
+}
+
+/******************************************************************************
+ * TEST CASES
+ *****************************************************************************/
+
+TEST(types_list_slice_pages, "as_list_slice pages through a list") {
+	as_arraylist* l = as_arraylist_new(10000, 0);
+
+	for (int64_t i = 0; i < 10000; i++) {
+		as_arraylist_append(l, (as_val*)as_integer_new(i));
+	}
+
+	as_val* first = as_arraylist_get(l, 0);
+	assert_int_eq(first->count, 1);
+
+	int64_t expect = 0;
+
+	for (uint32_t offset = 0; offset < 10000; offset += 300) {
+		as_list_slice* page = as_list_slice_new((as_list*)l, offset, 300);
+
+		assert_not_null(page);
+		assert_int_eq(as_list_size((as_list*)page),
+				offset + 300 <= 10000 ? 300 : 10000 - offset);
+
+		// Elements are not reserved, the parent is.
+		assert_int_eq(first->count, 1);
+		assert_int_eq(l->_._.count, 2);
+
+		as_list_iterator it;
+		as_list_iterator_init(&it, (as_list*)page);
+
+		while (as_iterator_has_next((as_iterator*)&it)) {
+			const as_integer* v =
+					(const as_integer*)as_iterator_next((as_iterator*)&it);
+			assert_int_eq(as_integer_get(v), expect);
+			expect++;
+		}
+
+		as_iterator_destroy((as_iterator*)&it);
+		as_list_slice_destroy(page);
+	}
+
+	assert_int_eq(expect, 10000);
+	assert_int_eq(l->_._.count, 1);
+
+	// Clipped and empty ranges.
+	as_list_slice s;
+	as_list_slice_init(&s, (as_list*)l, 20000, 10);
+	assert_int_eq(as_list_size((as_list*)&s), 0);
+	assert_null(as_list_get((as_list*)&s, 0));
+	as_list_slice_destroy(&s);
+
+	as_list_slice* tail = as_list_slice_tail((as_list*)l);
+	assert_int_eq(as_list_size((as_list*)tail), 9999);
+	assert_int_eq(as_list_get_int64((as_list*)tail, 0), 1);
+
+	// A slice of a slice views the parent directly.
+	as_list* take = as_list_take((as_list*)tail, 5);
+	assert_int_eq(as_list_size(take), 5);
+	assert_int_eq(as_list_get_int64(take, 4), 5);
+	assert_true(((as_list_slice*)take)->parent == (as_list*)l);
+
+	as_list_destroy(take);
+	as_list_slice_destroy(tail);
+
+	// The slice keeps the parent alive.
+	as_list_slice* drop = as_list_slice_drop((as_list*)l, 9990);
+	as_arraylist_destroy(l);
+	assert_int_eq(as_list_size((as_list*)drop), 10);
+	assert_int_eq(as_list_get_int64((as_list*)drop, 9), 9999);
+	as_list_slice_destroy(drop);
+}
+
+TEST(types_list_slice_write, "as_list_slice copies on write") {
+	as_arraylist* l = as_arraylist_new(10, 10);
+
+	for (int64_t i = 0; i < 10; i++) {
+		as_arraylist_append_int64(l, i);
+	}
+
+	as_list_slice* s = as_list_slice_new((as_list*)l, 2, 6);
+
+	// Narrowing doesn't copy.
+	assert_int_eq(as_list_remove((as_list*)s, 0), 0);
+	assert_int_eq(as_list_remove((as_list*)s, 4), 0);
+	assert_int_eq(as_list_trim((as_list*)s, 3), 0);
+	assert_null(s->copy);
+	assert_int_eq(as_list_size((as_list*)s), 3);
+	assert_int_eq(as_list_get_int64((as_list*)s, 0), 3);
+	assert_int_eq(as_list_get_int64((as_list*)s, 2), 5);
+
+	assert_int_eq(as_list_append_str((as_list*)s, "x"), 0);
+	assert_int_eq(as_list_set_int64((as_list*)s, 0, 100), 0);
+	assert_not_null(s->copy);
+	assert_null(s->parent);
+	assert_int_eq(l->_._.count, 1);
+
+	assert_int_eq(as_list_size((as_list*)s), 4);
+	assert_int_eq(as_list_get_int64((as_list*)s, 0), 100);
+	assert_int_eq(as_list_get_int64((as_list*)s, 1), 4);
+	assert_string_eq(as_list_get_str((as_list*)s, 3), "x");
+
+	// The parent is unchanged.
+	assert_int_eq(as_arraylist_get_int64(l, 3), 3);
+	assert_int_eq(as_arraylist_size(l), 10);
+
+	// Slices of a modified slice view its copy.
+	as_list_slice* s2 = as_list_slice_new((as_list*)s, 1, 2);
+	assert_int_eq(as_list_get_int64((as_list*)s2, 0), 4);
+	as_list_slice_destroy(s);
+	assert_int_eq(as_list_get_int64((as_list*)s2, 1), 5);
+	as_list_slice_destroy(s2);
+
+	as_arraylist_destroy(l);
+}
+
+TEST(types_list_slice_threads, "as_list_slice of a confined list is shared") {
+	as_arraylist* l = as_arraylist_new(8, 0);
+
+	as_val_confine((as_val*)l);
+
+	for (uint32_t i = 0; i < 8; i++) {
+		as_val* v = as_val_confine((as_val*)as_string_new_strdup("element"));
+
+		as_arraylist_append(l, v);
+	}
+
+	as_list_slice* s = as_list_slice_new((as_list*)l, 2, 4);
+
+	// Slicing shares the parent and its elements.
+	assert_false(l->_._.local);
+
+	for (uint32_t i = 0; i < 8; i++) {
+		assert_false(as_arraylist_get(l, i)->local);
+	}
+
+	pthread_t threads[2];
+
+	for (uint32_t i = 0; i < 2; i++) {
+		pthread_create(&threads[i], NULL, slice_churn, s);
+	}
+
+	for (uint32_t i = 0; i < 2; i++) {
+		pthread_join(threads[i], NULL);
+	}
+
+	for (uint32_t i = 0; i < 8; i++) {
+		assert_int_eq(as_arraylist_get(l, i)->count, 1);
+	}
+
+	as_list_slice_destroy(s);
+	as_arraylist_destroy(l);
+}
+
+TEST(types_list_slice_msgpack, "as_list_slice msgpack") {
+	as_arraylist l;
+	as_arraylist_init(&l, 5, 0);
+
+	for (int64_t i = 0; i < 5; i++) {
+		as_arraylist_append_int64(&l, i);
+	}
+
+	as_list_slice s;
+	as_list_slice_init(&s, (as_list*)&l, 1, 3);
+
+	as_serializer ser;
+	as_msgpack_init(&ser);
+
+	as_buffer b;
+	as_buffer_init(&b);
+
+	as_serializer_serialize(&ser, (as_val*)&s, &b);
+
+	as_val* v = NULL;
+	as_serializer_deserialize(&ser, &b, &v);
+
+	assert_not_null(v);
+	assert_int_eq(as_val_type(v), AS_LIST);
+	assert_int_eq(as_list_size((as_list*)v), 3);
+	assert_int_eq(as_val_cmp(v, (as_val*)&s), MSGPACK_COMPARE_EQUAL);
+
+	as_val_destroy(v);
+	as_buffer_destroy(&b);
+	as_serializer_destroy(&ser);
+	as_list_slice_destroy(&s);
+	as_arraylist_destroy(&l);
+}
+
+/******************************************************************************
+ * TEST SUITE
+ *****************************************************************************/
+
+SUITE(types_list_slice, "as_list_slice") {
+	suite_add(types_list_slice_pages);
+	suite_add(types_list_slice_write);
+	suite_add(types_list_slice_msgpack);
+	suite_add(types_list_slice_threads);
+}
@@ -3,6 +3,7 @@
 #include <aerospike/as_orderedmap.h>
 #include <aerospike/as_integer.h>
 #include <aerospike/as_map.h>
+#include <aerospike/as_map_iterator.h>
 #include <aerospike/as_pair.h>
 #include <aerospike/as_string.h>
 #include <aerospike/as_stringmap.h>
@@ -461,19 +462,184 @@ TEST(types_orderedmap_huge_random, "as_orderedmap insert huge random") {
 	info("total time in ms = %lu", cf_getms() - start_ms);
 }
 
+TEST(types_orderedmap_index, "as_orderedmap index and key range") {
+	as_orderedmap* m = as_orderedmap_new(10);
+
+	// Keys 0, 10, ..., 990 inserted out of order.
+	for (uint32_t i = 0; i < 100; i++) {
+		uint32_t k = (i * 37) % 100;
+
+		as_orderedmap_set(m, (as_val*)as_integer_new(k * 10),
+				(as_val*)as_integer_new(k));
+	}
+
+	as_val* key = NULL;
+	as_val* val = as_orderedmap_get_by_index(m, 42, &key);
+
+	assert_int_eq(as_integer_get((as_integer*)key), 420);
+	assert_int_eq(as_integer_get((as_integer*)val), 42);
+	assert_null(as_orderedmap_get_by_index(m, 100, NULL));
+
+	as_integer lo;
+	as_integer hi;
+	uint32_t index;
+	uint32_t count;
+
+	as_integer_init(&lo, 205);
+	as_integer_init(&hi, 300);
+	assert_int_eq(as_orderedmap_range_by_key(m, (as_val*)&lo, (as_val*)&hi,
+			&index, &count), 0);
+	assert_int_eq(index, 21);
+	assert_int_eq(count, 9);
+
+	assert_int_eq(as_orderedmap_range_by_key(m, NULL, (as_val*)&hi,
+			&index, &count), 0);
+	assert_int_eq(index, 0);
+	assert_int_eq(count, 30);
+
+	assert_int_eq(as_orderedmap_range_by_key(m, (as_val*)&hi, NULL,
+			&index, &count), 0);
+	assert_int_eq(index, 30);
+	assert_int_eq(count, 70);
+
+	as_orderedmap_iterator it;
+	as_orderedmap_iterator_init_from(&it, m, (as_val*)&lo);
+
+	int64_t expect = 210;
+
+	while (as_orderedmap_iterator_has_next(&it)) {
+		as_pair* p = (as_pair*)as_orderedmap_iterator_next(&it);
+		assert_int_eq(as_integer_get((as_integer*)as_pair_1(p)), expect);
+		expect += 10;
+	}
+
+	assert_int_eq(expect, 1000);
+
+	as_orderedmap_iterator_destroy(&it);
+	as_orderedmap_destroy(m);
+}
+
+TEST(types_orderedmap_rank, "as_orderedmap rank and value range") {
+	as_orderedmap* m = as_orderedmap_new(10);
+
+	as_orderedmap_set_flags(m, AS_PACKED_MAP_FLAG_KV_ORDERED);
+
+	// Values descend as keys ascend, with a duplicate value.
+	as_stringmap_set_int64((as_map*)m, "a", 50);
+	as_stringmap_set_int64((as_map*)m, "b", 40);
+	as_stringmap_set_int64((as_map*)m, "c", 30);
+	as_stringmap_set_int64((as_map*)m, "d", 30);
+	as_stringmap_set_int64((as_map*)m, "e", 10);
+
+	size_t before = as_val_memory_size((as_val*)m);
+
+	as_val* key = NULL;
+	as_val* val = as_orderedmap_get_by_rank(m, 0, &key);
+
+	assert_string_eq(as_string_get((as_string*)key), "e");
+	assert_int_eq(as_integer_get((as_integer*)val), 10);
+	assert_not_null(m->value_order);
+
+	// The cached value index is one uint32_t per entry.
+	assert_int_eq(as_val_memory_size((as_val*)m) - before,
+			5 * sizeof(uint32_t));
+
+	// Equal values are ranked by key.
+	as_orderedmap_get_by_rank(m, 1, &key);
+	assert_string_eq(as_string_get((as_string*)key), "c");
+	as_orderedmap_get_by_rank(m, 2, &key);
+	assert_string_eq(as_string_get((as_string*)key), "d");
+
+	as_integer lo;
+	as_integer hi;
+	uint32_t rank;
+	uint32_t count;
+
+	as_integer_init(&lo, 30);
+	as_integer_init(&hi, 50);
+	assert_int_eq(as_orderedmap_range_by_value(m, (as_val*)&lo, (as_val*)&hi,
+			&rank, &count), 0);
+	assert_int_eq(rank, 1);
+	assert_int_eq(count, 3);
+
+	// Modification drops the value index.
+	as_stringmap_set_int64((as_map*)m, "f", 0);
+	assert_null(m->value_order);
+
+	val = as_orderedmap_get_by_rank(m, 0, &key);
+	assert_string_eq(as_string_get((as_string*)key), "f");
+	val = as_orderedmap_get_by_rank(m, 5, &key);
+	assert_string_eq(as_string_get((as_string*)key), "a");
+	assert_null(as_orderedmap_get_by_rank(m, 6, NULL));
+
+	// Without the value ordered flag, no index is kept.
+	as_orderedmap_set_flags(m, 0);
+	as_orderedmap_remove(m, key);
+	val = as_orderedmap_get_by_rank(m, 4, &key);
+	assert_string_eq(as_string_get((as_string*)key), "b");
+	assert_null(m->value_order);
+
+	as_orderedmap_destroy(m);
+}
+
 
 /******************************************************************************
  * TEST SUITE
  *****************************************************************************/
 
+TEST(types_orderedmap_iterator_next_n, "as_orderedmap batched iteration") {
+	as_orderedmap* m = as_orderedmap_new(100);
+
+	for (int64_t i = 99; i >= 0; i--) {
+		as_orderedmap_set(m, (as_val*)as_integer_new(i),
+				(as_val*)as_integer_new(i * 10));
+	}
+
+	as_map_iterator it;
+	as_map_iterator_init(&it, (as_map*)m);
+
+	const as_val* keys[32];
+	const as_val* vals[32];
+	uint32_t n;
+	int64_t expect = 0;
+
+	while ((n = as_map_iterator_next_n((as_iterator*)&it, keys, vals, 32)) != 0) {
+		assert_true(n == 32 || expect + n == 100);
+
+		for (uint32_t i = 0; i < n; i++) {
+			assert_int_eq(as_integer_get((const as_integer*)keys[i]), expect);
+			assert_int_eq(as_integer_get((const as_integer*)vals[i]), expect * 10);
+			expect++;
+		}
+	}
+
+	assert_int_eq(expect, 100);
+	assert_false(as_iterator_has_next((as_iterator*)&it));
+	as_iterator_destroy((as_iterator*)&it);
+
+	// Mixing single and batched reads.
+	as_map_iterator_init(&it, (as_map*)m);
+	as_iterator_next((as_iterator*)&it);
+	assert_int_eq(as_map_iterator_next_n((as_iterator*)&it, keys, vals, 2), 2);
+	assert_int_eq(as_integer_get((const as_integer*)keys[0]), 1);
+	const as_pair* p = (const as_pair*)as_iterator_next((as_iterator*)&it);
+	assert_int_eq(as_integer_get((const as_integer*)as_pair_1((as_pair*)p)), 3);
+	as_iterator_destroy((as_iterator*)&it);
+
+	as_orderedmap_destroy(m);
+}
+
 SUITE(types_orderedmap, "as_orderedmap") {
 	suite_add(types_orderedmap_empty);
 	suite_add(types_orderedmap_ops);
 	suite_add(types_orderedmap_types);
 	suite_add(types_orderedmap_map_ops);
 	suite_add(types_orderedmap_iterator);
+	suite_add(types_orderedmap_iterator_next_n);
 	suite_add(types_orderedmap_foreach);
 	suite_add(types_orderedmap_msgpack);
+	suite_add(types_orderedmap_index);
+	suite_add(types_orderedmap_rank);
 	suite_add(types_orderedmap_huge_ordered);
 	suite_add(types_orderedmap_huge_random);
 }
@@ -0,0 +1,155 @@
+#include "../test.h"
+
+#include <aerospike/as_arraylist.h>
+#include <aerospike/as_atomic.h>
+#include <aerospike/as_integer.h>
+#include <aerospike/as_orderedmap.h>
+#include <aerospike/as_parallel.h>
+#include <aerospike/as_thread_pool.h>
+
+/******************************************************************************
+ * STATIC FUNCTIONS
+ *****************************************************************************/
+
+static bool
+list_add(as_val* v, void* acc, void* udata)
+{
+	*(int64_t*)acc += as_integer_get((as_integer*)v);
+	return true;
+}
+
+static bool
+map_add(const as_val* k, const as_val* v, void* acc, void* udata)
+{
+	*(int64_t*)acc += as_integer_get((as_integer*)k) * as_integer_get((as_integer*)v);
+	return true;
+}
+
+static void
+merge_add(void* acc, const void* other, void* udata)
+{
+	*(int64_t*)acc += *(const int64_t*)other;
+}
+
+static as_val*
+list_square(as_val* v, void* udata)
+{
+	int64_t i = as_integer_get((as_integer*)v);
+
+	return (as_val*)as_integer_new(i * i);
+}
+
+static bool
+list_count(as_val* v, void* udata)
+{
+	as_incr_uint32((uint32_t*)udata);
+	return true;
+}
+
+static bool
+list_stop(as_val* v, void* udata)
+{
+	as_incr_uint32((uint32_t*)udata);
+	return as_integer_get((as_integer*)v) != 500;
+}
+
+/******************************************************************************
+ * TEST CASES
+ *****************************************************************************/
+
+TEST(types_parallel_list, "parallel foreach, map and reduce over a list") {
+	as_thread_pool pool;
+	assert_int_eq(as_thread_pool_init(&pool, 3), 0);
+
+	as_arraylist l;
+	as_arraylist_init(&l, 200000, 0);
+
+	for (int64_t i = 1; i <= 200000; i++) {
+		as_arraylist_append_int64(&l, i);
+	}
+
+	int64_t sum = 0;
+	assert_true(as_list_parallel_reduce((as_list*)&l, &pool, list_add,
+			merge_add, &sum, sizeof(sum), NULL));
+	assert_int_eq(sum, 200000LL * 200001 / 2);
+
+	// Without a pool, runs on the caller.
+	sum = 0;
+	assert_true(as_list_parallel_reduce((as_list*)&l, NULL, list_add,
+			merge_add, &sum, sizeof(sum), NULL));
+	assert_int_eq(sum, 200000LL * 200001 / 2);
+
+	as_arraylist* squares = as_list_parallel_map((as_list*)&l, &pool,
+			list_square, NULL);
+	assert_not_null(squares);
+	assert_int_eq(as_arraylist_size(squares), 200000);
+
+	for (uint32_t i = 0; i < 200000; i++) {
+		assert_int_eq(as_arraylist_get_int64(squares, i), (int64_t)(i + 1) * (i + 1));
+	}
+
+	as_arraylist_destroy(squares);
+
+	uint32_t count = 0;
+	assert_true(as_list_parallel_foreach((as_list*)&l, &pool, list_count,
+			&count));
+	assert_int_eq(count, 200000);
+
+	// Stop early - the chunk holding 500 stops, the others soon follow.
+	count = 0;
+	assert_false(as_list_parallel_foreach((as_list*)&l, &pool, list_stop,
+			&count));
+	assert_true(count < 200000);
+
+	as_arraylist_destroy(&l);
+	as_thread_pool_destroy(&pool);
+}
+
+TEST(types_parallel_map, "parallel reduce over a map") {
+	as_thread_pool pool;
+	assert_int_eq(as_thread_pool_init(&pool, 3), 0);
+
+	as_orderedmap m;
+	as_orderedmap_init(&m, 50000);
+
+	int64_t expect = 0;
+	uint32_t x = 1;
+
+	for (int64_t i = 0; i < 50000; i++) {
+		// Out of order keys, so some are held for a later merge.
+		x = x * 1103515245 + 12345;
+		int64_t k = (int64_t)(x >> 1);
+
+		as_orderedmap_set(&m, (as_val*)as_integer_new(k),
+				(as_val*)as_integer_new(i % 7));
+	}
+
+	as_orderedmap_iterator it;
+	as_orderedmap_iterator_init(&it, &m);
+
+	while (as_orderedmap_iterator_has_next(&it)) {
+		const as_pair* p = (const as_pair*)as_orderedmap_iterator_next(&it);
+
+		expect += as_integer_get((as_integer*)p->_1) *
+				as_integer_get((as_integer*)p->_2);
+	}
+
+	as_orderedmap_iterator_destroy(&it);
+
+	int64_t sum = 0;
+	assert_true(as_map_parallel_reduce((as_map*)&m, &pool, map_add,
+			merge_add, &sum, sizeof(sum), NULL));
+	assert_int_eq(sum, expect);
+
+	as_orderedmap_destroy(&m);
+	as_thread_pool_destroy(&pool);
+}
+
+/******************************************************************************
+ * TEST SUITE
+ *****************************************************************************/
+
+SUITE(types_parallel, "parallel foreach, map and reduce") {
+	suite_add(types_parallel_list);
+	suite_add(types_parallel_map);
+}
@@ -0,0 +1,171 @@
+#include "../test.h"
+
+#include <aerospike/as_arraylist.h>
+#include <aerospike/as_integer.h>
+#include <aerospike/as_list.h>
+#include <aerospike/as_list_iterator.h>
+#include <aerospike/as_msgpack.h>
+#include <aerospike/as_persistent_list.h>
+#include <aerospike/as_serializer.h>
+#include <aerospike/as_string.h>
+
+/******************************************************************************
+ * TEST CASES
+ *****************************************************************************/
+
+TEST(types_persistent_list_empty, "as_persistent_list is empty") {
+	as_persistent_list* l = as_persistent_list_new();
+	assert_int_eq(as_list_size((as_list*)l), 0);
+	assert_null(as_persistent_list_get(l, 0));
+	as_persistent_list_destroy(l);
+}
+
+TEST(types_persistent_list_ops, "as_persistent_list ops") {
+	as_persistent_list l;
+	as_persistent_list_init(&l);
+
+	// Enough elements for a three level trie.
+	for (int64_t i = 0; i < 2000; i++) {
+		assert_int_eq(as_persistent_list_append_int64(&l, i), 0);
+	}
+
+	assert_int_eq(as_persistent_list_size(&l), 2000);
+	assert_int_eq(as_list_get_int64((as_list*)&l, 0), 0);
+	assert_int_eq(as_list_get_int64((as_list*)&l, 1025), 1025);
+	assert_int_eq(as_list_get_int64((as_list*)&l, 1999), 1999);
+
+	as_persistent_list_set_int64(&l, 1025, -1);
+	assert_int_eq(as_list_get_int64((as_list*)&l, 1025), -1);
+
+	as_list_insert_str((as_list*)&l, 1, "x");
+	assert_int_eq(as_persistent_list_size(&l), 2001);
+	assert_string_eq(as_list_get_str((as_list*)&l, 1), "x");
+	assert_int_eq(as_list_get_int64((as_list*)&l, 2), 1);
+	assert_int_eq(as_list_get_int64((as_list*)&l, 2000), 1999);
+
+	as_persistent_list_remove(&l, 1);
+	as_persistent_list_remove(&l, 1999);
+	assert_int_eq(as_persistent_list_size(&l), 1999);
+	assert_int_eq(as_list_get_int64((as_list*)&l, 1), 1);
+	assert_int_eq(as_list_get_int64((as_list*)&l, 1998), 1998);
+
+	as_persistent_list_trim(&l, 40);
+	assert_int_eq(as_persistent_list_size(&l), 40);
+	assert_null(as_persistent_list_get(&l, 40));
+
+	// Setting past the end pads with nil.
+	as_persistent_list_set_int64(&l, 42, 42);
+	assert_int_eq(as_persistent_list_size(&l), 43);
+	assert_int_eq(as_val_type(as_persistent_list_get(&l, 41)), AS_NIL);
+
+	as_list_destroy((as_list*)&l);
+}
+
+TEST(types_persistent_list_copy, "as_persistent_list copies share storage") {
+	as_persistent_list* l1 = as_persistent_list_new();
+
+	for (int64_t i = 0; i < 100; i++) {
+		as_persistent_list_append_int64(l1, i);
+	}
+
+	as_persistent_list* l2 = as_persistent_list_copy(l1);
+	assert_true(l1->root == l2->root);
+
+	as_persistent_list_set_int64(l2, 50, 500);
+	as_persistent_list_append_int64(l2, 100);
+	as_persistent_list_remove(l1, 0);
+
+	assert_int_eq(as_persistent_list_size(l1), 99);
+	assert_int_eq(as_persistent_list_size(l2), 101);
+	assert_int_eq(as_list_get_int64((as_list*)l1, 49), 50);
+	assert_int_eq(as_list_get_int64((as_list*)l2, 50), 500);
+	assert_int_eq(as_list_get_int64((as_list*)l2, 100), 100);
+
+	// Untouched leaves are still shared.
+	as_persistent_list* l3 = as_persistent_list_copy(l2);
+	as_persistent_list_set_int64(l3, 0, -1);
+	assert_true(l2->root != l3->root);
+	assert_true(l2->root->slots[1] == l3->root->slots[1]);
+
+	as_list* t = as_list_take((as_list*)l2, 101);
+	assert_int_eq(as_list_size(t), 101);
+	as_list_destroy(t);
+
+	as_list* d = as_list_drop((as_list*)l2, 90);
+	assert_int_eq(as_list_size(d), 11);
+	assert_int_eq(as_list_get_int64(d, 0), 90);
+	as_list_destroy(d);
+
+	as_persistent_list_destroy(l1);
+	as_persistent_list_destroy(l2);
+	as_persistent_list_destroy(l3);
+}
+
+TEST(types_persistent_list_iterator, "as_persistent_list iterator") {
+	as_persistent_list* l = as_persistent_list_new();
+
+	for (int64_t i = 0; i < 100; i++) {
+		as_persistent_list_append_int64(l, i);
+	}
+
+	as_list_iterator it;
+	as_list_iterator_init(&it, (as_list*)l);
+
+	int64_t n = 0;
+
+	while (as_iterator_has_next((as_iterator*)&it)) {
+		const as_val* v = as_iterator_next((as_iterator*)&it);
+		assert_int_eq(as_integer_get((as_integer*)v), n);
+		n++;
+	}
+
+	as_iterator_destroy((as_iterator*)&it);
+	assert_int_eq(n, 100);
+
+	as_persistent_list_destroy(l);
+}
+
+TEST(types_persistent_list_msgpack, "as_persistent_list msgpack and compare") {
+	as_persistent_list* pl = as_persistent_list_new();
+	as_arraylist* al = as_arraylist_new(10, 10);
+
+	for (int64_t i = 0; i < 40; i++) {
+		as_persistent_list_append_int64(pl, i);
+		as_arraylist_append_int64(al, i);
+	}
+
+	assert_int_eq(as_val_cmp((as_val*)pl, (as_val*)al), MSGPACK_COMPARE_EQUAL);
+
+	as_serializer ser;
+	as_msgpack_init(&ser);
+
+	as_buffer b1;
+	as_buffer b2;
+	as_serializer_serialize(&ser, (as_val*)pl, &b1);
+	as_serializer_serialize(&ser, (as_val*)al, &b2);
+
+	assert_int_eq(b1.size, b2.size);
+	assert_true(memcmp(b1.data, b2.data, b1.size) == 0);
+
+	as_buffer_destroy(&b1);
+	as_buffer_destroy(&b2);
+	as_serializer_destroy(&ser);
+
+	as_persistent_list_set_int64(pl, 39, 100);
+	assert_int_eq(as_val_cmp((as_val*)pl, (as_val*)al), MSGPACK_COMPARE_GREATER);
+
+	as_persistent_list_destroy(pl);
+	as_arraylist_destroy(al);
+}
+
+/******************************************************************************
+ * TEST SUITE
+ *****************************************************************************/
+
+SUITE(types_persistent_list, "as_persistent_list") {
+	suite_add(types_persistent_list_empty);
+	suite_add(types_persistent_list_ops);
+	suite_add(types_persistent_list_copy);
+	suite_add(types_persistent_list_iterator);
+	suite_add(types_persistent_list_msgpack);
+}
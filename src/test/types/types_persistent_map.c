@@ -0,0 +1,169 @@
+#include "../test.h"
+
+#include <aerospike/as_integer.h>
+#include <aerospike/as_map.h>
+#include <aerospike/as_map_iterator.h>
+#include <aerospike/as_msgpack.h>
+#include <aerospike/as_orderedmap.h>
+#include <aerospike/as_pair.h>
+#include <aerospike/as_persistent_map.h>
+#include <aerospike/as_serializer.h>
+#include <aerospike/as_string.h>
+#include <aerospike/as_stringmap.h>
+
+/******************************************************************************
+ * TEST CASES
+ *****************************************************************************/
+
+TEST(types_persistent_map_empty, "as_persistent_map is empty") {
+	as_persistent_map* m = as_persistent_map_new();
+	assert_int_eq(as_map_size((as_map*)m), 0);
+	as_map_destroy((as_map*)m);
+}
+
+TEST(types_persistent_map_ops, "as_persistent_map ops") {
+	as_persistent_map m;
+	as_persistent_map_init(&m);
+
+	for (int64_t i = 0; i < 1000; i++) {
+		int64_t k = (i * 7919) % 1000;
+		as_persistent_map_set(&m, (as_val*)as_integer_new(k),
+				(as_val*)as_integer_new(k * 10));
+	}
+
+	assert_int_eq(as_persistent_map_size(&m), 1000);
+
+	as_integer k;
+	as_integer_init(&k, 123);
+
+	as_integer* v = (as_integer*)as_persistent_map_get(&m, (as_val*)&k);
+	assert_int_eq(as_integer_get(v), 1230);
+
+	// Replace.
+	as_persistent_map_set(&m, (as_val*)as_integer_new(123),
+			(as_val*)as_integer_new(-1));
+	assert_int_eq(as_persistent_map_size(&m), 1000);
+	v = (as_integer*)as_persistent_map_get(&m, (as_val*)&k);
+	assert_int_eq(as_integer_get(v), -1);
+
+	// Remove.
+	assert_int_eq(as_persistent_map_remove(&m, (as_val*)&k), 0);
+	assert_int_eq(as_persistent_map_remove(&m, (as_val*)&k), -1);
+	assert_int_eq(as_persistent_map_size(&m), 999);
+	assert_null(as_persistent_map_get(&m, (as_val*)&k));
+
+	// Key order.
+	as_val* key;
+	as_persistent_map_get_by_index(&m, 123, &key);
+	assert_int_eq(as_integer_get((as_integer*)key), 124);
+	assert_null(as_persistent_map_get_by_index(&m, 999, NULL));
+
+	as_map_clear((as_map*)&m);
+	assert_int_eq(as_persistent_map_size(&m), 0);
+
+	as_map_destroy((as_map*)&m);
+}
+
+TEST(types_persistent_map_copy, "as_persistent_map copies share storage") {
+	as_persistent_map* m1 = as_persistent_map_new();
+
+	as_stringmap_set_int64((as_map*)m1, "a", 1);
+	as_stringmap_set_int64((as_map*)m1, "b", 2);
+	as_stringmap_set_int64((as_map*)m1, "c", 3);
+
+	as_persistent_map* m2 = as_persistent_map_copy(m1);
+	assert_true(m1->root == m2->root);
+
+	as_stringmap_set_int64((as_map*)m2, "b", 20);
+	as_stringmap_set_int64((as_map*)m2, "d", 4);
+
+	as_string k;
+	as_string_init(&k, "a", false);
+	as_persistent_map_remove(m1, (as_val*)&k);
+
+	assert_int_eq(as_persistent_map_size(m1), 2);
+	assert_int_eq(as_persistent_map_size(m2), 4);
+	assert_int_eq(as_stringmap_get_int64((as_map*)m1, "b"), 2);
+	assert_int_eq(as_stringmap_get_int64((as_map*)m2, "a"), 1);
+	assert_int_eq(as_stringmap_get_int64((as_map*)m2, "b"), 20);
+	assert_int_eq(as_stringmap_get_int64((as_map*)m2, "d"), 4);
+
+	as_persistent_map_destroy(m1);
+	as_persistent_map_destroy(m2);
+}
+
+TEST(types_persistent_map_iterator, "as_persistent_map iterator") {
+	as_persistent_map* m = as_persistent_map_new();
+
+	for (int64_t i = 99; i >= 0; i--) {
+		as_persistent_map_set(m, (as_val*)as_integer_new(i),
+				(as_val*)as_integer_new(i));
+	}
+
+	as_map_iterator it;
+	as_map_iterator_init(&it, (as_map*)m);
+
+	int64_t n = 0;
+
+	while (as_iterator_has_next((as_iterator*)&it)) {
+		as_pair* p = (as_pair*)as_iterator_next((as_iterator*)&it);
+		assert_int_eq(as_integer_get((as_integer*)as_pair_1(p)), n);
+		n++;
+	}
+
+	as_iterator_destroy((as_iterator*)&it);
+	assert_int_eq(n, 100);
+
+	as_persistent_map_destroy(m);
+}
+
+TEST(types_persistent_map_msgpack, "as_persistent_map msgpack and compare") {
+	as_persistent_map* pm = as_persistent_map_new();
+	as_orderedmap* om = as_orderedmap_new(10);
+
+	for (int64_t i = 0; i < 40; i++) {
+		as_persistent_map_set(pm, (as_val*)as_integer_new(i),
+				(as_val*)as_integer_new(i));
+		as_orderedmap_set(om, (as_val*)as_integer_new(i),
+				(as_val*)as_integer_new(i));
+	}
+
+	assert_int_eq(as_val_cmp((as_val*)pm, (as_val*)om), MSGPACK_COMPARE_EQUAL);
+
+	as_serializer ser;
+	as_msgpack_init(&ser);
+
+	as_buffer b1;
+	as_buffer b2;
+	as_serializer_serialize(&ser, (as_val*)pm, &b1);
+	as_serializer_serialize(&ser, (as_val*)om, &b2);
+
+	assert_int_eq(b1.size, b2.size);
+	assert_true(memcmp(b1.data, b2.data, b1.size) == 0);
+
+	as_buffer_destroy(&b1);
+	as_buffer_destroy(&b2);
+	as_serializer_destroy(&ser);
+
+	as_integer k;
+	as_integer_init(&k, 0);
+	as_persistent_map_remove(pm, (as_val*)&k);
+	as_persistent_map_set(pm, (as_val*)as_integer_new(40),
+			(as_val*)as_integer_new(40));
+	assert_int_eq(as_val_cmp((as_val*)pm, (as_val*)om), MSGPACK_COMPARE_GREATER);
+
+	as_persistent_map_destroy(pm);
+	as_orderedmap_destroy(om);
+}
+
+/******************************************************************************
+ * TEST SUITE
+ *****************************************************************************/
+
+SUITE(types_persistent_map, "as_persistent_map") {
+	suite_add(types_persistent_map_empty);
+	suite_add(types_persistent_map_ops);
+	suite_add(types_persistent_map_copy);
+	suite_add(types_persistent_map_iterator);
+	suite_add(types_persistent_map_msgpack);
+}
@@ -229,6 +229,50 @@ TEST( types_queue_push_limit, "as_queue push limit" ) {
 	as_queue_destroy(&v);
 }
 
+TEST( types_queue_push_n, "as_queue batch push and pop" ) {
+	as_queue v;
+	as_queue_inita(&v, sizeof(int), 8);
+
+	int in[100];
+	int out[100];
+
+	for (int i = 0; i < 100; i++) {
+		in[i] = i;
+	}
+
+	// Offset the head, so batches wrap around the end of the block.
+	assert(as_queue_push_n(&v, in, 5) == 5);
+	assert(as_queue_pop_n(&v, out, 3) == 3);
+	assert(out[0] == 0 && out[2] == 2);
+
+	assert(as_queue_push_n(&v, &in[5], 5) == 5);
+	assert(as_queue_size(&v) == 7);
+	assert(v.capacity == 8);
+
+	// Grows from stack to heap.
+	assert(as_queue_push_n(&v, &in[10], 90) == 90);
+	assert(as_queue_size(&v) == 97);
+	assert(v.capacity == 128);
+	assert(v.flags == 1);
+
+	assert(as_queue_pop_n(&v, out, 10) == 10);
+
+	for (int i = 0; i < 10; i++) {
+		assert(out[i] == i + 3);
+	}
+
+	assert(as_queue_pop_n(&v, out, 100) == 87);
+
+	for (int i = 0; i < 87; i++) {
+		assert(out[i] == i + 13);
+	}
+
+	assert(as_queue_empty(&v));
+	assert(as_queue_pop_n(&v, out, 100) == 0);
+
+	as_queue_destroy(&v);
+}
+
 /******************************************************************************
  * TEST SUITE
  *****************************************************************************/
@@ -241,4 +285,5 @@ SUITE( types_queue, "as_queue" ) {
 	suite_add( types_queue_push_head );
 	suite_add( types_queue_pop_tail );
 	suite_add( types_queue_push_limit );
+	suite_add( types_queue_push_n );
 }
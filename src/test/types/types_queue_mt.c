@@ -1,7 +1,10 @@
 #include "../test.h"
 
+#include <aerospike/as_monitor.h>
 #include <aerospike/as_queue_mt.h>
+#include <aerospike/as_sleep.h>
 #include <citrusleaf/alloc.h>
+#include <citrusleaf/cf_clock.h>
 
 /******************************************************************************
  * TEST CASES
@@ -228,6 +231,171 @@ TEST(types_queue_mt_thread, "types_queue_mt_thread")
 	as_queue_mt_destroy(&shared_queue);
 }
 
+static as_queue_mt batch_queue;
+static int batch_sum = 0;
+
+static void*
+batch_consumer(void* data)
+{
+	int vals[16];
+	int remaining = *(int*)data;
+
+	while (remaining > 0) {
+		uint32_t n = as_queue_mt_pop_n(&batch_queue, vals, 16, AS_QUEUE_FOREVER);
+
+		for (uint32_t i = 0; i < n; i++) {
+			batch_sum += vals[i];
+		}
+		remaining -= n;
+	}
+	return NULL;
+}
+
+TEST(types_queue_mt_batch, "as_queue_mt batch push and pop")
+{
+	as_queue_mt_init(&batch_queue, sizeof(int), 10);
+
+	int vals[50];
+
+	for (int i = 0; i < 50; i++) {
+		vals[i] = i;
+	}
+
+	int out[50];
+	assert(as_queue_mt_pop_n(&batch_queue, out, 50, AS_QUEUE_NOWAIT) == 0);
+	assert(as_queue_mt_pop_n(&batch_queue, out, 50, 10) == 0);
+
+	int total = 5000;
+
+	pthread_t thread;
+	pthread_create(&thread, NULL, batch_consumer, &total);
+
+	for (int i = 0; i < total / 50; i++) {
+		assert(as_queue_mt_push_n(&batch_queue, vals, 50) == 50);
+	}
+
+	pthread_join(thread, NULL);
+
+	assert(batch_sum == (total / 50) * (49 * 50 / 2));
+	assert(as_queue_mt_empty(&batch_queue));
+
+	as_queue_mt_destroy(&batch_queue);
+}
+
+static as_queue_mt ping_queue;
+static as_queue_mt pong_queue;
+
+static void*
+pong_worker(void* data)
+{
+	int val;
+
+	for (int i = 0; i < 1000; i++) {
+		as_queue_mt_pop(&ping_queue, &val, AS_QUEUE_FOREVER);
+		as_queue_mt_push(&pong_queue, &val);
+	}
+	return NULL;
+}
+
+TEST(types_queue_mt_spin, "as_queue_mt spin budget")
+{
+	for (uint32_t spin = 0; spin <= 1000; spin += 1000) {
+		as_queue_mt_init(&ping_queue, sizeof(int), 4);
+		as_queue_mt_init(&pong_queue, sizeof(int), 4);
+		as_queue_mt_set_spin(&ping_queue, spin);
+		as_queue_mt_set_spin(&pong_queue, spin);
+
+		pthread_t thread;
+		pthread_create(&thread, NULL, pong_worker, NULL);
+
+		for (int i = 0; i < 1000; i++) {
+			int val = -1;
+
+			as_queue_mt_push(&ping_queue, &i);
+			assert(as_queue_mt_pop(&pong_queue, &val, AS_QUEUE_FOREVER));
+			assert(val == i);
+		}
+
+		pthread_join(thread, NULL);
+
+		int val;
+		assert(! as_queue_mt_pop(&pong_queue, &val, 20));
+
+		as_queue_mt_destroy(&ping_queue);
+		as_queue_mt_destroy(&pong_queue);
+	}
+}
+
+static void*
+monitor_notifier(void* data)
+{
+	as_sleep(20);
+	as_monitor_notify((as_monitor*)data);
+	return NULL;
+}
+
+TEST(types_queue_mt_timed, "as_queue_mt and as_monitor timed waits")
+{
+	as_queue_mt q;
+	as_queue_mt_init(&q, sizeof(int), 4);
+
+	int val;
+	uint64_t start = cf_getms();
+
+	assert(! as_queue_mt_pop(&q, &val, 50));
+	assert(cf_getms() - start >= 49);
+
+	as_queue_mt_destroy(&q);
+
+	as_monitor monitor;
+	as_monitor_init(&monitor);
+
+	start = cf_getms();
+	assert(! as_monitor_wait_ms(&monitor, 30));
+	assert(cf_getms() - start >= 29);
+
+	pthread_t thread;
+	pthread_create(&thread, NULL, monitor_notifier, &monitor);
+
+	assert(as_monitor_wait_ms(&monitor, 5000));
+	pthread_join(thread, NULL);
+
+	as_monitor_destroy(&monitor);
+}
+
+TEST(types_queue_mt_stats, "as_queue_mt counters")
+{
+	as_queue_mt q;
+	as_queue_mt_inita(&q, sizeof(int), 4);
+
+	as_queue_stats stats;
+	assert(! as_queue_mt_get_stats(&q, &stats));
+	assert(as_queue_mt_enable_stats(&q));
+
+	int vals[8] = { 0, 1, 2, 3, 4, 5, 6, 7 };
+
+	assert(as_queue_mt_push_n(&q, vals, 8) == 8);
+	assert(as_queue_mt_push(&q, &vals[0]));
+	assert(as_queue_mt_pop_n(&q, vals, 8, AS_QUEUE_NOWAIT) == 8);
+
+	assert(as_queue_mt_get_stats(&q, &stats));
+	assert(stats.lock_count == 3);
+	assert(stats.lock_contended == 0);
+	assert(stats.depth_max == 9);
+
+	// Without a spin budget, a timed pop on an empty queue parks.
+	as_queue_mt_set_spin(&q, 0);
+
+	int val;
+	assert(as_queue_mt_pop(&q, &val, AS_QUEUE_NOWAIT));
+	assert(! as_queue_mt_pop(&q, &val, 10));
+
+	assert(as_queue_mt_get_stats(&q, &stats));
+	assert(stats.parks >= 1);
+
+	as_queue_mt_destroy(&q);
+}
+
 /******************************************************************************
  * TEST SUITE
  *****************************************************************************/
@@ -239,4 +407,8 @@ SUITE(types_queue_mt, "as_queue_mt") {
     suite_add(types_queue_mt_pointers);
 	suite_add(types_queue_mt_pop_tail);
 	suite_add(types_queue_mt_thread);
+	suite_add(types_queue_mt_batch);
+	suite_add(types_queue_mt_spin);
+	suite_add(types_queue_mt_timed);
+	suite_add(types_queue_mt_stats);
 }
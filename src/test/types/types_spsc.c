@@ -0,0 +1,241 @@
+#include "../test.h"
+
+#include <aerospike/as_atomic.h>
+#include <aerospike/as_queue_mt.h>
+#include <aerospike/as_spsc.h>
+#include <citrusleaf/cf_clock.h>
+#include <pthread.h>
+
+/******************************************************************************
+ * STATIC FUNCTIONS
+ *****************************************************************************/
+
+#define SPSC_ITEMS 1000000
+#define SPSC_BATCH 32
+
+// Items are item_size bytes, starting with their sequence number.
+typedef struct spsc_arg_s {
+	as_spsc* q;
+	as_queue_mt* mt;
+	uint32_t item_size;
+	uint32_t count;
+	uint32_t batch;
+	bool ordered;
+} spsc_arg;
+
+static void*
+spsc_producer(void* udata)
+{
+	spsc_arg* arg = (spsc_arg*)udata;
+	uint8_t items[SPSC_BATCH * 64] = { 0 };
+
+	for (uint32_t i = 0; i < arg->count; i += arg->batch) {
+		for (uint32_t j = 0; j < arg->batch; j++) {
+			uint64_t seq = i + j;
+
+			memcpy(&items[j * arg->item_size], &seq, sizeof(seq));
+		}
+
+		if (arg->q) {
+			as_spsc_push_n(arg->q, items, arg->batch, -1);
+		}
+		else if (arg->batch == 1) {
+			as_queue_mt_push(arg->mt, items);
+		}
+		else {
+			as_queue_mt_push_n(arg->mt, items, arg->batch);
+		}
+	}
+	return NULL;
+}
+
+static void*
+spsc_consumer(void* udata)
+{
+	spsc_arg* arg = (spsc_arg*)udata;
+	uint8_t items[SPSC_BATCH * 64];
+	uint64_t next = 0;
+
+	arg->ordered = true;
+
+	while (next < arg->count) {
+		uint32_t n;
+
+		if (arg->q) {
+			n = as_spsc_pop_n(arg->q, items, arg->batch, -1);
+		}
+		else {
+			n = as_queue_mt_pop_n(arg->mt, items, arg->batch, AS_QUEUE_FOREVER);
+		}
+
+		for (uint32_t j = 0; j < n; j++) {
+			uint64_t seq;
+
+			memcpy(&seq, &items[j * arg->item_size], sizeof(seq));
+			arg->ordered = arg->ordered && seq == next;
+			next++;
+		}
+	}
+	return NULL;
+}
+
+// Returns items per second, through a spsc ring if q is set, otherwise
+// through mt.
+static uint64_t
+spsc_run(as_spsc* q, as_queue_mt* mt, uint32_t item_size, uint32_t batch,
+	bool* ordered)
+{
+	spsc_arg parg = { .q = q, .mt = mt, .item_size = item_size,
+			.count = SPSC_ITEMS, .batch = batch };
+	spsc_arg carg = parg;
+	pthread_t producer;
+	pthread_t consumer;
+	uint64_t start = cf_getns();
+
+	pthread_create(&consumer, NULL, spsc_consumer, &carg);
+	pthread_create(&producer, NULL, spsc_producer, &parg);
+	pthread_join(producer, NULL);
+	pthread_join(consumer, NULL);
+
+	uint64_t ns = cf_getns() - start;
+
+	*ordered = carg.ordered;
+	return ns == 0 ? 0 : (uint64_t)SPSC_ITEMS * 1000000000 / ns;
+}
+
+/******************************************************************************
+ * TEST CASES
+ *****************************************************************************/
+
+TEST(types_spsc_basic, "as_spsc push and pop") {
+	as_spsc q;
+	assert_true(as_spsc_init(&q, sizeof(uint32_t), 5, false));
+
+	// Rounded up to a power of 2, and bounded.
+	assert_int_eq(q.mask + 1, 8);
+
+	uint32_t v;
+	assert_false(as_spsc_pop(&q, &v, 0));
+
+	// Wrap around the ring a few times.
+	for (uint32_t round = 0; round < 5; round++) {
+		for (uint32_t i = 0; i < 8; i++) {
+			v = round * 8 + i;
+			assert_true(as_spsc_push(&q, &v, 0));
+		}
+
+		assert_false(as_spsc_push(&q, &v, 0));
+		assert_int_eq(as_spsc_size(&q), 8);
+
+		for (uint32_t i = 0; i < 8; i++) {
+			assert_true(as_spsc_pop(&q, &v, 0));
+			assert_int_eq(v, round * 8 + i);
+		}
+
+		assert_int_eq(as_spsc_size(&q), 0);
+	}
+
+	// Batches stop short when full, and split across the end of the ring.
+	uint32_t vals[12];
+
+	for (uint32_t i = 0; i < 12; i++) {
+		vals[i] = i;
+	}
+
+	assert_int_eq(as_spsc_push_n(&q, vals, 3, 0), 3);
+	assert_int_eq(as_spsc_pop_n(&q, vals, 3, 0), 3);
+	assert_int_eq(as_spsc_push_n(&q, vals, 12, 0), 8);
+
+	uint32_t out[12];
+
+	assert_int_eq(as_spsc_pop_n(&q, out, 12, 0), 8);
+
+	for (uint32_t i = 0; i < 8; i++) {
+		assert_int_eq(out[i], vals[i]);
+	}
+
+	assert_int_eq(as_spsc_pop_n(&q, out, 12, 0), 0);
+	as_spsc_destroy(&q);
+}
+
+TEST(types_spsc_threads, "as_spsc in order across threads") {
+	for (uint32_t blocking = 0; blocking < 2; blocking++) {
+		for (uint32_t batch = 1; batch <= SPSC_BATCH; batch *= SPSC_BATCH) {
+			as_spsc q;
+			bool ordered = false;
+
+			// A small ring, so both sides wait.
+			assert_true(as_spsc_init(&q, 24, 64, blocking != 0));
+			spsc_run(&q, NULL, 24, batch, &ordered);
+			assert_true(ordered);
+			assert_int_eq(as_spsc_size(&q), 0);
+			as_spsc_destroy(&q);
+		}
+	}
+}
+
+TEST(types_spsc_timed, "as_spsc timed waits") {
+	for (uint32_t blocking = 0; blocking < 2; blocking++) {
+		as_spsc q;
+		assert_true(as_spsc_init(&q, sizeof(uint32_t), 2, blocking != 0));
+
+		uint32_t v = 0;
+		uint64_t start = cf_getms();
+
+		assert_false(as_spsc_pop(&q, &v, 30));
+		assert_true(cf_getms() - start >= 29);
+
+		assert_true(as_spsc_push(&q, &v, 0));
+		assert_true(as_spsc_push(&q, &v, 0));
+
+		start = cf_getms();
+		assert_false(as_spsc_push(&q, &v, 30));
+		assert_true(cf_getms() - start >= 29);
+
+		as_spsc_destroy(&q);
+	}
+}
+
+TEST(types_spsc_bench, "as_spsc vs as_queue_mt throughput") {
+	static const uint32_t sizes[] = { 8, 64 };
+
+	for (uint32_t s = 0; s < 2; s++) {
+		for (uint32_t batch = 1; batch <= SPSC_BATCH; batch *= SPSC_BATCH) {
+			uint32_t item_size = sizes[s];
+			bool ordered = false;
+			as_queue_mt mt;
+			as_spsc q;
+
+			as_queue_mt_init(&mt, item_size, 1024);
+			uint64_t m = spsc_run(NULL, &mt, item_size, batch, &ordered);
+			assert_true(ordered);
+			as_queue_mt_destroy(&mt);
+
+			as_spsc_init(&q, item_size, 1024, true);
+			uint64_t b = spsc_run(&q, NULL, item_size, batch, &ordered);
+			assert_true(ordered);
+			as_spsc_destroy(&q);
+
+			as_spsc_init(&q, item_size, 1024, false);
+			uint64_t p = spsc_run(&q, NULL, item_size, batch, &ordered);
+			assert_true(ordered);
+			as_spsc_destroy(&q);
+
+			info("%2u byte items, batch %2u: as_queue_mt %9lu items/s, "
+					"spsc blocking %10lu items/s, spsc polling %10lu items/s",
+					item_size, batch, (unsigned long)m, (unsigned long)b,
+					(unsigned long)p);
+		}
+	}
+}
+
+/******************************************************************************
+ * TEST SUITE
+ *****************************************************************************/
+
+SUITE(types_spsc, "as_spsc") {
+	suite_add(types_spsc_basic);
+	suite_add(types_spsc_threads);
+	suite_add(types_spsc_timed);
+	suite_add(types_spsc_bench);
+}
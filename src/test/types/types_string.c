@@ -1,6 +1,7 @@
 
 #include "../test.h"
 
+#include <aerospike/as_msgpack.h>
 #include <aerospike/as_string.h>
 
 /******************************************************************************
@@ -28,6 +29,40 @@ TEST( types_string_random, "as_string containing random values" ) {
     as_string_destroy(&s);
 }
 
+TEST( types_string_strndup, "as_string from as_string_new_strndup" ) {
+    as_string * s = as_string_new_strndup("shortkeyXXX", 8);
+    assert( as_string_len(s) == 8 );
+    assert_string_eq( as_string_get(s), "shortkey" );
+    assert_true( as_string_get(s) == (char *)(s + 1) );
+    assert_false( s->free );
+
+    as_string * l = as_string_new_strdup("a string that is not embedded");
+    assert_true( l->len == SIZE_MAX );
+    assert( as_string_len(l) == 29 );
+    assert_true( as_string_get(l) != (char *)(l + 1) );
+
+    uint32_t hash = as_val_hashcode(l);
+    assert_true( hash != 0 && l->hash == hash );
+    assert_int_eq( as_val_hashcode(l), hash );
+
+    as_string_destroy(s);
+    as_string_destroy(l);
+}
+
+TEST( types_string_cmp, "as_string comparison is length aware" ) {
+    as_string * a = as_string_new_strndup("ab\0c", 4);
+    as_string * b = as_string_new_strndup("ab\0d", 4);
+    as_string * c = as_string_new_strndup("ab", 2);
+
+    assert_int_eq( as_val_cmp((as_val *)a, (as_val *)b), MSGPACK_COMPARE_LESS );
+    assert_int_eq( as_val_cmp((as_val *)c, (as_val *)a), MSGPACK_COMPARE_LESS );
+    assert_int_eq( as_val_cmp((as_val *)a, (as_val *)a), MSGPACK_COMPARE_EQUAL );
+
+    as_string_destroy(a);
+    as_string_destroy(b);
+    as_string_destroy(c);
+}
+
 /******************************************************************************
  * TEST SUITE
  *****************************************************************************/
@@ -36,4 +71,6 @@ SUITE( types_string, "as_string" ) {
     // suite_add( types_string_null );
     suite_add( types_string_empty );
     suite_add( types_string_random );
+    suite_add( types_string_strndup );
+    suite_add( types_string_cmp );
 }
\ No newline at end of file
@@ -0,0 +1,876 @@
+#include "../test.h"
+
+#include <aerospike/as_atomic.h>
+#include <aerospike/as_monitor.h>
+#include <aerospike/as_sleep.h>
+#include <aerospike/as_thread_pool.h>
+#include <citrusleaf/alloc.h>
+#include <citrusleaf/cf_clock.h>
+#include <citrusleaf/cf_queue.h>
+#include <pthread.h>
+#include <sched.h>
+
+/******************************************************************************
+ * STATIC FUNCTIONS
+ *****************************************************************************/
+
+typedef struct tree_ctx_s {
+	as_thread_pool* pool;
+	uint32_t count;
+	uint32_t pending;
+	as_monitor monitor;
+} tree_ctx;
+
+typedef struct tree_node_s {
+	tree_ctx* ctx;
+	uint32_t depth;
+} tree_node;
+
+static void
+count_task(void* udata)
+{
+	as_incr_uint32((uint32_t*)udata);
+}
+
+static void
+tree_done(tree_ctx* ctx)
+{
+	if (as_aaf_uint32(&ctx->pending, -1) == 0) {
+		as_monitor_notify(&ctx->monitor);
+	}
+}
+
+// Fans out into a binary tree of tasks, all queued from pool threads.
+static void
+tree_task(void* udata)
+{
+	tree_node* node = (tree_node*)udata;
+	tree_ctx* ctx = node->ctx;
+
+	as_incr_uint32(&ctx->count);
+
+	if (node->depth != 0) {
+		for (uint32_t i = 0; i < 2; i++) {
+			tree_node* child = (tree_node*)cf_malloc(sizeof(tree_node));
+
+			child->ctx = ctx;
+			child->depth = node->depth - 1;
+			as_incr_uint32(&ctx->pending);
+			as_thread_pool_queue_task(ctx->pool, tree_task, child);
+		}
+	}
+
+	cf_free(node);
+	tree_done(ctx);
+}
+
+static uint32_t
+tree_run(as_thread_pool* pool, uint32_t depth)
+{
+	tree_ctx ctx = { .pool = pool, .count = 0, .pending = 1 };
+	as_monitor_init(&ctx.monitor);
+
+	tree_node* root = (tree_node*)cf_malloc(sizeof(tree_node));
+
+	root->ctx = &ctx;
+	root->depth = depth;
+	as_thread_pool_queue_task(pool, tree_task, root);
+
+	as_monitor_wait(&ctx.monitor);
+	as_monitor_destroy(&ctx.monitor);
+	return ctx.count;
+}
+
+typedef struct group_node_s {
+	as_task_group* group;
+	uint32_t* count;
+	uint32_t depth;
+} group_node;
+
+// Fans out into a binary tree of tasks, all in one group.
+static void
+group_tree_task(void* udata)
+{
+	group_node* node = (group_node*)udata;
+
+	as_incr_uint32(node->count);
+
+	if (node->depth != 0) {
+		for (uint32_t i = 0; i < 2; i++) {
+			group_node* child = (group_node*)cf_malloc(sizeof(group_node));
+
+			*child = *node;
+			child->depth--;
+			as_task_group_add(node->group, group_tree_task, child);
+		}
+	}
+
+	cf_free(node);
+}
+
+typedef struct nested_ctx_s {
+	as_thread_pool* pool;
+	uint32_t count;
+} nested_ctx;
+
+// Waits for a group on the pool it runs on.
+static void
+nested_wait_task(void* udata)
+{
+	nested_ctx* ctx = (nested_ctx*)udata;
+	void* tasks[16];
+
+	for (uint32_t i = 0; i < 16; i++) {
+		tasks[i] = &ctx->count;
+	}
+
+	as_task_group group;
+
+	as_task_group_init(&group, ctx->pool);
+	as_task_group_add_n(&group, count_task, tasks, 16);
+	as_task_group_wait(&group, -1);
+	as_task_group_destroy(&group);
+}
+
+// Sets state to 1, then runs until it is set to 2.
+static void
+block_task(void* udata)
+{
+	uint32_t* state = (uint32_t*)udata;
+
+	as_store_uint32_rls(state, 1);
+
+	while (as_load_uint32_acq(state) != 2) {
+		as_sleep(1);
+	}
+}
+
+static void*
+square_fn(void* udata)
+{
+	uintptr_t v = (uintptr_t)udata;
+
+	return (void*)(v * v);
+}
+
+static uint32_t g_inits = 0;
+static uint32_t g_finis = 0;
+static uint32_t g_init_slots = 0;
+
+static void
+count_init(uint32_t index)
+{
+	as_incr_uint32(&g_inits);
+	as_aaf_uint32(&g_init_slots, (int32_t)(1 << index));
+}
+
+static uint32_t g_cancels = 0;
+
+static void
+cancel_task(void* udata)
+{
+	(void)udata;
+	as_incr_uint32(&g_cancels);
+}
+
+static void
+count_fini(void)
+{
+	as_incr_uint32(&g_finis);
+}
+
+// Polls for up to a few seconds.
+static bool
+wait_for_uint32(uint32_t* value, uint32_t expected)
+{
+	for (uint32_t i = 0; i < 5000; i++) {
+		if (as_load_uint32_acq(value) == expected) {
+			return true;
+		}
+
+		as_sleep(1);
+	}
+	return false;
+}
+
+typedef struct order_log_s {
+	uint32_t n;
+	uint32_t ids[128];
+} order_log;
+
+typedef struct order_task_s {
+	order_log* log;
+	uint32_t id;
+} order_task;
+
+static void
+order_run(void* udata)
+{
+	order_task* t = (order_task*)udata;
+	uint32_t i = as_faa_uint32(&t->log->n, 1);
+
+	t->log->ids[i] = t->id;
+}
+
+// Starts a 1 thread pool with its worker blocked, so tasks queue up.
+static void
+pool_start_blocked(as_thread_pool* pool, as_thread_pool_config* config,
+	uint32_t* state)
+{
+	config->thread_size = 1;
+	as_thread_pool_init_config(pool, config);
+
+	*state = 0;
+	as_thread_pool_queue_task(pool, block_task, state);
+
+	while (as_load_uint32_acq(state) == 0) {
+		as_sleep(1);
+	}
+}
+
+#if defined(__linux__)
+static void
+cpu_task(void* udata)
+{
+	as_store_uint32((uint32_t*)udata, (uint32_t)sched_getcpu());
+}
+#endif
+
+// The old design, as a baseline - every worker pops one shared queue.
+typedef struct shared_task_s {
+	as_task_fn fn;
+	void* udata;
+} shared_task;
+
+static void*
+shared_worker(void* udata)
+{
+	shared_task task;
+
+	while (cf_queue_pop((cf_queue*)udata, &task, CF_QUEUE_FOREVER) == CF_QUEUE_OK &&
+			task.fn) {
+		task.fn(task.udata);
+	}
+	return NULL;
+}
+
+static uint64_t
+shared_run(uint32_t n_threads, uint32_t n_tasks)
+{
+	cf_queue* q = cf_queue_create(sizeof(shared_task), true);
+	pthread_t threads[8];
+	uint32_t count = 0;
+	uint64_t start = cf_getns();
+
+	for (uint32_t i = 0; i < n_threads; i++) {
+		pthread_create(&threads[i], NULL, shared_worker, q);
+	}
+
+	shared_task task = { .fn = count_task, .udata = &count };
+
+	for (uint32_t i = 0; i < n_tasks; i++) {
+		cf_queue_push(q, &task);
+	}
+
+	task.fn = NULL;
+
+	for (uint32_t i = 0; i < n_threads; i++) {
+		cf_queue_push(q, &task);
+	}
+
+	for (uint32_t i = 0; i < n_threads; i++) {
+		pthread_join(threads[i], NULL);
+	}
+
+	uint64_t ns = cf_getns() - start;
+
+	cf_queue_destroy(q);
+	return ns == 0 ? 0 : (uint64_t)n_tasks * 1000000000 / ns;
+}
+
+static uint64_t
+pool_run(uint32_t n_threads, uint32_t n_tasks)
+{
+	as_thread_pool pool;
+	uint32_t count = 0;
+	uint64_t start = cf_getns();
+
+	as_thread_pool_init(&pool, n_threads);
+
+	for (uint32_t i = 0; i < n_tasks; i++) {
+		as_thread_pool_queue_task(&pool, count_task, &count);
+	}
+
+	as_thread_pool_destroy(&pool);
+
+	uint64_t ns = cf_getns() - start;
+
+	return ns == 0 ? 0 : (uint64_t)n_tasks * 1000000000 / ns;
+}
+
+/******************************************************************************
+ * TEST CASES
+ *****************************************************************************/
+
+TEST(types_thread_pool_drain, "as_thread_pool runs all queued tasks before destroy") {
+	as_thread_pool pool;
+	assert_int_eq(as_thread_pool_init(&pool, 4), 0);
+
+	uint32_t count = 0;
+
+	for (uint32_t i = 0; i < 100000; i++) {
+		assert_int_eq(as_thread_pool_queue_task(&pool, count_task, &count), 0);
+	}
+
+	assert_int_eq(as_thread_pool_destroy(&pool), 0);
+	assert_int_eq(count, 100000);
+
+	// Destroyed, and an empty pool takes no tasks.
+	assert_int_eq(as_thread_pool_queue_task(&pool, count_task, &count), -1);
+	assert_int_eq(as_thread_pool_destroy(&pool), 0);
+
+	assert_int_eq(as_thread_pool_init(&pool, 0), 0);
+	assert_int_eq(as_thread_pool_queue_task(&pool, count_task, &count), -1);
+	assert_int_eq(as_thread_pool_destroy(&pool), 0);
+}
+
+TEST(types_thread_pool_steal, "as_thread_pool tasks queued by workers are stolen") {
+	as_thread_pool pool;
+	assert_int_eq(as_thread_pool_init(&pool, 4), 0);
+
+	// A binary tree of depth 16 has 2^17 - 1 nodes. The deques start small,
+	// so this also grows them.
+	assert_int_eq(tree_run(&pool, 16), (1 << 17) - 1);
+	assert_int_eq(tree_run(&pool, 0), 1);
+
+	as_thread_pool_destroy(&pool);
+}
+
+TEST(types_thread_pool_batch, "as_thread_pool_queue_tasks queues a batch") {
+	as_thread_pool pool;
+	assert_int_eq(as_thread_pool_init(&pool, 4), 0);
+
+	uint32_t count = 0;
+	void* tasks[1000];
+
+	for (uint32_t i = 0; i < 1000; i++) {
+		tasks[i] = &count;
+	}
+
+	assert_int_eq(as_thread_pool_queue_tasks(&pool, count_task, tasks, 1000), 1000);
+	assert_int_eq(as_thread_pool_queue_tasks(&pool, count_task, tasks, 0), 0);
+	as_thread_pool_destroy(&pool);
+	assert_int_eq(count, 1000);
+
+	assert_int_eq(as_thread_pool_queue_tasks(&pool, count_task, tasks, 1000), 0);
+}
+
+TEST(types_thread_pool_group, "as_task_group waits for its tasks") {
+	as_thread_pool pool;
+	assert_int_eq(as_thread_pool_init(&pool, 4), 0);
+
+	uint32_t count = 0;
+	void* tasks[1000];
+
+	for (uint32_t i = 0; i < 1000; i++) {
+		tasks[i] = &count;
+	}
+
+	as_task_group group;
+	as_task_group_init(&group, &pool);
+
+	// An empty group is done.
+	assert_true(as_task_group_wait(&group, 0));
+
+	as_task_group_add_n(&group, count_task, tasks, 1000);
+	assert_true(as_task_group_wait(&group, -1));
+	assert_int_eq(count, 1000);
+
+	// Reused, with tasks adding to their own group.
+	group_node* root = (group_node*)cf_malloc(sizeof(group_node));
+
+	count = 0;
+	root->group = &group;
+	root->count = &count;
+	root->depth = 12;
+	as_task_group_add(&group, group_tree_task, root);
+	assert_true(as_task_group_wait(&group, -1));
+	assert_int_eq(count, (1 << 13) - 1);
+
+	// Timed out while a task runs, then done. The task must have started on a
+	// worker, or the wait would help by running it.
+	uint32_t state = 0;
+
+	as_task_group_add(&group, block_task, &state);
+
+	while (as_load_uint32_acq(&state) == 0) {
+		as_sleep(1);
+	}
+
+	assert_false(as_task_group_wait(&group, 20));
+	as_store_uint32_rls(&state, 2);
+	assert_true(as_task_group_wait(&group, -1));
+
+	as_task_group_destroy(&group);
+	as_thread_pool_destroy(&pool);
+
+	// Without a pool, tasks run on the caller.
+	count = 0;
+	as_task_group_init(&group, NULL);
+	as_task_group_add_n(&group, count_task, tasks, 10);
+	assert_int_eq(count, 10);
+	assert_true(as_task_group_wait(&group, 0));
+	as_task_group_destroy(&group);
+}
+
+TEST(types_thread_pool_group_nested, "as_task_group waits from inside the pool") {
+	// Every worker waits on a group of its own pool, and helps run the
+	// group's tasks rather than deadlock.
+	as_thread_pool pool;
+	assert_int_eq(as_thread_pool_init(&pool, 2), 0);
+
+	nested_ctx ctx = { .pool = &pool, .count = 0 };
+	void* tasks[64];
+
+	for (uint32_t i = 0; i < 64; i++) {
+		tasks[i] = &ctx;
+	}
+
+	as_task_group group;
+	as_task_group_init(&group, &pool);
+	as_task_group_add_n(&group, nested_wait_task, tasks, 64);
+	assert_true(as_task_group_wait(&group, -1));
+	assert_int_eq(ctx.count, 64 * 16);
+	as_task_group_destroy(&group);
+
+	as_thread_pool_destroy(&pool);
+}
+
+TEST(types_thread_pool_future, "as_future returns a task's result") {
+	as_thread_pool pool;
+	assert_int_eq(as_thread_pool_init(&pool, 4), 0);
+
+	as_future futures[100];
+
+	for (uintptr_t i = 0; i < 100; i++) {
+		as_future_submit(&futures[i], &pool, square_fn, (void*)i);
+	}
+
+	for (uintptr_t i = 0; i < 100; i++) {
+		assert_true(as_future_wait(&futures[i], -1));
+		assert_int_eq((uintptr_t)as_future_get(&futures[i]), i * i);
+		as_future_destroy(&futures[i]);
+	}
+
+	as_thread_pool_destroy(&pool);
+
+	as_future future;
+
+	as_future_submit(&future, NULL, square_fn, (void*)7);
+	assert_int_eq((uintptr_t)as_future_get(&future), 49);
+	as_future_destroy(&future);
+}
+
+TEST(types_thread_pool_resize, "as_thread_pool grows and shrinks") {
+	g_inits = 0;
+	g_finis = 0;
+	g_init_slots = 0;
+
+	as_thread_pool_config config = {
+		.thread_size = 2,
+		.thread_max = 8,
+		.init_fn = count_init,
+		.fini_fn = count_fini
+	};
+
+	as_thread_pool pool;
+	assert_int_eq(as_thread_pool_init_config(&pool, &config), 0);
+	assert_int_eq(pool.thread_size, 2);
+	assert_true(wait_for_uint32(&g_inits, 2));
+	assert_int_eq(g_init_slots, 0x3);
+
+	assert_int_eq(as_thread_pool_resize(&pool, 0), -1);
+	assert_int_eq(as_thread_pool_resize(&pool, 9), -1);
+
+	assert_int_eq(as_thread_pool_resize(&pool, 8), 0);
+	assert_int_eq(pool.thread_size, 8);
+	assert_true(wait_for_uint32(&g_inits, 8));
+	assert_int_eq(g_init_slots, 0xff);
+
+	// Tasks still run while workers stop.
+	uint32_t count = 0;
+
+	for (uint32_t i = 0; i < 10000; i++) {
+		as_thread_pool_queue_task(&pool, count_task, &count);
+	}
+
+	assert_int_eq(as_thread_pool_resize(&pool, 1), 0);
+	assert_int_eq(pool.thread_size, 1);
+	assert_true(wait_for_uint32(&g_finis, 7));
+	assert_true(wait_for_uint32(&count, 10000));
+
+	// Slots of stopped workers are reused.
+	assert_int_eq(as_thread_pool_resize(&pool, 4), 0);
+	assert_int_eq(pool.thread_size, 4);
+	assert_true(wait_for_uint32(&g_inits, 11));
+
+	as_thread_pool_destroy(&pool);
+	assert_int_eq(g_finis, 11);
+	assert_int_eq(as_thread_pool_resize(&pool, 1), -1);
+}
+
+TEST(types_thread_pool_resize_busy, "as_thread_pool shrinks then grows under load") {
+	g_inits = 0;
+	g_finis = 0;
+
+	as_thread_pool_config config = {
+		.thread_size = 4,
+		.thread_max = 4,
+		.init_fn = count_init,
+		.fini_fn = count_fini
+	};
+
+	as_thread_pool pool;
+	assert_int_eq(as_thread_pool_init_config(&pool, &config), 0);
+
+	uint32_t states[4] = { 0 };
+
+	for (uint32_t i = 0; i < 4; i++) {
+		as_thread_pool_queue_task(&pool, block_task, &states[i]);
+	}
+
+	for (uint32_t i = 0; i < 4; i++) {
+		assert_true(wait_for_uint32(&states[i], 1));
+	}
+
+	// Workers told to stop while busy are taken back, not replaced.
+	assert_int_eq(as_thread_pool_resize(&pool, 2), 0);
+	assert_int_eq(pool.thread_size, 2);
+	assert_int_eq(as_thread_pool_resize(&pool, 4), 0);
+	assert_int_eq(pool.thread_size, 4);
+
+	for (uint32_t i = 0; i < 4; i++) {
+		as_store_uint32_rls(&states[i], 2);
+	}
+
+	uint32_t count = 0;
+
+	for (uint32_t i = 0; i < 1000; i++) {
+		as_thread_pool_queue_task(&pool, count_task, &count);
+	}
+
+	assert_true(wait_for_uint32(&count, 1000));
+	assert_int_eq(pool.thread_size, 4);
+	assert_int_eq(g_inits, 4);
+	assert_int_eq(g_finis, 0);
+
+	as_thread_pool_destroy(&pool);
+	assert_int_eq(g_finis, 4);
+}
+
+TEST(types_thread_pool_reap, "as_thread_pool stops idle workers and restarts them") {
+	g_finis = 0;
+
+	as_thread_pool_config config = {
+		.thread_size = 4,
+		.thread_min = 1,
+		.idle_ms = 10,
+		.fini_fn = count_fini
+	};
+
+	as_thread_pool pool;
+	assert_int_eq(as_thread_pool_init_config(&pool, &config), 0);
+	assert_true(wait_for_uint32(&pool.thread_size, 1));
+
+	// A stopping worker still runs tasks it finds - wait until they're gone.
+	assert_true(wait_for_uint32(&g_finis, 3));
+
+	// Keep the last worker busy - tasks then find no idle worker, and start
+	// new ones.
+	uint32_t state = 0;
+
+	as_thread_pool_queue_task(&pool, block_task, &state);
+
+	while (as_load_uint32_acq(&state) == 0) {
+		as_sleep(1);
+	}
+
+	uint32_t count = 0;
+
+	as_thread_pool_queue_task(&pool, count_task, &count);
+	assert_true(as_load_uint32(&pool.thread_size) > 1);
+	assert_true(wait_for_uint32(&count, 1));
+
+	as_store_uint32_rls(&state, 2);
+	assert_true(wait_for_uint32(&pool.thread_size, 1));
+
+	as_thread_pool_destroy(&pool);
+}
+
+#if defined(__linux__)
+TEST(types_thread_pool_affinity, "as_thread_pool pins workers to cpus") {
+	uint32_t cpus[] = { 0 };
+	as_thread_pool_config config = {
+		.thread_size = 2,
+		.cpus = cpus,
+		.n_cpus = 1,
+		.cpu_per_worker = true
+	};
+
+	as_thread_pool pool;
+	assert_int_eq(as_thread_pool_init_config(&pool, &config), 0);
+
+	uint32_t cpu[8];
+
+	for (uint32_t i = 0; i < 8; i++) {
+		cpu[i] = UINT32_MAX;
+		as_thread_pool_queue_task(&pool, cpu_task, &cpu[i]);
+	}
+
+	as_thread_pool_destroy(&pool);
+
+	for (uint32_t i = 0; i < 8; i++) {
+		assert_int_eq(cpu[i], 0);
+	}
+}
+#endif
+
+TEST(types_thread_pool_lanes_strict, "as_thread_pool runs higher lanes first") {
+	as_thread_pool_config config = { .n_lanes = 3 };
+	as_thread_pool pool;
+	uint32_t state;
+
+	pool_start_blocked(&pool, &config, &state);
+
+	order_log log = { .n = 0 };
+	order_task tasks[6];
+	uint32_t lanes[6] = { 2, 2, 1, 0, 0, 0 };
+
+	for (uint32_t i = 0; i < 6; i++) {
+		tasks[i].log = &log;
+		tasks[i].id = i;
+
+		as_task_opts opts = { .lane = lanes[i], .front = i == 5 };
+
+		assert_int_eq(as_thread_pool_queue_task_opts(&pool, order_run, &tasks[i], &opts), 0);
+	}
+
+	as_store_uint32_rls(&state, 2);
+	as_thread_pool_destroy(&pool);
+
+	uint32_t expected[6] = { 5, 3, 4, 2, 0, 1 };
+
+	assert_int_eq(log.n, 6);
+
+	for (uint32_t i = 0; i < 6; i++) {
+		assert_int_eq(log.ids[i], expected[i]);
+	}
+}
+
+TEST(types_thread_pool_lanes_weighted, "as_thread_pool shares turns between weighted lanes") {
+	uint32_t weights[] = { 3, 1 };
+	as_thread_pool_config config = { .n_lanes = 2, .lane_weights = weights };
+	as_thread_pool pool;
+	uint32_t state;
+
+	pool_start_blocked(&pool, &config, &state);
+
+	order_log log = { .n = 0 };
+	order_task tasks[80];
+
+	// Ids below 40 on lane 0, the rest on lane 1.
+	for (uint32_t i = 0; i < 80; i++) {
+		tasks[i].log = &log;
+		tasks[i].id = i;
+
+		as_task_opts opts = { .lane = i < 40 ? 0 : 1 };
+
+		as_thread_pool_queue_task_opts(&pool, order_run, &tasks[i], &opts);
+	}
+
+	as_store_uint32_rls(&state, 2);
+	as_thread_pool_destroy(&pool);
+	assert_int_eq(log.n, 80);
+
+	// While both lanes have tasks, lane 1 gets about a quarter of the turns.
+	uint32_t n_low = 0;
+
+	for (uint32_t i = 0; i < 40; i++) {
+		if (log.ids[i] >= 40) {
+			n_low++;
+		}
+	}
+
+	info("lane 1 ran %u of the first 40 tasks", n_low);
+	assert_true(n_low >= 6 && n_low <= 14);
+}
+
+TEST(types_thread_pool_lanes_unweighted, "as_thread_pool runs lanes of weight 0 last") {
+	uint32_t weights[] = { 0, 1, 1 };
+	as_thread_pool_config config = { .n_lanes = 3, .lane_weights = weights };
+	as_thread_pool pool;
+	uint32_t state;
+
+	pool_start_blocked(&pool, &config, &state);
+
+	order_log log = { .n = 0 };
+	order_task tasks[20];
+
+	// Ids below 10 on lane 0, the rest on lane 2.
+	for (uint32_t i = 0; i < 20; i++) {
+		tasks[i].log = &log;
+		tasks[i].id = i;
+
+		as_task_opts opts = { .lane = i < 10 ? 0 : 2 };
+
+		as_thread_pool_queue_task_opts(&pool, order_run, &tasks[i], &opts);
+	}
+
+	as_store_uint32_rls(&state, 2);
+	as_thread_pool_destroy(&pool);
+	assert_int_eq(log.n, 20);
+
+	// Lane 1's turns pass to lane 2, not to lane 0.
+	for (uint32_t i = 0; i < 20; i++) {
+		assert_int_eq(log.ids[i], i < 10 ? i + 10 : i - 10);
+	}
+}
+
+TEST(types_thread_pool_deadline, "as_thread_pool cancels tasks past their deadline") {
+	as_thread_pool_config config = { 0 };
+	as_thread_pool pool;
+	uint32_t state;
+
+	pool_start_blocked(&pool, &config, &state);
+
+	uint32_t ran = 0;
+
+	g_cancels = 0;
+
+	as_task_opts expiring = { .deadline = cf_getns() + 1000 * 1000, .cancel_fn = cancel_task };
+	as_task_opts dropping = { .deadline = cf_getns() + 1000 * 1000 };
+	as_task_opts lasting = { .lane = 5, .deadline = cf_getns() + 60 * 1000000000ULL };
+
+	assert_int_eq(as_thread_pool_queue_task_opts(&pool, count_task, &ran, &expiring), 0);
+	assert_int_eq(as_thread_pool_queue_task_opts(&pool, count_task, &ran, &dropping), 0);
+	assert_int_eq(as_thread_pool_queue_task_opts(&pool, count_task, &ran, &lasting), 0);
+
+	// Cancelled in a group, which still completes.
+	as_task_group group;
+
+	as_task_group_init(&group, &pool);
+	as_task_group_add_opts(&group, count_task, &ran, &expiring);
+
+	as_sleep(5);
+	as_store_uint32_rls(&state, 2);
+
+	assert_true(as_task_group_wait(&group, -1));
+	as_task_group_destroy(&group);
+	as_thread_pool_destroy(&pool);
+
+	assert_int_eq(ran, 1);
+	assert_int_eq(g_cancels, 2);
+}
+
+TEST(types_thread_pool_stats, "as_thread_pool counters and timings") {
+	as_thread_pool_config config = { .stats = true };
+	as_thread_pool pool;
+	as_thread_pool_stats stats;
+	uint32_t state;
+
+	pool_start_blocked(&pool, &config, &state);
+
+	// Tasks wait behind the blocked one, and one expires.
+	uint32_t count = 0;
+	as_task_opts expiring = { .deadline = cf_getns() + 1000 * 1000 };
+
+	assert_int_eq(as_thread_pool_queue_task_opts(&pool, count_task, &count, &expiring), 0);
+
+	for (uint32_t i = 0; i < 100; i++) {
+		assert_int_eq(as_thread_pool_queue_task(&pool, count_task, &count), 0);
+	}
+
+	as_sleep(5);
+	as_store_uint32_rls(&state, 2);
+
+	// Counted just after each task returns.
+	for (uint32_t i = 0; i < 5000; i++) {
+		assert_true(as_thread_pool_get_stats(&pool, &stats));
+
+		if (stats.tasks == 102) {
+			break;
+		}
+
+		as_sleep(1);
+	}
+
+	assert_int_eq(count, 100);
+	assert_int_eq(stats.tasks, 102);
+	assert_int_eq(stats.expired, 1);
+	assert_int_eq(stats.threads, 1);
+	assert_int_eq(stats.wait.count, 102);
+	assert_int_eq(stats.run.count, 102);
+	assert_true(stats.run.max >= 4 * 1000 * 1000);
+	assert_true(as_histogram_percentile(&stats.wait, 50) >= 4 * 1000 * 1000);
+	assert_true(stats.lanes.depth_max >= 101);
+	assert_true(stats.lanes.lock_count >= 2);
+
+	info("wait p50 %lu ns, run p50 %lu ns, %lu wakeups, %lu parks",
+			(unsigned long)as_histogram_percentile(&stats.wait, 50),
+			(unsigned long)as_histogram_percentile(&stats.run, 50),
+			(unsigned long)stats.wakeups, (unsigned long)stats.parks);
+
+	as_thread_pool_destroy(&pool);
+	assert_false(as_thread_pool_get_stats(&pool, &stats));
+
+	// Not kept unless configured.
+	assert_int_eq(as_thread_pool_init(&pool, 1), 0);
+	assert_false(as_thread_pool_get_stats(&pool, &stats));
+	as_thread_pool_destroy(&pool);
+}
+
+TEST(types_thread_pool_bench, "as_thread_pool tiny task throughput") {
+	for (uint32_t n_threads = 1; n_threads <= 8; n_threads *= 2) {
+		uint64_t shared = shared_run(n_threads, 200000);
+		uint64_t pool = pool_run(n_threads, 200000);
+
+		as_thread_pool p;
+		as_thread_pool_init(&p, n_threads);
+
+		uint64_t start = cf_getns();
+		uint32_t count = tree_run(&p, 17);
+		uint64_t ns = cf_getns() - start;
+
+		as_thread_pool_destroy(&p);
+
+		info("%u threads: shared queue %8lu tasks/s, pool %8lu tasks/s, "
+				"pool fan-out %8lu tasks/s", n_threads, (unsigned long)shared,
+				(unsigned long)pool,
+				(unsigned long)(ns == 0 ? 0 : (uint64_t)count * 1000000000 / ns));
+	}
+}
+
+/******************************************************************************
+ * TEST SUITE
+ *****************************************************************************/
+
+SUITE(types_thread_pool, "as_thread_pool") {
+	suite_add(types_thread_pool_drain);
+	suite_add(types_thread_pool_steal);
+	suite_add(types_thread_pool_batch);
+	suite_add(types_thread_pool_group);
+	suite_add(types_thread_pool_group_nested);
+	suite_add(types_thread_pool_future);
+	suite_add(types_thread_pool_resize);
+	suite_add(types_thread_pool_resize_busy);
+	suite_add(types_thread_pool_reap);
+	suite_add(types_thread_pool_lanes_strict);
+	suite_add(types_thread_pool_lanes_weighted);
+	suite_add(types_thread_pool_lanes_unweighted);
+	suite_add(types_thread_pool_deadline);
+	suite_add(types_thread_pool_stats);
+#if defined(__linux__)
+	suite_add(types_thread_pool_affinity);
+#endif
+	suite_add(types_thread_pool_bench);
+}
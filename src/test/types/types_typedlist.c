@@ -0,0 +1,178 @@
+#include "../test.h"
+
+#include <aerospike/as_arraylist.h>
+#include <aerospike/as_double.h>
+#include <aerospike/as_integer.h>
+#include <aerospike/as_list.h>
+#include <aerospike/as_list_iterator.h>
+#include <aerospike/as_msgpack.h>
+#include <aerospike/as_serializer.h>
+#include <aerospike/as_string.h>
+#include <aerospike/as_typedlist.h>
+
+#include <string.h>
+
+/******************************************************************************
+ * TEST CASES
+ *****************************************************************************/
+
+TEST(types_typedlist_int64, "as_typedlist int64 ops") {
+	as_typedlist l;
+	as_typedlist_init(&l, AS_TYPEDLIST_INT64, 0);
+
+	for (int64_t i = 0; i < 1000; i++) {
+		assert_int_eq(as_list_append_int64((as_list*)&l, i * 1000), 0);
+	}
+
+	const int64_t* values = as_typedlist_int64_values(&l);
+	assert_not_null(values);
+	assert_null(as_typedlist_double_values(&l));
+	assert_int_eq(values[999], 999000);
+	assert_int_eq(as_list_size((as_list*)&l), 1000);
+	assert_int_eq(as_list_get_int64((as_list*)&l, 500), 500000);
+
+	// Boxed once, then the same value is returned.
+	as_val* v = as_list_get((as_list*)&l, 500);
+	assert_int_eq(as_integer_get(as_integer_fromval(v)), 500000);
+	assert_true(v == as_list_get((as_list*)&l, 500));
+
+	assert_int_eq(as_list_insert_int64((as_list*)&l, 0, -1), 0);
+	assert_int_eq(as_list_get_int64((as_list*)&l, 0), -1);
+	assert_true(v == as_list_get((as_list*)&l, 501));
+
+	assert_int_eq(as_list_remove((as_list*)&l, 0), 0);
+	assert_int_eq(as_list_set((as_list*)&l, 500, (as_val*)as_integer_new(7)), 0);
+	assert_int_eq(as_list_get_int64((as_list*)&l, 500), 7);
+
+	assert_int_eq(as_list_trim((as_list*)&l, 10), 0);
+	assert_int_eq(as_list_size((as_list*)&l), 10);
+
+	as_list* take = as_list_take((as_list*)&l, 3);
+	assert_int_eq(as_list_size(take), 3);
+	assert_int_eq(as_list_get_int64(take, 2), 2000);
+	as_list_destroy(take);
+
+	as_typedlist_destroy(&l);
+}
+
+TEST(types_typedlist_double, "as_typedlist double ops") {
+	as_typedlist* l = as_typedlist_new(AS_TYPEDLIST_DOUBLE, 4);
+
+	for (int i = 0; i < 10; i++) {
+		assert_int_eq(as_list_append_double((as_list*)l, i + 0.5), 0);
+	}
+
+	assert_not_null(as_typedlist_double_values(l));
+	assert_true(as_list_get_double((as_list*)l, 9) == 9.5);
+	assert_true(as_double_get(as_double_fromval(as_list_get((as_list*)l, 3))) == 3.5);
+
+	as_list_iterator it;
+	as_list_iterator_init(&it, (as_list*)l);
+
+	int n = 0;
+
+	while (as_iterator_has_next((as_iterator*)&it)) {
+		const as_val* v = as_iterator_next((as_iterator*)&it);
+		assert_true(as_double_get(as_double_fromval(v)) == n + 0.5);
+		n++;
+	}
+
+	as_iterator_destroy((as_iterator*)&it);
+	assert_int_eq(n, 10);
+
+	as_typedlist_destroy(l);
+}
+
+TEST(types_typedlist_promote, "as_typedlist promotes on other types") {
+	as_typedlist* l = as_typedlist_new(AS_TYPEDLIST_INT64, 4);
+
+	for (int64_t i = 0; i < 4; i++) {
+		as_typedlist_append_int64(l, 1000000 + i);
+	}
+
+	as_val* v = as_list_get((as_list*)l, 1);
+
+	assert_int_eq(as_list_append_str((as_list*)l, "x"), 0);
+	assert_null(as_typedlist_int64_values(l));
+	assert_null(as_typedlist_fromlist((as_list*)l));
+	assert_int_eq(as_list_size((as_list*)l), 5);
+	assert_string_eq(as_list_get_str((as_list*)l, 4), "x");
+	assert_int_eq(as_list_get_int64((as_list*)l, 3), 1000003);
+
+	// Boxed values survive promotion.
+	assert_true(v == as_list_get((as_list*)l, 1));
+
+	as_typedlist_destroy(l);
+
+	as_typedlist* d = as_typedlist_new(AS_TYPEDLIST_DOUBLE, 0);
+	as_list_append_double((as_list*)d, 1.5);
+	as_list_append_int64((as_list*)d, 2);
+	assert_null(as_typedlist_double_values(d));
+	assert_int_eq(as_list_get_int64((as_list*)d, 1), 2);
+	as_typedlist_destroy(d);
+}
+
+TEST(types_typedlist_msgpack, "as_typedlist msgpack and compare") {
+	as_typedlist* tl = as_typedlist_new(AS_TYPEDLIST_INT64, 100);
+	as_arraylist* al = as_arraylist_new(100, 10);
+
+	for (int64_t i = -50; i < 50; i++) {
+		as_typedlist_append_int64(tl, i * 100000);
+		as_arraylist_append_int64(al, i * 100000);
+	}
+
+	// Before anything is boxed.
+	assert_true(as_val_memory_size((as_val*)tl) <
+			as_val_memory_size((as_val*)al) / 2);
+	assert_int_eq(as_val_cmp((as_val*)tl, (as_val*)al), MSGPACK_COMPARE_EQUAL);
+
+	as_serializer ser;
+	as_msgpack_init(&ser);
+
+	as_buffer b1;
+	as_buffer b2;
+	as_serializer_serialize(&ser, (as_val*)tl, &b1);
+	as_serializer_serialize(&ser, (as_val*)al, &b2);
+
+	assert_int_eq(b1.size, b2.size);
+	assert_true(memcmp(b1.data, b2.data, b1.size) == 0);
+
+	as_unpacker pk = { .buffer = b1.data, .offset = 0, .length = b1.size };
+	as_val* v = NULL;
+
+	assert_int_eq(as_unpack_val_typed(&pk, &v), 0);
+	assert_not_null(as_typedlist_fromlist((as_list*)v));
+	assert_int_eq(as_val_cmp(v, (as_val*)al), MSGPACK_COMPARE_EQUAL);
+	as_val_destroy(v);
+
+	// Mixed element types unpack as an arraylist.
+	as_arraylist_append_str(al, "x");
+	as_buffer_destroy(&b2);
+	as_serializer_serialize(&ser, (as_val*)al, &b2);
+
+	as_unpacker pk2 = { .buffer = b2.data, .offset = 0, .length = b2.size };
+
+	assert_int_eq(as_unpack_val_typed(&pk2, &v), 0);
+	assert_null(as_typedlist_fromlist((as_list*)v));
+	assert_int_eq(as_val_cmp(v, (as_val*)al), MSGPACK_COMPARE_EQUAL);
+	assert_int_eq(pk2.offset, b2.size);
+	as_val_destroy(v);
+
+	as_buffer_destroy(&b1);
+	as_buffer_destroy(&b2);
+	as_serializer_destroy(&ser);
+
+	as_typedlist_destroy(tl);
+	as_arraylist_destroy(al);
+}
+
+/******************************************************************************
+ * TEST SUITE
+ *****************************************************************************/
+
+SUITE(types_typedlist, "as_typedlist") {
+	suite_add(types_typedlist_int64);
+	suite_add(types_typedlist_double);
+	suite_add(types_typedlist_promote);
+	suite_add(types_typedlist_msgpack);
+}
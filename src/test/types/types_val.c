@@ -0,0 +1,289 @@
+#include "../test.h"
+
+#include <aerospike/as_arraylist.h>
+#include <aerospike/as_hashmap.h>
+#include <aerospike/as_bytes.h>
+#include <aerospike/as_integer.h>
+#include <aerospike/as_msgpack.h>
+#include <aerospike/as_persistent_list.h>
+#include <aerospike/as_sleep.h>
+#include <aerospike/as_string.h>
+#include <aerospike/as_stringmap.h>
+#include <aerospike/as_typedlist.h>
+#include <aerospike/as_val_reclaim.h>
+
+#include <string.h>
+
+/******************************************************************************
+ * TEST CASES
+ *****************************************************************************/
+
+#define DEEP 200000
+
+TEST(types_val_destroy_deep, "destroy a deeply nested list without recursion")
+{
+	as_arraylist* list = as_arraylist_new(1, 0);
+
+	for (int i = 0; i < DEEP; i++) {
+		as_arraylist* parent = as_arraylist_new(2, 0);
+		as_arraylist_append_int64(parent, i);
+		as_arraylist_append(parent, (as_val*)list);
+		list = parent;
+	}
+
+	assert_int_eq(as_arraylist_size(list), 2);
+	as_arraylist_destroy(list);
+}
+
+TEST(types_val_destroy_wide, "destroy a wide tree of maps")
+{
+	as_arraylist* list = as_arraylist_new(1000, 0);
+
+	for (int i = 0; i < 1000; i++) {
+		as_hashmap* map = as_hashmap_new(4);
+		as_stringmap_set_int64((as_map*)map, "a", i);
+		as_stringmap_set_str((as_map*)map, "b", "a string longer than inline");
+		as_arraylist_append(list, (as_val*)map);
+	}
+
+	as_val_destroy(list);
+}
+
+TEST(types_val_destroy_deferred, "destroy on the reclaimer thread")
+{
+	as_val_reclaim_stats stats;
+
+	// Not started - destroyed in place.
+	as_arraylist* list = as_arraylist_new(1, 0);
+	assert_null(as_val_destroy_deferred((as_val*)list));
+
+	assert_int_eq(as_val_reclaim_start(2), 0);
+	assert_int_eq(as_val_reclaim_start(2), -1);
+
+	for (int i = 0; i < 100; i++) {
+		list = as_arraylist_new(10, 0);
+
+		for (int j = 0; j < 10; j++) {
+			as_arraylist_append_int64(list, 1000000 + j);
+		}
+
+		assert_null(as_val_destroy_deferred((as_val*)list));
+	}
+
+	// Not the last reference - only the count is dropped.
+	list = as_arraylist_new(1, 0);
+	as_val_reserve(list);
+	assert_not_null(as_val_destroy_deferred((as_val*)list));
+	assert_int_eq(list->_._.count, 1);
+
+	// Leaves are never deferred.
+	assert_null(as_val_destroy_deferred((as_val*)as_integer_new(1000000)));
+
+	// Confined elements held elsewhere are shared before the handover - once
+	// there's room in the backlog, so it is handed over.
+	do {
+		as_sleep(1);
+		as_val_reclaim_get_stats(&stats);
+	} while (stats.backlog != 0);
+
+	as_arraylist* other = as_arraylist_new(1, 0);
+	as_val* e = as_val_confine((as_val*)as_integer_new(1000000));
+
+	as_val_reserve(e);
+	as_arraylist_append(other, e);
+	assert_null(as_val_destroy_deferred((as_val*)other));
+	assert_false(e->local);
+	as_val_destroy(e);
+
+	as_val_reclaim_stop();
+	as_val_destroy(list);
+
+	as_val_reclaim_get_stats(&stats);
+	assert_int_eq(stats.deferred + stats.overflows, 101);
+	assert_int_eq(stats.reclaimed, stats.deferred);
+	assert_int_eq(stats.backlog, 0);
+	assert_true(stats.backlog_peak <= 2);
+}
+
+TEST(types_val_memory_size, "heap memory of a value tree")
+{
+	const char* text = "a string longer than the inline buffer";
+
+	as_arraylist* list = as_arraylist_new(4, 0);
+	as_string* s = as_string_new_strdup(text);
+	as_arraylist_append(list, (as_val*)s);
+	as_arraylist_append_int64(list, 1L << 40);
+	as_arraylist_append(list, (as_val*)as_integer_new_cached(5)); // not counted
+
+	size_t expected = sizeof(as_arraylist) + 4 * sizeof(as_val*) +
+			sizeof(as_string) + strlen(text) + 1 + sizeof(as_integer);
+
+	assert_int_eq(as_val_memory_size((as_val*)list), expected);
+
+	as_val_memory mem = { 0 };
+	as_val_memory_usage((as_val*)list, &mem);
+	assert_int_eq(mem.exclusive, expected);
+	assert_int_eq(mem.shared, 0);
+
+	// Referenced from another list - the string becomes shared.
+	as_arraylist* other = as_arraylist_new(1, 0);
+	as_arraylist_append(other, as_val_reserve(s));
+
+	memset(&mem, 0, sizeof(mem));
+	as_val_memory_usage((as_val*)list, &mem);
+	assert_int_eq(mem.shared, sizeof(as_string) + strlen(text) + 1);
+	assert_int_eq(mem.exclusive + mem.shared, expected);
+
+	as_arraylist_destroy(other);
+	as_arraylist_destroy(list);
+
+	// Persistent list copies share their nodes.
+	as_persistent_list* p1 = as_persistent_list_new();
+
+	for (int i = 0; i < 100; i++) {
+		as_persistent_list_append_int64(p1, 1000000 + i);
+	}
+
+	memset(&mem, 0, sizeof(mem));
+	as_val_memory_usage((as_val*)p1, &mem);
+	assert_int_eq(mem.shared, 0);
+
+	as_persistent_list* p2 = as_persistent_list_copy(p1);
+
+	memset(&mem, 0, sizeof(mem));
+	as_val_memory_usage((as_val*)p2, &mem);
+	assert_int_eq(mem.exclusive, sizeof(as_persistent_list));
+	assert_true(mem.shared > 100 * sizeof(as_integer));
+
+	as_persistent_list_destroy(p1);
+	as_persistent_list_destroy(p2);
+}
+
+static as_map*
+clone_template(void)
+{
+	as_hashmap* rec = as_hashmap_new(8);
+	as_stringmap_set_str((as_map*)rec, "name", "a string longer than inline");
+	as_stringmap_set_int64((as_map*)rec, "ttl", 1L << 40);
+
+	as_arraylist* tags = as_arraylist_new(4, 4);
+	as_arraylist_append_int64(tags, 1);
+	as_arraylist_append_str(tags, "two");
+	as_stringmap_set_list((as_map*)rec, "tags", (as_list*)tags);
+
+	as_orderedmap* ord = as_orderedmap_new(4);
+	as_orderedmap_set_flags(ord, AS_PACKED_MAP_FLAG_KV_ORDERED);
+	as_stringmap_set_int64((as_map*)ord, "b", 2);
+	as_stringmap_set_int64((as_map*)ord, "a", 1);
+	as_stringmap_set_map((as_map*)rec, "ord", (as_map*)ord);
+
+	as_typedlist* nums = as_typedlist_new(AS_TYPEDLIST_DOUBLE, 2);
+	as_typedlist_append_double(nums, 1.5);
+	as_typedlist_append_double(nums, 2.5);
+	as_stringmap_set_list((as_map*)rec, "nums", (as_list*)nums);
+
+	uint8_t raw[3] = { 1, 2, 3 };
+	as_bytes* b = as_bytes_new(3);
+	as_bytes_set(b, 0, raw, 3);
+	as_stringmap_set_bytes((as_map*)rec, "blob", b);
+
+	return (as_map*)rec;
+}
+
+TEST(types_val_clone_deep, "deep clone of a value tree")
+{
+	as_map* rec = clone_template();
+	as_map* copy = (as_map*)as_val_clone((as_val*)rec);
+
+	assert_not_null(copy);
+	assert_int_eq(as_val_cmp((as_val*)rec, (as_val*)copy), MSGPACK_COMPARE_EQUAL);
+
+	// Nothing is shared.
+	const char* keys[] = { "name", "ttl", "tags", "ord", "nums", "blob" };
+
+	for (int i = 0; i < 6; i++) {
+		as_val* v1 = as_stringmap_get(rec, keys[i]);
+		as_val* v2 = as_stringmap_get(copy, keys[i]);
+
+		assert_true(v1 != v2);
+		assert_int_eq(v1->count, 1);
+		assert_int_eq(v2->count, 1);
+	}
+
+	// Types and flags are kept.
+	as_map* ord = as_stringmap_get_map(copy, "ord");
+	assert_not_null(as_orderedmap_frommap(ord));
+	assert_int_eq(ord->flags, AS_PACKED_MAP_FLAG_KV_ORDERED);
+	assert_not_null(as_typedlist_fromlist(as_stringmap_get_list(copy, "nums")));
+
+	as_list_append_int64(as_stringmap_get_list(copy, "tags"), 3);
+	assert_int_eq(as_list_size(as_stringmap_get_list(copy, "tags")), 3);
+	assert_int_eq(as_list_size(as_stringmap_get_list(rec, "tags")), 2);
+
+	as_map_destroy(copy);
+	as_map_destroy(rec);
+
+	// Static values are returned as is.
+	assert_true(as_val_clone((as_val*)&as_nil) == (as_val*)&as_nil);
+	assert_null(as_val_clone(NULL));
+}
+
+TEST(types_val_clone_cow, "copy-on-write clone of a value tree")
+{
+	as_map* rec = clone_template();
+	as_map* copy = (as_map*)as_val_clone_cow((as_val*)rec);
+
+	assert_not_null(copy);
+	assert_true(copy != rec);
+	assert_int_eq(as_val_cmp((as_val*)rec, (as_val*)copy), MSGPACK_COMPARE_EQUAL);
+
+	// Children are shared until unshared.
+	as_list* tags = as_stringmap_get_list(rec, "tags");
+	assert_true(as_stringmap_get_list(copy, "tags") == tags);
+	assert_int_eq(tags->_.count, 2);
+
+	// The root may be modified directly.
+	as_stringmap_set_int64(copy, "ttl", 300);
+	assert_int_eq(as_stringmap_get_int64(rec, "ttl"), 1L << 40);
+
+	as_string key;
+	as_string_init(&key, "tags", false);
+
+	as_list* mine = (as_list*)as_map_unshare(copy, (as_val*)&key);
+	assert_not_null(mine);
+	assert_true(mine != tags);
+	assert_int_eq(tags->_.count, 1);
+
+	// Already unshared - left in place.
+	assert_true(as_map_unshare(copy, (as_val*)&key) == (as_val*)mine);
+	as_string_destroy(&key);
+
+	as_list_append_int64(mine, 3);
+	assert_int_eq(as_list_size(mine), 3);
+	assert_int_eq(as_list_size(tags), 2);
+
+	// The elements of the unshared list are still shared.
+	assert_true(as_list_get(mine, 1) == as_list_get(tags, 1));
+
+	as_string* s = (as_string*)as_list_unshare(mine, 1);
+	assert_true((as_val*)s != as_list_get(tags, 1));
+	assert_string_eq(as_string_get(s), "two");
+
+	as_map_destroy(rec);
+	assert_int_eq(as_list_size(as_stringmap_get_list(copy, "tags")), 3);
+	as_map_destroy(copy);
+}
+
+/******************************************************************************
+ * TEST SUITE
+ *****************************************************************************/
+
+SUITE(types_val, "as_val")
+{
+	suite_add(types_val_destroy_deep);
+	suite_add(types_val_destroy_wide);
+	suite_add(types_val_destroy_deferred);
+	suite_add(types_val_memory_size);
+	suite_add(types_val_clone_deep);
+	suite_add(types_val_clone_cow);
+}